@@ -135,16 +135,23 @@ class Kunquat():
                 ctypes.cast(cdata, ctypes.POINTER(ctypes.c_ubyte)),
                 len(data))
 
-    def validate(self):
+    def validate(self, full=False):
         """Validate data in the Kunquat instance.
 
+        Optional arguments:
+        full -- If True, check all data instead of only the parts
+                changed since the previous validation.
+
         Exceptions:
         KunquatFormatError -- The module data is not valid.  This
                               indicates that the handle is useless and
                               should be discarded.
 
         """
-        _kunquat.kqt_Handle_validate(self._handle)
+        if full:
+            _kunquat.kqt_Handle_validate_full(self._handle)
+        else:
+            _kunquat.kqt_Handle_validate(self._handle)
 
     @property
     def track(self):
@@ -329,6 +336,36 @@ class Kunquat():
             el = json.loads(str(raw_el_data, encoding='utf-8'))
         return all_events
 
+    def get_profile(self):
+        """Get the render profile.
+
+        Return value:
+        A dictionary describing the cumulative rendering cost of each
+        device and master output stage.  The counters are only
+        updated if libkunquat is built with render profiling enabled.
+
+        """
+        raw_profile = _kunquat.kqt_Handle_get_profile(self._handle)
+        return json.loads(str(raw_profile, encoding='utf-8'))
+
+    def reset_profile(self):
+        """Reset the render profile counters."""
+        _kunquat.kqt_Handle_reset_profile(self._handle)
+
+    def set_render_trace_enabled(self, enabled):
+        """Enable or disable render timeline tracing."""
+        _kunquat.kqt_Handle_set_render_trace_enabled(self._handle, 1 if enabled else 0)
+
+    def get_render_trace(self):
+        """Get the render timeline recorded since the previous call.
+
+        Return value:
+        A dictionary in the Chrome trace event format.
+
+        """
+        raw_trace = _kunquat.kqt_Handle_get_render_trace(self._handle)
+        return json.loads(str(raw_trace, encoding='utf-8'))
+
     def __del__(self):
         if self._handle:
             _kunquat.kqt_del_Handle(self._handle)
@@ -516,6 +553,9 @@ _kunquat.kqt_Handle_clear_error.restype = None
 _kunquat.kqt_Handle_validate.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_validate.restype = ctypes.c_int
 _kunquat.kqt_Handle_validate.errcheck = _error_check
+_kunquat.kqt_Handle_validate_full.argtypes = [kqt_Handle]
+_kunquat.kqt_Handle_validate_full.restype = ctypes.c_int
+_kunquat.kqt_Handle_validate_full.errcheck = _error_check
 
 _kunquat.kqt_Handle_set_data.argtypes = [
         kqt_Handle, ctypes.c_char_p, ctypes.POINTER(ctypes.c_ubyte), ctypes.c_long]
@@ -579,6 +619,19 @@ _kunquat.kqt_Handle_receive_events.argtypes = [kqt_Handle]
 _kunquat.kqt_Handle_receive_events.restype = ctypes.c_char_p
 _kunquat.kqt_Handle_receive_events.errcheck = _error_check
 
+_kunquat.kqt_Handle_get_profile.argtypes = [kqt_Handle]
+_kunquat.kqt_Handle_get_profile.restype = ctypes.c_char_p
+_kunquat.kqt_Handle_get_profile.errcheck = _error_check
+_kunquat.kqt_Handle_reset_profile.argtypes = [kqt_Handle]
+_kunquat.kqt_Handle_reset_profile.restype = ctypes.c_int
+_kunquat.kqt_Handle_reset_profile.errcheck = _error_check
+_kunquat.kqt_Handle_set_render_trace_enabled.argtypes = [kqt_Handle, ctypes.c_int]
+_kunquat.kqt_Handle_set_render_trace_enabled.restype = ctypes.c_int
+_kunquat.kqt_Handle_set_render_trace_enabled.errcheck = _error_check
+_kunquat.kqt_Handle_get_render_trace.argtypes = [kqt_Handle]
+_kunquat.kqt_Handle_get_render_trace.restype = ctypes.c_char_p
+_kunquat.kqt_Handle_get_render_trace.errcheck = _error_check
+
 _kunquat.kqt_get_event_names.argtypes = []
 _kunquat.kqt_get_event_names.restype = ctypes.POINTER(ctypes.c_char_p)
 _kunquat.kqt_get_event_arg_type.argtypes = [ctypes.c_char_p]
@@ -47,6 +47,7 @@ from scripts.cc import get_cc
 from scripts.configure import test_add_external_deps, test_add_test_deps
 from scripts.build_libkunquat import build_libkunquat
 from scripts.test_libkunquat import test_libkunquat
+from scripts.bench_libkunquat import bench_libkunquat
 from scripts.build_examples import build_examples
 from scripts.install_libkunquat import install_libkunquat
 from scripts.install_examples import install_examples
@@ -166,6 +167,12 @@ def build():
     if options.enable_debug_asserts:
         cc.add_define('ENABLE_DEBUG_ASSERTS')
 
+    if options.enable_render_profiling:
+        cc.add_define('ENABLE_RENDER_PROFILING')
+
+    if options.enable_rt_checks:
+        cc.add_define('ENABLE_RT_CHECKS')
+
     #if options.enable_profiling:
     #    compile_flags.append('-pg')
     #    link_flags.append('-pg')
@@ -213,6 +220,23 @@ def build():
         build_examples(builder)
 
 
+def bench():
+    build()
+
+    if not options.enable_libkunquat:
+        print('Benchmarks require libkunquat to be enabled.', file=sys.stderr)
+        sys.exit(1)
+
+    cc = get_cc(options.cc)
+    cc.set_optimisation(options.optimise)
+
+    builder = PrettyBuilder()
+
+    test_add_external_deps(builder, options, cc)
+
+    bench_libkunquat(builder, options, cc)
+
+
 def clean():
     if os.path.exists('build'):
         # Remove Python-specific build directories first
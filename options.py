@@ -9,6 +9,12 @@ enable_debug = True
 # enable debug asserts
 enable_debug_asserts = False
 
+# enable render profiling instrumentation (see kqt_Handle_get_profile)
+enable_render_profiling = False
+
+# report allocations and locking inside render sections (see kunquat/testing.h)
+enable_rt_checks = False
+
 # enable libkunquat
 enable_libkunquat = True
 
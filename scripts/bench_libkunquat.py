@@ -0,0 +1,63 @@
+# -*- coding: utf-8 -*-
+
+#
+# Author: Tomi Jylhä-Ollila, Finland 2017
+#
+# This file is part of Kunquat.
+#
+# CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+#
+# To the extent possible under law, Kunquat Affirmers have waived all
+# copyright and related or neighboring rights to Kunquat.
+#
+
+import os
+import os.path
+import shlex
+import subprocess
+import sys
+
+from . import command
+
+
+def bench_libkunquat(builder, options, cc):
+    build_dir = os.path.join('build', 'src')
+    bench_dir = os.path.join(build_dir, 'bench')
+
+    src_dir = os.path.join('src', 'bench')
+
+    cc.add_include_dir(os.path.join('src', 'include'))
+
+    libkunquat_dir = os.path.join(build_dir, 'lib')
+    cc.add_lib_dir(libkunquat_dir)
+    cc.add_lib('kunquat')
+
+    echo = '\n   Benchmarking libkunquat\n'
+
+    src_path = os.path.join(src_dir, 'bench.c')
+    out_path = os.path.join(bench_dir, 'bench')
+    cc.build_exe(builder, src_path, out_path, echo=echo)
+
+    # Measure scaling up to the number of available processors
+    thread_count = min(max(os.cpu_count() or 1, 1), 32)
+    if not options.enable_threads:
+        thread_count = 1
+
+    call = 'env LD_LIBRARY_PATH={} {} --threads {}'.format(
+            libkunquat_dir, out_path, thread_count)
+    try:
+        output = subprocess.check_output(shlex.split(call), universal_newlines=True)
+    except subprocess.CalledProcessError as e:
+        print('Benchmark failed with return code {}'.format(e.returncode),
+                file=sys.stderr)
+        sys.exit(1)
+
+    print(output, end='')
+
+    results_path = os.path.join(bench_dir, 'results.json')
+    with open(results_path, 'w') as f:
+        f.write(output)
+
+    print('\nBenchmark results were written to {}'.format(results_path))
+
+
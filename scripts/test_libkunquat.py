@@ -61,8 +61,10 @@ def test_libkunquat(builder, options, cc):
             'connections': ['handle', 'player'],
             'generator': ['connections'],
             'instrument': ['connections'],
+            'filter': ['connections'],
             'dsp': ['connections', 'fast_sin'],
             'validation': ['handle'],
+            'rt_check': ['player'],
         })
     finished_tests = set()
 
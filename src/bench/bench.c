@@ -0,0 +1,766 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <kunquat/Handle.h>
+#include <kunquat/limits.h>
+#include <kunquat/Player.h>
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+/*
+ * Rendering benchmarks of libkunquat.
+ *
+ * Each scenario builds a synthetic module through kqt_Handle_set_data, starts
+ * a number of sustained notes and measures the time spent in kqt_Handle_play
+ * with each thread count. The results are written to standard output in JSON
+ * format so that they can be compared across revisions.
+ */
+
+
+#define AUDIO_RATE 48000
+#define BUFFER_SIZE 2048
+#define WARMUP_FRAMES (BUFFER_SIZE * 4)
+
+#define DEFAULT_FRAMES (AUDIO_RATE * 10)
+#define DEFAULT_VOICES 32
+#define DEFAULT_THREADS_MAX 4
+
+// The voice count used for measuring effect costs without a render profile
+#define EFFECT_VOICES 1
+
+#define BUS_CHAIN_DEPTH 16
+#define FREEVERB_CHAIN_DEPTH 8
+#define FILTER_CHAIN_LENGTH 4
+
+
+typedef struct Bench_config
+{
+    long frames;
+    int voices;
+    int threads_max;
+    const char* scenario;
+} Bench_config;
+
+
+typedef bool Module_builder(kqt_Handle handle);
+
+
+typedef struct Scenario
+{
+    const char* name;
+    Module_builder* build;
+    int effect_channels;
+    const char* skip_reason;
+} Scenario;
+
+
+static int64_t get_time_ns(void)
+{
+#if defined(_XOPEN_SOURCE) && (_XOPEN_SOURCE >= 600)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
+#else
+    return (int64_t)((double)clock() * (1000000000.0 / CLOCKS_PER_SEC));
+#endif
+}
+
+
+static bool set_data(kqt_Handle handle, const char* key, const char* data)
+{
+    if (!kqt_Handle_set_data(handle, key, data, (long)strlen(data)))
+    {
+        fprintf(stderr, "Could not set %s: %s\n", key, kqt_Handle_get_error(handle));
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool set_dataf(
+        kqt_Handle handle, const char* data, const char* key_format, ...)
+{
+    char key[128] = "";
+
+    va_list args;
+    va_start(args, key_format);
+    vsnprintf(key, sizeof(key), key_format, args);
+    va_end(args);
+
+    return set_data(handle, key, data);
+}
+
+
+static bool add_ports(
+        kqt_Handle handle, const char* prefix, int in_count, int out_count)
+{
+    for (int i = 0; i < in_count; ++i)
+    {
+        if (!set_dataf(handle, "{}", "%sin_%02x/p_manifest.json", prefix, i))
+            return false;
+    }
+
+    for (int i = 0; i < out_count; ++i)
+    {
+        if (!set_dataf(handle, "{}", "%sout_%02x/p_manifest.json", prefix, i))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool add_proc(
+        kqt_Handle handle,
+        int au,
+        int proc,
+        const char* type,
+        bool is_voice,
+        int in_count,
+        int out_count)
+{
+    char prefix[32] = "";
+    snprintf(prefix, sizeof(prefix), "au_%02x/proc_%02x/", au, proc);
+
+    char manifest[64] = "";
+    snprintf(manifest, sizeof(manifest), "{ \"type\": \"%s\" }", type);
+
+    return set_dataf(handle, manifest, "%sp_manifest.json", prefix) &&
+        set_dataf(
+                handle,
+                is_voice ? "\"voice\"" : "\"mixed\"",
+                "%sp_signal_type.json",
+                prefix) &&
+        add_ports(handle, prefix, in_count, out_count);
+}
+
+
+static bool add_module_base(kqt_Handle handle, const char* connections)
+{
+    return set_data(handle, "out_00/p_manifest.json", "{}") &&
+        set_data(handle, "out_01/p_manifest.json", "{}") &&
+        set_data(handle, "p_connections.json", connections) &&
+        set_data(handle, "p_control_map.json", "[ [0, 0] ]") &&
+        set_data(handle, "control_00/p_manifest.json", "{}");
+}
+
+
+/*
+ * The instrument always contains pitch (proc_00) and force (proc_01)
+ * processors. Force output keeps the voices alive, so the sound generator
+ * connections must include ["proc_01/C/out_00", "proc_XX/C/in_01"].
+ */
+static bool add_instrument(kqt_Handle handle, const char* connections)
+{
+    char conns[2048] = "";
+    snprintf(
+            conns,
+            sizeof(conns),
+            "[ [\"proc_00/C/out_00\", \"proc_01/C/in_00\"], %s",
+            connections + 1);
+
+    return set_data(handle, "au_00/p_manifest.json", "{ \"type\": \"instrument\" }") &&
+        add_ports(handle, "au_00/", 0, 2) &&
+        set_data(handle, "au_00/p_connections.json", conns) &&
+        add_proc(handle, 0, 0, "pitch", true, 0, 1) &&
+        add_proc(handle, 0, 1, "force", true, 1, 1);
+}
+
+
+static bool add_additive_proc(kqt_Handle handle, int proc)
+{
+    if (!add_proc(handle, 0, proc, "add", true, 2, 2))
+        return false;
+
+    // Use a few partials so that the cost resembles a typical instrument
+    for (int i = 0; i < 8; ++i)
+    {
+        char pitch[16] = "";
+        snprintf(pitch, sizeof(pitch), "%d", i + 1);
+        char volume[16] = "";
+        snprintf(volume, sizeof(volume), "%d", -6 * i);
+
+        if (!set_dataf(handle, pitch, "au_00/proc_%02x/c/tone_%02x/p_f_pitch.json", proc, i) ||
+                !set_dataf(
+                    handle, volume, "au_00/proc_%02x/c/tone_%02x/p_f_volume.json", proc, i))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool add_effect(
+        kqt_Handle handle, int au, const char* type, const char* param_key, const char* param)
+{
+    char prefix[16] = "";
+    snprintf(prefix, sizeof(prefix), "au_%02x/", au);
+
+    if (!set_dataf(handle, "{ \"type\": \"effect\" }", "%sp_manifest.json", prefix) ||
+            !add_ports(handle, prefix, 2, 2) ||
+            !set_dataf(
+                handle,
+                "[ [\"in_00\", \"proc_00/C/in_00\"]"
+                ", [\"in_01\", \"proc_00/C/in_01\"]"
+                ", [\"proc_00/C/out_00\", \"out_00\"]"
+                ", [\"proc_00/C/out_01\", \"out_01\"]"
+                "]",
+                "%sp_connections.json",
+                prefix) ||
+            !add_proc(handle, au, 0, type, false, 2, 2))
+        return false;
+
+    if ((param_key != NULL) && !set_dataf(handle, param, "%sproc_00/%s", prefix, param_key))
+        return false;
+
+    return true;
+}
+
+
+static const char* additive_instrument_connections =
+    "[ [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+    ", [\"proc_01/C/out_00\", \"proc_02/C/in_01\"]"
+    ", [\"proc_02/C/out_00\", \"out_00\"]"
+    ", [\"proc_02/C/out_01\", \"out_01\"]"
+    "]";
+
+
+static bool build_add(kqt_Handle handle)
+{
+    return add_module_base(
+                handle,
+                "[ [\"au_00/out_00\", \"out_00\"], [\"au_00/out_01\", \"out_01\"] ]") &&
+        add_instrument(handle, additive_instrument_connections) &&
+        add_additive_proc(handle, 2);
+}
+
+
+static bool build_padsynth(kqt_Handle handle)
+{
+    return add_module_base(
+                handle,
+                "[ [\"au_00/out_00\", \"out_00\"], [\"au_00/out_01\", \"out_01\"] ]") &&
+        add_instrument(
+                handle,
+                "[ [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+                ", [\"proc_01/C/out_00\", \"proc_02/C/in_01\"]"
+                ", [\"proc_02/C/out_00\", \"out_00\"]"
+                ", [\"proc_02/C/out_01\", \"out_01\"]"
+                "]") &&
+        add_proc(handle, 0, 2, "padsynth", true, 2, 2) &&
+        set_data(handle, "au_00/proc_02/c/p_b_stereo.json", "true") &&
+        set_data(
+                handle,
+                "au_00/proc_02/c/p_ps_params.json",
+                "{ \"sample_length\": 65536"
+                ", \"harmonics\": [ [1, 1], [2, 0.5], [3, 0.3], [4, 0.2], [5, 0.1] ]"
+                "}");
+}
+
+
+static bool build_ks(kqt_Handle handle)
+{
+    return add_module_base(
+                handle,
+                "[ [\"au_00/out_00\", \"out_00\"], [\"au_00/out_00\", \"out_01\"] ]") &&
+        add_instrument(
+                handle,
+                "[ [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+                ", [\"proc_01/C/out_00\", \"proc_02/C/in_01\"]"
+                ", [\"proc_01/C/out_00\", \"proc_03/C/in_00\"]"
+                ", [\"proc_03/C/out_00\", \"proc_02/C/in_02\"]"
+                ", [\"proc_02/C/out_00\", \"out_00\"]"
+                "]") &&
+        add_proc(handle, 0, 2, "ks", true, 3, 1) &&
+        add_proc(handle, 0, 3, "noise", true, 1, 1);
+}
+
+
+static bool build_filter_chain(kqt_Handle handle)
+{
+    char conns[1024] = "";
+    int length = snprintf(
+            conns,
+            sizeof(conns),
+            "[ [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+            ", [\"proc_01/C/out_00\", \"proc_02/C/in_01\"]"
+            ", [\"proc_02/C/out_00\", \"proc_03/C/in_00\"]"
+            ", [\"proc_02/C/out_01\", \"proc_03/C/in_01\"]");
+
+    for (int i = 0; i < FILTER_CHAIN_LENGTH - 1; ++i)
+    {
+        const int proc = 3 + i;
+        length += snprintf(
+                conns + length,
+                sizeof(conns) - (size_t)length,
+                ", [\"proc_%02x/C/out_00\", \"proc_%02x/C/in_00\"]"
+                ", [\"proc_%02x/C/out_01\", \"proc_%02x/C/in_01\"]",
+                proc, proc + 1, proc, proc + 1);
+    }
+
+    const int last_proc = 2 + FILTER_CHAIN_LENGTH;
+    snprintf(
+            conns + length,
+            sizeof(conns) - (size_t)length,
+            ", [\"proc_%02x/C/out_00\", \"out_00\"]"
+            ", [\"proc_%02x/C/out_01\", \"out_01\"]"
+            "]",
+            last_proc, last_proc);
+
+    if (!add_module_base(
+                handle,
+                "[ [\"au_00/out_00\", \"out_00\"], [\"au_00/out_01\", \"out_01\"] ]") ||
+            !add_instrument(handle, conns) ||
+            !add_additive_proc(handle, 2))
+        return false;
+
+    for (int i = 0; i < FILTER_CHAIN_LENGTH; ++i)
+    {
+        const int proc = 3 + i;
+        if (!add_proc(handle, 0, proc, "filter", true, 2, 2) ||
+                !set_dataf(handle, (i % 2 == 0) ? "0" : "1",
+                    "au_00/proc_%02x/c/p_i_type.json", proc) ||
+                !set_dataf(handle, "80", "au_00/proc_%02x/c/p_f_cutoff.json", proc) ||
+                !set_dataf(handle, "50", "au_00/proc_%02x/c/p_f_resonance.json", proc))
+            return false;
+    }
+
+    return true;
+}
+
+
+static const char* single_effect_connections =
+    "[ [\"au_00/out_00\", \"au_01/in_00\"]"
+    ", [\"au_00/out_01\", \"au_01/in_01\"]"
+    ", [\"au_01/out_00\", \"out_00\"]"
+    ", [\"au_01/out_01\", \"out_01\"]"
+    "]";
+
+
+static bool build_freeverb(kqt_Handle handle)
+{
+    return add_module_base(handle, single_effect_connections) &&
+        add_instrument(handle, additive_instrument_connections) &&
+        add_additive_proc(handle, 2) &&
+        add_effect(handle, 1, "freeverb", NULL, NULL);
+}
+
+
+static bool build_compress(kqt_Handle handle)
+{
+    return add_module_base(handle, single_effect_connections) &&
+        add_instrument(handle, additive_instrument_connections) &&
+        add_additive_proc(handle, 2) &&
+        add_effect(handle, 1, "compress", "c/p_b_downward_enabled.json", "true");
+}
+
+
+static bool build_effect_chain(
+        kqt_Handle handle,
+        int depth,
+        const char* type,
+        const char* param_key,
+        const char* param)
+{
+    char conns[4096] = "";
+    int length = snprintf(
+            conns,
+            sizeof(conns),
+            "[ [\"au_00/out_00\", \"au_01/in_00\"]"
+            ", [\"au_00/out_01\", \"au_01/in_01\"]");
+
+    for (int au = 1; au < depth; ++au)
+        length += snprintf(
+                conns + length,
+                sizeof(conns) - (size_t)length,
+                ", [\"au_%02x/out_00\", \"au_%02x/in_00\"]"
+                ", [\"au_%02x/out_01\", \"au_%02x/in_01\"]",
+                au, au + 1, au, au + 1);
+
+    snprintf(
+            conns + length,
+            sizeof(conns) - (size_t)length,
+            ", [\"au_%02x/out_00\", \"out_00\"]"
+            ", [\"au_%02x/out_01\", \"out_01\"]"
+            "]",
+            depth, depth);
+
+    if (!add_module_base(handle, conns) ||
+            !add_instrument(handle, additive_instrument_connections) ||
+            !add_additive_proc(handle, 2))
+        return false;
+
+    for (int au = 1; au <= depth; ++au)
+    {
+        if (!add_effect(handle, au, type, param_key, param))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool build_freeverb_chain(kqt_Handle handle)
+{
+    return build_effect_chain(handle, FREEVERB_CHAIN_DEPTH, "freeverb", NULL, NULL);
+}
+
+
+static bool build_bus_chain(kqt_Handle handle)
+{
+    return build_effect_chain(
+            handle, BUS_CHAIN_DEPTH, "volume", "c/p_f_volume.json", "-0.1");
+}
+
+
+// The first scenario renders the bare instrument that is also used by the
+// effect scenarios
+static const Scenario scenarios[] =
+{
+    { "add",            build_add,              0,  NULL },
+    { "sample",         NULL,                   0,  "requires WavPack-encoded sample data" },
+    { "padsynth",       build_padsynth,         0,  NULL },
+    { "ks",             build_ks,               0,  NULL },
+    { "filter_chain",   build_filter_chain,     0,  NULL },
+    { "freeverb",       build_freeverb,         2,  NULL },
+    { "freeverb_chain", build_freeverb_chain,   FREEVERB_CHAIN_DEPTH * 2,   NULL },
+    { "compress",       build_compress,         2,  NULL },
+    { "bus_chain",      build_bus_chain,        BUS_CHAIN_DEPTH * 2,        NULL },
+};
+
+
+/*
+ * Get the rendering time of the effects from the render profile. Effect
+ * processors are located in the audio units that follow the instrument.
+ * Returns false if libkunquat has been built without render profiling.
+ */
+static bool get_profiled_effect_seconds(kqt_Handle handle, double* seconds)
+{
+    const char* profile = kqt_Handle_get_profile(handle);
+    if ((profile == NULL) || (strstr(profile, "\"enabled\": true") == NULL))
+        return false;
+
+    static const char field_prefix[] = "\"nanoseconds\": ";
+
+    int64_t nanoseconds = 0;
+
+    const char* devices_end = strstr(profile, "\"stages\"");
+    const char* key = strstr(profile, "\"au_");
+    while ((key != NULL) && (devices_end != NULL) && (key < devices_end))
+    {
+        // Each device has a list of counters, one for each thread
+        const char* counters_end = strchr(key, ']');
+        if (counters_end == NULL)
+            break;
+
+        unsigned au = 0;
+        unsigned proc = 0;
+        if ((sscanf(key, "\"au_%x/proc_%x\"", &au, &proc) == 2) && (au > 0))
+        {
+            const char* field = strstr(key, field_prefix);
+            while ((field != NULL) && (field < counters_end))
+            {
+                nanoseconds += strtoll(field + strlen(field_prefix), NULL, 10);
+                field = strstr(field + 1, field_prefix);
+            }
+        }
+
+        key = strstr(counters_end, "\"au_");
+    }
+
+    *seconds = (double)nanoseconds / 1000000000.0;
+
+    return true;
+}
+
+
+static bool run_scenario(
+        const Scenario* scenario,
+        const Bench_config* config,
+        int voices,
+        int thread_count,
+        double* seconds,
+        bool* has_effect_seconds,
+        double* effect_seconds)
+{
+    kqt_Handle handle = kqt_new_Handle();
+    if (handle == 0)
+    {
+        fprintf(stderr, "Could not create a Kunquat Handle: %s\n", kqt_Handle_get_error(0));
+        return false;
+    }
+
+    bool success = scenario->build(handle);
+    if (success && !kqt_Handle_validate(handle))
+    {
+        fprintf(stderr, "Module of scenario %s is invalid: %s\n",
+                scenario->name, kqt_Handle_get_error(handle));
+        success = false;
+    }
+
+    if (success && (
+                !kqt_Handle_set_audio_rate(handle, AUDIO_RATE) ||
+                !kqt_Handle_set_audio_buffer_size(handle, BUFFER_SIZE) ||
+                !kqt_Handle_set_thread_count(handle, thread_count)))
+    {
+        fprintf(stderr, "Could not configure the Handle: %s\n",
+                kqt_Handle_get_error(handle));
+        success = false;
+    }
+
+    if (success)
+    {
+        // Keep playing after the (empty) composition has ended
+        kqt_Handle_fire_event(handle, 0, "[\"cpause\", null]");
+
+        // Spread the notes over channels so that each voice stays in the foreground
+        for (int i = 0; i < voices; ++i)
+        {
+            char event[32] = "";
+            snprintf(event, sizeof(event), "[\"n+\", %d]", -2400 + (i % 36) * 100);
+            kqt_Handle_fire_event(handle, i % KQT_CHANNELS_MAX, event);
+        }
+
+        for (long rendered = 0; rendered < WARMUP_FRAMES; rendered += BUFFER_SIZE)
+            kqt_Handle_play(handle, BUFFER_SIZE);
+
+        kqt_Handle_reset_profile(handle);
+
+        const int64_t start = get_time_ns();
+
+        for (long rendered = 0; rendered < config->frames; rendered += BUFFER_SIZE)
+        {
+            if (!kqt_Handle_play(handle, BUFFER_SIZE))
+            {
+                fprintf(stderr, "Rendering failed: %s\n", kqt_Handle_get_error(handle));
+                success = false;
+                break;
+            }
+        }
+
+        *seconds = (double)(get_time_ns() - start) / 1000000000.0;
+
+        if (has_effect_seconds != NULL)
+            *has_effect_seconds = get_profiled_effect_seconds(handle, effect_seconds);
+    }
+
+    kqt_del_Handle(handle);
+
+    return success;
+}
+
+
+static bool run_benchmarks(const Bench_config* config)
+{
+    printf("{\"audio_rate\": %d, \"buffer_size\": %d, \"frames\": %ld, \"voices\": %d,\n",
+            AUDIO_RATE, BUFFER_SIZE, config->frames, config->voices);
+    printf("\"scenarios\": [");
+
+    const double audio_seconds = (double)config->frames / AUDIO_RATE;
+    const double voice_frames = (double)config->frames * config->voices;
+
+    // Rendering times of the plain additive instrument with EFFECT_VOICES
+    // voices, measured when first needed
+    double base_seconds[KQT_THREADS_MAX] = { 0 };
+    bool has_base_seconds[KQT_THREADS_MAX] = { false };
+
+    bool is_first = true;
+    for (size_t i = 0; i < sizeof(scenarios) / sizeof(scenarios[0]); ++i)
+    {
+        const Scenario* scenario = &scenarios[i];
+        if ((config->scenario != NULL) && (strcmp(config->scenario, scenario->name) != 0))
+            continue;
+
+        printf("%s\n  {\"name\": \"%s\"", is_first ? "" : ",", scenario->name);
+        is_first = false;
+
+        if (scenario->build == NULL)
+        {
+            printf(", \"skipped\": \"%s\"}", scenario->skip_reason);
+            continue;
+        }
+
+        printf(", \"results\": [");
+
+        double single_thread_seconds = 0;
+        for (int thread_count = 1; thread_count <= config->threads_max; ++thread_count)
+        {
+            double seconds = 0;
+            bool has_effect_seconds = false;
+            double effect_seconds = 0;
+            if (!run_scenario(
+                        scenario,
+                        config,
+                        config->voices,
+                        thread_count,
+                        &seconds,
+                        &has_effect_seconds,
+                        &effect_seconds))
+                return false;
+
+            if (thread_count == 1)
+                single_thread_seconds = seconds;
+
+            printf("%s\n    {\"threads\": %d, \"seconds\": %.6f"
+                    ", \"realtime_factor\": %.6f, \"ns_per_voice_frame\": %.3f",
+                    (thread_count > 1) ? "," : "",
+                    thread_count,
+                    seconds,
+                    seconds / audio_seconds,
+                    seconds * 1000000000.0 / voice_frames);
+
+            if (scenario->effect_channels > 0)
+            {
+                const char* source = "profile";
+
+                // Without a render profile, the instrument would hide the cost
+                // of the effects in timing noise, so compare light loads instead
+                if (!has_effect_seconds)
+                {
+                    source = "difference";
+
+                    const int ti = thread_count - 1;
+                    if (!has_base_seconds[ti])
+                    {
+                        if (!run_scenario(
+                                    &scenarios[0],
+                                    config,
+                                    EFFECT_VOICES,
+                                    thread_count,
+                                    &base_seconds[ti],
+                                    NULL,
+                                    NULL))
+                            return false;
+                        has_base_seconds[ti] = true;
+                    }
+
+                    double light_seconds = 0;
+                    if (!run_scenario(
+                                scenario,
+                                config,
+                                EFFECT_VOICES,
+                                thread_count,
+                                &light_seconds,
+                                NULL,
+                                NULL))
+                        return false;
+
+                    effect_seconds = light_seconds - base_seconds[ti];
+                }
+
+                printf(", \"effect_cost_source\": \"%s\"", source);
+
+                const double effect_channel_frames =
+                    (double)config->frames * scenario->effect_channels;
+                if (effect_seconds > 0)
+                    printf(", \"ns_per_effect_channel_frame\": %.3f",
+                            effect_seconds * 1000000000.0 / effect_channel_frames);
+                else
+                    printf(", \"ns_per_effect_channel_frame\": null"
+                            ", \"effect_cost_note\": \"below measurement noise\"");
+            }
+
+            printf(", \"speedup\": %.3f}",
+                    (seconds > 0) ? single_thread_seconds / seconds : 0.0);
+            fflush(stdout);
+        }
+
+        printf("]}");
+    }
+
+    printf("]}\n");
+
+    return true;
+}
+
+
+static void print_usage(const char* program)
+{
+    fprintf(stderr,
+            "Usage: %s [--frames N] [--voices N] [--threads N] [--scenario NAME]\n"
+            "\n"
+            "  --frames N        number of frames rendered per run (default: %d)\n"
+            "  --voices N        number of simultaneous voices, at most %d (default: %d)\n"
+            "  --threads N       measure thread counts 1..N (default: %d)\n"
+            "  --scenario NAME   only run the named scenario\n",
+            program,
+            DEFAULT_FRAMES,
+            KQT_CHANNELS_MAX,
+            DEFAULT_VOICES,
+            DEFAULT_THREADS_MAX);
+
+    return;
+}
+
+
+int main(int argc, char** argv)
+{
+    Bench_config* config = &(Bench_config)
+    {
+        .frames = DEFAULT_FRAMES,
+        .voices = DEFAULT_VOICES,
+        .threads_max = DEFAULT_THREADS_MAX,
+        .scenario = NULL,
+    };
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        if (value == NULL)
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        if (strcmp(arg, "--frames") == 0)
+            config->frames = strtol(value, NULL, 10);
+        else if (strcmp(arg, "--voices") == 0)
+            config->voices = (int)strtol(value, NULL, 10);
+        else if (strcmp(arg, "--threads") == 0)
+            config->threads_max = (int)strtol(value, NULL, 10);
+        else if (strcmp(arg, "--scenario") == 0)
+            config->scenario = value;
+        else
+        {
+            print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+
+        ++i;
+    }
+
+    if ((config->frames <= 0) ||
+            (config->voices < 1) || (config->voices > KQT_CHANNELS_MAX) ||
+            (config->threads_max < 1) || (config->threads_max > KQT_THREADS_MAX))
+    {
+        print_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!run_benchmarks(config))
+        return EXIT_FAILURE;
+
+    return EXIT_SUCCESS;
+}
+
+
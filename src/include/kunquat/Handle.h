@@ -78,6 +78,7 @@ kqt_Handle kqt_new_Handle(void);
  * \li kqt_Handle_get_error
  * \li kqt_Handle_clear_error
  * \li kqt_Handle_validate
+ * \li kqt_Handle_validate_full
  * \li kqt_del_Handle
  *
  * \param handle   The Kunquat Handle -- should be valid.
@@ -143,6 +144,9 @@ void kqt_Handle_clear_error(kqt_Handle handle);
  * This function needs to be called after one or more successful calls of
  * kqt_Handle_set_data before the Handle can be fully utilised again.
  *
+ * Only the parts of the composition affected by the data set since the
+ * previous validation are checked.
+ *
  * \param handle   The Handle -- should be valid.
  *
  * \return   \c 1 if successful, \c 0 if failed. If the validation fails,
@@ -152,6 +156,21 @@ void kqt_Handle_clear_error(kqt_Handle handle);
 int kqt_Handle_validate(kqt_Handle handle);
 
 
+/**
+ * Validate the whole composition in the Kunquat Handle.
+ *
+ * This function is equivalent to kqt_Handle_validate except that all data
+ * is checked regardless of what has changed.
+ *
+ * \param handle   The Handle -- should be valid.
+ *
+ * \return   \c 1 if successful, \c 0 if failed. If the validation fails,
+ *           the Handle can no longer be used and should be deallocated by
+ *           calling kqt_del_Handle(\a handle).
+ */
+int kqt_Handle_validate_full(kqt_Handle handle);
+
+
 /**
  * Free all the resources allocated for an existing Kunquat Handle.
  *
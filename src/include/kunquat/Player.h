@@ -297,6 +297,84 @@ int kqt_Handle_fire_event(kqt_Handle handle, int channel, const char* event);
 const char* kqt_Handle_receive_events(kqt_Handle handle);
 
 
+/**
+ * Return the render profile in JSON format.
+ *
+ * The render profile is only collected if libkunquat has been built with
+ * render profiling enabled; otherwise, the \c enabled field of the returned
+ * object is \c false and all counters are zero.
+ *
+ * The returned object contains the following fields:
+ *
+ * \li \c enabled: \c true if profiling data is collected.
+ * \li \c thread_count: The number of rendering threads in use.
+ * \li \c devices: An object that maps the key of each rendered device (e.g.
+ *     \c "au_00/proc_01") to a list of counters, one for each thread.
+ * \li \c stages: An object that maps the names of master output stages
+ *     (\c master_volume, \c test_outputs and \c dc_blocker) to counters.
+ *
+ * Each counter is an object with the fields \c nanoseconds (cumulative
+ * rendering time), \c calls (number of render calls) and \c voice_frames
+ * (number of active voice frames rendered).
+ *
+ * \param handle   The Handle -- should be valid.
+ *
+ * \return   The render profile, or \c NULL if an error occurred. The returned
+ *           string is valid until the next call of this function or
+ *           kqt_Handle_get_render_trace.
+ */
+const char* kqt_Handle_get_profile(kqt_Handle handle);
+
+
+/**
+ * Reset the render profile counters.
+ *
+ * \param handle   The Handle -- should be valid.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_reset_profile(kqt_Handle handle);
+
+
+/**
+ * Enable or disable render timeline tracing.
+ *
+ * When tracing is enabled, each rendering thread records the start and end
+ * times of its barrier waits, Voice groups and mixed signal tasks in a
+ * fixed-size ring buffer. If the buffer fills up before the events are
+ * retrieved, the oldest events are overwritten. Disabling tracing discards
+ * all recorded events.
+ *
+ * Tracing is disabled by default.
+ *
+ * \param handle    The Handle -- should be valid.
+ * \param enabled   \c 1 to enable tracing, \c 0 to disable it.
+ *
+ * \return   \c 1 if successful, otherwise \c 0.
+ */
+int kqt_Handle_set_render_trace_enabled(kqt_Handle handle, int enabled);
+
+
+/**
+ * Return the recorded render timeline in Chrome trace event JSON format.
+ *
+ * The returned object can be loaded in chrome://tracing or Perfetto. Thread
+ * \c 0 is the thread that calls kqt_Handle_play, and threads \c 1 onwards
+ * are the rendering threads. In single-threaded mode, rendering thread \c 1
+ * also runs in the calling thread. The number of events lost due to buffer
+ * overflow is stored in the field \c otherData.dropped_events.
+ *
+ * The returned events are removed from the trace buffers.
+ *
+ * \param handle   The Handle -- should be valid.
+ *
+ * \return   The render timeline, or \c NULL if an error occurred. The
+ *           returned string is valid until the next call of this function
+ *           or kqt_Handle_get_profile.
+ */
+const char* kqt_Handle_get_render_trace(kqt_Handle handle);
+
+
 /* \} */
 
 
@@ -56,6 +56,36 @@ long kqt_get_memory_alloc_count(void);
 void kqt_suppress_assert_messages(void);
 
 
+/**
+ * Set whether a real-time safety violation aborts the program.
+ *
+ * Real-time safety checks are only performed if libkunquat is built with
+ * ENABLE_RT_CHECKS. In that case, any memory allocation, mutex lock,
+ * condition wait or blocking I/O performed by a render thread during
+ * \a kqt_Handle_play is reported to standard error output along with a
+ * backtrace. By default, the program is then aborted.
+ *
+ * \param enabled   \c 0 if violations should only be reported and counted,
+ *                  or non-zero if violations should abort the program.
+ */
+void kqt_set_rt_check_abort(int enabled);
+
+
+/**
+ * Get the number of real-time safety violations detected.
+ *
+ * \return   The number of violations since the last reset, or \c 0 if
+ *           libkunquat is built without ENABLE_RT_CHECKS.
+ */
+long kqt_get_rt_check_violation_count(void);
+
+
+/**
+ * Reset the real-time safety violation counter.
+ */
+void kqt_reset_rt_check_violation_count(void);
+
+
 /* \} */
 
 
@@ -19,6 +19,7 @@
 #include <init/devices/Audio_unit.h>
 #include <init/Module.h>
 #include <init/Parse_manager.h>
+#include <init/Validation_scope.h>
 #include <kunquat/limits.h>
 #include <memory.h>
 #include <string/common.h>
@@ -170,6 +171,7 @@ bool Handle_init(Handle* handle)
     handle->data_is_valid = true;
     handle->data_is_validated = true;
     handle->update_connections = false;
+    Validation_scope_init(&handle->validation_scope);
     handle->module = NULL;
     handle->error = *ERROR_AUTO;
     handle->validation_error = *ERROR_AUTO;
@@ -289,8 +291,14 @@ int kqt_Handle_validate(kqt_Handle handle)
         return 0;
     }
 
+    // Find out which checks are affected by the changes since last validation
+    const Validation_scope* scope = &h->validation_scope;
+    const bool check_all_sheet = scope->is_full || scope->album;
+    const bool check_all_songs = check_all_sheet || scope->any_pat;
+    const bool check_track_list = check_all_sheet || scope->any_song;
+
     // Check album
-    if (h->module->album_is_existent)
+    if (check_all_sheet && h->module->album_is_existent)
     {
         const Track_list* tl = h->module->track_list;
         set_invalid_if(
@@ -304,6 +312,9 @@ int kqt_Handle_validate(kqt_Handle handle)
     // Check songs
     for (int i = 0; i < KQT_SONGS_MAX; ++i)
     {
+        if (!check_all_songs && !Validation_scope_has_song(scope, i))
+            continue;
+
         if (!Song_table_get_existent(h->module->songs, i))
             continue;
 
@@ -346,7 +357,7 @@ int kqt_Handle_validate(kqt_Handle handle)
     }
 
     // Check for nonexistent songs in the track list
-    if (h->module->album_is_existent)
+    if (check_track_list && h->module->album_is_existent)
     {
         const Track_list* tl = h->module->track_list;
         rassert(tl != NULL);
@@ -363,6 +374,9 @@ int kqt_Handle_validate(kqt_Handle handle)
     // Check existing patterns
     for (int i = 0; i < KQT_PATTERNS_MAX; ++i)
     {
+        if (!check_all_sheet && !Validation_scope_has_pattern(scope, i))
+            continue;
+
         if (!Pat_table_get_existent(h->module->pats, i))
             continue;
 
@@ -390,6 +404,9 @@ int kqt_Handle_validate(kqt_Handle handle)
                 const Track_list* tl = h->module->track_list;
                 rassert(tl != NULL);
 
+                const Pat_inst_ref* piref = &(Pat_inst_ref){
+                    .pat = (int16_t)i, .inst = (int16_t)k };
+
                 for (int track = 0; track < Track_list_get_len(tl); ++track)
                 {
                     const int song_index = Track_list_get_song_index(tl, track);
@@ -400,18 +417,14 @@ int kqt_Handle_validate(kqt_Handle handle)
                     const Order_list* ol = h->module->order_lists[song_index];
                     rassert(ol != NULL);
 
-                    for (int system = 0; system < Order_list_get_len(ol); ++system)
+                    // Order lists reject duplicates of their own
+                    if (Order_list_contains_pat_inst_ref(ol, piref))
                     {
-                        const Pat_inst_ref* piref =
-                            Order_list_get_pat_inst_ref(ol, system);
-                        if (piref->pat == i && piref->inst == k)
-                        {
-                            set_invalid_if(
-                                    instance_found,
-                                    "Duplicate occurrence of pattern instance"
-                                    " [%d, %d]", i, k);
-                            instance_found = true;
-                        }
+                        set_invalid_if(
+                                instance_found,
+                                "Duplicate occurrence of pattern instance"
+                                " [%d, %d]", i, k);
+                        instance_found = true;
                     }
                 }
 
@@ -428,7 +441,7 @@ int kqt_Handle_validate(kqt_Handle handle)
     }
 
     // Check controls
-    if (h->module->au_map != NULL)
+    if ((scope->is_full || scope->controls) && (h->module->au_map != NULL))
     {
         set_invalid_if(
                 !Input_map_is_valid(h->module->au_map, h->module->au_controls),
@@ -443,6 +456,9 @@ int kqt_Handle_validate(kqt_Handle handle)
         Au_table* au_table = Module_get_au_table(h->module);
         for (int au_index = 0; au_index < KQT_AUDIO_UNITS_MAX; ++au_index)
         {
+            if (!Validation_scope_has_au(scope, au_index))
+                continue;
+
             const Audio_unit* au = Au_table_get(au_table, au_index);
             if ((au != NULL) && Device_is_existent((const Device*)au))
             {
@@ -475,8 +491,9 @@ int kqt_Handle_validate(kqt_Handle handle)
             }
         }
 
-        // Top-level connections
-        if (h->module->connections != NULL)
+        // Top-level connections, which also depend on the ports of audio units
+        if ((scope->is_full || scope->connections || scope->any_au) &&
+                (h->module->connections != NULL))
         {
             set_invalid_if(
                     !Connections_check_connections(
@@ -491,6 +508,9 @@ int kqt_Handle_validate(kqt_Handle handle)
         Au_table* au_table = Module_get_au_table(h->module);
         for (int au_index = 0; au_index < KQT_AUDIO_UNITS_MAX; ++au_index)
         {
+            if (!Validation_scope_has_au(scope, au_index))
+                continue;
+
             const Audio_unit* au = Au_table_get(au_table, au_index);
             if ((au != NULL) && Device_is_existent((const Device*)au))
             {
@@ -529,6 +549,9 @@ int kqt_Handle_validate(kqt_Handle handle)
         Au_table* au_table = Module_get_au_table(h->module);
         for (int au_index = 0; au_index < KQT_AUDIO_UNITS_MAX; ++au_index)
         {
+            if (!Validation_scope_has_au(scope, au_index))
+                continue;
+
             const Audio_unit* au = Au_table_get(au_table, au_index);
             if ((au != NULL) && Device_is_existent((const Device*)au))
             {
@@ -544,6 +567,7 @@ int kqt_Handle_validate(kqt_Handle handle)
 
     // Data is OK
     h->data_is_validated = true;
+    Validation_scope_init(&h->validation_scope);
 
     // Update connections if needed
     if (h->update_connections)
@@ -560,6 +584,19 @@ int kqt_Handle_validate(kqt_Handle handle)
 #undef set_invalid_if
 
 
+int kqt_Handle_validate_full(kqt_Handle handle)
+{
+    check_handle(handle, 0);
+    Handle* h = get_handle(handle);
+
+    check_data_is_valid(h, 0);
+
+    Validation_scope_set_full(&h->validation_scope);
+
+    return kqt_Handle_validate(handle);
+}
+
+
 void Handle_set_error_(
         Handle* handle,
         Error_type type,
@@ -384,3 +384,73 @@ const char* kqt_Handle_receive_events(kqt_Handle handle)
 }
 
 
+const char* kqt_Handle_get_profile(kqt_Handle handle)
+{
+    check_handle(handle, NULL);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, NULL);
+    check_data_is_validated(h, NULL);
+
+    const char* profile = Player_get_profile(h->player);
+    if (profile == NULL)
+    {
+        Handle_set_error(h, ERROR_MEMORY, "Couldn't allocate memory for render profile");
+        return NULL;
+    }
+
+    return profile;
+}
+
+
+int kqt_Handle_reset_profile(kqt_Handle handle)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    Player_reset_profile(h->player);
+
+    return 1;
+}
+
+
+int kqt_Handle_set_render_trace_enabled(kqt_Handle handle, int enabled)
+{
+    check_handle(handle, 0);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, 0);
+    check_data_is_validated(h, 0);
+
+    if (!Player_set_render_trace_enabled(h->player, enabled != 0))
+    {
+        Handle_set_error(h, ERROR_MEMORY, "Couldn't allocate memory for render trace");
+        return 0;
+    }
+
+    return 1;
+}
+
+
+const char* kqt_Handle_get_render_trace(kqt_Handle handle)
+{
+    check_handle(handle, NULL);
+
+    Handle* h = get_handle(handle);
+    check_data_is_valid(h, NULL);
+    check_data_is_validated(h, NULL);
+
+    const char* trace = Player_get_render_trace(h->player);
+    if (trace == NULL)
+    {
+        Handle_set_error(h, ERROR_MEMORY, "Couldn't allocate memory for render trace");
+        return NULL;
+    }
+
+    return trace;
+}
+
+
@@ -20,6 +20,7 @@
 
 #include <Error.h>
 #include <init/Module.h>
+#include <init/Validation_scope.h>
 #include <kunquat/Player.h>
 #include <player/Player.h>
 
@@ -43,6 +44,7 @@ typedef struct Handle
     bool data_is_valid;
     bool data_is_validated;
     bool update_connections;
+    Validation_scope validation_scope;
     Module* module;
     Error error;
     Error validation_error;
@@ -0,0 +1,123 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <containers/Name_table.h>
+
+#include <containers/AAtree.h>
+#include <debug/assert.h>
+#include <kunquat/limits.h>
+#include <memory.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+typedef struct Entry
+{
+    char name[KQT_VAR_NAME_MAX];
+    int32_t id;
+} Entry;
+
+
+struct Name_table
+{
+    AAtree* tree;
+    int32_t count;
+};
+
+
+Name_table* new_Name_table(void)
+{
+    Name_table* table = memory_alloc_item(Name_table);
+    if (table == NULL)
+        return NULL;
+
+    table->count = 0;
+    table->tree = new_AAtree(
+            (AAtree_item_cmp*)strcmp, (AAtree_item_destroy*)memory_free);
+    if (table->tree == NULL)
+    {
+        del_Name_table(table);
+        return NULL;
+    }
+
+    return table;
+}
+
+
+int32_t Name_table_add(Name_table* table, const char* name)
+{
+    rassert(table != NULL);
+    rassert(name != NULL);
+    rassert(strlen(name) < KQT_VAR_NAME_MAX);
+
+    const Entry* existing = AAtree_get_exact(table->tree, name);
+    if (existing != NULL)
+        return existing->id;
+
+    Entry* entry = memory_alloc_item(Entry);
+    if (entry == NULL)
+        return -1;
+
+    strcpy(entry->name, name);
+    entry->id = table->count;
+
+    if (!AAtree_ins(table->tree, entry))
+    {
+        memory_free(entry);
+        return -1;
+    }
+
+    ++table->count;
+
+    return entry->id;
+}
+
+
+int32_t Name_table_get_id(const Name_table* table, const char* name)
+{
+    rassert(table != NULL);
+    rassert(name != NULL);
+
+    if (strlen(name) >= KQT_VAR_NAME_MAX)
+        return -1;
+
+    const Entry* entry = AAtree_get_exact(table->tree, name);
+    if (entry == NULL)
+        return -1;
+
+    return entry->id;
+}
+
+
+int32_t Name_table_get_count(const Name_table* table)
+{
+    rassert(table != NULL);
+    return table->count;
+}
+
+
+void del_Name_table(Name_table* table)
+{
+    if (table == NULL)
+        return;
+
+    del_AAtree(table->tree);
+    memory_free(table);
+
+    return;
+}
+
+
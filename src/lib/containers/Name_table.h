@@ -0,0 +1,88 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_NAME_TABLE_H
+#define KQT_NAME_TABLE_H
+
+
+#include <decl.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * A symbol table that assigns dense integer identifiers to names.
+ *
+ * Identifiers are assigned in the order of addition starting from \c 0, and
+ * they remain valid for the lifetime of the table.
+ */
+
+
+/**
+ * Create a new Name table.
+ *
+ * \return   The new Name table if successful, or \c NULL if memory
+ *           allocation failed.
+ */
+Name_table* new_Name_table(void);
+
+
+/**
+ * Add a name to the Name table.
+ *
+ * \param table   The Name table -- must not be \c NULL.
+ * \param name    The name -- must not be \c NULL and must be shorter than
+ *                \c KQT_VAR_NAME_MAX characters.
+ *
+ * \return   The identifier of \a name, or \c -1 if memory allocation failed.
+ *           If \a name is already in the table, its existing identifier is
+ *           returned.
+ */
+int32_t Name_table_add(Name_table* table, const char* name);
+
+
+/**
+ * Get the identifier of a name in the Name table.
+ *
+ * \param table   The Name table -- must not be \c NULL.
+ * \param name    The name -- must not be \c NULL.
+ *
+ * \return   The identifier of \a name, or \c -1 if \a name is not in the table.
+ */
+int32_t Name_table_get_id(const Name_table* table, const char* name);
+
+
+/**
+ * Get the number of names in the Name table.
+ *
+ * \param table   The Name table -- must not be \c NULL.
+ *
+ * \return   The number of names, which is also the upper bound of identifiers.
+ */
+int32_t Name_table_get_count(const Name_table* table);
+
+
+/**
+ * Destroy an existing Name table.
+ *
+ * \param table   The Name table, or \c NULL.
+ */
+void del_Name_table(Name_table* table);
+
+
+#endif // KQT_NAME_TABLE_H
+
+
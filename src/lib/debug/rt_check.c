@@ -0,0 +1,204 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <debug/rt_check.h>
+
+#include <debug/assert.h>
+
+#ifdef WITH_PTHREAD
+#include <pthread.h>
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+
+static bool abort_on_violation = true;
+static int64_t violation_count = 0;
+
+
+#ifdef ENABLE_RT_CHECKS
+
+// NOTE: The checks below must not use our own Mutex or memory functions
+//       as those are the operations being checked
+
+#ifdef WITH_PTHREAD
+
+static pthread_once_t render_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t render_key;
+static pthread_mutex_t violation_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// The value stored in render_key while the thread is rendering
+static char render_marker = 1;
+
+
+static void make_render_key(void)
+{
+    const int status = pthread_key_create(&render_key, NULL);
+    rassert(status == 0);
+    return;
+}
+
+
+static void set_rendering(bool rendering)
+{
+    pthread_once(&render_key_once, make_render_key);
+    const int status =
+        pthread_setspecific(render_key, rendering ? &render_marker : NULL);
+    rassert(status == 0);
+    return;
+}
+
+
+static bool is_rendering(void)
+{
+    pthread_once(&render_key_once, make_render_key);
+    return (pthread_getspecific(render_key) != NULL);
+}
+
+
+static void lock_violations(void)
+{
+    pthread_mutex_lock(&violation_lock);
+    return;
+}
+
+
+static void unlock_violations(void)
+{
+    pthread_mutex_unlock(&violation_lock);
+    return;
+}
+
+#else // !WITH_PTHREAD
+
+static bool rendering_flag = false;
+
+
+static void set_rendering(bool rendering)
+{
+    rendering_flag = rendering;
+    return;
+}
+
+
+static bool is_rendering(void)
+{
+    return rendering_flag;
+}
+
+
+static void lock_violations(void)
+{
+    return;
+}
+
+
+static void unlock_violations(void)
+{
+    return;
+}
+
+#endif // !WITH_PTHREAD
+
+
+void rt_check_enter_render(void)
+{
+    rassert(!is_rendering());
+    set_rendering(true);
+    return;
+}
+
+
+void rt_check_leave_render(void)
+{
+    rassert(is_rendering());
+    set_rendering(false);
+    return;
+}
+
+
+void rt_check_report(
+        const char* operation,
+        const char* file_name,
+        int line_number,
+        const char* func_name)
+{
+    rassert(operation != NULL);
+    rassert(file_name != NULL);
+    rassert(func_name != NULL);
+
+    if (!is_rendering())
+        return;
+
+    // Don't report violations caused by the report itself
+    set_rendering(false);
+
+    lock_violations();
+
+    ++violation_count;
+
+    fprintf(stderr,
+            "libkunquat: %s:%d: %s: Real-time safety violation: %s"
+            " inside a render section.\n",
+            file_name, line_number, func_name, operation);
+    assert_print_backtrace();
+
+    const bool do_abort = abort_on_violation;
+
+    unlock_violations();
+
+    if (do_abort)
+        abort();
+
+    set_rendering(true);
+
+    return;
+}
+
+#endif // ENABLE_RT_CHECKS
+
+
+bool rt_check_is_enabled(void)
+{
+#ifdef ENABLE_RT_CHECKS
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+void rt_check_set_abort(bool enabled)
+{
+    abort_on_violation = enabled;
+    return;
+}
+
+
+int64_t rt_check_get_violation_count(void)
+{
+    return violation_count;
+}
+
+
+void rt_check_reset_violation_count(void)
+{
+    violation_count = 0;
+    return;
+}
+
+
@@ -0,0 +1,110 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_RT_CHECK_H
+#define KQT_RT_CHECK_H
+
+
+#include <common.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Real-time safety checks.
+ *
+ * When libkunquat is built with ENABLE_RT_CHECKS, each thread that renders
+ * audio marks the section in which it must not block. Operations that may
+ * block (memory management, mutex locks, condition waits and blocking I/O)
+ * call \a rt_check, which reports the operation with a backtrace if the
+ * calling thread is inside a render section. Without ENABLE_RT_CHECKS, the
+ * hooks expand to nothing.
+ */
+#ifdef ENABLE_RT_CHECKS
+
+/**
+ * Mark the beginning of a render section in the calling thread.
+ */
+void rt_check_enter_render(void);
+
+
+/**
+ * Mark the end of a render section in the calling thread.
+ */
+void rt_check_leave_render(void);
+
+
+/**
+ * Report a real-time safety violation if the calling thread is rendering.
+ *
+ * \param operation   The description of the operation -- must not be \c NULL.
+ * \param file_name   The source code file name -- must not be \c NULL.
+ * \param line_number   The source code file line number.
+ * \param func_name   The name of the function -- must not be \c NULL.
+ */
+void rt_check_report(
+        const char* operation,
+        const char* file_name,
+        int line_number,
+        const char* func_name);
+
+#define rt_check(operation) rt_check_report(operation, __FILE__, __LINE__, __func__)
+
+#else // !ENABLE_RT_CHECKS
+
+#define rt_check_enter_render() ignore(0)
+#define rt_check_leave_render() ignore(0)
+#define rt_check(operation) ignore(0)
+
+#endif // !ENABLE_RT_CHECKS
+
+
+/**
+ * Find out whether real-time safety checks are compiled in.
+ *
+ * \return   \c true if violations are detected, otherwise \c false.
+ */
+bool rt_check_is_enabled(void);
+
+
+/**
+ * Set whether a real-time safety violation aborts the program.
+ *
+ * Violations abort by default. If aborting is disabled, violations are
+ * reported and counted.
+ *
+ * \param enabled   \c true if violations should abort, otherwise \c false.
+ */
+void rt_check_set_abort(bool enabled);
+
+
+/**
+ * Get the number of real-time safety violations detected.
+ *
+ * \return   The number of violations.
+ */
+int64_t rt_check_get_violation_count(void);
+
+
+/**
+ * Reset the real-time safety violation counter.
+ */
+void rt_check_reset_violation_count(void);
+
+
+#endif // KQT_RT_CHECK_H
+
+
@@ -15,6 +15,7 @@
 #include <kunquat/testing.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 #include <mathnum/common.h>
 #include <memory.h>
 
@@ -41,3 +42,23 @@ void kqt_suppress_assert_messages(void)
 }
 
 
+void kqt_set_rt_check_abort(int enabled)
+{
+    rt_check_set_abort(enabled != 0);
+    return;
+}
+
+
+long kqt_get_rt_check_violation_count(void)
+{
+    return (long)rt_check_get_violation_count();
+}
+
+
+void kqt_reset_rt_check_violation_count(void)
+{
+    rt_check_reset_violation_count();
+    return;
+}
+
+
@@ -38,9 +38,11 @@ typedef struct Linear_controls Linear_controls;
 typedef struct Master_params Master_params;
 typedef struct Mixed_signal_plan Mixed_signal_plan;
 typedef struct Module Module;
+typedef struct Name_table Name_table;
 typedef struct Param_proc_filter Param_proc_filter;
 typedef struct Proc_state Proc_state;
 typedef struct Processor Processor;
+typedef struct Render_trace Render_trace;
 typedef struct Sample Sample;
 typedef struct Sample_params Sample_params;
 typedef struct Song Song;
@@ -254,6 +254,23 @@ const Connection* Device_node_get_received(const Device_node* node, int port)
 }
 
 
+bool Device_node_is_receive_exclusive(const Device_node* node, int port)
+{
+    rassert(node != NULL);
+    rassert(port >= 0);
+    rassert(port < KQT_DEVICE_PORTS_MAX);
+
+    const Connection* edge = node->receive[port];
+    if ((edge == NULL) || (edge->next != NULL))
+        return false;
+
+    const Connection* send_edge = edge->node->send[edge->port];
+    rassert(send_edge != NULL);
+
+    return (send_edge->next == NULL);
+}
+
+
 Device_node_type Device_node_get_type(const Device_node* node)
 {
     rassert(node != NULL);
@@ -136,6 +136,22 @@ int Device_node_get_last_receive_port(const Device_node* node);
 const Connection* Device_node_get_received(const Device_node* node, int port);
 
 
+/**
+ * Tell whether a receive port of a Device node has an exclusive connection.
+ *
+ * A connection is exclusive if it is the only connection to the receive port
+ * and the only connection from the send port of the sender. The signal of an
+ * exclusive connection is not needed anywhere else, so it can be handed over
+ * to the receiver without mixing.
+ *
+ * \param node   The Device node -- must not be \c NULL.
+ * \param port   The port number -- must be >= \c 0 and < \c KQT_DEVICE_PORTS_MAX.
+ *
+ * \return   \c true if the connection to \a port is exclusive, otherwise \c false.
+ */
+bool Device_node_is_receive_exclusive(const Device_node* node, int port);
+
+
 /**
  * Get the type of the Device node.
  *
@@ -29,6 +29,7 @@
 #include <init/Environment.h>
 #include <init/manifest.h>
 #include <init/sheet/Channel_defaults_list.h>
+#include <init/Validation_scope.h>
 #include <memory.h>
 #include <string/common.h>
 #include <string/key_pattern.h>
@@ -252,10 +253,24 @@ bool parse_data(Handle* handle, const char* key, const void* data, long length)
             params.subkey = key + strlen(keyp_to_func[i].keyp);
             params.sr = Streader_init(STREADER_AUTO, data, length);
 
+            // Record the parts of the module affected by both the old and
+            // the new data so that kqt_Handle_validate can skip the rest
+            Validation_scope_add_key(
+                    &handle->validation_scope,
+                    handle->module,
+                    key_pattern,
+                    key_indices);
+
             const bool success = keyp_to_func[i].func(&params);
             if (!success)
                 return false;
 
+            Validation_scope_add_key(
+                    &handle->validation_scope,
+                    handle->module,
+                    key_pattern,
+                    key_indices);
+
             // Mark connections for update if needed
             if (was_connection_possible != is_connection_possible(
                         handle, key_pattern, key_indices))
@@ -1279,6 +1294,45 @@ static bool read_any_proc_signal_type(
 }
 
 
+static bool read_any_proc_control_period(
+        Reader_params* params, Au_table* au_table, int level)
+{
+    rassert(params != NULL);
+    rassert(au_table != NULL);
+
+    int32_t au_index = -1;
+    acquire_au_index(au_index, params, level);
+    int32_t proc_index = -1;
+    acquire_proc_index(proc_index, params, level + 1);
+
+    Audio_unit* au = NULL;
+    acquire_au(au, params->handle, au_table, au_index);
+    Proc_table* proc_table = Audio_unit_get_procs(au);
+
+    Processor* proc = add_processor(params->handle, au, proc_table, proc_index);
+    if (proc == NULL)
+        return false;
+
+    int64_t period = 1;
+    if (Streader_has_data(params->sr))
+    {
+        if (!Streader_read_int(params->sr, &period))
+            return false;
+
+        if ((period < 1) || (period > PROC_CONTROL_PERIOD_MAX))
+        {
+            Handle_set_error(params->handle, ERROR_FORMAT,
+                    "Invalid processor control period: %" PRId64, period);
+            return false;
+        }
+    }
+
+    Processor_set_control_period(proc, (int32_t)period);
+
+    return true;
+}
+
+
 static bool read_any_proc_impl_conf_key(
         Reader_params* params, Au_table* au_table, int level)
 {
@@ -1483,6 +1537,7 @@ static bool read_column(Reader_params* params)
 
     if (!Pattern_set_column(pattern, col_index, column))
     {
+        del_Column(column);
         Handle_set_error(params->handle, ERROR_MEMORY,
                 "Could not allocate memory for a new column");
         return false;
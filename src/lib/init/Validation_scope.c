@@ -0,0 +1,170 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <init/Validation_scope.h>
+
+#include <debug/assert.h>
+#include <init/sheet/Order_list.h>
+#include <Pat_inst_ref.h>
+#include <string/common.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+Validation_scope* Validation_scope_init(Validation_scope* scope)
+{
+    rassert(scope != NULL);
+
+    scope->is_full = false;
+    scope->album = false;
+    scope->controls = false;
+    scope->connections = false;
+    scope->any_song = false;
+    scope->any_pat = false;
+    scope->any_au = false;
+    memset(scope->songs, 0, sizeof(scope->songs));
+    memset(scope->pats, 0, sizeof(scope->pats));
+    memset(scope->aus, 0, sizeof(scope->aus));
+
+    return scope;
+}
+
+
+void Validation_scope_set_full(Validation_scope* scope)
+{
+    rassert(scope != NULL);
+    scope->is_full = true;
+    return;
+}
+
+
+static void Validation_scope_add_order_list(
+        Validation_scope* scope, const Order_list* ol)
+{
+    rassert(scope != NULL);
+
+    if (ol == NULL)
+        return;
+
+    for (int system = 0; system < Order_list_get_len(ol); ++system)
+    {
+        const Pat_inst_ref* piref = Order_list_get_pat_inst_ref(ol, system);
+        rassert(piref != NULL);
+
+        if ((0 <= piref->pat) && (piref->pat < KQT_PATTERNS_MAX))
+        {
+            scope->pats[piref->pat] = true;
+            scope->any_pat = true;
+        }
+    }
+
+    return;
+}
+
+
+void Validation_scope_add_key(
+        Validation_scope* scope,
+        const Module* module,
+        const char* key_pattern,
+        const Key_indices indices)
+{
+    rassert(scope != NULL);
+    rassert(module != NULL);
+    rassert(key_pattern != NULL);
+    rassert(indices != NULL);
+
+    if (scope->is_full)
+        return;
+
+    if (string_has_prefix(key_pattern, "album/"))
+    {
+        scope->album = true;
+    }
+    else if (string_has_prefix(key_pattern, "song_XX/"))
+    {
+        const int song_index = indices[0];
+        if ((0 <= song_index) && (song_index < KQT_SONGS_MAX))
+        {
+            scope->songs[song_index] = true;
+            scope->any_song = true;
+
+            // Pattern instance usage depends on the order list
+            Validation_scope_add_order_list(scope, module->order_lists[song_index]);
+        }
+    }
+    else if (string_has_prefix(key_pattern, "pat_XXX/"))
+    {
+        const int pat_index = indices[0];
+        if ((0 <= pat_index) && (pat_index < KQT_PATTERNS_MAX))
+        {
+            scope->pats[pat_index] = true;
+            scope->any_pat = true;
+        }
+    }
+    else if (string_has_prefix(key_pattern, "au_XX/"))
+    {
+        const int au_index = indices[0];
+        if ((0 <= au_index) && (au_index < KQT_AUDIO_UNITS_MAX))
+        {
+            scope->aus[au_index] = true;
+            scope->any_au = true;
+        }
+    }
+    else if (string_eq(key_pattern, "p_control_map.json") ||
+            string_has_prefix(key_pattern, "control_XX/"))
+    {
+        scope->controls = true;
+    }
+    else if (string_eq(key_pattern, "p_connections.json") ||
+            string_has_prefix(key_pattern, "out_XX/"))
+    {
+        scope->connections = true;
+    }
+
+    return;
+}
+
+
+bool Validation_scope_has_song(const Validation_scope* scope, int index)
+{
+    rassert(scope != NULL);
+    rassert(index >= 0);
+    rassert(index < KQT_SONGS_MAX);
+
+    return scope->is_full || scope->songs[index];
+}
+
+
+bool Validation_scope_has_pattern(const Validation_scope* scope, int index)
+{
+    rassert(scope != NULL);
+    rassert(index >= 0);
+    rassert(index < KQT_PATTERNS_MAX);
+
+    return scope->is_full || scope->pats[index];
+}
+
+
+bool Validation_scope_has_au(const Validation_scope* scope, int index)
+{
+    rassert(scope != NULL);
+    rassert(index >= 0);
+    rassert(index < KQT_AUDIO_UNITS_MAX);
+
+    return scope->is_full || scope->aus[index];
+}
+
+
@@ -0,0 +1,124 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_VALIDATION_SCOPE_H
+#define KQT_VALIDATION_SCOPE_H
+
+
+#include <init/Module.h>
+#include <kunquat/limits.h>
+#include <string/key_pattern.h>
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+
+/**
+ * The parts of a Module that need to be validated after data changes.
+ *
+ * The scope only records which parts were touched. It is up to the validator
+ * to extend the checks to everything that depends on them, e.g. the songs
+ * that use a changed pattern.
+ */
+typedef struct Validation_scope
+{
+    bool is_full;
+    bool album;
+    bool controls;
+    bool connections;
+    bool any_song;
+    bool any_pat;
+    bool any_au;
+    bool songs[KQT_SONGS_MAX];
+    bool pats[KQT_PATTERNS_MAX];
+    bool aus[KQT_AUDIO_UNITS_MAX];
+} Validation_scope;
+
+
+/**
+ * Initialise an empty Validation scope.
+ *
+ * \param scope   The Validation scope -- must not be \c NULL.
+ *
+ * \return   The parameter \a scope.
+ */
+Validation_scope* Validation_scope_init(Validation_scope* scope);
+
+
+/**
+ * Extend the Validation scope to cover the whole Module.
+ *
+ * \param scope   The Validation scope -- must not be \c NULL.
+ */
+void Validation_scope_set_full(Validation_scope* scope);
+
+
+/**
+ * Add the parts of the Module affected by a key to the Validation scope.
+ *
+ * This function should be called both before and after the data of the key
+ * is changed, so that the references removed from an order list are also
+ * covered.
+ *
+ * \param scope         The Validation scope -- must not be \c NULL.
+ * \param module        The Module -- must not be \c NULL.
+ * \param key_pattern   The key pattern -- must not be \c NULL.
+ * \param indices       The indices extracted from the key -- must not be
+ *                      \c NULL.
+ */
+void Validation_scope_add_key(
+        Validation_scope* scope,
+        const Module* module,
+        const char* key_pattern,
+        const Key_indices indices);
+
+
+/**
+ * Check if a song needs to be validated.
+ *
+ * \param scope   The Validation scope -- must not be \c NULL.
+ * \param index   The song index -- must be >= \c 0 and < \c KQT_SONGS_MAX.
+ *
+ * \return   \c true if the song is in scope, otherwise \c false.
+ */
+bool Validation_scope_has_song(const Validation_scope* scope, int index);
+
+
+/**
+ * Check if a pattern needs to be validated.
+ *
+ * \param scope   The Validation scope -- must not be \c NULL.
+ * \param index   The pattern index -- must be >= \c 0 and
+ *                < \c KQT_PATTERNS_MAX.
+ *
+ * \return   \c true if the pattern is in scope, otherwise \c false.
+ */
+bool Validation_scope_has_pattern(const Validation_scope* scope, int index);
+
+
+/**
+ * Check if an audio unit needs to be validated.
+ *
+ * \param scope   The Validation scope -- must not be \c NULL.
+ * \param index   The audio unit index -- must be >= \c 0 and
+ *                < \c KQT_AUDIO_UNITS_MAX.
+ *
+ * \return   \c true if the audio unit is in scope, otherwise \c false.
+ */
+bool Validation_scope_has_au(const Validation_scope* scope, int index);
+
+
+#endif // KQT_VALIDATION_SCOPE_H
+
+
@@ -496,13 +496,16 @@ static void Audio_unit_init_control_var_generic(
 
     bool carried = false;
 
+    int32_t var_id = -1;
+
     if (mode == DEVICE_CONTROL_VAR_MODE_VOICE)
     {
         const Channel_cv_state* cvstate = Channel_get_cv_state(channel);
-        if (Channel_cv_state_is_carrying_enabled(cvstate, var_name))
+        var_id = Channel_cv_state_get_id(cvstate, var_name);
+        if (Channel_cv_state_is_carrying_enabled(cvstate, var_id))
         {
             const Value* carried_value =
-                Channel_cv_state_get_value(cvstate, var_name);
+                Channel_cv_state_get_value(cvstate, var_id);
             if (carried_value != NULL)
             {
                 Value* converted = VALUE_AUTO;
@@ -532,7 +535,7 @@ static void Audio_unit_init_control_var_generic(
         {
             Channel_cv_state* cvstate = Channel_get_cv_state_mut(channel);
             const bool success =
-                Channel_cv_state_set_value(cvstate, var_name, init_value);
+                Channel_cv_state_set_value(cvstate, var_id, init_value);
             rassert(success);
         }
 
@@ -79,6 +79,7 @@ struct Device_impl
     Device_impl_get_voice_wb_size_func* get_voice_wb_size;
     Voice_state_init_func* init_vstate;
     Voice_state_render_voice_func* render_voice;
+    Voice_state_render_voices_batch_func* render_voices_batch;
     Device_impl_destroy_func* destroy;
 };
 
@@ -96,6 +96,7 @@ Processor* new_Processor(int index, const Au_params* au_params)
 
     proc->enable_voice_support = false;
     proc->enable_signal_support = false;
+    proc->control_period = 1;
 
     Device_set_state_creator(&proc->parent, Processor_create_dstate);
 
@@ -121,6 +122,25 @@ bool Processor_get_voice_signals(const Processor* proc)
 }
 
 
+void Processor_set_control_period(Processor* proc, int32_t period)
+{
+    rassert(proc != NULL);
+    rassert(period >= 1);
+    rassert(period <= PROC_CONTROL_PERIOD_MAX);
+
+    proc->control_period = period;
+
+    return;
+}
+
+
+int32_t Processor_get_control_period(const Processor* proc)
+{
+    rassert(proc != NULL);
+    return proc->control_period;
+}
+
+
 /*
 void Processor_set_signal_support(Processor* proc, bool enabled)
 {
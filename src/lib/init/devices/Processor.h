@@ -30,6 +30,9 @@
 #include <stdint.h>
 
 
+#define PROC_CONTROL_PERIOD_MAX 1024
+
+
 /**
  * Processor creates signal output based on voice or signal input.
  */
@@ -41,6 +44,7 @@ struct Processor
 
     bool enable_voice_support;
     bool enable_signal_support;
+    int32_t control_period;
 };
 
 
@@ -79,6 +83,31 @@ void Processor_set_voice_signals(Processor* proc, bool enabled);
 bool Processor_get_voice_signals(const Processor* proc);
 
 
+/**
+ * Set the control period of the Processor.
+ *
+ * Processors that produce control signals compute their output only every
+ * \a period frames and interpolate linearly between the computed values.
+ * Processors without control-rate support ignore this setting.
+ *
+ * \param proc     The Processor -- must not be \c NULL.
+ * \param period   The control period in frames -- must be >= \c 1 and
+ *                 <= \c PROC_CONTROL_PERIOD_MAX. The value \c 1 disables
+ *                 control-rate processing.
+ */
+void Processor_set_control_period(Processor* proc, int32_t period);
+
+
+/**
+ * Get the control period of the Processor.
+ *
+ * \param proc   The Processor -- must not be \c NULL.
+ *
+ * \return   The control period in frames.
+ */
+int32_t Processor_get_control_period(const Processor* proc);
+
+
 /**
  * Get the Audio unit parameters associated with the Processor.
  *
@@ -15,11 +15,13 @@
 #include <init/devices/param_types/Envelope.h>
 
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <memory.h>
 #include <string/common.h>
 
 #include <float.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -42,11 +44,14 @@ struct Envelope
     int nodes_res;
     int marks[ENVELOPE_MARKS_MAX];
     double* nodes;
+    double* slopes; // slopes[i] is the slope between nodes i and i + 1
 };
 
 
 static bool Envelope_read_nodes(Envelope* env, Streader* sr);
 
+static void Envelope_update_slopes(Envelope* env, int first_node, int last_node);
+
 
 Envelope* new_Envelope(int nodes_max,
         double min_x, double max_x, double step_x,
@@ -65,8 +70,11 @@ Envelope* new_Envelope(int nodes_max,
         return NULL;
 
     env->nodes = memory_alloc_items(double, nodes_max * 2);
-    if (env->nodes == NULL)
+    env->slopes = memory_alloc_items(double, nodes_max);
+    if ((env->nodes == NULL) || (env->slopes == NULL))
     {
+        memory_free(env->nodes);
+        memory_free(env->slopes);
         memory_free(env);
         return NULL;
     }
@@ -369,6 +377,8 @@ int Envelope_set_node(Envelope* env, double x, double y)
     env->nodes[start * 2] = x;
     env->nodes[start * 2 + 1] = y;
 
+    Envelope_update_slopes(env, start - 1, env->node_count - 1);
+
     return start;
 }
 
@@ -396,6 +406,8 @@ bool Envelope_del_node(Envelope* env, int index)
 
     --env->node_count;
 
+    Envelope_update_slopes(env, index - 1, env->node_count - 1);
+
     for (int i = 0; i < ENVELOPE_MARKS_MAX; ++i)
     {
         if (env->marks[i] > index)
@@ -482,10 +494,33 @@ double* Envelope_move_node(Envelope* env, int index, double x, double y)
     else
         env->nodes[index * 2 + 1] = y;
 
+    Envelope_update_slopes(env, index - 1, index + 1);
+
     return env->nodes + index * 2;
 }
 
 
+static void Envelope_update_slopes(Envelope* env, int first_node, int last_node)
+{
+    rassert(env != NULL);
+
+    // Update the segments between the given nodes
+    const int start = max(0, first_node);
+    const int stop = min(env->node_count - 1, last_node);
+
+    for (int i = start; i < stop; ++i)
+    {
+        const double prev_x = env->nodes[i * 2];
+        const double prev_y = env->nodes[i * 2 + 1];
+        const double next_x = env->nodes[i * 2 + 2];
+        const double next_y = env->nodes[i * 2 + 3];
+        env->slopes[i] = (next_y - prev_y) / (next_x - prev_x);
+    }
+
+    return;
+}
+
+
 double Envelope_get_value(const Envelope* env, double x)
 {
     rassert(env != NULL);
@@ -533,8 +568,7 @@ double Envelope_get_value(const Envelope* env, double x)
 
         case ENVELOPE_INT_LINEAR:
         {
-            return prev_y + (x - prev_x) *
-                   ((next_y - prev_y) / (next_x - prev_x));
+            return prev_y + (x - prev_x) * env->slopes[end];
         }
         break;
 
@@ -547,6 +581,93 @@ double Envelope_get_value(const Envelope* env, double x)
 }
 
 
+void Envelope_get_values(
+        const Envelope* env, const float* xs, float* values, int32_t count)
+{
+    rassert(env != NULL);
+    rassert(xs != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    if (env->node_count == 0)
+    {
+        for (int32_t i = 0; i < count; ++i)
+            values[i] = NAN;
+        return;
+    }
+
+    const double* nodes = env->nodes;
+    const double* slopes = env->slopes;
+    const double first_x = nodes[0];
+    const double last_x = nodes[env->node_count * 2 - 2];
+
+    // Start of the segment that contains the previous position
+    int cursor = 0;
+
+    for (int32_t i = 0; i < count; ++i)
+    {
+        const double x = xs[i];
+        dassert(isfinite(x));
+
+        if (x < first_x || x > last_x)
+        {
+            values[i] = NAN;
+            continue;
+        }
+
+        if (env->node_count == 1)
+        {
+            values[i] = (float)nodes[1];
+            continue;
+        }
+
+        // Walk to the segment that contains x
+        while (x < nodes[cursor * 2])
+            --cursor;
+        while (x > nodes[cursor * 2 + 2])
+            ++cursor;
+
+        dassert(cursor >= 0);
+        dassert(cursor < env->node_count - 1);
+
+        const double prev_x = nodes[cursor * 2];
+        const double prev_y = nodes[cursor * 2 + 1];
+        const double next_x = nodes[cursor * 2 + 2];
+        const double next_y = nodes[cursor * 2 + 3];
+
+        double value = NAN;
+        if (x == prev_x)
+        {
+            value = prev_y;
+        }
+        else if (x == next_x)
+        {
+            value = next_y;
+        }
+        else
+        {
+            switch (env->interp)
+            {
+                case ENVELOPE_INT_NEAREST:
+                    value = (x - prev_x < next_x - x) ? prev_y : next_y;
+                    break;
+
+                case ENVELOPE_INT_LINEAR:
+                    value = prev_y + (x - prev_x) * slopes[cursor];
+                    break;
+
+                default:
+                    rassert(false);
+            }
+        }
+
+        values[i] = (float)value;
+    }
+
+    return;
+}
+
+
 void Envelope_set_first_lock(Envelope* env, bool lock_x, bool lock_y)
 {
     rassert(env != NULL);
@@ -577,6 +698,7 @@ void del_Envelope(Envelope* env)
         return;
 
     memory_free(env->nodes);
+    memory_free(env->slopes);
     memory_free(env);
 
     return;
@@ -22,6 +22,7 @@
 
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 
@@ -192,6 +193,25 @@ double* Envelope_move_node(Envelope* env, int index, double x, double y);
 double Envelope_get_value(const Envelope* env, double x);
 
 
+/**
+ * Get values from the Envelope at multiple positions.
+ *
+ * The segment search starts from the segment of the previous position, so
+ * this is considerably faster than calling \a Envelope_get_value for each
+ * position when consecutive positions are close to each other.
+ *
+ * \param env      The Envelope -- must not be \c NULL.
+ * \param xs       The x coordinates -- must not be \c NULL and must contain
+ *                 finite values.
+ * \param values   The destination array for values of y, or \c NAN where
+ *                 the Envelope is undefined -- must not be \c NULL. This may
+ *                 be the same array as \a xs.
+ * \param count    The number of positions -- must be >= \c 0.
+ */
+void Envelope_get_values(
+        const Envelope* env, const float* xs, float* values, int32_t count);
+
+
 /**
  * Set the locking of the first node.
  *
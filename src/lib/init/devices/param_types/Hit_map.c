@@ -20,16 +20,11 @@
 
 #include <inttypes.h>
 #include <math.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
 
-struct Hit_map
-{
-    AAtree* hits[KQT_HITS_MAX];
-};
-
-
 typedef struct Random_list
 {
     double force;
@@ -38,6 +33,16 @@ typedef struct Random_list
 } Random_list;
 
 
+struct Hit_map
+{
+    AAtree* hits[KQT_HITS_MAX];
+
+    // Random lists of each hit sorted by force for lookups
+    int32_t list_counts[KQT_HITS_MAX];
+    const Random_list** lists[KQT_HITS_MAX];
+};
+
+
 static int Random_list_cmp(const Random_list* list1, const Random_list* list2)
 {
     rassert(list1 != NULL);
@@ -158,6 +163,50 @@ static bool read_mapping(Streader* sr, int32_t index, void* userdata)
     return Streader_match_char(sr, ']');
 }
 
+static bool Hit_map_build_lists(Hit_map* map)
+{
+    rassert(map != NULL);
+
+    const Random_list* first_key = &(Random_list){ .force = -INFINITY };
+
+    for (int hit_index = 0; hit_index < KQT_HITS_MAX; ++hit_index)
+    {
+        const AAtree* forces = map->hits[hit_index];
+        if (forces == NULL)
+            continue;
+
+        AAiter* iter = AAiter_init(AAITER_AUTO, forces);
+
+        int32_t count = 0;
+        for (const Random_list* list = AAiter_get_at_least(iter, first_key);
+                list != NULL;
+                list = AAiter_get_next(iter))
+            ++count;
+
+        if (count == 0)
+            continue;
+
+        const Random_list** lists = memory_alloc_items(const Random_list*, count);
+        if (lists == NULL)
+            return false;
+
+        int32_t index = 0;
+        for (const Random_list* list = AAiter_get_at_least(iter, first_key);
+                list != NULL;
+                list = AAiter_get_next(iter))
+        {
+            lists[index] = list;
+            ++index;
+        }
+
+        map->list_counts[hit_index] = count;
+        map->lists[hit_index] = lists;
+    }
+
+    return true;
+}
+
+
 Hit_map* new_Hit_map_from_string(Streader* sr)
 {
     rassert(sr != NULL);
@@ -173,7 +222,11 @@ Hit_map* new_Hit_map_from_string(Streader* sr)
     }
 
     for (int i = 0; i < KQT_HITS_MAX; ++i)
+    {
         map->hits[i] = NULL;
+        map->list_counts[i] = 0;
+        map->lists[i] = NULL;
+    }
 
     if (!Streader_has_data(sr))
         return map;
@@ -184,6 +237,13 @@ Hit_map* new_Hit_map_from_string(Streader* sr)
         return NULL;
     }
 
+    if (!Hit_map_build_lists(map))
+    {
+        del_Hit_map(map);
+        Streader_set_memory_error(sr, "Could not allocate memory for hit map");
+        return NULL;
+    }
+
     return map;
 }
 
@@ -197,14 +257,31 @@ const Sample_entry* Hit_map_get_entry(
     rassert(isfinite(force) || force == -INFINITY);
     rassert(random != NULL);
 
-    AAtree* forces = map->hits[hit_index];
-    if (forces == NULL)
+    const Random_list** lists = map->lists[hit_index];
+    const int32_t count = map->list_counts[hit_index];
+    if (count == 0)
         return NULL;
 
-    Random_list* key = &(Random_list){ .force = force };
-    Random_list* greater = AAtree_get_at_least(forces, key);
-    Random_list* smaller = AAtree_get_at_most(forces, key);
-    Random_list* list = NULL;
+    // Find the first list with force at least as high as requested
+    int32_t low = 0;
+    int32_t high = count;
+    while (low < high)
+    {
+        const int32_t mid = low + (high - low) / 2;
+        if (lists[mid]->force < force)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+
+    const Random_list* greater = (low < count) ? lists[low] : NULL;
+    const Random_list* smaller = NULL;
+    if ((greater != NULL) && (greater->force == force))
+        smaller = greater;
+    else if (low > 0)
+        smaller = lists[low - 1];
+
+    const Random_list* list = NULL;
 
     if (greater == NULL)
         list = smaller;
@@ -232,7 +309,10 @@ void del_Hit_map(Hit_map* map)
         return;
 
     for (int i = 0; i < KQT_HITS_MAX; ++i)
+    {
+        memory_free(map->lists[i]);
         del_AAtree(map->hits[i]);
+    }
 
     memory_free(map);
 
@@ -16,18 +16,15 @@
 
 #include <containers/AAtree.h>
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <memory.h>
 
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 
 
-struct Note_map
-{
-    AAtree* map;
-};
-
-
 typedef struct Random_list
 {
     double freq;
@@ -38,12 +35,45 @@ typedef struct Random_list
 } Random_list;
 
 
+/**
+ * The lookup grid divides the (pitch, force) plane around the mapping points
+ * into cells. Each cell lists the mapping points that may be the closest
+ * point to any position inside the cell, so a lookup only needs to compare
+ * distances to a few candidates. Positions outside the grid are searched from
+ * the tree.
+ */
+#define GRID_CENTS_PADDING 2400.0
+#define GRID_FORCE_PADDING 64.0
+#define GRID_WIDTH_MAX 512
+#define GRID_HEIGHT_MAX 32
+
+
+struct Note_map
+{
+    AAtree* map;
+
+    int32_t list_count;
+    const Random_list** lists; // all random lists in map order
+
+    double grid_min_cents;
+    double grid_cell_cents;
+    int32_t grid_width;
+    double grid_min_force;
+    double grid_cell_force;
+    int32_t grid_height;
+    int32_t* cell_starts; // offsets to cell_lists, one past the last cell included
+    int32_t* cell_lists; // candidate indices to lists in map order
+};
+
+
 static int Random_list_cmp(const Random_list* list1, const Random_list* list2);
 
 static void del_Random_list(Random_list* list);
 
 static double distance(const Random_list* list, const Random_list* key);
 
+static void Note_map_clear_grid(Note_map* map);
+
 
 static int Random_list_cmp(const Random_list* list1, const Random_list* list2)
 {
@@ -174,6 +204,17 @@ Note_map* new_Note_map_from_string(Streader* sr)
         return NULL;
     }
 
+    map->list_count = 0;
+    map->lists = NULL;
+    map->grid_min_cents = 0;
+    map->grid_cell_cents = 1;
+    map->grid_width = 0;
+    map->grid_min_force = 0;
+    map->grid_cell_force = 1;
+    map->grid_height = 0;
+    map->cell_starts = NULL;
+    map->cell_lists = NULL;
+
     map->map = new_AAtree(
             (AAtree_item_cmp*)Random_list_cmp, (AAtree_item_destroy*)del_Random_list);
     if (map->map == NULL)
@@ -193,6 +234,14 @@ Note_map* new_Note_map_from_string(Streader* sr)
         return NULL;
     }
 
+    if (!Note_map_build_grid(map))
+    {
+        del_Note_map(map);
+        Streader_set_memory_error(
+                sr, "Could not allocate memory for note map");
+        return NULL;
+    }
+
     return map;
 }
 
@@ -209,15 +258,22 @@ bool Note_map_add_entry(Note_map* map, double cents, double force, Sample_entry*
     if (list == NULL)
     {
         list = memory_alloc_item(Random_list);
-        if (list == NULL || !AAtree_ins(map->map, list))
-        {
-            memory_free(list);
+        if (list == NULL)
             return false;
-        }
+
         list->freq = exp2(cents / 1200) * 440;
         list->cents = cents;
         list->force = force;
         list->entry_count = 0;
+
+        if (!AAtree_ins(map->map, list))
+        {
+            memory_free(list);
+            return false;
+        }
+
+        // The grid is rebuilt after all entries have been added
+        Note_map_clear_grid(map);
     }
 
     if (list->entry_count >= NOTE_MAP_RANDOMS_MAX)
@@ -246,16 +302,209 @@ static double distance(const Random_list* list, const Random_list* key)
 }
 
 
-const Sample_entry* Note_map_get_entry(
-        const Note_map* map, double cents, double force, Random* random)
+static void get_cell_bounds(
+        const Note_map* map,
+        int32_t x,
+        int32_t y,
+        double* min_x,
+        double* max_x,
+        double* min_y,
+        double* max_y)
 {
     rassert(map != NULL);
-    rassert(isfinite(cents));
-    rassert(isfinite(force) || (isinf(force) && force < 0));
-    rassert(random != NULL);
+    rassert(x >= 0);
+    rassert(x < map->grid_width);
+    rassert(y >= 0);
+    rassert(y < map->grid_height);
+
+    // Bounds in the distance space with a small margin for rounding errors
+    const double cents_margin = map->grid_cell_cents * 1e-6;
+    const double force_margin = map->grid_cell_force * 1e-6;
+
+    *min_x = (map->grid_min_cents + x * map->grid_cell_cents - cents_margin) * 64;
+    *max_x = (map->grid_min_cents + (x + 1) * map->grid_cell_cents + cents_margin) * 64;
+    *min_y = map->grid_min_force + y * map->grid_cell_force - force_margin;
+    *max_y = map->grid_min_force + (y + 1) * map->grid_cell_force + force_margin;
+
+    return;
+}
+
+
+static double get_min_cell_distance(
+        const Random_list* list, double min_x, double max_x, double min_y, double max_y)
+{
+    rassert(list != NULL);
+
+    const double x = list->cents * 64;
+    const double y = list->force;
+    const double dx = (x < min_x) ? (min_x - x) : (x > max_x) ? (x - max_x) : 0;
+    const double dy = (y < min_y) ? (min_y - y) : (y > max_y) ? (y - max_y) : 0;
+
+    return hypot(dx, dy);
+}
+
+
+static double get_max_cell_distance(
+        const Random_list* list, double min_x, double max_x, double min_y, double max_y)
+{
+    rassert(list != NULL);
+
+    const double x = list->cents * 64;
+    const double y = list->force;
+    const double dx = max(fabs(x - min_x), fabs(x - max_x));
+    const double dy = max(fabs(y - min_y), fabs(y - max_y));
+
+    return hypot(dx, dy);
+}
+
+
+static void Note_map_clear_grid(Note_map* map)
+{
+    rassert(map != NULL);
+
+    memory_free(map->lists);
+    map->lists = NULL;
+    memory_free(map->cell_starts);
+    map->cell_starts = NULL;
+    memory_free(map->cell_lists);
+    map->cell_lists = NULL;
+
+    map->list_count = 0;
+    map->grid_width = 0;
+    map->grid_height = 0;
+
+    return;
+}
+
+
+bool Note_map_build_grid(Note_map* map)
+{
+    rassert(map != NULL);
+
+    Note_map_clear_grid(map);
+
+    // Collect the random lists in map order
+    int32_t list_count = 0;
+    AAiter* iter = AAiter_init(AAITER_AUTO, map->map);
+    const Random_list* first_key =
+        &(Random_list){ .cents = -INFINITY, .force = -INFINITY };
+    for (const Random_list* list = AAiter_get_at_least(iter, first_key);
+            list != NULL;
+            list = AAiter_get_next(iter))
+        ++list_count;
+
+    if (list_count == 0)
+        return true;
+
+    map->lists = memory_alloc_items(const Random_list*, list_count);
+    if (map->lists == NULL)
+        return false;
+
+    double min_cents = INFINITY;
+    double max_cents = -INFINITY;
+    double min_force = INFINITY;
+    double max_force = -INFINITY;
+
+    int32_t index = 0;
+    for (const Random_list* list = AAiter_get_at_least(iter, first_key);
+            list != NULL;
+            list = AAiter_get_next(iter))
+    {
+        map->lists[index] = list;
+        ++index;
+
+        min_cents = min(min_cents, list->cents);
+        max_cents = max(max_cents, list->cents);
+        min_force = min(min_force, list->force);
+        max_force = max(max_force, list->force);
+    }
+    map->list_count = list_count;
+
+    // Set up grid dimensions
+    const int32_t width = clamp(list_count * 4, 16, GRID_WIDTH_MAX);
+    const int32_t height = clamp(list_count, 1, GRID_HEIGHT_MAX);
+    const int32_t cell_count = width * height;
+
+    map->grid_min_cents = min_cents - GRID_CENTS_PADDING;
+    map->grid_cell_cents =
+        (max_cents - min_cents + 2 * GRID_CENTS_PADDING) / (double)width;
+    map->grid_min_force = min_force - GRID_FORCE_PADDING;
+    map->grid_cell_force =
+        (max_force - min_force + 2 * GRID_FORCE_PADDING) / (double)height;
+
+    map->cell_starts = memory_alloc_items(int32_t, cell_count + 1);
+    if (map->cell_starts == NULL)
+    {
+        Note_map_clear_grid(map);
+        return false;
+    }
+
+    map->grid_width = width;
+    map->grid_height = height;
+
+    // Find candidates in two passes: count and then store
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        int32_t total_count = 0;
+
+        for (int32_t y = 0; y < height; ++y)
+        {
+            for (int32_t x = 0; x < width; ++x)
+            {
+                double min_x = NAN;
+                double max_x = NAN;
+                double min_y = NAN;
+                double max_y = NAN;
+                get_cell_bounds(map, x, y, &min_x, &max_x, &min_y, &max_y);
+
+                // Any closest point is at most this far from positions in the cell
+                double max_dist = INFINITY;
+                for (int32_t i = 0; i < list_count; ++i)
+                    max_dist = min(max_dist, get_max_cell_distance(
+                                map->lists[i], min_x, max_x, min_y, max_y));
+                max_dist += max_dist * 1e-9 + 1e-9;
+
+                const int32_t cell_index = (y * width) + x;
+                if (pass == 0)
+                    map->cell_starts[cell_index] = total_count;
+                else
+                    rassert(map->cell_starts[cell_index] == total_count);
+
+                for (int32_t i = 0; i < list_count; ++i)
+                {
+                    const double min_dist = get_min_cell_distance(
+                            map->lists[i], min_x, max_x, min_y, max_y);
+                    if (min_dist <= max_dist)
+                    {
+                        if (pass == 1)
+                            map->cell_lists[total_count] = i;
+                        ++total_count;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            map->cell_starts[cell_count] = total_count;
+            map->cell_lists = memory_alloc_items(int32_t, total_count);
+            if (map->cell_lists == NULL)
+            {
+                Note_map_clear_grid(map);
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+static const Random_list* find_list_in_tree(const Note_map* map, const Random_list* key)
+{
+    rassert(map != NULL);
+    rassert(key != NULL);
 
-    const Random_list* key =
-        &(Random_list){ .force = force, .freq = NAN, .cents = cents };
     AAiter* iter = AAiter_init(AAITER_AUTO, map->map);
     Random_list* estimate_low = AAiter_get_at_most(iter, key);
     Random_list* choice = NULL;
@@ -305,20 +554,69 @@ const Sample_entry* Note_map_get_entry(
         }
     }
 
-    if (choice == NULL)
+    return choice;
+}
+
+
+static const Random_list* find_list_in_grid(const Note_map* map, const Random_list* key)
+{
+    rassert(map != NULL);
+    rassert(key != NULL);
+
+    if ((map->grid_width == 0) || !isfinite(key->force))
+        return find_list_in_tree(map, key);
+
+    const double x_pos = floor((key->cents - map->grid_min_cents) / map->grid_cell_cents);
+    const double y_pos = floor((key->force - map->grid_min_force) / map->grid_cell_force);
+    if (!(x_pos >= 0 && x_pos < map->grid_width && y_pos >= 0 && y_pos < map->grid_height))
+        return find_list_in_tree(map, key);
+
+    const int32_t cell_index = ((int32_t)y_pos * map->grid_width) + (int32_t)x_pos;
+    const int32_t start = map->cell_starts[cell_index];
+    const int32_t stop = map->cell_starts[cell_index + 1];
+    rassert(start < stop);
+
+    // Resolve ties like the tree search: the last tied list at or below
+    // the key in map order wins, otherwise the first tied list above it
+    const Random_list* choice = NULL;
+    double choice_d = INFINITY;
+    for (int32_t i = start; i < stop; ++i)
     {
-//        fprintf(stderr, "empty map\n");
-        return NULL;
+        const Random_list* candidate = map->lists[map->cell_lists[i]];
+        const double d = distance(candidate, key);
+        const bool is_above_key = (Random_list_cmp(candidate, key) > 0);
+        if ((d < choice_d) || (!is_above_key && (d == choice_d)))
+        {
+            choice = candidate;
+            choice_d = d;
+        }
     }
 
+    return choice;
+}
+
+
+const Sample_entry* Note_map_get_entry(
+        const Note_map* map, double cents, double force, Random* random)
+{
+    rassert(map != NULL);
+    rassert(isfinite(cents));
+    rassert(isfinite(force) || (isinf(force) && force < 0));
+    rassert(random != NULL);
+
+    const Random_list* key =
+        &(Random_list){ .force = force, .freq = NAN, .cents = cents };
+    const Random_list* choice = find_list_in_grid(map, key);
+
+    if (choice == NULL)
+        return NULL;
+
     if (choice->entry_count == 0)
         return NULL;
 
     rassert(choice->entry_count <= NOTE_MAP_RANDOMS_MAX);
-//    state->middle_tone = choice->freq;
     const int index = Random_get_index(random, choice->entry_count);
     rassert(index >= 0);
-//    fprintf(stderr, "%d\n", index);
 
     return &choice->entries[index];
 }
@@ -329,6 +627,7 @@ void del_Note_map(Note_map* map)
     if (map == NULL)
         return;
 
+    Note_map_clear_grid(map);
     del_AAtree(map->map);
     memory_free(map);
 
@@ -42,7 +42,9 @@ Note_map* new_Note_map_from_string(Streader* sr);
 /**
  * Add a Sample entry into the Note map.
  *
- * This function is for Processors that create their own Note maps.
+ * This function is for Processors that create their own Note maps. Adding
+ * a new mapping position discards the lookup grid of the Note map, so
+ * \a Note_map_build_grid should be called after all entries have been added.
  *
  * \param map     The Note map -- must not be \c NULL.
  * \param cents   The pitch in cents -- must be finite.
@@ -60,6 +62,18 @@ Note_map* new_Note_map_from_string(Streader* sr);
 bool Note_map_add_entry(Note_map* map, double cents, double force, Sample_entry* entry);
 
 
+/**
+ * Build the lookup grid of the Note map.
+ *
+ * Without the grid, Sample entries are still found but the lookup is slower.
+ *
+ * \param map   The Note map -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Note_map_build_grid(Note_map* map);
+
+
 /**
  * Get a Sample entry from the Note map.
  *
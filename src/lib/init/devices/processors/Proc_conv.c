@@ -0,0 +1,284 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <init/devices/processors/Proc_conv.h>
+
+#include <debug/assert.h>
+#include <init/devices/Device.h>
+#include <init/devices/Device_impl.h>
+#include <init/devices/Device_params.h>
+#include <init/devices/param_types/Sample.h>
+#include <init/devices/Proc_cons.h>
+#include <init/devices/Processor.h>
+#include <init/devices/processors/Proc_init_utils.h>
+#include <mathnum/common.h>
+#include <mathnum/fft.h>
+#include <memory.h>
+#include <player/devices/processors/Conv_state.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+static Set_sample_func  Proc_conv_set_ir;
+static Set_int_func     Proc_conv_set_part_size;
+
+static void del_Proc_conv(Device_impl* dimpl);
+
+
+Device_impl* new_Proc_conv(void)
+{
+    Proc_conv* conv = memory_alloc_item(Proc_conv);
+    if (conv == NULL)
+        return NULL;
+
+    conv->part_size = CONV_PART_SIZE_DEFAULT;
+    conv->part_count = 0;
+    conv->ir_channels = 0;
+    conv->ir_length = 0;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        conv->ir_data[ch] = NULL;
+        conv->ir_spectra[ch] = NULL;
+    }
+
+    if (!Device_impl_init(&conv->parent, del_Proc_conv))
+    {
+        del_Device_impl(&conv->parent);
+        return NULL;
+    }
+
+    conv->parent.create_pstate = new_Conv_pstate;
+
+    // Register key set/update handlers
+    if (!(REGISTER_SET_WITH_STATE_CB(
+                conv, sample, ir, "p_ir.wv", NULL, Conv_pstate_set_ir) &&
+            REGISTER_SET_WITH_STATE_CB(
+                conv, sample, ir, "p_ir.wav", NULL, Conv_pstate_set_ir) &&
+            REGISTER_SET_WITH_STATE_CB(
+                conv,
+                int,
+                part_size,
+                "p_i_part_size.json",
+                CONV_PART_SIZE_DEFAULT,
+                Conv_pstate_set_part_size)
+         ))
+    {
+        del_Device_impl(&conv->parent);
+        return NULL;
+    }
+
+    return &conv->parent;
+}
+
+
+static bool Proc_conv_update_spectra(Proc_conv* conv)
+{
+    rassert(conv != NULL);
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        memory_free(conv->ir_spectra[ch]);
+        conv->ir_spectra[ch] = NULL;
+    }
+
+    conv->part_count = 0;
+
+    if (conv->ir_length == 0)
+        return true;
+
+    const int32_t part_size = conv->part_size;
+    const int32_t spectrum_size = part_size * 2;
+    const int32_t part_count =
+        (int32_t)((conv->ir_length + part_size - 1) / part_size);
+
+    for (int ch = 0; ch < conv->ir_channels; ++ch)
+    {
+        conv->ir_spectra[ch] =
+            memory_alloc_items(float, (int64_t)part_count * spectrum_size);
+        if (conv->ir_spectra[ch] == NULL)
+            return false;
+    }
+
+    FFT_worker* fw = FFT_worker_init(FFT_WORKER_AUTO, spectrum_size);
+    if (fw == NULL)
+        return false;
+
+    // Include the normalisation of the inverse transform in the spectra
+    const float scale = 1.0f / (float)spectrum_size;
+
+    for (int ch = 0; ch < conv->ir_channels; ++ch)
+    {
+        const float* ir = conv->ir_data[ch];
+
+        for (int32_t part = 0; part < part_count; ++part)
+        {
+            float* spectrum = conv->ir_spectra[ch] + (int64_t)part * spectrum_size;
+
+            // The second half is zero padding for overlap-save convolution
+            const int64_t ir_start = (int64_t)part * part_size;
+            const int32_t copy_count =
+                (int32_t)min(conv->ir_length - ir_start, part_size);
+            for (int32_t i = 0; i < copy_count; ++i)
+                spectrum[i] = ir[ir_start + i] * scale;
+            for (int32_t i = copy_count; i < spectrum_size; ++i)
+                spectrum[i] = 0;
+
+            FFT_worker_rfft(fw, spectrum, spectrum_size);
+        }
+    }
+
+    FFT_worker_deinit(fw);
+
+    conv->part_count = part_count;
+
+    return true;
+}
+
+
+static float get_sample_value(const Sample* sample, int ch, int64_t index)
+{
+    rassert(sample != NULL);
+    rassert(ch >= 0);
+    rassert(ch < sample->channels);
+    rassert(index >= 0);
+    rassert(index < sample->len);
+
+    if (sample->is_float)
+        return ((const float*)sample->data[ch])[index];
+
+    switch (sample->bits)
+    {
+        case 8:
+            return (float)(((const int8_t*)sample->data[ch])[index] * (1.0 / 0x80));
+
+        case 16:
+            return (float)(((const int16_t*)sample->data[ch])[index] * (1.0 / 0x8000));
+
+        case 32:
+            return (float)(((const int32_t*)sample->data[ch])[index] * (1.0 / 0x80000000UL));
+
+        default:
+            rassert(false);
+    }
+
+    return 0;
+}
+
+
+static bool Proc_conv_update_ir(Proc_conv* conv)
+{
+    rassert(conv != NULL);
+
+    // The WavPack impulse response takes precedence over the WAV one
+    const Device_params* dparams = conv->parent.device->dparams;
+    const Sample* value = Device_params_get_sample(dparams, "p_ir.wv");
+    if (value == NULL)
+        value = Device_params_get_sample(dparams, "p_ir.wav");
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        memory_free(conv->ir_data[ch]);
+        conv->ir_data[ch] = NULL;
+    }
+
+    conv->ir_channels = 0;
+    conv->ir_length = 0;
+
+    if ((value != NULL) && (value->len > 0) && (value->data[0] != NULL))
+    {
+        const int64_t length = min(value->len, CONV_IR_LENGTH_MAX);
+        const int channels = ((value->channels == 2) && (value->data[1] != NULL)) ? 2 : 1;
+
+        for (int ch = 0; ch < channels; ++ch)
+        {
+            conv->ir_data[ch] = memory_alloc_items(float, length);
+            if (conv->ir_data[ch] == NULL)
+                return false;
+
+            for (int64_t i = 0; i < length; ++i)
+                conv->ir_data[ch][i] = get_sample_value(value, ch, i);
+        }
+
+        conv->ir_channels = channels;
+        conv->ir_length = length;
+    }
+
+    return Proc_conv_update_spectra(conv);
+}
+
+
+static bool Proc_conv_set_ir(
+        Device_impl* dimpl, const Key_indices indices, const Sample* value)
+{
+    rassert(dimpl != NULL);
+    ignore(indices);
+    ignore(value);
+
+    return Proc_conv_update_ir((Proc_conv*)dimpl);
+}
+
+
+static bool Proc_conv_set_part_size(
+        Device_impl* dimpl, const Key_indices indices, int64_t value)
+{
+    rassert(dimpl != NULL);
+    ignore(indices);
+
+    Proc_conv* conv = (Proc_conv*)dimpl;
+
+    if ((value >= CONV_PART_SIZE_MIN) && (value <= CONV_PART_SIZE_MAX) && is_p2(value))
+        conv->part_size = (int32_t)value;
+    else
+        conv->part_size = CONV_PART_SIZE_DEFAULT;
+
+    return Proc_conv_update_spectra(conv);
+}
+
+
+const float* Proc_conv_get_ir_spectra(const Proc_conv* conv, int ch)
+{
+    rassert(conv != NULL);
+    rassert(ch >= 0);
+    rassert(ch < 2);
+
+    if (conv->part_count == 0)
+        return NULL;
+
+    // A mono impulse response is used for both channels
+    return conv->ir_spectra[min(ch, conv->ir_channels - 1)];
+}
+
+
+static void del_Proc_conv(Device_impl* dimpl)
+{
+    if (dimpl == NULL)
+        return;
+
+    Proc_conv* conv = (Proc_conv*)dimpl;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        memory_free(conv->ir_data[ch]);
+        memory_free(conv->ir_spectra[ch]);
+    }
+
+    memory_free(conv);
+
+    return;
+}
+
+
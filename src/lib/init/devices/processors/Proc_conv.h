@@ -0,0 +1,72 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_PROC_CONV_H
+#define KQT_PROC_CONV_H
+
+
+#include <init/devices/Device_impl.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define CONV_PART_SIZE_MIN 64
+#define CONV_PART_SIZE_MAX 16384
+#define CONV_PART_SIZE_DEFAULT 1024
+
+#define CONV_IR_LENGTH_MAX (1L << 22)
+
+
+/**
+ * The convolution processor.
+ *
+ * The impulse response is split into partitions of \a part_size frames, and
+ * the spectra of the partitions are calculated when the impulse response or
+ * the partition size is set. The partition size is also the latency of the
+ * processor, so smaller partitions trade CPU time for lower latency.
+ */
+typedef struct Proc_conv
+{
+    Device_impl parent;
+
+    int32_t part_size;
+    int32_t part_count;
+
+    int ir_channels;
+    int64_t ir_length;
+    float* ir_data[2];
+
+    float* ir_spectra[2];
+} Proc_conv;
+
+
+/**
+ * Get the spectra of the impulse response partitions of a channel.
+ *
+ * Each spectrum contains 2 * \a part_size values in the format of
+ * \a FFT_worker_rfft, and the spectra are scaled so that the inverse transform
+ * does not need normalisation.
+ *
+ * \param conv   The convolution processor -- must not be \c NULL.
+ * \param ch     The channel number -- must be \c 0 or \c 1.
+ *
+ * \return   The partition spectra, or \c NULL if there is no impulse response.
+ */
+const float* Proc_conv_get_ir_spectra(const Proc_conv* conv, int ch);
+
+
+#endif // KQT_PROC_CONV_H
+
+
@@ -67,6 +67,7 @@ MODULE_AU_KEYP(au_expressions,          "au_XX/p_expressions.json",
 
 MODULE_AU_KEYP(proc_manifest,           "au_XX/proc_XX/p_manifest.json",        "")
 MODULE_AU_KEYP(proc_signal_type,        "au_XX/proc_XX/p_signal_type.json",     "\"voice\"")
+MODULE_AU_KEYP(proc_control_period,     "au_XX/proc_XX/p_control_period.json",  "1")
 MODULE_AU_KEYP(proc_in_port_manifest,   "au_XX/proc_XX/in_XX/p_manifest.json",  "")
 MODULE_AU_KEYP(proc_out_port_manifest,  "au_XX/proc_XX/out_XX/p_manifest.json", "")
 MODULE_AU_KEYP(proc_impl_key,           "au_XX/proc_XX/i/",                     "")
@@ -15,262 +15,288 @@
 #include <init/sheet/Column.h>
 
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <mathnum/Tstamp.h>
 #include <memory.h>
 #include <player/Event_names.h>
 
-#include <inttypes.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdint.h>
-#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 
+/**
+ * All Column data is stored in the same memory block as the Column itself:
+ *
+ *   Tstamp positions[trigger_count]
+ *   int row_starts[trigger_count + 1]
+ *   Event_type types[trigger_count]
+ *   int desc_offsets[trigger_count]
+ *   char descs[descs_size]
+ *
+ * Each description in descs is null-terminated.
+ */
 struct Column
 {
     Tstamp len;
-    uint32_t version;
-    Column_iter* edit_iter;
-    AAtree* triggers;
+    int trigger_count;
+    int row_count;
+    Tstamp* positions;
+    int* row_starts;
+    Event_type* types;
+    int* desc_offsets;
+    char* descs;
 };
 
 
-static Trigger_list* new_Trigger_list(Trigger_list* nil, Trigger* trigger);
-
-static Trigger_list* Trigger_list_init(Trigger_list* trlist);
-
-static int Trigger_list_cmp(const Trigger_list* list1, const Trigger_list* list2);
-
-static void del_Trigger_list(Trigger_list* trlist);
-
-
-static Trigger_list* new_Trigger_list(Trigger_list* nil, Trigger* trigger)
+Column_iter* Column_iter_init(Column_iter* iter, const Column* col, int row)
 {
-    rassert(!(nil == NULL) || (trigger == NULL));
-    rassert(!(trigger == NULL) || (nil == NULL));
-
-    Trigger_list* trlist = memory_alloc_item(Trigger_list);
-    if (trlist == NULL)
-        return NULL;
+    rassert(iter != NULL);
+    rassert(col != NULL);
+    rassert(row >= 0);
+    rassert(row < col->row_count);
 
-    if (nil == NULL)
-    {
-        rassert(trigger == NULL);
-        trlist->trigger = NULL;
-        trlist->prev = trlist->next = trlist;
-    }
-    else
-    {
-        rassert(trigger != NULL);
-        trlist->trigger = trigger;
-        trlist->prev = trlist->next = nil;
-    }
+    iter->col = col;
+    iter->index = col->row_starts[row];
+    iter->stop = col->row_starts[row + 1];
 
-    return trlist;
+    return iter;
 }
 
 
-static Trigger_list* Trigger_list_init(Trigger_list* trlist)
+bool Column_iter_has_trigger(const Column_iter* iter)
 {
-    rassert(trlist != NULL);
-    trlist->prev = trlist->next = trlist;
-    return trlist;
+    rassert(iter != NULL);
+    return (iter->index < iter->stop);
 }
 
 
-static int Trigger_list_cmp(const Trigger_list* list1, const Trigger_list* list2)
+Event_type Column_iter_get_type(const Column_iter* iter)
 {
-    rassert(list1 != NULL);
-    rassert(list2 != NULL);
-
-    Trigger* ev1 = list1->next->trigger;
-    Trigger* ev2 = list2->next->trigger;
-    rassert(ev1 != NULL);
-    rassert(ev2 != NULL);
+    rassert(iter != NULL);
+    rassert(Column_iter_has_trigger(iter));
 
-    return Tstamp_cmp(Trigger_get_pos(ev1), Trigger_get_pos(ev2));
+    return iter->col->types[iter->index];
 }
 
 
-Column_iter* new_Column_iter(Column* col)
+const char* Column_iter_get_desc(const Column_iter* iter)
 {
-    Column_iter* iter = memory_alloc_item(Column_iter);
-    if (iter == NULL)
-        return NULL;
-
-    Column_iter_init(iter);
-
-    if (col != NULL)
-    {
-        iter->version = col->version;
-        iter->col = col;
-        iter->tree_iter.tree = col->triggers;
-    }
+    rassert(iter != NULL);
+    rassert(Column_iter_has_trigger(iter));
 
-    return iter;
+    return &iter->col->descs[iter->col->desc_offsets[iter->index]];
 }
 
 
-void Column_iter_init(Column_iter* iter)
+void Column_iter_next(Column_iter* iter)
 {
     rassert(iter != NULL);
+    rassert(Column_iter_has_trigger(iter));
 
-    iter->version = 0;
-    iter->col = NULL;
-    iter->tree_iter = *AAITER_AUTO;
-    iter->trlist = NULL;
+    ++iter->index;
 
     return;
 }
 
 
-void Column_iter_change_col(Column_iter* iter, Column* col)
+static Column* new_Column_with_size(const Tstamp* len, int trigger_count, int descs_size)
 {
-    rassert(iter != NULL);
-    rassert(col != NULL);
-
-    iter->col = col;
-    iter->version = col->version;
-    AAiter_init(&iter->tree_iter, col->triggers);
-    iter->trlist = NULL;
+    rassert(trigger_count >= 0);
+    rassert(descs_size >= 0);
+
+    const int64_t size =
+        (int64_t)sizeof(Column) +
+        (int64_t)sizeof(Tstamp) * trigger_count +
+        (int64_t)sizeof(int) * (trigger_count + 1) +
+        (int64_t)sizeof(Event_type) * trigger_count +
+        (int64_t)sizeof(int) * trigger_count +
+        descs_size;
+
+    char* block = memory_alloc(size);
+    if (block == NULL)
+        return NULL;
 
-    return;
-}
+    Column* col = (Column*)block;
+    block += sizeof(Column);
 
+    if (len != NULL)
+        Tstamp_copy(&col->len, len);
+    else
+        Tstamp_set(&col->len, INT64_MAX, 0);
 
-Trigger* Column_iter_get(Column_iter* iter, const Tstamp* pos)
-{
-    rassert(iter != NULL);
-    rassert(pos != NULL);
+    col->trigger_count = trigger_count;
+    col->row_count = 0;
 
-    iter->trlist = Column_iter_get_row(iter, pos);
-    if (iter->trlist == NULL)
-        return NULL;
+    col->positions = (Tstamp*)block;
+    block += sizeof(Tstamp) * (size_t)trigger_count;
+    col->row_starts = (int*)block;
+    block += sizeof(int) * (size_t)(trigger_count + 1);
+    col->types = (Event_type*)block;
+    block += sizeof(Event_type) * (size_t)trigger_count;
+    col->desc_offsets = (int*)block;
+    block += sizeof(int) * (size_t)trigger_count;
+    col->descs = block;
 
-    rassert(iter->trlist->trigger == NULL);
-    rassert(iter->trlist->next != iter->trlist);
-    iter->trlist = iter->trlist->next;
-    rassert(iter->trlist->trigger != NULL);
+    col->row_starts[0] = 0;
 
-    return iter->trlist->trigger;
+    return col;
 }
 
 
-Trigger_list* Column_iter_get_row(Column_iter* iter, const Tstamp* pos)
+Column* new_Column(const Tstamp* len)
 {
-    rassert(iter != NULL);
-    rassert(pos != NULL);
-
-    if (iter->col == NULL)
-        return NULL;
-
-    iter->version = iter->col->version;
-    Trigger* trigger = &(Trigger){ .type = Event_NONE };
-    Tstamp_copy(&trigger->pos, pos);
-    Trigger_list* key = Trigger_list_init(&(Trigger_list){ .trigger = trigger });
-    iter->trlist = AAiter_get_at_least(&iter->tree_iter, key);
-
-    return iter->trlist;
+    return new_Column_with_size(len, 0, 0);
 }
 
 
-Trigger* Column_iter_get_next(Column_iter* iter)
+typedef struct Trigger_stats
 {
-    rassert(iter != NULL);
-
-    if (iter->trlist == NULL || iter->col == NULL)
-        return NULL;
+    const Event_names* event_names;
+    int trigger_count;
+    int descs_size;
+} Trigger_stats;
 
-    if (iter->version != iter->col->version)
-    {
-        iter->trlist = NULL;
-        iter->version = iter->col->version;
-        return NULL;
-    }
+static bool count_trigger(Streader* sr, int32_t index, void* userdata)
+{
+    rassert(sr != NULL);
+    ignore(index);
+    rassert(userdata != NULL);
 
-    rassert(iter->trlist->trigger != NULL);
-    rassert(iter->trlist != iter->trlist->next);
+    Trigger_stats* stats = userdata;
 
-    iter->trlist = iter->trlist->next;
-    if (iter->trlist->trigger != NULL)
-        return iter->trlist->trigger;
+    Trigger* trigger = &(Trigger){ .desc = NULL };
+    if (!Trigger_read(trigger, sr, stats->event_names))
+        return false;
 
-    iter->trlist = Column_iter_get_next_row(iter);
-    if (iter->trlist == NULL)
-        return NULL;
+    if ((stats->trigger_count >= INT_MAX / 2) ||
+            (stats->descs_size > INT_MAX - trigger->desc_length - 1))
+    {
+        Streader_set_error(sr, "Too many triggers in a column");
+        return false;
+    }
 
-    rassert(iter->trlist->trigger == NULL);
-    rassert(iter->trlist->next != iter->trlist);
-    iter->trlist = iter->trlist->next;
-    rassert(iter->trlist->trigger != NULL);
+    ++stats->trigger_count;
+    stats->descs_size += trigger->desc_length + 1;
 
-    return iter->trlist->trigger;
+    return true;
 }
 
 
-Trigger_list* Column_iter_get_next_row(Column_iter* iter)
+typedef struct Read_trigger_data
 {
-    rassert(iter != NULL);
+    Column* col;
+    const Event_names* event_names;
+    int descs_used;
+} Read_trigger_data;
 
-    if (iter->trlist == NULL || iter->col == NULL)
-        return NULL;
+static bool read_trigger(Streader* sr, int32_t index, void* userdata)
+{
+    rassert(sr != NULL);
+    rassert(index >= 0);
+    rassert(userdata != NULL);
 
-    if (iter->version != iter->col->version)
-    {
-        iter->trlist = NULL;
-        iter->version = iter->col->version;
-        return NULL;
-    }
+    Read_trigger_data* rtdata = userdata;
+    Column* col = rtdata->col;
+    rassert(index < col->trigger_count);
+
+    Trigger* trigger = &(Trigger){ .desc = NULL };
+    if (!Trigger_read(trigger, sr, rtdata->event_names))
+        return false;
+
+    Tstamp_copy(&col->positions[index], &trigger->pos);
+    col->types[index] = trigger->type;
+    col->desc_offsets[index] = rtdata->descs_used;
 
-    iter->trlist = AAiter_get_next(&iter->tree_iter);
+    char* desc = &col->descs[rtdata->descs_used];
+    memcpy(desc, trigger->desc, (size_t)trigger->desc_length);
+    desc[trigger->desc_length] = '\0';
+    rtdata->descs_used += trigger->desc_length + 1;
 
-    return iter->trlist;
+    return true;
 }
 
 
-void del_Column_iter(Column_iter* iter)
+static bool Column_sort_triggers(Column* col)
 {
-    if (iter == NULL)
-        return;
+    rassert(col != NULL);
 
-    memory_free(iter);
-    return;
-}
+    const int count = col->trigger_count;
 
+    // Triggers are usually stored in order
+    bool is_sorted = true;
+    for (int i = 1; i < count; ++i)
+    {
+        if (Tstamp_cmp(&col->positions[i - 1], &col->positions[i]) > 0)
+        {
+            is_sorted = false;
+            break;
+        }
+    }
 
-static bool Column_parse(Column* col, Streader* sr, const Event_names* event_names);
+    if (is_sorted)
+        return true;
 
+    char* temp = memory_alloc(
+            (int64_t)(sizeof(Tstamp) + sizeof(Event_type) + sizeof(int) * 3) *
+            count);
+    if (temp == NULL)
+        return false;
 
-Column* new_Column(const Tstamp* len)
-{
-    Column* col = memory_alloc_item(Column);
-    if (col == NULL)
-        return NULL;
+    Tstamp* positions = (Tstamp*)temp;
+    Event_type* types = (Event_type*)(temp + sizeof(Tstamp) * (size_t)count);
+    int* desc_offsets = (int*)(types + count);
+    int* order = desc_offsets + count;
+    int* work = order + count;
 
-    col->version = 1;
-    col->triggers = new_AAtree(
-            (AAtree_item_cmp*)Trigger_list_cmp, (AAtree_item_destroy*)del_Trigger_list);
-    if (col->triggers == NULL)
+    // Sort trigger indices by position, retaining the order of simultaneous
+    // Triggers
+    for (int i = 0; i < count; ++i)
+        order[i] = i;
+
+    for (int width = 1; width < count; width *= 2)
     {
-        memory_free(col);
-        return NULL;
+        for (int start = 0; start < count; start += 2 * width)
+        {
+            const int middle = min(start + width, count);
+            const int stop = min(start + 2 * width, count);
+
+            int left = start;
+            int right = middle;
+            for (int i = start; i < stop; ++i)
+            {
+                if ((left < middle) && ((right >= stop) || (Tstamp_cmp(
+                                    &col->positions[order[left]],
+                                    &col->positions[order[right]]) <= 0)))
+                    work[i] = order[left++];
+                else
+                    work[i] = order[right++];
+            }
+        }
+
+        int* swap = order;
+        order = work;
+        work = swap;
     }
 
-    col->edit_iter = new_Column_iter(col);
-    if (col->edit_iter == NULL)
+    // Rearrange the Triggers
+    memcpy(positions, col->positions, sizeof(Tstamp) * (size_t)count);
+    memcpy(types, col->types, sizeof(Event_type) * (size_t)count);
+    memcpy(desc_offsets, col->desc_offsets, sizeof(int) * (size_t)count);
+
+    for (int i = 0; i < count; ++i)
     {
-        del_AAtree(col->triggers);
-        memory_free(col);
-        return NULL;
+        const int src = order[i];
+        Tstamp_copy(&col->positions[i], &positions[src]);
+        col->types[i] = types[src];
+        col->desc_offsets[i] = desc_offsets[src];
     }
 
-    if (len != NULL)
-        Tstamp_copy(&col->len, len);
-    else
-        Tstamp_set(&col->len, INT64_MAX, 0);
+    memory_free(temp);
 
-    return col;
+    return true;
 }
 
 
@@ -283,149 +309,89 @@ Column* new_Column_from_string(
     if (Streader_is_error_set(sr))
         return NULL;
 
-    Column* col = new_Column(len);
-    if (col == NULL)
-        return NULL;
-
-    if (!Column_parse(col, sr, event_names))
+    if (!Streader_has_data(sr))
     {
-        del_Column(col);
-        return NULL;
+        // An empty Column has no properties, so we're done.
+        return new_Column(len);
     }
 
-    return col;
-}
-
-
-typedef struct Read_trigger_data
-{
-    Column* col;
-    const Event_names* event_names;
-} Read_trigger_data;
-
-static bool read_trigger(Streader* sr, int32_t index, void* userdata)
-{
-    rassert(sr != NULL);
-    ignore(index);
-    rassert(userdata != NULL);
+    // Find out the amount of storage needed
+    const int64_t start_pos = sr->pos;
+    const int start_line = sr->line;
 
-    Read_trigger_data* rtdata = userdata;
+    Trigger_stats* stats = &(Trigger_stats)
+    {
+        .event_names = event_names,
+        .trigger_count = 0,
+        .descs_size = 0,
+    };
+    if (!Streader_read_list(sr, count_trigger, stats))
+        return NULL;
 
-    Trigger* trigger = new_Trigger_from_string(sr, rtdata->event_names);
-    if (trigger == NULL || !Column_ins(rtdata->col, trigger))
+    Column* col = new_Column_with_size(len, stats->trigger_count, stats->descs_size);
+    if (col == NULL)
     {
-        del_Trigger(trigger);
-        return false;
+        Streader_set_memory_error(sr, "Could not allocate memory for a column");
+        return NULL;
     }
 
-    return true;
-}
-
-static bool Column_parse(Column* col, Streader* sr, const Event_names* event_names)
-{
-    rassert(col != NULL);
-    rassert(sr != NULL);
-    rassert(event_names != NULL);
-
-    if (Streader_is_error_set(sr))
-        return false;
+    // Read the Triggers
+    sr->pos = start_pos;
+    sr->line = start_line;
 
-    if (!Streader_has_data(sr))
+    Read_trigger_data rtdata = { col, event_names, 0 };
+    if (!Streader_read_list(sr, read_trigger, &rtdata))
     {
-        // An empty Column has no properties, so we're done.
-        return true;
+        del_Column(col);
+        return NULL;
     }
+    rassert(rtdata.descs_used == stats->descs_size);
 
-    Read_trigger_data rtdata = { col, event_names };
-    return Streader_read_list(sr, read_trigger, &rtdata);
-}
-
-
-bool Column_ins(Column* col, Trigger* trigger)
-{
-    rassert(col != NULL);
-    rassert(trigger != NULL);
-
-    ++col->version;
-    Trigger_list* key = Trigger_list_init(&(Trigger_list){ .trigger = trigger });
-    Trigger_list* ret = AAtree_get_at_least(col->triggers, key);
-    if (ret == NULL || Tstamp_cmp(Trigger_get_pos(trigger),
-            Trigger_get_pos(ret->next->trigger)) != 0)
+    if (!Column_sort_triggers(col))
     {
-        Trigger_list* nil = new_Trigger_list(NULL, NULL);
-        if (nil == NULL)
-            return false;
-
-        Trigger_list* node = new_Trigger_list(nil, trigger);
-        if (node == NULL)
-        {
-            del_Trigger_list(nil);
-            return false;
-        }
-
-        nil->prev = nil->next = node;
-        node->prev = node->next = nil;
+        Streader_set_memory_error(sr, "Could not allocate memory for a column");
+        del_Column(col);
+        return NULL;
+    }
 
-        if (!AAtree_ins(col->triggers, nil))
+    // Find trigger rows
+    for (int i = 0; i < col->trigger_count; ++i)
+    {
+        if ((i == 0) || (Tstamp_cmp(&col->positions[i - 1], &col->positions[i]) != 0))
         {
-            del_Trigger_list(nil);
-            del_Trigger_list(node);
-            return false;
+            col->row_starts[col->row_count] = i;
+            ++col->row_count;
         }
-
-        return true;
     }
+    col->row_starts[col->row_count] = col->trigger_count;
 
-    rassert(ret->next != ret);
-    rassert(ret->prev != ret);
-    rassert(ret->trigger == NULL);
-
-    Trigger_list* node = new_Trigger_list(ret, trigger);
-    if (node == NULL)
-        return false;
+    return col;
+}
 
-    node->prev = ret->prev;
-    node->next = ret;
-    ret->prev->next = node;
-    ret->prev = node;
 
-    return true;
+int Column_get_row_count(const Column* col)
+{
+    rassert(col != NULL);
+    return col->row_count;
 }
 
 
-void del_Column(Column* col)
+const Tstamp* Column_get_row_pos(const Column* col, int row)
 {
-    if (col == NULL)
-        return;
-
-    del_AAtree(col->triggers);
-    del_Column_iter(col->edit_iter);
-    memory_free(col);
+    rassert(col != NULL);
+    rassert(row >= 0);
+    rassert(row < col->row_count);
 
-    return;
+    return &col->positions[col->row_starts[row]];
 }
 
 
-static void del_Trigger_list(Trigger_list* trlist)
+void del_Column(Column* col)
 {
-    if (trlist == NULL)
+    if (col == NULL)
         return;
 
-    rassert(trlist->trigger == NULL);
-    Trigger_list* cur = trlist->next;
-    rassert(cur->trigger != NULL);
-
-    while (cur->trigger != NULL)
-    {
-        Trigger_list* next = cur->next;
-        rassert(cur->trigger != NULL);
-        del_Trigger(cur->trigger);
-        memory_free(cur);
-        cur = next;
-    }
-
-    rassert(cur == trlist);
-    memory_free(cur);
+    memory_free(col);
 
     return;
 }
@@ -16,10 +16,10 @@
 #define KQT_COLUMN_H
 
 
-#include <containers/AAtree.h>
 #include <init/sheet/Trigger.h>
 #include <mathnum/Tstamp.h>
 #include <player/Event_names.h>
+#include <player/Event_type.h>
 #include <string/Streader.h>
 
 #include <stdbool.h>
@@ -27,98 +27,84 @@
 #include <stdlib.h>
 
 
-typedef struct Trigger_list
-{
-    Trigger* trigger;
-    struct Trigger_list* prev;
-    struct Trigger_list* next;
-} Trigger_list;
-
-
 /**
  * Column is a container for Triggers in a Pattern. It contains a
  * "monophonic" section of music.
+ *
+ * The Triggers are stored in contiguous arrays sorted by position, and the
+ * contents of a Column cannot be changed after creation. Triggers located at
+ * the same position form a trigger row.
  */
 typedef struct Column Column;
 
 
 /**
- * Column_iter is used for retrieving Triggers from a Column.
+ * Column_iter is used for retrieving the Triggers of a trigger row.
  */
 typedef struct Column_iter
 {
-    uint32_t version;
-    Column* col;
-    AAiter tree_iter;
-    Trigger_list* trlist;
+    const Column* col;
+    int index;
+    int stop;
 } Column_iter;
 
 
-/**
- * Create a new Column iterator.
- *
- * \param col   The Column associated with the iterator, or \c NULL if memory
- *              allocation failed.
- */
-Column_iter* new_Column_iter(Column* col);
+#define COLUMN_ITER_AUTO (&(Column_iter){ .col = NULL, .index = 0, .stop = 0 })
 
 
 /**
  * Initialise a Column iterator.
  *
  * \param iter   The Column iterator -- must not be \c NULL.
+ * \param col    The Column -- must not be \c NULL.
+ * \param row    The trigger row index -- must be >= \c 0 and less than the
+ *               row count of \a col.
+ *
+ * \return   The parameter \a iter.
  */
-void Column_iter_init(Column_iter* iter);
+Column_iter* Column_iter_init(Column_iter* iter, const Column* col, int row);
 
 
 /**
- * Change the Column associated with the Column iterator.
+ * Check if the Column iterator points at a Trigger.
  *
  * \param iter   The Column iterator -- must not be \c NULL.
- * \param col    The Column -- must not be \c NULL.
+ *
+ * \return   \c true if a Trigger is available, or \c false if the end of the
+ *           trigger row has been reached.
  */
-void Column_iter_change_col(Column_iter* iter, Column* col);
+bool Column_iter_has_trigger(const Column_iter* iter);
 
 
 /**
- * Get a Trigger from the Column.
- *
- * The first Trigger with position greater than or equal to the given position
- * will be returned.
+ * Get the event type of the current Trigger.
  *
- * \param iter   The Column iterator -- must not be \c NULL.
- * \param pos    The position of the Trigger -- must not be \c NULL.
+ * \param iter   The Column iterator -- must not be \c NULL and must point
+ *               at a Trigger.
  *
- * \return   The Trigger if one exists, otherwise \c NULL.
+ * \return   The event type.
  */
-Trigger* Column_iter_get(Column_iter* iter, const Tstamp* pos);
-
-
-Trigger_list* Column_iter_get_row(Column_iter* iter, const Tstamp* pos);
+Event_type Column_iter_get_type(const Column_iter* iter);
 
 
 /**
- * Get the Trigger next to the previous Trigger retrieved from the Column.
- *
- * If not preceded by a successful call to Column_iter_get(), \c NULL will be
- * returned.
+ * Get the JSON description of the current Trigger.
  *
- * \param iter   The Column iterator -- must not be \c NULL.
+ * \param iter   The Column iterator -- must not be \c NULL and must point
+ *               at a Trigger.
  *
- * \return   The Trigger if one exists, otherwise \c NULL.
+ * \return   The description (does not include timestamp).
  */
-Trigger* Column_iter_get_next(Column_iter* iter);
-
-
-Trigger_list* Column_iter_get_next_row(Column_iter* iter);
+const char* Column_iter_get_desc(const Column_iter* iter);
 
 
 /**
- * Destroy an existing Column iterator.
+ * Move the Column iterator to the next Trigger in the trigger row.
  *
- * \param iter   The Column iterator -- must not be \c NULL.
+ * \param iter   The Column iterator -- must not be \c NULL and must point
+ *               at a Trigger.
  */
-void del_Column_iter(Column_iter* iter);
+void Column_iter_next(Column_iter* iter);
 
 
 /**
@@ -148,17 +134,25 @@ Column* new_Column_from_string(
 
 
 /**
- * Insert a new Trigger into the Column.
+ * Get the number of trigger rows in the Column.
+ *
+ * \param col   The Column -- must not be \c NULL.
  *
- * If other Triggers are already located at the target position, the new Trigger
- * will be placed after these Triggers.
+ * \return   The number of trigger rows.
+ */
+int Column_get_row_count(const Column* col);
+
+
+/**
+ * Get the position of a trigger row in the Column.
  *
- * \param col       The Column -- must not be \c NULL.
- * \param trigger   The Trigger -- must not be \c NULL.
+ * \param col   The Column -- must not be \c NULL.
+ * \param row   The trigger row index -- must be >= \c 0 and less than the
+ *              row count of \a col.
  *
- * \return   \c true if successful, or \c false if memory allocation failed.
+ * \return   The position of the trigger row.
  */
-bool Column_ins(Column* col, Trigger* trigger);
+const Tstamp* Column_get_row_pos(const Column* col, int row);
 
 
 /**
@@ -177,14 +177,10 @@ bool Order_list_contains_pat_inst_ref(const Order_list* ol, const Pat_inst_ref*
     rassert(ol != NULL);
     rassert(piref != NULL);
 
-    for (int64_t i = 0; i < Vector_size(ol->pat_insts); ++i)
-    {
-        const Pat_inst_ref* cur_piref = Vector_get_ref(ol->pat_insts, i);
-        if (Pat_inst_ref_cmp(cur_piref, piref) == 0)
-            return true;
-    }
+    Index_mapping* key = INDEX_MAPPING_AUTO;
+    key->p = *piref;
 
-    return false;
+    return AAtree_contains(ol->index_map, key);
 }
 
 
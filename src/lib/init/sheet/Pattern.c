@@ -32,6 +32,9 @@ struct Pattern
     Column* cols[KQT_COLUMNS_MAX];
     Tstamp length;
     Bit_array* existents;
+
+    int row_count;
+    Pattern_row* rows;
 };
 
 
@@ -44,6 +47,8 @@ Pattern* new_Pattern(void)
     for (int i = 0; i < KQT_COLUMNS_MAX; ++i)
         pat->cols[i] = NULL;
     pat->existents = NULL;
+    pat->row_count = 0;
+    pat->rows = NULL;
 
     for (int i = 0; i < KQT_COLUMNS_MAX; ++i)
     {
@@ -115,6 +120,24 @@ bool Pattern_get_inst_existent(const Pattern* pat, int index)
 }
 
 
+static int row_location_cmp(
+        const Tstamp* pos1, int ch1, const Tstamp* pos2, int ch2)
+{
+    rassert(pos1 != NULL);
+    rassert(pos2 != NULL);
+
+    const int pos_cmp = Tstamp_cmp(pos1, pos2);
+    if (pos_cmp != 0)
+        return pos_cmp;
+
+    if (ch1 < ch2)
+        return -1;
+    else if (ch1 > ch2)
+        return 1;
+    return 0;
+}
+
+
 bool Pattern_set_column(Pattern* pat, int index, Column* col)
 {
     rassert(pat != NULL);
@@ -122,6 +145,63 @@ bool Pattern_set_column(Pattern* pat, int index, Column* col)
     rassert(index < KQT_COLUMNS_MAX);
     rassert(col != NULL);
 
+    // Count the rows of the new timeline
+    const int col_row_count = Column_get_row_count(col);
+
+    int replaced_row_count = 0;
+    for (int i = 0; i < pat->row_count; ++i)
+    {
+        if (pat->rows[i].ch == index)
+            ++replaced_row_count;
+    }
+
+    const int new_row_count = pat->row_count - replaced_row_count + col_row_count;
+    Pattern_row* new_rows = NULL;
+    if (new_row_count > 0)
+    {
+        new_rows = memory_alloc_items(Pattern_row, new_row_count);
+        if (new_rows == NULL)
+            return false;
+    }
+
+    // Merge the rows of the new Column with the rows of other Columns
+    int col_row = 0;
+    int old_index = 0;
+    for (int new_index = 0; new_index < new_row_count; ++new_index)
+    {
+        while (old_index < pat->row_count && pat->rows[old_index].ch == index)
+            ++old_index;
+
+        const Pattern_row* old_row =
+            (old_index < pat->row_count) ? &pat->rows[old_index] : NULL;
+
+        Pattern_row* new_row = &new_rows[new_index];
+
+        if (col_row < col_row_count && (old_row == NULL ||
+                    row_location_cmp(
+                        Column_get_row_pos(col, col_row),
+                        index,
+                        &old_row->pos,
+                        old_row->ch) < 0))
+        {
+            Tstamp_copy(&new_row->pos, Column_get_row_pos(col, col_row));
+            new_row->ch = index;
+            new_row->col = col;
+            new_row->col_row = col_row;
+            ++col_row;
+        }
+        else
+        {
+            rassert(old_row != NULL);
+            *new_row = *old_row;
+            ++old_index;
+        }
+    }
+
+    memory_free(pat->rows);
+    pat->rows = new_rows;
+    pat->row_count = new_row_count;
+
     Column* old_col = pat->cols[index];
     pat->cols[index] = col;
     del_Column(old_col);
@@ -140,6 +220,45 @@ Column* Pattern_get_column(const Pattern* pat, int index)
 }
 
 
+int Pattern_get_row_count(const Pattern* pat)
+{
+    rassert(pat != NULL);
+    return pat->row_count;
+}
+
+
+const Pattern_row* Pattern_get_row(const Pattern* pat, int index)
+{
+    rassert(pat != NULL);
+    rassert(index >= 0);
+    rassert(index < pat->row_count);
+
+    return &pat->rows[index];
+}
+
+
+int Pattern_find_row(const Pattern* pat, const Tstamp* pos, int ch)
+{
+    rassert(pat != NULL);
+    rassert(pos != NULL);
+    rassert(ch >= 0);
+
+    int start = 0;
+    int stop = pat->row_count;
+    while (start < stop)
+    {
+        const int middle = start + (stop - start) / 2;
+        const Pattern_row* row = &pat->rows[middle];
+        if (row_location_cmp(&row->pos, row->ch, pos, ch) < 0)
+            start = middle + 1;
+        else
+            stop = middle;
+    }
+
+    return start;
+}
+
+
 const Tstamp* Pattern_get_length(const Pattern* pat)
 {
     rassert(pat != NULL);
@@ -156,6 +275,7 @@ void del_Pattern(Pattern* pat)
         del_Column(pat->cols[i]);
 
     del_Bit_array(pat->existents);
+    memory_free(pat->rows);
     memory_free(pat);
 
     return;
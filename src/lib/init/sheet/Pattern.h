@@ -35,6 +35,20 @@ typedef struct Pattern Pattern;
 #define PATTERN_DEFAULT_LENGTH (Tstamp_set(TSTAMP_AUTO, 16, 0))
 
 
+/**
+ * A trigger row in the merged timeline of all Columns in a Pattern.
+ *
+ * The timeline is sorted by position and then by channel.
+ */
+typedef struct Pattern_row
+{
+    Tstamp pos;
+    int ch;
+    const Column* col;
+    int col_row;
+} Pattern_row;
+
+
 /**
  * Create a new Pattern object.
  *
@@ -104,6 +118,42 @@ bool Pattern_set_column(Pattern* pat, int index, Column* col);
 Column* Pattern_get_column(const Pattern* pat, int index);
 
 
+/**
+ * Get the number of trigger rows in the Pattern.
+ *
+ * \param pat   The Pattern -- must not be \c NULL.
+ *
+ * \return   The total number of trigger rows in all Columns of \a pat.
+ */
+int Pattern_get_row_count(const Pattern* pat);
+
+
+/**
+ * Get a trigger row from the timeline of the Pattern.
+ *
+ * \param pat     The Pattern -- must not be \c NULL.
+ * \param index   The row index -- must be >= \c 0 and less than the row
+ *                count of \a pat.
+ *
+ * \return   The trigger row.
+ */
+const Pattern_row* Pattern_get_row(const Pattern* pat, int index);
+
+
+/**
+ * Find the first trigger row located at or after the given position.
+ *
+ * \param pat   The Pattern -- must not be \c NULL.
+ * \param pos   The position -- must not be \c NULL.
+ * \param ch    The first channel included at \a pos -- must be >= \c 0.
+ *
+ * \return   The index of the first row with position > \a pos, or position
+ *           equal to \a pos and channel >= \a ch. If no such row exists,
+ *           the row count of \a pat is returned.
+ */
+int Pattern_find_row(const Pattern* pat, const Tstamp* pos, int ch);
+
+
 /**
  * Get the length of the Pattern.
  *
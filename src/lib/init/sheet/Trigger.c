@@ -16,41 +16,26 @@
 
 #include <debug/assert.h>
 #include <kunquat/limits.h>
-#include <memory.h>
 
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
-#include <string.h>
 
 
-Trigger* new_Trigger(Event_type type, Tstamp* pos)
-{
-    rassert(Event_is_valid(type));
-    rassert(pos != NULL);
-
-    Trigger* trigger = memory_alloc_item(Trigger);
-    if (trigger == NULL)
-        return NULL;
-
-    trigger->type = type;
-    Tstamp_copy(&trigger->pos, pos);
-    trigger->desc = NULL;
-
-    return trigger;
-}
-
-
-Trigger* new_Trigger_from_string(Streader* sr, const Event_names* names)
+bool Trigger_read(Trigger* trigger, Streader* sr, const Event_names* names)
 {
+    rassert(trigger != NULL);
     rassert(sr != NULL);
     rassert(names != NULL);
 
     if (Streader_is_error_set(sr))
-        return NULL;
+        return false;
 
     // Trigger position
     Tstamp* pos = TSTAMP_AUTO;
     if (!Streader_readf(sr, "[%t,[", pos))
-        return NULL;
+        return false;
 
     // Store event description location for copying
     const char* event_desc = &sr->str[sr->pos - 1];
@@ -59,14 +44,14 @@ Trigger* new_Trigger_from_string(Streader* sr, const Event_names* names)
     char type_str[EVENT_NAME_MAX + 2] = "";
     if (!(Streader_read_string(sr, EVENT_NAME_MAX + 2, type_str) &&
                 Streader_match_char(sr, ',')))
-        return NULL;
+        return false;
 
     Event_type type = Event_names_get(names, type_str);
     if (!Event_is_trigger(type))
     {
         Streader_set_error(
                 sr, "Invalid or unsupported event type: \"%s\"", type_str);
-        return NULL;
+        return false;
     }
 
     // Event argument
@@ -90,76 +75,31 @@ Trigger* new_Trigger_from_string(Streader* sr, const Event_names* names)
         Streader_read_string(sr, 0, NULL);
     }
     if (Streader_is_error_set(sr))
-        return NULL;
+        return false;
 
     // End of event description
     Streader_match_char(sr, ']');
     if (Streader_is_error_set(sr))
-        return NULL;
+        return false;
 
-    // Create the trigger
-    Trigger* trigger = new_Trigger(type, pos);
-    if (trigger == NULL)
+    const int64_t desc_length = &sr->str[sr->pos] - event_desc;
+    if (desc_length > INT_MAX)
     {
-        Streader_set_memory_error(
-                sr, "Could not allocate memory for a trigger");
-        return NULL;
+        Streader_set_error(sr, "Event description is too long");
+        return false;
     }
 
-    // Copy the event description
-    trigger->desc = memory_calloc_items(
-            char, (&sr->str[sr->pos] - event_desc) + 1);
-    if (trigger->desc == NULL)
-    {
-        del_Trigger(trigger);
-        return NULL;
-    }
-
-    strncpy(trigger->desc, event_desc, (size_t)(&sr->str[sr->pos] - event_desc));
-
     // End of trigger
     Streader_match_char(sr, ']');
     if (Streader_is_error_set(sr))
-    {
-        del_Trigger(trigger);
-        return NULL;
-    }
-
-    return trigger;
-}
-
+        return false;
 
-const Tstamp* Trigger_get_pos(const Trigger* trigger)
-{
-    rassert(trigger != NULL);
-    return &trigger->pos;
-}
-
-
-Event_type Trigger_get_type(const Trigger* trigger)
-{
-    rassert(trigger != NULL);
-    return trigger->type;
-}
-
-
-const char* Trigger_get_desc(const Trigger* trigger)
-{
-    rassert(trigger != NULL);
-    return trigger->desc;
-}
-
-
-void del_Trigger(Trigger* trigger)
-{
-    if (trigger == NULL)
-        return;
-
-    rassert(Event_is_valid(trigger->type));
-    memory_free(trigger->desc);
-    memory_free(trigger);
+    Tstamp_copy(&trigger->pos, pos);
+    trigger->type = type;
+    trigger->desc = event_desc;
+    trigger->desc_length = (int)desc_length;
 
-    return;
+    return true;
 }
 
 
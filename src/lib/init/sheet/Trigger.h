@@ -22,80 +22,35 @@
 #include <player/Event_type.h>
 #include <string/Streader.h>
 
+#include <stdbool.h>
 #include <stdlib.h>
 
 
 /**
  * Trigger causes firing of an event at a specified location.
+ *
+ * A Trigger read from JSON data refers to its description in the source
+ * string, so the description must be copied before the source is released.
  */
 typedef struct Trigger
 {
     Tstamp pos;         ///< The Trigger position.
-    int ch_index;       ///< Channel number.
     Event_type type;    ///< The event type.
-    char* desc;         ///< Trigger description in JSON format.
+    const char* desc;   ///< Trigger description in JSON format (not terminated).
+    int desc_length;    ///< The length of the description in bytes.
 } Trigger;
 
 
 /**
- * Create a Trigger of specified type.
- *
- * \param type   The event type -- must be valid.
- * \param pos    The Trigger position -- must not be \c NULL.
- *
- * \return   The new Trigger if successful, or \c NULL if memory allocation
- *           failed or the event type isn't supported.
- */
-Trigger* new_Trigger(Event_type type, Tstamp* pos);
-
-
-/**
- * Create a Trigger from a JSON string.
- *
- * \param sr      The Streader of the data -- must not be \c NULL.
- * \param names   The Event names -- must not be \c NULL.
- *
- * \return   The new Trigger if successful, otherwise \c NULL.
- */
-Trigger* new_Trigger_from_string(Streader* sr, const Event_names* names);
-
-
-/**
- * Get the Trigger position (relative to the containing Pattern).
- *
- * \param trigger   The Trigger -- must not be \c NULL.
- *
- * \return   The position.
- */
-const Tstamp* Trigger_get_pos(const Trigger* trigger);
-
-
-/**
- * Get the event type of the Trigger.
+ * Read a Trigger from a JSON string.
  *
- * \param trigger   The Trigger -- must not be \c NULL.
- *
- * \return   The event type.
- */
-Event_type Trigger_get_type(const Trigger* trigger);
-
-
-/**
- * Get a JSON description of the Trigger (does not include timestamp).
- *
- * \param trigger   The Trigger -- must not be \c NULL.
- *
- * \return   The JSON string.
- */
-const char* Trigger_get_desc(const Trigger* trigger);
-
-
-/**
- * Destroy an existing Trigger.
+ * \param trigger   The Trigger to be filled -- must not be \c NULL.
+ * \param sr        The Streader of the data -- must not be \c NULL.
+ * \param names     The Event names -- must not be \c NULL.
  *
- * \param trigger   The Trigger, or \c NULL.
+ * \return   \c true if successful, otherwise \c false.
  */
-void del_Trigger(Trigger* trigger);
+bool Trigger_read(Trigger* trigger, Streader* sr, const Event_names* names);
 
 
 #endif // KQT_TRIGGER_H
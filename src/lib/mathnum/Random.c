@@ -15,9 +15,11 @@
 #include <mathnum/Random.h>
 
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <mathnum/hmac.h>
 
 #include <float.h>
+#include <math.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -63,13 +65,22 @@ void Random_reset(Random* random)
 }
 
 
+// Multiplier and increment from Knuth
+#define RANDOM_MUL 6364136223846793005ULL
+#define RANDOM_INC 1442695040888963407ULL
+
+
+static uint64_t get_next_state(uint64_t state)
+{
+    return RANDOM_MUL * state + RANDOM_INC;
+}
+
+
 uint64_t Random_get_uint64(Random* random)
 {
     rassert(random != NULL);
 
-    // multiplier and increment from Knuth
-    random->state = 6364136223846793005ULL * random->state +
-                    1442695040888963407ULL;
+    random->state = get_next_state(random->state);
 
     return random->state;
 }
@@ -108,18 +119,164 @@ double Random_get_float_scale(Random* random)
 }
 
 
+static const int64_t SIGNAL_MAX_VAL_ABS = (DOUBLE_LIMIT >> 1) - 1;
+
+
+static double get_signal(uint64_t state)
+{
+    // Get random value in range [-max_val_abs, max_val_abs]
+    int64_t bits = (int64_t)(state >> EXCESS_DOUBLE_BITS);
+    bits &= ~(int64_t)1;
+    bits -= SIGNAL_MAX_VAL_ABS;
+
+    return (double)bits / (double)SIGNAL_MAX_VAL_ABS;
+}
+
+
 double Random_get_float_signal(Random* random)
 {
     rassert(random != NULL);
+    return get_signal(Random_get_uint64(random));
+}
 
-    static const int64_t max_val_abs = (DOUBLE_LIMIT >> 1) - 1;
 
-    // Get random value in range [-max_val_abs, max_val_abs]
-    int64_t bits = (int64_t)(Random_get_uint64(random) >> EXCESS_DOUBLE_BITS);
-    bits &= ~(int64_t)1;
-    bits -= max_val_abs;
+/*
+ * The block functions run RANDOM_LANES interleaved copies of the generator.
+ * Each lane advances RANDOM_LANES steps at a time, which produces the same
+ * sequence as the serial generator without a dependency between
+ * consecutive values.
+ */
+
+#define RANDOM_LANES 8
+
+
+typedef struct Random_lanes
+{
+    uint64_t mul;
+    uint64_t inc;
+    uint64_t states[RANDOM_LANES];
+} Random_lanes;
+
+
+static void Random_lanes_init(Random_lanes* lanes, uint64_t state)
+{
+    rassert(lanes != NULL);
+
+    // Get the coefficients of RANDOM_LANES consecutive steps
+    lanes->mul = 1;
+    lanes->inc = 0;
+    for (int i = 0; i < RANDOM_LANES; ++i)
+    {
+        lanes->mul *= RANDOM_MUL;
+        lanes->inc = RANDOM_MUL * lanes->inc + RANDOM_INC;
+    }
+
+    for (int lane = 0; lane < RANDOM_LANES; ++lane)
+    {
+        state = get_next_state(state);
+        lanes->states[lane] = state;
+    }
+
+    return;
+}
 
-    return (double)bits / (double)max_val_abs;
+
+static void Random_lanes_step(Random_lanes* lanes)
+{
+    rassert(lanes != NULL);
+
+    for (int lane = 0; lane < RANDOM_LANES; ++lane)
+        lanes->states[lane] = lanes->mul * lanes->states[lane] + lanes->inc;
+
+    return;
+}
+
+
+void Random_fill_float_signal(Random* random, float* values, int32_t count)
+{
+    rassert(random != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    int32_t i = 0;
+
+    if (count >= RANDOM_LANES)
+    {
+        Random_lanes* lanes = &(Random_lanes){ .mul = 0 };
+        Random_lanes_init(lanes, random->state);
+
+        for (; i + RANDOM_LANES <= count; i += RANDOM_LANES)
+        {
+            for (int lane = 0; lane < RANDOM_LANES; ++lane)
+                values[i + lane] = (float)get_signal(lanes->states[lane]);
+
+            random->state = lanes->states[RANDOM_LANES - 1];
+            Random_lanes_step(lanes);
+        }
+    }
+
+    for (; i < count; ++i)
+        values[i] = (float)Random_get_float_signal(random);
+
+    return;
+}
+
+
+#define EXCESS_FLOAT_BITS (64 - FLT_MANT_DIG)
+#define FLOAT_LIMIT ((int64_t)1 << FLT_MANT_DIG)
+
+
+static float get_float_lb(uint64_t state)
+{
+    // Use only as many bits as we can represent exactly to stay below 1
+    return (float)(state >> EXCESS_FLOAT_BITS) / (float)FLOAT_LIMIT;
+}
+
+
+void Random_fill_float_gaussian(Random* random, float* values, int32_t count)
+{
+    rassert(random != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    // Get uniform values in the range [0, 1)
+    int32_t i = 0;
+
+    if (count >= RANDOM_LANES)
+    {
+        Random_lanes* lanes = &(Random_lanes){ .mul = 0 };
+        Random_lanes_init(lanes, random->state);
+
+        for (; i + RANDOM_LANES <= count; i += RANDOM_LANES)
+        {
+            for (int lane = 0; lane < RANDOM_LANES; ++lane)
+                values[i + lane] = get_float_lb(lanes->states[lane]);
+
+            random->state = lanes->states[RANDOM_LANES - 1];
+            Random_lanes_step(lanes);
+        }
+    }
+
+    for (; i < count; ++i)
+        values[i] = get_float_lb(Random_get_uint64(random));
+
+    // Apply the Box-Muller transform to pairs of uniform values
+    for (i = 0; i + 1 < count; i += 2)
+    {
+        const double radius = sqrt(-2.0 * log(1.0 - values[i]));
+        const double angle = PI2 * values[i + 1];
+        values[i] = (float)(radius * cos(angle));
+        values[i + 1] = (float)(radius * sin(angle));
+    }
+
+    if (i < count)
+    {
+        const double radius = sqrt(-2.0 * log(1.0 - values[i]));
+        const double angle = PI2 * Random_get_float_lb(random);
+        values[i] = (float)(radius * cos(angle));
+    }
+
+    return;
 }
 
 
@@ -152,6 +152,32 @@ double Random_get_float_scale(Random* random);
 double Random_get_float_signal(Random* random);
 
 
+/**
+ * Fill a buffer with floating point numbers in the range [-1.0, 1.0].
+ *
+ * The values are the same as those returned by consecutive calls of
+ * \a Random_get_float_signal, but several steps of the generator are
+ * calculated in parallel.
+ *
+ * \param random   The Random generator -- must not be \c NULL.
+ * \param values   The destination buffer -- must not be \c NULL.
+ * \param count    The number of values to generate -- must be >= \c 0.
+ */
+void Random_fill_float_signal(Random* random, float* values, int32_t count);
+
+
+/**
+ * Fill a buffer with normally distributed floating point numbers.
+ *
+ * The values have zero mean and unit variance.
+ *
+ * \param random   The Random generator -- must not be \c NULL.
+ * \param values   The destination buffer -- must not be \c NULL.
+ * \param count    The number of values to generate -- must be >= \c 0.
+ */
+void Random_fill_float_gaussian(Random* random, float* values, int32_t count);
+
+
 #endif // KQT_RANDOM_H
 
 
@@ -15,8 +15,11 @@
 #include <mathnum/conversions.h>
 
 #include <debug/assert.h>
+#include <mathnum/fast_math.h>
 
 #include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
 
 
 double dB_to_scale(double dB)
@@ -26,6 +29,18 @@ double dB_to_scale(double dB)
 }
 
 
+void fast_dB_to_scale_array(float* scales, const float* dBs, int32_t count)
+{
+    rassert(scales != NULL);
+    rassert(dBs != NULL);
+    rassert(count >= 0);
+
+    fast_exp2_array(scales, dBs, count, 1.0 / 6.0, 1, FAST_MATH_ACCURACY_APPROX);
+
+    return;
+}
+
+
 double scale_to_dB(double scale)
 {
     rassert(scale >= 0);
@@ -33,6 +48,18 @@ double scale_to_dB(double scale)
 }
 
 
+void fast_scale_to_dB_array(float* dBs, const float* scales, int32_t count)
+{
+    rassert(dBs != NULL);
+    rassert(scales != NULL);
+    rassert(count >= 0);
+
+    fast_log2_array(dBs, scales, count, 6, FAST_MATH_ACCURACY_APPROX);
+
+    return;
+}
+
+
 double cents_to_Hz(double cents)
 {
     rassert(isfinite(cents));
@@ -40,3 +67,15 @@ double cents_to_Hz(double cents)
 }
 
 
+void fast_cents_to_Hz_array(float* Hz, const float* cents, int32_t count)
+{
+    rassert(Hz != NULL);
+    rassert(cents != NULL);
+    rassert(count >= 0);
+
+    fast_exp2_array(Hz, cents, count, 1.0 / 1200.0, 440, FAST_MATH_ACCURACY_APPROX);
+
+    return;
+}
+
+
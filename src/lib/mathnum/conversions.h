@@ -21,6 +21,7 @@
 #include <mathnum/fast_log2.h>
 
 #include <math.h>
+#include <stdint.h>
 
 
 /**
@@ -51,6 +52,18 @@ static inline double fast_dB_to_scale(double dB)
 }
 
 
+/**
+ * Convert an array of dB values to scale factors using fast approximation.
+ *
+ * \param scales   The destination array -- must not be \c NULL.
+ *                 This may be the same as \a dBs.
+ * \param dBs      The values in dB -- must not be \c NULL. All values must
+ *                 be finite or \c -INFINITY.
+ * \param count    The number of values -- must be >= \c 0.
+ */
+void fast_dB_to_scale_array(float* scales, const float* dBs, int32_t count);
+
+
 /**
  * Convert the given scale value to dB.
  *
@@ -78,6 +91,18 @@ static inline double fast_scale_to_dB(double scale)
 }
 
 
+/**
+ * Convert an array of scale values to dB using fast approximation.
+ *
+ * \param dBs      The destination array -- must not be \c NULL.
+ *                 This may be the same as \a scales.
+ * \param scales   The scale values -- must not be \c NULL. All values must
+ *                 be finite and >= \c 0.
+ * \param count    The number of values -- must be >= \c 0.
+ */
+void fast_scale_to_dB_array(float* dBs, const float* scales, int32_t count);
+
+
 /**
  * Convert the given pitch from cents to Hz.
  *
@@ -104,6 +129,18 @@ static inline double fast_cents_to_Hz(double cents)
 }
 
 
+/**
+ * Convert an array of pitches from cents to Hz using fast approximation.
+ *
+ * \param Hz      The destination array -- must not be \c NULL.
+ *                This may be the same as \a cents.
+ * \param cents   The cents values -- must not be \c NULL. All values must be
+ *                finite or NaN, the latter of which are converted to \c 0.
+ * \param count   The number of values -- must be >= \c 0.
+ */
+void fast_cents_to_Hz_array(float* Hz, const float* cents, int32_t count);
+
+
 #endif // KQT_CONVERSIONS_H
 
 
@@ -0,0 +1,287 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <mathnum/fast_math.h>
+
+#include <debug/assert.h>
+#include <mathnum/common.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * The approximations below are restatements of fast_exp2, fast_log2 and
+ * fast_sin that avoid library calls, table gathers and data-dependent
+ * branches so that the compiler can vectorise the loops. They produce the
+ * same results as the scalar versions, which is verified in the tests.
+ *
+ * The arrays are processed in blocks, and each block is processed in stages
+ * that are kept in separate loops. This way the selections in each stage
+ * remain simple enough for the compiler to turn them into vector blends.
+ */
+
+
+#define BLOCK_SIZE 32
+
+
+// Keeps the exponent of the exp2 result within the range of normal doubles
+#define EXP2_ARG_BOUND 1020.0
+
+
+static void get_exp2_args(double* args, const float* src, int32_t count, double in_mul)
+{
+    for (int32_t i = 0; i < count; ++i)
+    {
+        double x = in_mul * src[i];
+
+        // NOTE: The comparisons are false for NaN, which becomes -EXP2_ARG_BOUND
+        x = isgreater(x, -EXP2_ARG_BOUND) ? x : -EXP2_ARG_BOUND;
+        x = isless(x, EXP2_ARG_BOUND) ? x : EXP2_ARG_BOUND;
+
+        args[i] = x;
+    }
+
+    return;
+}
+
+
+#define EXP2_K 3
+#define EXP2_N (1 << EXP2_K)
+#define EXP2_L 0.49278062009491144505781798
+#define EXP2_A 11.5415603271117072588793974
+
+
+// Adding this value rounds a double of small magnitude to an integer that is
+// readable from the low bits of the sum
+#define ROUND_MAGIC 6755399441055744.0 // 1.5 * 2^52
+
+
+static double approx_exp2(double x)
+{
+    static const double b[EXP2_N] =
+    {
+        0.0866433975699931636771540,
+        0.0944852950344677400302341,
+        0.1030369448582453432116499,
+        0.1123625851181203074735361,
+        0.1225322679335683989642377,
+        0.1336223856825675311641740,
+        0.1457162448440193058635239,
+        0.1589046917773470349548137
+    };
+
+    x *= EXP2_N;
+
+    // Calculate j = floor(x + L)
+    const double shifted = x + EXP2_L;
+    const double rounded_magic = shifted + ROUND_MAGIC;
+    const double rounded = rounded_magic - ROUND_MAGIC;
+    uint64_t rounded_bits = 0;
+    memcpy(&rounded_bits, &rounded_magic, sizeof(double));
+    const uint64_t floor_bits =
+        isgreater(rounded, shifted) ? rounded_bits - 1 : rounded_bits;
+    const int32_t j = (int32_t)(uint32_t)floor_bits;
+    const double i = (double)j;
+
+    // Select b[j & (N - 1)] without a gather
+    const int32_t k = j & (EXP2_N - 1);
+    const double b01 = (k & 1) ? b[1] : b[0];
+    const double b23 = (k & 1) ? b[3] : b[2];
+    const double b45 = (k & 1) ? b[5] : b[4];
+    const double b67 = (k & 1) ? b[7] : b[6];
+    const double b03 = (k & 2) ? b23 : b01;
+    const double b47 = (k & 2) ? b67 : b45;
+    const double bk = (k & 4) ? b47 : b03;
+
+    // Equivalent to ldexp as the result is a normal number
+    const uint64_t scale_bits = (uint64_t)((j >> EXP2_K) + 1023) << 52;
+    double scale = 0;
+    memcpy(&scale, &scale_bits, sizeof(double));
+
+    return bk * (x - i + EXP2_A) * scale;
+}
+
+
+void fast_exp2_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double in_mul,
+        double out_mul,
+        Fast_math_accuracy accuracy)
+{
+    rassert(dest != NULL);
+    rassert(src != NULL);
+    rassert(count >= 0);
+    rassert(isfinite(in_mul));
+    rassert(isfinite(out_mul));
+    rassert(accuracy == FAST_MATH_ACCURACY_APPROX ||
+            accuracy == FAST_MATH_ACCURACY_FULL);
+
+    double args[BLOCK_SIZE] = { 0 };
+
+    for (int32_t block_start = 0; block_start < count; block_start += BLOCK_SIZE)
+    {
+        const int32_t block_size = min(count - block_start, BLOCK_SIZE);
+        float* block_dest = dest + block_start;
+
+        get_exp2_args(args, src + block_start, block_size, in_mul);
+
+        if (accuracy == FAST_MATH_ACCURACY_APPROX)
+        {
+            for (int32_t i = 0; i < block_size; ++i)
+                block_dest[i] = (float)(out_mul * approx_exp2(args[i]));
+        }
+        else
+        {
+            for (int32_t i = 0; i < block_size; ++i)
+                block_dest[i] = (float)(out_mul * exp2(args[i]));
+        }
+    }
+
+    return;
+}
+
+
+#define LOG2_FAC 2.8853900817779268 // 2 * (1 / ln(2))
+#define LOG2_FAC_F13 (LOG2_FAC * (1.0 / 3.0))
+#define LOG2_FAC_F15 (LOG2_FAC * (1.0 / 5.0))
+
+
+static double approx_log2(double x)
+{
+    // Split x into an exponent and a significand in the range [1, 2)
+    uint64_t bits = 0;
+    memcpy(&bits, &x, sizeof(double));
+    const int32_t exp = (int32_t)((bits >> 52) & 0x7ff) - 1023;
+    bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    double sx = 0;
+    memcpy(&sx, &bits, sizeof(double));
+
+    const double sxmp1 = (sx - 1) / (sx + 1);
+    const double sxmp1_2 = sxmp1 * sxmp1;
+
+    const double l2sx =
+        sxmp1 * (LOG2_FAC + sxmp1_2 * (LOG2_FAC_F13 + (LOG2_FAC_F15 * sxmp1_2)));
+
+    return l2sx + (double)exp;
+}
+
+
+void fast_log2_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double out_mul,
+        Fast_math_accuracy accuracy)
+{
+    rassert(dest != NULL);
+    rassert(src != NULL);
+    rassert(count >= 0);
+    rassert(out_mul > 0);
+    rassert(accuracy == FAST_MATH_ACCURACY_APPROX ||
+            accuracy == FAST_MATH_ACCURACY_FULL);
+
+    if (accuracy == FAST_MATH_ACCURACY_FULL)
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            dassert(isfinite(src[i]));
+            dassert(src[i] >= 0);
+            dest[i] = (float)(log2(src[i]) * out_mul);
+        }
+
+        return;
+    }
+
+    double xs[BLOCK_SIZE] = { 0 };
+    float results[BLOCK_SIZE] = { 0 };
+
+    for (int32_t block_start = 0; block_start < count; block_start += BLOCK_SIZE)
+    {
+        const int32_t block_size = min(count - block_start, BLOCK_SIZE);
+        float* block_dest = dest + block_start;
+
+        for (int32_t i = 0; i < block_size; ++i)
+        {
+            dassert(isfinite(src[block_start + i]));
+            dassert(src[block_start + i] >= 0);
+            xs[i] = src[block_start + i];
+        }
+
+        for (int32_t i = 0; i < block_size; ++i)
+            results[i] = (float)(approx_log2(xs[i]) * out_mul);
+
+        for (int32_t i = 0; i < block_size; ++i)
+            block_dest[i] = isgreater(xs[i], 0) ? results[i] : -INFINITY;
+    }
+
+    return;
+}
+
+
+#define SIN_A (-4.0 / PI)
+#define SIN_B (4.0 / (PI * PI))
+#define SIN_Q 0.775
+#define SIN_P (1 - SIN_Q)
+
+
+static double approx_sin(double x)
+{
+    const double x_m_pi = x - PI;
+    const double approx1 = (SIN_A * x_m_pi) + (SIN_B * x_m_pi * fabs(x_m_pi));
+    return SIN_Q * approx1 + SIN_P * approx1 * fabs(approx1);
+}
+
+
+void fast_sin_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double out_mul,
+        Fast_math_accuracy accuracy)
+{
+    rassert(dest != NULL);
+    rassert(src != NULL);
+    rassert(count >= 0);
+    rassert(isfinite(out_mul));
+    rassert(accuracy == FAST_MATH_ACCURACY_APPROX ||
+            accuracy == FAST_MATH_ACCURACY_FULL);
+
+    if (accuracy == FAST_MATH_ACCURACY_FULL)
+    {
+        for (int32_t i = 0; i < count; ++i)
+        {
+            dassert(src[i] >= 0);
+            dassert(src[i] <= (float)(2.0 * PI));
+            dest[i] = (float)(sin(src[i]) * out_mul);
+        }
+
+        return;
+    }
+
+    for (int32_t i = 0; i < count; ++i)
+    {
+        dassert(src[i] >= 0);
+        dassert(src[i] <= (float)(2.0 * PI));
+        dest[i] = (float)(approx_sin(src[i]) * out_mul);
+    }
+
+    return;
+}
+
+
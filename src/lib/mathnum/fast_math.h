@@ -0,0 +1,107 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_FAST_MATH_H
+#define KQT_FAST_MATH_H
+
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Accuracy tiers of the array functions.
+ *
+ * The approximate tier yields the same results as the scalar functions
+ * fast_exp2, fast_log2 and fast_sin. The full tier uses the standard
+ * library functions.
+ */
+typedef enum
+{
+    FAST_MATH_ACCURACY_APPROX = 0,
+    FAST_MATH_ACCURACY_FULL,
+} Fast_math_accuracy;
+
+
+/**
+ * Calculate scaled powers of 2 for an array of values.
+ *
+ * Each destination value is set to out_mul * 2^(in_mul * x), where x is
+ * the corresponding source value. A NaN source value yields \c 0.
+ *
+ * \param dest       The destination array -- must not be \c NULL.
+ *                   This may be the same as \a src.
+ * \param src        The source array -- must not be \c NULL.
+ * \param count      The number of values -- must be >= \c 0.
+ * \param in_mul     The multiplier applied to the source values
+ *                   -- must be finite.
+ * \param out_mul    The multiplier applied to the results -- must be finite.
+ * \param accuracy   The accuracy tier -- must be valid.
+ */
+void fast_exp2_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double in_mul,
+        double out_mul,
+        Fast_math_accuracy accuracy);
+
+
+/**
+ * Calculate scaled base-2 logarithms for an array of values.
+ *
+ * Each destination value is set to out_mul * log2(x), where x is the
+ * corresponding source value. A source value of \c 0 yields \c -INFINITY.
+ *
+ * \param dest       The destination array -- must not be \c NULL.
+ *                   This may be the same as \a src.
+ * \param src        The source array -- must not be \c NULL. All values must
+ *                   be finite and >= \c 0.
+ * \param count      The number of values -- must be >= \c 0.
+ * \param out_mul    The multiplier applied to the results -- must be > \c 0.
+ * \param accuracy   The accuracy tier -- must be valid.
+ */
+void fast_log2_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double out_mul,
+        Fast_math_accuracy accuracy);
+
+
+/**
+ * Calculate scaled sines for an array of phases.
+ *
+ * Each destination value is set to out_mul * sin(x), where x is the
+ * corresponding source value.
+ *
+ * \param dest       The destination array -- must not be \c NULL.
+ *                   This may be the same as \a src.
+ * \param src        The source array -- must not be \c NULL. All values must
+ *                   be within [0, 2 * PI].
+ * \param count      The number of values -- must be >= \c 0.
+ * \param out_mul    The multiplier applied to the results -- must be finite.
+ * \param accuracy   The accuracy tier -- must be valid.
+ */
+void fast_sin_array(
+        float* dest,
+        const float* src,
+        int32_t count,
+        double out_mul,
+        Fast_math_accuracy accuracy);
+
+
+#endif // KQT_FAST_MATH_H
+
+
@@ -15,6 +15,7 @@
 #include <memory.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 
 #include <stdbool.h>
 
@@ -46,6 +47,8 @@ void* memory_alloc(int64_t size)
     if (size == 0)
         return NULL;
 
+    rt_check("memory_alloc");
+
     update_out_of_memory_error();
 
     void* block = malloc((size_t)size);
@@ -64,6 +67,8 @@ void* memory_calloc(int64_t item_count, int64_t item_size)
     if (item_count == 0 || item_size == 0)
         return NULL;
 
+    rt_check("memory_calloc");
+
     update_out_of_memory_error();
 
     void* block = calloc((size_t)item_count, (size_t)item_size);
@@ -83,6 +88,8 @@ void* memory_realloc(void* ptr, int64_t size)
     else if (size == 0)
         return NULL;
 
+    rt_check("memory_realloc");
+
     update_out_of_memory_error();
 
     void* block = realloc(ptr, (size_t)size);
@@ -95,6 +102,9 @@ void* memory_realloc(void* ptr, int64_t size)
 
 void memory_free(void* ptr)
 {
+    if (ptr != NULL)
+        rt_check("memory_free");
+
     free(ptr);
     return;
 }
@@ -21,21 +21,17 @@
 #include <stdlib.h>
 
 
-void Cgiter_init(Cgiter* cgiter, const Module* module, int col_index)
+void Cgiter_init(Cgiter* cgiter, const Module* module)
 {
     rassert(cgiter != NULL);
     rassert(module != NULL);
-    rassert(col_index >= 0);
-    rassert(col_index < KQT_COLUMNS_MAX);
 
     cgiter->module = module;
-    cgiter->col_index = col_index;
     Position_init(&cgiter->pos);
-    Column_iter_init(&cgiter->citer);
 
-    cgiter->cur_tr.head = NULL;
-
-    cgiter->row_returned = false;
+    cgiter->row_index = 0;
+    cgiter->next_ch = 0;
+    cgiter->returned_ch = -1;
 
     cgiter->has_finished = false;
     cgiter->is_pattern_playback_state = false;
@@ -97,7 +93,8 @@ void Cgiter_reset(Cgiter* cgiter, const Position* start_pos)
         cgiter->is_pattern_playback_state = true;
     }
 
-    cgiter->row_returned = false;
+    cgiter->next_ch = 0;
+    cgiter->returned_ch = -1;
 
     cgiter->has_finished = false;
 
@@ -117,58 +114,95 @@ void Cgiter_reset(Cgiter* cgiter, const Position* start_pos)
 }
 
 
-const Trigger_row* Cgiter_get_trigger_row(Cgiter* cgiter)
+static const Pattern* get_pattern(const Cgiter* cgiter, const Pat_inst_ref** piref)
 {
     rassert(cgiter != NULL);
+    rassert(piref != NULL);
 
-    if (Cgiter_has_finished(cgiter))
+    if (cgiter->is_pattern_playback_state)
+        *piref = &cgiter->pos.piref;
+    else
+        *piref = find_pat_inst_ref(
+                cgiter->module, cgiter->pos.track, cgiter->pos.system);
+
+    if (*piref == NULL)
         return NULL;
 
-    // Don't return a previously returned row
-    if (cgiter->row_returned)
+    return Module_get_pattern(cgiter->module, *piref);
+}
+
+
+static bool is_row_before_cursor(const Cgiter* cgiter, const Pattern_row* row)
+{
+    rassert(cgiter != NULL);
+    rassert(row != NULL);
+
+    const int pos_cmp = Tstamp_cmp(&row->pos, &cgiter->pos.pat_pos);
+    return (pos_cmp < 0) || (pos_cmp == 0 && row->ch < cgiter->next_ch);
+}
+
+
+static int find_row_index(const Cgiter* cgiter, const Pattern* pattern)
+{
+    rassert(cgiter != NULL);
+    rassert(pattern != NULL);
+
+    // Use the previous location if it is still consistent with our position,
+    // as the Pattern contents may have changed since our last visit
+    const int row_count = Pattern_get_row_count(pattern);
+    const int index = cgiter->row_index;
+    if ((index >= 0) && (index <= row_count) &&
+            (index == 0 ||
+                is_row_before_cursor(cgiter, Pattern_get_row(pattern, index - 1))) &&
+            (index == row_count ||
+                !is_row_before_cursor(cgiter, Pattern_get_row(pattern, index))))
+        return index;
+
+    return Pattern_find_row(pattern, &cgiter->pos.pat_pos, cgiter->next_ch);
+}
+
+
+const Pattern_row* Cgiter_get_trigger_row(Cgiter* cgiter)
+{
+    rassert(cgiter != NULL);
+
+    if (Cgiter_has_finished(cgiter))
         return NULL;
-    cgiter->row_returned = true;
 
     // Find pattern
-    const Pattern* pattern = NULL;
     const Pat_inst_ref* piref = NULL;
-    if (cgiter->is_pattern_playback_state)
-        piref = &cgiter->pos.piref;
-    else
-        piref = find_pat_inst_ref(cgiter->module, cgiter->pos.track, cgiter->pos.system);
-
-    if (piref != NULL)
-        pattern = Module_get_pattern(cgiter->module, piref);
-
+    const Pattern* pattern = get_pattern(cgiter, &piref);
     if (pattern == NULL)
         return NULL;
 
     // Store current pattern instance for reference
     cgiter->pos.piref = *piref;
 
-    Column* column = Pattern_get_column(pattern, cgiter->col_index);
-    if (column == NULL)
+    const int index = find_row_index(cgiter, pattern);
+    cgiter->row_index = index;
+    if (index >= Pattern_get_row_count(pattern))
         return NULL;
 
-    Column_iter_change_col(&cgiter->citer, column);
-    cgiter->cur_tr.head = Column_iter_get_row(&cgiter->citer, &cgiter->pos.pat_pos);
-    if (cgiter->cur_tr.head == NULL)
-        return NULL;
-    rassert(cgiter->cur_tr.head->next != NULL);
-    rassert(cgiter->cur_tr.head->next->trigger != NULL);
-    if (Tstamp_cmp(&cgiter->cur_tr.head->next->trigger->pos, &cgiter->pos.pat_pos) > 0)
+    const Pattern_row* row = Pattern_get_row(pattern, index);
+    if (Tstamp_cmp(&row->pos, &cgiter->pos.pat_pos) > 0)
         return NULL;
 
-    return &cgiter->cur_tr;
+    cgiter->row_index = index + 1;
+    cgiter->next_ch = row->ch + 1;
+    cgiter->returned_ch = row->ch;
+
+    return row;
 }
 
 
 void Cgiter_clear_returned_status(Cgiter* cgiter)
 {
     rassert(cgiter != NULL);
-    rassert(cgiter->row_returned);
+    rassert(cgiter->returned_ch >= 0);
 
-    cgiter->row_returned = false;
+    cgiter->next_ch = cgiter->returned_ch;
+    cgiter->returned_ch = -1;
+    --cgiter->row_index;
 
     return;
 }
@@ -184,16 +218,8 @@ bool Cgiter_peek(Cgiter* cgiter, Tstamp* dist)
         return false;
 
     // Find pattern
-    const Pattern* pattern = NULL;
     const Pat_inst_ref* piref = NULL;
-    if (cgiter->is_pattern_playback_state)
-        piref = &cgiter->pos.piref;
-    else
-        piref = find_pat_inst_ref(cgiter->module, cgiter->pos.track, cgiter->pos.system);
-
-    if (piref != NULL)
-        pattern = Module_get_pattern(cgiter->module, piref);
-
+    const Pattern* pattern = get_pattern(cgiter, &piref);
     if (pattern == NULL)
         return false;
 
@@ -209,26 +235,21 @@ bool Cgiter_peek(Cgiter* cgiter, Tstamp* dist)
         return true;
     }
 
-    // Check next trigger row
-    Column* column = Pattern_get_column(pattern, cgiter->col_index);
-    rassert(column != NULL);
-    Column_iter_change_col(&cgiter->citer, column);
-
-    const Tstamp* epsilon = Tstamp_set(TSTAMP_AUTO, 0, 1);
-    Tstamp* next_pos_min = Tstamp_add(TSTAMP_AUTO, &cgiter->pos.pat_pos, epsilon);
-    Trigger_list* row = Column_iter_get_row(&cgiter->citer, next_pos_min);
+    // Check next trigger row, skipping any remaining rows at our position
+    const int row_count = Pattern_get_row_count(pattern);
+    int index = find_row_index(cgiter, pattern);
+    while (index < row_count &&
+            Tstamp_cmp(&Pattern_get_row(pattern, index)->pos, &cgiter->pos.pat_pos) <= 0)
+        ++index;
 
-    if (row != NULL)
+    if (index < row_count)
     {
-        rassert(row->next != NULL);
-        rassert(row->next->trigger != NULL);
-        if (Tstamp_cmp(&row->next->trigger->pos, pat_length) <= 0)
+        const Pattern_row* row = Pattern_get_row(pattern, index);
+        if (Tstamp_cmp(&row->pos, pat_length) <= 0)
         {
             // Trigger row found inside this pattern
-            const Tstamp* dist_to_row = Tstamp_sub(
-                    TSTAMP_AUTO,
-                    &row->next->trigger->pos,
-                    &cgiter->pos.pat_pos);
+            const Tstamp* dist_to_row =
+                Tstamp_sub(TSTAMP_AUTO, &row->pos, &cgiter->pos.pat_pos);
             Tstamp_mina(dist, dist_to_row);
             return true;
         }
@@ -295,14 +316,19 @@ void Cgiter_move(Cgiter* cgiter, const Tstamp* dist)
             Cgiter_go_to_next_system(cgiter);
         }
 
-        cgiter->row_returned = false;
+        cgiter->row_index = 0;
+        cgiter->next_ch = 0;
+        cgiter->returned_ch = -1;
         return;
     }
 
     // Move forwards
     Tstamp_adda(&cgiter->pos.pat_pos, dist);
     if (Tstamp_cmp(dist, TSTAMP_AUTO) > 0)
-        cgiter->row_returned = false;
+    {
+        cgiter->next_ch = 0;
+        cgiter->returned_ch = -1;
+    }
 
     return;
 }
@@ -17,33 +17,28 @@
 
 
 #include <init/Module.h>
-#include <init/sheet/Column.h>
+#include <init/sheet/Pattern.h>
 #include <player/Position.h>
 
 #include <stdbool.h>
 #include <stdlib.h>
 
 
-// TODO: define proper interface in Column
-typedef struct Trigger_row
-{
-    Trigger_list* head;
-} Trigger_row;
-
-
 /**
- * Iterates over triggers in column groups.
+ * Iterates over trigger rows of all columns in playback order.
+ *
+ * The Cgiter follows the merged row timeline of the current Pattern, so
+ * columns without triggers at the current position are never visited.
  */
 typedef struct Cgiter
 {
     const Module* module;
-    int col_index;
 
     Position pos;
-    Column_iter citer;
-    Trigger_row cur_tr; // TODO: remove
 
-    bool row_returned;
+    int row_index;
+    int next_ch;
+    int returned_ch;
 
     bool has_finished;
     bool is_pattern_playback_state;
@@ -53,12 +48,10 @@ typedef struct Cgiter
 /**
  * Initialise Cgiter.
  *
- * \param cgiter      The Cgiter -- must not be \c NULL.
- * \param module      The Module -- must not be \c NULL.
- * \param col_index   The column index -- must be >= \c 0 and
- *                    < \c KQT_COLUMNS_MAX.
+ * \param cgiter   The Cgiter -- must not be \c NULL.
+ * \param module   The Module -- must not be \c NULL.
  */
-void Cgiter_init(Cgiter* cgiter, const Module* module, int col_index);
+void Cgiter_init(Cgiter* cgiter, const Module* module);
 
 
 /**
@@ -73,20 +66,22 @@ void Cgiter_reset(Cgiter* cgiter, const Position* start_pos);
 
 
 /**
- * Return trigger row at the current Cgiter position.
+ * Return the next unprocessed trigger row at the current Cgiter position.
+ *
+ * Trigger rows at the same position are returned in channel order.
  *
  * \param cgiter   The Cgiter -- must not be \c NULL.
  *
  * \return   The trigger row if one exists, otherwise \c NULL.
  */
-const Trigger_row* Cgiter_get_trigger_row(Cgiter* cgiter);
+const Pattern_row* Cgiter_get_trigger_row(Cgiter* cgiter);
 
 
 /**
- * Allow a previously returned trigger row to be returned again.
+ * Allow the most recently returned trigger row to be returned again.
  *
- * \param cgiter   The Cgiter -- must not be \c NULL and must have the
- *                 returned flag set.
+ * \param cgiter   The Cgiter -- must not be \c NULL and must have returned
+ *                 a trigger row at the current position.
  */
 void Cgiter_clear_returned_status(Cgiter* cgiter);
 
@@ -19,27 +19,40 @@
 #include <init/sheet/Channel_defaults.h>
 #include <mathnum/Tstamp.h>
 #include <memory.h>
+#include <player/Active_names.h>
 #include <player/Channel_cv_state.h>
 #include <player/Channel_stream_state.h>
+#include <player/LFO.h>
+#include <player/Slider.h>
 
 #include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 
-static bool Channel_init(Channel* ch, int num, Env_state* estate, const Module* module)
+static bool Channel_init(
+        Channel* ch,
+        int num,
+        Env_state* estate,
+        const Module* module,
+        const Name_table* stream_names,
+        const Name_table* cv_names)
 {
     rassert(ch != NULL);
     rassert(num >= 0);
     rassert(num < KQT_COLUMNS_MAX);
     rassert(estate != NULL);
     rassert(module != NULL);
+    rassert(stream_names != NULL);
+    rassert(cv_names != NULL);
 
     General_state_preinit(&ch->parent);
 
-    ch->cvstate = new_Channel_cv_state();
-    ch->csstate = new_Channel_stream_state();
+    ch->cvstate = new_Channel_cv_state(cv_names);
+    ch->csstate = new_Channel_stream_state(stream_names);
     if ((ch->cvstate == NULL) || (ch->csstate == NULL) ||
             !General_state_init(&ch->parent, false, estate, module))
     {
@@ -56,6 +69,9 @@ static bool Channel_init(Channel* ch, int num, Env_state* estate, const Module*
     ch->num = num;
     ch->mute = false;
 
+    ch->next_active = NULL;
+    ch->is_active = false;
+
     Channel_reset(ch);
 
     return true;
@@ -68,6 +84,8 @@ Channel* new_Channel(
         Au_table* au_table,
         Env_state* estate,
         Voice_pool* voices,
+        const Name_table* stream_names,
+        const Name_table* cv_names,
         double tempo,
         int32_t audio_rate)
 {
@@ -84,7 +102,7 @@ Channel* new_Channel(
     if (ch == NULL)
         return NULL;
 
-    if (!Channel_init(ch, num, estate, module))
+    if (!Channel_init(ch, num, estate, module, stream_names, cv_names))
     {
         memory_free(ch);
         return NULL;
@@ -199,6 +217,7 @@ void Channel_reset(Channel* ch)
 
     Channel_cv_state_reset(ch->cvstate);
     Channel_stream_state_reset(ch->csstate);
+    Channel_reset_active_ids(ch);
 
     Random_reset(&ch->rand);
     if (ch->event_cache != NULL)
@@ -255,6 +274,84 @@ Voice* Channel_get_fg_voice(Channel* ch, int proc_index)
 }
 
 
+int32_t Channel_get_active_stream_id(Channel* ch)
+{
+    rassert(ch != NULL);
+
+    if (ch->active_stream_id < 0)
+    {
+        const char* stream_name =
+            Active_names_get(ch->parent.active_names, ACTIVE_CAT_STREAM);
+        ch->active_stream_id = Channel_stream_state_get_id(ch->csstate, stream_name);
+    }
+
+    return ch->active_stream_id;
+}
+
+
+int32_t Channel_get_active_cv_id(Channel* ch)
+{
+    rassert(ch != NULL);
+
+    if (ch->active_cv_id < 0)
+    {
+        const char* var_name =
+            Active_names_get(ch->parent.active_names, ACTIVE_CAT_CONTROL_VAR);
+        ch->active_cv_id = Channel_cv_state_get_id(ch->cvstate, var_name);
+    }
+
+    return ch->active_cv_id;
+}
+
+
+void Channel_reset_active_ids(Channel* ch)
+{
+    rassert(ch != NULL);
+
+    ch->active_stream_id = -1;
+    ch->active_cv_id = -1;
+
+    return;
+}
+
+
+bool Channel_update_carried_controls(Channel* ch, int64_t step_count)
+{
+    rassert(ch != NULL);
+    rassert(step_count >= 0);
+
+    bool is_in_progress = false;
+
+    {
+        Force_controls* fc = &ch->force_controls;
+
+        if (Slider_in_progress(&fc->slider))
+            fc->force = (float)Slider_skip(&fc->slider, step_count);
+
+        if (LFO_active(&fc->tremolo))
+            LFO_skip(&fc->tremolo, step_count);
+
+        is_in_progress |= Slider_in_progress(&fc->slider) || LFO_active(&fc->tremolo);
+    }
+
+    {
+        Pitch_controls* pc = &ch->pitch_controls;
+
+        if (Slider_in_progress(&pc->slider))
+            pc->pitch = Slider_skip(&pc->slider, step_count);
+
+        if (LFO_active(&pc->vibrato))
+            LFO_skip(&pc->vibrato, step_count);
+
+        is_in_progress |= Slider_in_progress(&pc->slider) || LFO_active(&pc->vibrato);
+    }
+
+    is_in_progress |= Channel_stream_state_update(ch->csstate, step_count);
+
+    return is_in_progress;
+}
+
+
 double Channel_get_fg_force(const Channel* ch)
 {
     rassert(ch != NULL);
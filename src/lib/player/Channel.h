@@ -91,6 +91,12 @@ struct Channel
 
     char init_ch_expression[KQT_VAR_NAME_MAX];
     bool carry_note_expression;
+
+    int32_t active_stream_id;      ///< Cached identifier of the active stream.
+    int32_t active_cv_id;          ///< Cached identifier of the active control variable.
+
+    Channel* next_active;          ///< Next Channel with controls in progress.
+    bool is_active;                ///< Channel is listed as having controls in progress.
 };
 
 
@@ -103,6 +109,9 @@ struct Channel
  * \param au_table     The audio unit table -- must not be \c NULL.
  * \param estate       The Environment state -- must not be \c NULL.
  * \param voices       The Voice pool -- must not be \c NULL.
+ * \param stream_names The table of stream names -- must not be \c NULL.
+ * \param cv_names     The table of control variable names -- must not be
+ *                     \c NULL.
  * \param tempo        The current tempo -- must be finite and positive.
  * \param audio_rate   The current audio rate -- must be positive.
  *
@@ -115,6 +124,8 @@ Channel* new_Channel(
         Au_table* au_table,
         Env_state* estate,
         Voice_pool* voices,
+        const Name_table* stream_names,
+        const Name_table* cv_names,
         double tempo,
         int32_t audio_rate);
 
@@ -213,6 +224,51 @@ Random* Channel_get_random_source(Channel* ch);
 Voice* Channel_get_fg_voice(Channel* ch, int proc_index);
 
 
+/**
+ * Get the identifier of the active stream of the Channel.
+ *
+ * \param ch   The Channel -- must not be \c NULL.
+ *
+ * \return   The stream identifier, or \c -1 if the active stream name does
+ *           not refer to a known stream.
+ */
+int32_t Channel_get_active_stream_id(Channel* ch);
+
+
+/**
+ * Get the identifier of the active control variable of the Channel.
+ *
+ * \param ch   The Channel -- must not be \c NULL.
+ *
+ * \return   The variable identifier, or \c -1 if the active control variable
+ *           name does not refer to a known variable.
+ */
+int32_t Channel_get_active_cv_id(Channel* ch);
+
+
+/**
+ * Forget the cached identifiers of active names.
+ *
+ * This must be called whenever the active stream or control variable name
+ * of the Channel changes.
+ *
+ * \param ch   The Channel -- must not be \c NULL.
+ */
+void Channel_reset_active_ids(Channel* ch);
+
+
+/**
+ * Update the carried controls of the Channel.
+ *
+ * \param ch           The Channel -- must not be \c NULL.
+ * \param step_count   The number of frames to update -- must be >= \c 0.
+ *
+ * \return   \c true if any of the controls still has a slide or oscillation
+ *           in progress, otherwise \c false.
+ */
+bool Channel_update_carried_controls(Channel* ch, int64_t step_count);
+
+
 /**
  * Return an actual force of a current foreground Voice.
  *
@@ -14,7 +14,8 @@
 
 #include <player/Channel_cv_state.h>
 
-#include <containers/AAtree.h>
+#include <containers/Name_table.h>
+#include <containers/Vector.h>
 #include <debug/assert.h>
 #include <mathnum/Tstamp.h>
 #include <memory.h>
@@ -29,51 +30,43 @@
 
 typedef struct Entry
 {
-    char var_name[KQT_VAR_NAME_MAX];
-
     Value value;
     bool is_set;
     bool carry;
 } Entry;
 
 
-#define ENTRY_AUTO (&(Entry){ .var_name = "", .is_set = false, .carry = false })
-
-
-static Entry* Entry_init(Entry* entry, const char* var_name)
+struct Channel_cv_state
 {
-    rassert(entry != NULL);
-    rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
+    const Name_table* names;
+    Vector* entries; // indexed by variable identifiers
+};
 
-    strcpy(entry->var_name, var_name);
 
-    entry->value.type = VALUE_TYPE_NONE;
+static Entry* get_entry(const Channel_cv_state* state, int32_t var_id)
+{
+    rassert(state != NULL);
 
-    entry->is_set = false;
-    entry->carry = false;
+    if ((var_id < 0) || (var_id >= Vector_size(state->entries)))
+        return NULL;
 
-    return entry;
+    return Vector_get_ref(state->entries, var_id);
 }
 
 
-struct Channel_cv_state
+Channel_cv_state* new_Channel_cv_state(const Name_table* names)
 {
-    AAtree* tree;
-};
-
+    rassert(names != NULL);
 
-Channel_cv_state* new_Channel_cv_state(void)
-{
     Channel_cv_state* state = memory_alloc_item(Channel_cv_state);
     if (state == NULL)
         return NULL;
 
-    state->tree = NULL;
+    state->names = names;
+    state->entries = NULL;
 
-    state->tree = new_AAtree(
-            (AAtree_item_cmp*)strcmp, (AAtree_item_destroy*)memory_free);
-    if (state->tree == NULL)
+    state->entries = new_Vector(sizeof(Entry));
+    if (state->entries == NULL)
     {
         del_Channel_cv_state(state);
         return NULL;
@@ -83,45 +76,42 @@ Channel_cv_state* new_Channel_cv_state(void)
 }
 
 
-bool Channel_cv_state_add_entry(Channel_cv_state* state, const char* var_name)
+bool Channel_cv_state_add_entry(Channel_cv_state* state, int32_t var_id)
 {
     rassert(state != NULL);
-    rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
+    rassert(var_id >= 0);
+    rassert(var_id < Name_table_get_count(state->names));
 
-    const Entry* entry = Entry_init(ENTRY_AUTO, var_name);
-
-    if (!AAtree_contains(state->tree, entry))
+    while (Vector_size(state->entries) <= var_id)
     {
-        Entry* new_entry = memory_alloc_item(Entry);
-        if (new_entry == NULL)
-            return false;
+        Entry* new_entry = &(Entry){ .is_set = false, .carry = false };
+        new_entry->value.type = VALUE_TYPE_NONE;
 
-        *new_entry = *entry;
-
-        if (!AAtree_ins(state->tree, new_entry))
-        {
-            memory_free(new_entry);
+        if (!Vector_append(state->entries, new_entry))
             return false;
-        }
     }
 
     return true;
 }
 
 
-bool Channel_cv_state_set_value(
-        Channel_cv_state* state, const char* var_name, const Value* value)
+int32_t Channel_cv_state_get_id(const Channel_cv_state* state, const char* var_name)
 {
     rassert(state != NULL);
     rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
+
+    return Name_table_get_id(state->names, var_name);
+}
+
+
+bool Channel_cv_state_set_value(
+        Channel_cv_state* state, int32_t var_id, const Value* value)
+{
+    rassert(state != NULL);
     rassert(value != NULL);
     rassert(Value_type_is_realtime(value->type));
 
-    const Entry* key = Entry_init(ENTRY_AUTO, var_name);
-
-    Entry* entry = AAtree_get_exact(state->tree, key);
+    Entry* entry = get_entry(state, var_id);
     if (entry == NULL)
         return false;
 
@@ -132,16 +122,11 @@ bool Channel_cv_state_set_value(
 }
 
 
-const Value* Channel_cv_state_get_value(
-        const Channel_cv_state* state, const char* var_name)
+const Value* Channel_cv_state_get_value(const Channel_cv_state* state, int32_t var_id)
 {
     rassert(state != NULL);
-    rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
 
-    const Entry* key = Entry_init(ENTRY_AUTO, var_name);
-
-    const Entry* entry = AAtree_get_exact(state->tree, key);
+    const Entry* entry = get_entry(state, var_id);
     if ((entry == NULL) || !entry->is_set)
         return NULL;
 
@@ -150,15 +135,11 @@ const Value* Channel_cv_state_get_value(
 
 
 bool Channel_cv_state_set_carrying_enabled(
-        Channel_cv_state* state, const char* var_name, bool enabled)
+        Channel_cv_state* state, int32_t var_id, bool enabled)
 {
     rassert(state != NULL);
-    rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
 
-    const Entry* key = Entry_init(ENTRY_AUTO, var_name);
-
-    Entry* entry = AAtree_get_exact(state->tree, key);
+    Entry* entry = get_entry(state, var_id);
     if (entry == NULL)
         return false;
 
@@ -168,16 +149,11 @@ bool Channel_cv_state_set_carrying_enabled(
 }
 
 
-bool Channel_cv_state_is_carrying_enabled(
-        const Channel_cv_state* state, const char* var_name)
+bool Channel_cv_state_is_carrying_enabled(const Channel_cv_state* state, int32_t var_id)
 {
     rassert(state != NULL);
-    rassert(var_name != NULL);
-    rassert(strlen(var_name) < KQT_VAR_NAME_MAX);
 
-    const Entry* key = Entry_init(ENTRY_AUTO, var_name);
-
-    const Entry* entry = AAtree_get_exact(state->tree, key);
+    const Entry* entry = get_entry(state, var_id);
     if (entry == NULL)
         return false;
 
@@ -189,17 +165,11 @@ void Channel_cv_state_reset(Channel_cv_state* state)
 {
     rassert(state != NULL);
 
-    const Entry* key = Entry_init(ENTRY_AUTO, "");
-
-    AAiter* iter = AAiter_init(AAITER_AUTO, state->tree);
-
-    Entry* entry = AAiter_get_at_least(iter, key);
-    while (entry != NULL)
+    for (int32_t i = 0; i < Vector_size(state->entries); ++i)
     {
+        Entry* entry = get_entry(state, i);
         entry->is_set = false;
         entry->carry = false;
-
-        entry = AAiter_get_next(iter);
     }
 
     return;
@@ -211,7 +181,7 @@ void del_Channel_cv_state(Channel_cv_state* state)
     if (state == NULL)
         return;
 
-    del_AAtree(state->tree);
+    del_Vector(state->entries);
     memory_free(state);
 
     return;
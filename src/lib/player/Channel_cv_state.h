@@ -16,6 +16,7 @@
 #define KQT_CHANNEL_CV_STATE_H
 
 
+#include <decl.h>
 #include <kunquat/limits.h>
 #include <mathnum/Tstamp.h>
 #include <Value.h>
@@ -26,7 +27,8 @@
 
 
 /**
- * A dictionary for audio unit control variable states in a Channel.
+ * A table of audio unit control variable states in a Channel, indexed by
+ * variable identifiers.
  */
 typedef struct Channel_cv_state Channel_cv_state;
 
@@ -34,75 +36,90 @@ typedef struct Channel_cv_state Channel_cv_state;
 /**
  * Create a new Channel control variable state.
  *
+ * \param names   The table of control variable names shared by all Channels
+ *                -- must not be \c NULL.
+ *
  * \return   The new Channel control variable state if successful, or \c NULL
  *           if memory allocation failed.
  */
-Channel_cv_state* new_Channel_cv_state(void);
+Channel_cv_state* new_Channel_cv_state(const Name_table* names);
 
 
 /**
  * Add a control variable entry to the Channel control variable state.
  *
- * \param state      The Channel control variable state -- must not be \c NULL.
- * \param var_name   The variable name -- must not be \c NULL and must be
- *                   shorter than \c KQT_VAR_NAME_MAX characters.
+ * \param state    The Channel control variable state -- must not be \c NULL.
+ * \param var_id   The variable identifier in the shared name table
+ *                 -- must be >= \c 0.
  *
  * \return   \c true if successful, or \c false if memory allocation failed.
  */
-bool Channel_cv_state_add_entry(Channel_cv_state* state, const char* var_name);
+bool Channel_cv_state_add_entry(Channel_cv_state* state, int32_t var_id);
+
+
+/**
+ * Get the identifier of a control variable name.
+ *
+ * \param state      The Channel control variable state -- must not be \c NULL.
+ * \param var_id     The variable identifier.
+ *
+ * \return   The variable identifier, or \c -1 if \a var_name is not a known
+ *           control variable.
+ */
+int32_t Channel_cv_state_get_id(const Channel_cv_state* state, const char* var_name);
 
 
 /**
  * Set a value of a control variable in the Channel control variable state.
  *
  * \param state      The Channel control variable state -- must not be \c NULL.
- * \param var_name   The variable name -- must not be \c NULL.
+ * \param var_id     The variable identifier.
  * \param value      The new value -- must not be \c NULL.
  *
  * \return   \c true if the new value was actually set, or \c false if
- *           \a state does not contain an entry called \a var_name.
+ *           \a state does not contain an entry with identifier \a var_id.
  */
 bool Channel_cv_state_set_value(
-        Channel_cv_state* state, const char* var_name, const Value* value);
+        Channel_cv_state* state, int32_t var_id, const Value* value);
 
 
 /**
  * Get a value of a control variable in the Channel control variable state.
  *
  * \param state      The Channel control variable state -- must not be \c NULL.
- * \param var_name   The variable name -- must not be \c NULL.
+ * \param var_id     The variable identifier.
  *
  * \return   The stored value if one exists, otherwise \c NULL.
  */
 const Value* Channel_cv_state_get_value(
-        const Channel_cv_state* state, const char* var_name);
+        const Channel_cv_state* state, int32_t var_id);
 
 
 /**
  * Set carrying state of a control variable in the Channel control variable state.
  *
  * \param state      The Channel control variable state -- must not be \c NULL.
- * \param var_name   The variable name -- must not be \c NULL.
+ * \param var_id     The variable identifier.
  * \param enabled    \c true to enable carrying, \c false to disable.
  *
  * \return   \c true if the new carrying state was set, or \c false if \a state
- *           does not contain an entry with matching variable name and value type.
+ *           does not contain an entry with identifier \a var_id.
  */
 bool Channel_cv_state_set_carrying_enabled(
-        Channel_cv_state* state, const char* var_name, bool enabled);
+        Channel_cv_state* state, int32_t var_id, bool enabled);
 
 
 /**
  * Get carrying state of a control variable in the Channel control variable state.
  *
  * \param state      The Channel control variable state -- must not be \c NULL.
- * \param var_name   The variable name -- must not be \c NULL.
+ * \param var_id     The variable identifier.
  *
- * \return   \c true if carrying is enabled for the control variable called
- *           \a var_name, otherwise \c false.
+ * \return   \c true if carrying is enabled for the control variable with
+ *           identifier \a var_id, otherwise \c false.
  */
 bool Channel_cv_state_is_carrying_enabled(
-        const Channel_cv_state* state, const char* var_name);
+        const Channel_cv_state* state, int32_t var_id);
 
 
 /**
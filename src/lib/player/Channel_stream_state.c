@@ -14,24 +14,23 @@
 
 #include <player/Channel_stream_state.h>
 
-#include <containers/AAtree.h>
+#include <containers/Name_table.h>
+#include <containers/Vector.h>
 #include <debug/assert.h>
-#include <kunquat/limits.h>
 #include <mathnum/Tstamp.h>
 #include <memory.h>
 #include <player/Linear_controls.h>
-#include <string/var_name.h>
 
 #include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
-#include <string.h>
 
 
 typedef struct Entry
 {
-    char name[KQT_VAR_NAME_MAX];
+    struct Entry* next_active;
+    bool is_active;
 
     Linear_controls controls;
     bool is_set;
@@ -47,21 +46,53 @@ typedef struct Entry
 
 struct Channel_stream_state
 {
-    AAtree* tree;
+    const Name_table* names;
+    Vector* entries; // Entry pointers indexed by stream identifiers
+    Entry* active_head; // entries that may need updating during playback
 };
 
 
-Channel_stream_state* new_Channel_stream_state(void)
+static Entry* get_entry(const Channel_stream_state* state, int32_t stream_id)
 {
+    rassert(state != NULL);
+
+    if ((stream_id < 0) || (stream_id >= Vector_size(state->entries)))
+        return NULL;
+
+    return *(Entry**)Vector_get_ref(state->entries, stream_id);
+}
+
+
+static void activate_entry(Channel_stream_state* state, Entry* entry)
+{
+    rassert(state != NULL);
+    rassert(entry != NULL);
+
+    if (entry->is_active)
+        return;
+
+    entry->next_active = state->active_head;
+    entry->is_active = true;
+    state->active_head = entry;
+
+    return;
+}
+
+
+Channel_stream_state* new_Channel_stream_state(const Name_table* names)
+{
+    rassert(names != NULL);
+
     Channel_stream_state* state = memory_alloc_item(Channel_stream_state);
     if (state == NULL)
         return NULL;
 
-    state->tree = NULL;
+    state->names = names;
+    state->entries = NULL;
+    state->active_head = NULL;
 
-    state->tree = new_AAtree(
-            (AAtree_item_cmp*)strcmp, (AAtree_item_destroy*)memory_free);
-    if (state->tree == NULL)
+    state->entries = new_Vector(sizeof(Entry*));
+    if (state->entries == NULL)
     {
         del_Channel_stream_state(state);
         return NULL;
@@ -77,13 +108,10 @@ void Channel_stream_state_set_audio_rate(
     rassert(state != NULL);
     rassert(audio_rate > 0);
 
-    AAiter* iter = AAiter_init(AAITER_AUTO, state->tree);
-
-    Entry* entry = AAiter_get_at_least(iter, "");
-    while (entry != NULL)
+    for (int32_t i = 0; i < Vector_size(state->entries); ++i)
     {
+        Entry* entry = get_entry(state, i);
         Linear_controls_set_audio_rate(&entry->controls, audio_rate);
-        entry = AAiter_get_next(iter);
     }
 
     return;
@@ -96,33 +124,30 @@ void Channel_stream_state_set_tempo(Channel_stream_state* state, double tempo)
     rassert(isfinite(tempo));
     rassert(tempo > 0);
 
-    AAiter* iter = AAiter_init(AAITER_AUTO, state->tree);
-
-    Entry* entry = AAiter_get_at_least(iter, "");
-    while (entry != NULL)
+    for (int32_t i = 0; i < Vector_size(state->entries); ++i)
     {
+        Entry* entry = get_entry(state, i);
         Linear_controls_set_tempo(&entry->controls, tempo);
-        entry = AAiter_get_next(iter);
     }
 
     return;
 }
 
 
-bool Channel_stream_state_add_entry(
-        Channel_stream_state* state, const char* stream_name)
+bool Channel_stream_state_add_entry(Channel_stream_state* state, int32_t stream_id)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
+    rassert(stream_id >= 0);
+    rassert(stream_id < Name_table_get_count(state->names));
 
-    if (!AAtree_contains(state->tree, stream_name))
+    while (Vector_size(state->entries) <= stream_id)
     {
         Entry* new_entry = memory_alloc_item(Entry);
         if (new_entry == NULL)
             return false;
 
-        strcpy(new_entry->name, stream_name);
+        new_entry->next_active = NULL;
+        new_entry->is_active = false;
         Linear_controls_init(&new_entry->controls);
         new_entry->is_set = false;
 
@@ -133,7 +158,7 @@ bool Channel_stream_state_add_entry(
         Tstamp_set(&new_entry->osc_depth_slide, -1, 0);
         new_entry->carry = false;
 
-        if (!AAtree_ins(state->tree, new_entry))
+        if (!Vector_append(state->entries, &new_entry))
         {
             memory_free(new_entry);
             return false;
@@ -144,133 +169,136 @@ bool Channel_stream_state_add_entry(
 }
 
 
-bool Channel_stream_state_set_value(
-        Channel_stream_state* state, const char* stream_name, double value)
+int32_t Channel_stream_state_get_id(
+        const Channel_stream_state* state, const char* stream_name)
 {
     rassert(state != NULL);
     rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
+
+    return Name_table_get_id(state->names, stream_name);
+}
+
+
+bool Channel_stream_state_set_value(
+        Channel_stream_state* state, int32_t stream_id, double value)
+{
+    rassert(state != NULL);
     rassert(isfinite(value));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_set_value(&entry->controls, value);
     entry->is_set = true;
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_slide_target(
-        Channel_stream_state* state, const char* stream_name, double value)
+        Channel_stream_state* state, int32_t stream_id, double value)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(isfinite(value));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_slide_value_target(&entry->controls, value);
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_slide_length(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length)
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(length != NULL);
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_slide_value_length(&entry->controls, length);
     Tstamp_copy(&entry->slide_length, length);
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_set_osc_speed(
-        Channel_stream_state* state, const char* stream_name, double speed)
+        Channel_stream_state* state, int32_t stream_id, double speed)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(isfinite(speed));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_osc_speed_value(&entry->controls, speed);
     entry->osc_speed = speed;
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_set_osc_depth(
-        Channel_stream_state* state, const char* stream_name, double depth)
+        Channel_stream_state* state, int32_t stream_id, double depth)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(isfinite(depth));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_osc_depth_value(&entry->controls, depth);
     entry->osc_depth = depth;
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_set_osc_speed_slide(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length)
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(length != NULL);
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_osc_speed_slide_value(&entry->controls, length);
     Tstamp_copy(&entry->osc_speed_slide, length);
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 bool Channel_stream_state_set_osc_depth_slide(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length)
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(length != NULL);
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_osc_depth_slide_value(&entry->controls, length);
     Tstamp_copy(&entry->osc_depth_slide, length);
+    activate_entry(state, entry);
 
     return true;
 }
@@ -278,33 +306,30 @@ bool Channel_stream_state_set_osc_depth_slide(
 
 bool Channel_stream_state_set_controls(
         Channel_stream_state* state,
-        const char* stream_name,
+        int32_t stream_id,
         const Linear_controls* controls)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(controls != NULL);
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
     Linear_controls_copy(&entry->controls, controls);
     entry->is_set = true;
+    activate_entry(state, entry);
 
     return true;
 }
 
 
 const Linear_controls* Channel_stream_state_get_controls(
-        const Channel_stream_state* state, const char* stream_name)
+        const Channel_stream_state* state, int32_t stream_id)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
 
-    const Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    const Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return NULL;
 
@@ -313,13 +338,11 @@ const Linear_controls* Channel_stream_state_get_controls(
 
 
 bool Channel_stream_state_set_carrying_enabled(
-        Channel_stream_state* state, const char* stream_name, bool enabled)
+        Channel_stream_state* state, int32_t stream_id, bool enabled)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
@@ -330,13 +353,11 @@ bool Channel_stream_state_set_carrying_enabled(
 
 
 bool Channel_stream_state_is_carrying_enabled(
-        const Channel_stream_state* state, const char* stream_name)
+        const Channel_stream_state* state, int32_t stream_id)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
@@ -346,15 +367,13 @@ bool Channel_stream_state_is_carrying_enabled(
 
 bool Channel_stream_state_apply_overrides(
         const Channel_stream_state* state,
-        const char* stream_name,
+        int32_t stream_id,
         Linear_controls* controls)
 {
     rassert(state != NULL);
-    rassert(stream_name != NULL);
-    rassert(is_valid_var_name(stream_name));
     rassert(controls != NULL);
 
-    Entry* entry = AAtree_get_exact(state->tree, stream_name);
+    Entry* entry = get_entry(state, stream_id);
     if (entry == NULL)
         return false;
 
@@ -373,23 +392,36 @@ bool Channel_stream_state_apply_overrides(
 }
 
 
-void Channel_stream_state_update(Channel_stream_state* state, int64_t step_count)
+bool Channel_stream_state_update(Channel_stream_state* state, int64_t step_count)
 {
     rassert(state != NULL);
     rassert(step_count >= 0);
 
-    AAiter* iter = AAiter_init(AAITER_AUTO, state->tree);
-
-    Entry* entry = AAiter_get_at_least(iter, "");
-    while (entry != NULL)
+    Entry** link = &state->active_head;
+    while (*link != NULL)
     {
-        if (entry->is_set && !isnan(Linear_controls_get_value(&entry->controls)))
+        Entry* entry = *link;
+        rassert(entry->is_active);
+
+        const bool is_valid =
+            entry->is_set && !isnan(Linear_controls_get_value(&entry->controls));
+        if (is_valid)
             Linear_controls_skip(&entry->controls, step_count);
 
-        entry = AAiter_get_next(iter);
+        if (is_valid && Linear_controls_is_in_progress(&entry->controls))
+        {
+            link = &entry->next_active;
+        }
+        else
+        {
+            // Nothing to update until the entry is modified again
+            *link = entry->next_active;
+            entry->next_active = NULL;
+            entry->is_active = false;
+        }
     }
 
-    return;
+    return (state->active_head != NULL);
 }
 
 
@@ -397,11 +429,14 @@ void Channel_stream_state_reset(Channel_stream_state* state)
 {
     rassert(state != NULL);
 
-    AAiter* iter = AAiter_init(AAITER_AUTO, state->tree);
+    state->active_head = NULL;
 
-    Entry* entry = AAiter_get_at_least(iter, "");
-    while (entry != NULL)
+    for (int32_t i = 0; i < Vector_size(state->entries); ++i)
     {
+        Entry* entry = get_entry(state, i);
+
+        entry->next_active = NULL;
+        entry->is_active = false;
         Linear_controls_init(&entry->controls);
         entry->is_set = false;
 
@@ -411,8 +446,6 @@ void Channel_stream_state_reset(Channel_stream_state* state)
         entry->osc_depth = NAN;
         Tstamp_set(&entry->osc_depth_slide, -1, 0);
         entry->carry = false;
-
-        entry = AAiter_get_next(iter);
     }
 
     return;
@@ -424,7 +457,14 @@ void del_Channel_stream_state(Channel_stream_state* state)
     if (state == NULL)
         return;
 
-    del_AAtree(state->tree);
+    if (state->entries != NULL)
+    {
+        for (int32_t i = 0; i < Vector_size(state->entries); ++i)
+            memory_free(get_entry(state, i));
+
+        del_Vector(state->entries);
+    }
+
     memory_free(state);
 
     return;
@@ -24,7 +24,7 @@
 
 
 /**
- * A dictionary for stream states in a Channel.
+ * A table of stream states in a Channel, indexed by stream identifiers.
  */
 typedef struct Channel_stream_state Channel_stream_state;
 
@@ -32,10 +32,13 @@ typedef struct Channel_stream_state Channel_stream_state;
 /**
  * Create a new Channel stream state.
  *
+ * \param names   The table of stream names shared by all Channels
+ *                -- must not be \c NULL.
+ *
  * \return   The new Channel stream state if successful, or \c NULL if memory
  *           allocation failed.
  */
-Channel_stream_state* new_Channel_stream_state(void);
+Channel_stream_state* new_Channel_stream_state(const Name_table* names);
 
 
 /**
@@ -60,126 +63,142 @@ void Channel_stream_state_set_tempo(Channel_stream_state* state, double tempo);
 /**
  * Add a stream to the Channel stream state.
  *
- * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param state       The Channel stream state -- must not be \c NULL.
+ * \param stream_id   The stream identifier in the shared name table
+ *                    -- must be >= \c 0.
  *
  * \return   \c true if successful, or \c false if memory allocation failed.
  */
-bool Channel_stream_state_add_entry(
-        Channel_stream_state* state, const char* stream_name);
+bool Channel_stream_state_add_entry(Channel_stream_state* state, int32_t stream_id);
+
+
+/**
+ * Get the identifier of a stream name.
+ *
+ * Stream operations use identifiers so that the name only needs to be looked
+ * up once.
+ *
+ * \param state         The Channel stream state -- must not be \c NULL.
+ * \param stream_name   The name of the stream -- must not be \c NULL.
+ *
+ * \return   The stream identifier, or \c -1 if \a stream_name is not a known
+ *           stream.
+ */
+int32_t Channel_stream_state_get_id(
+        const Channel_stream_state* state, const char* stream_name);
 
 
 /**
  * Set a value of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param value         The value -- must be finite.
  *
  * \return   \c true if the new value was actually set, or \c false if \a state
- *           does not contain a stream called \a stream_name.
+ *           does not contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_value(
-        Channel_stream_state* state, const char* stream_name, double value);
+        Channel_stream_state* state, int32_t stream_id, double value);
 
 
 /**
  * Set sliding target of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param value         The target value -- must be finite.
  *
  * \return   \c true if \a value was applied, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_slide_target(
-        Channel_stream_state* state, const char* stream_name, double value);
+        Channel_stream_state* state, int32_t stream_id, double value);
 
 
 /**
  * Set slide length of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param length        The new slide length -- must not be \c NULL.
  *
  * \return   \c true if \a length was set, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_slide_length(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length);
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length);
 
 
 /**
  * Set oscillation speed of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param speed         The new speed -- must be finite and >= \c 0.
  *
  * \return   \c true if \a speed was applied, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_osc_speed(
-        Channel_stream_state* state, const char* stream_name, double speed);
+        Channel_stream_state* state, int32_t stream_id, double speed);
 
 
 /**
  * Set oscillation depth of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param depth         The new depth -- must be finite.
  *
  * \return   \c true if \a depth was applied, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_osc_depth(
-        Channel_stream_state* state, const char* stream_name, double depth);
+        Channel_stream_state* state, int32_t stream_id, double depth);
 
 
 /**
  * Set oscillation speed slide of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param length        The slide length -- must not be \c NULL.
  *
  * \return   \c true if \a length was set, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_osc_speed_slide(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length);
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length);
 
 
 /**
  * Set oscillation depth slide of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param length        The slide length -- must not be \c NULL.
  *
  * \return   \c true if \a length was set, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_osc_depth_slide(
-        Channel_stream_state* state, const char* stream_name, const Tstamp* length);
+        Channel_stream_state* state, int32_t stream_id, const Tstamp* length);
 
 
 /**
  * Set Linear controls of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param controls      The Linear controls -- must not be \c NULL.
  *
  * \return   \c true if \a controls were set, or \c false if \a state does not
- *           contain a stream called \a stream_name.
+ *           contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_controls(
         Channel_stream_state* state,
-        const char* stream_name,
+        int32_t stream_id,
         const Linear_controls* controls);
 
 
@@ -187,64 +206,70 @@ bool Channel_stream_state_set_controls(
  * Get Linear controls of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  *
  * \return   The Linear controls if a corresponding stream exists, otherwise \c NULL.
  */
 const Linear_controls* Channel_stream_state_get_controls(
-        const Channel_stream_state* state, const char* stream_name);
+        const Channel_stream_state* state, int32_t stream_id);
 
 
 /**
  * Set carrying state of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param enabled       \c true to enable carrying, \c false to disable.
  *
  * \return   \c true if the new carrying state was set, or \c false if \a state
- *           does not contain a stream called \a stream_name.
+ *           does not contain a stream with identifier \a stream_id.
  */
 bool Channel_stream_state_set_carrying_enabled(
-        Channel_stream_state* state, const char* stream_name, bool enabled);
+        Channel_stream_state* state, int32_t stream_id, bool enabled);
 
 
 /**
  * Get carrying state of a stream in the Channel stream state.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  *
- * \return   \c true if carrying is enabled for the stream called
- *           \a stream_name, otherwise \c false.
+ * \return   \c true if carrying is enabled for the stream with identifier
+ *           \a stream_id, otherwise \c false.
  */
 bool Channel_stream_state_is_carrying_enabled(
-        const Channel_stream_state* state, const char* stream_name);
+        const Channel_stream_state* state, int32_t stream_id);
 
 
 /**
  * Apply overriden settings in the Channel stream state to Linear controls.
  *
  * \param state         The Channel stream state -- must not be \c NULL.
- * \param stream_name   The name of the stream -- must be a valid variable name.
+ * \param stream_id     The stream identifier.
  * \param controls      The Linear controls -- must not be \c NULL.
  *
- * \return   \c true if settings were applied, or \c false if \a stream_name
+ * \return   \c true if settings were applied, or \c false if \a stream_id
  *           was not found in \a state.
  */
 bool Channel_stream_state_apply_overrides(
         const Channel_stream_state* state,
-        const char* stream_name,
+        int32_t stream_id,
         Linear_controls* controls);
 
 
 /**
  * Update streams in the Channel stream state.
  *
+ * Only streams that have been modified since they last became idle are
+ * visited.
+ *
  * \param state        The Channel stream state -- must not be \c NULL.
  * \param step_count   Number of steps to update -- must be >= \c 0.
+ *
+ * \return   \c true if any stream still has a slide or oscillation in
+ *           progress, otherwise \c false.
  */
-void Channel_stream_state_update(Channel_stream_state* state, int64_t step_count);
+bool Channel_stream_state_update(Channel_stream_state* state, int64_t step_count);
 
 
 /**
@@ -17,7 +17,10 @@
 #include <debug/assert.h>
 #include <init/Connections.h>
 #include <init/devices/Audio_unit.h>
+#include <init/devices/Device_impl.h>
+#include <init/devices/Processor.h>
 #include <kunquat/limits.h>
+#include <mathnum/common.h>
 #include <player/devices/Device_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <memory.h>
@@ -93,13 +96,145 @@ static Entry* new_Entry(Device_state* state, int thread_count)
 }
 
 
+typedef struct Dense_slot
+{
+    uint32_t id;
+    int index;                              // -1 if unused
+} Dense_slot;
+
+
+/**
+ * The dense index stores all Device states in a contiguous array. The thread
+ * states of each thread are stored together so that rendering threads only
+ * touch their own part of the index.
+ *
+ * Device IDs come from a process-wide counter, so they are mapped to the dense
+ * indices with a linear probing table sized by the device count.
+ */
+typedef struct Dense_index
+{
+    int count;
+    uint32_t slot_mask;
+    Dense_slot* slots;                      // slot_mask + 1
+    Device_state** states;                  // count
+    Device_thread_state** thread_states;    // thread_count * count
+} Dense_index;
+
+
 struct Device_states
 {
     int thread_count;
     Entry* entries[ENTRY_TABLE_SIZE];
+
+    bool is_dense_valid;
+    Dense_index dense;
+    void* dense_block;
 };
 
 
+static void Device_states_invalidate_dense_index(Device_states* states)
+{
+    rassert(states != NULL);
+
+    states->is_dense_valid = false;
+    memory_free(states->dense_block);
+    states->dense_block = NULL;
+
+    return;
+}
+
+
+static bool Device_states_build_dense_index(Device_states* states)
+{
+    rassert(states != NULL);
+
+    Device_states_invalidate_dense_index(states);
+
+    int count = 0;
+    for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
+    {
+        for (const Entry* entry = states->entries[ei]; entry != NULL; entry = entry->next)
+            ++count;
+    }
+
+    if (count == 0)
+        return true;
+
+    // Keep the slot table at most half full so that probe sequences stay short
+    const int64_t slot_count = ceil_p2(2 * (int64_t)count);
+    const int thread_count = states->thread_count;
+
+    char* block = memory_alloc(
+            (int64_t)sizeof(Dense_slot) * slot_count +
+            (int64_t)sizeof(Device_state*) * count +
+            (int64_t)sizeof(Device_thread_state*) * thread_count * count);
+    if (block == NULL)
+        return false;
+
+    states->dense_block = block;
+
+    Dense_index* dense = &states->dense;
+    dense->count = count;
+    dense->slot_mask = (uint32_t)(slot_count - 1);
+    dense->slots = (Dense_slot*)block;
+    block += sizeof(Dense_slot) * (size_t)slot_count;
+    dense->states = (Device_state**)block;
+    block += sizeof(Device_state*) * (size_t)count;
+    dense->thread_states = (Device_thread_state**)block;
+
+    for (int64_t i = 0; i < slot_count; ++i)
+    {
+        dense->slots[i].id = 0;
+        dense->slots[i].index = -1;
+    }
+
+    int index = 0;
+    for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
+    {
+        for (const Entry* entry = states->entries[ei]; entry != NULL; entry = entry->next)
+        {
+            const uint32_t id = entry->state->device_id;
+            uint32_t slot = id & dense->slot_mask;
+            while (dense->slots[slot].index >= 0)
+                slot = (slot + 1) & dense->slot_mask;
+
+            dense->slots[slot].id = id;
+            dense->slots[slot].index = index;
+            dense->states[index] = entry->state;
+            for (int ti = 0; ti < thread_count; ++ti)
+                dense->thread_states[ti * count + index] = entry->thread_states[ti];
+
+            ++index;
+        }
+    }
+
+    states->is_dense_valid = true;
+
+    return true;
+}
+
+
+static int get_dense_index(const Device_states* states, uint32_t id)
+{
+    rassert(states != NULL);
+
+    if (!states->is_dense_valid)
+        return -1;
+
+    const Dense_index* dense = &states->dense;
+    uint32_t slot = id & dense->slot_mask;
+    while (dense->slots[slot].index >= 0)
+    {
+        if (dense->slots[slot].id == id)
+            return dense->slots[slot].index;
+
+        slot = (slot + 1) & dense->slot_mask;
+    }
+
+    return -1;
+}
+
+
 Device_states* new_Device_states(void)
 {
     Device_states* states = memory_alloc_item(Device_states);
@@ -110,6 +245,9 @@ Device_states* new_Device_states(void)
     for (int i = 0; i < ENTRY_TABLE_SIZE; ++i)
         states->entries[i] = NULL;
 
+    states->is_dense_valid = false;
+    states->dense_block = NULL;
+
     return states;
 }
 
@@ -120,6 +258,8 @@ bool Device_states_set_thread_count(Device_states* states, int new_count)
     rassert(new_count >= 1);
     rassert(new_count <= KQT_THREADS_MAX);
 
+    Device_states_invalidate_dense_index(states);
+
     for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
     {
         Entry* entry = states->entries[ei];
@@ -165,6 +305,8 @@ bool Device_states_add_state(Device_states* states, Device_state* state)
     rassert(states != NULL);
     rassert(state != NULL);
 
+    Device_states_invalidate_dense_index(states);
+
     const uint32_t h = id_hash(state->device_id);
 
     Entry* entry = new_Entry(state, states->thread_count);
@@ -181,7 +323,7 @@ bool Device_states_add_state(Device_states* states, Device_state* state)
 }
 
 
-static Entry* get_entry(const Device_states* states, uint32_t id)
+static Entry* find_entry(const Device_states* states, uint32_t id)
 {
     rassert(states != NULL);
     rassert(id > 0);
@@ -198,16 +340,31 @@ static Entry* get_entry(const Device_states* states, uint32_t id)
         target = target->next;
     }
 
-    rassert(false);
     return NULL;
 }
 
 
+static Entry* get_entry(const Device_states* states, uint32_t id)
+{
+    rassert(states != NULL);
+    rassert(id > 0);
+
+    Entry* target = find_entry(states, id);
+    rassert(target != NULL);
+
+    return target;
+}
+
+
 Device_state* Device_states_get_state(const Device_states* states, uint32_t id)
 {
     rassert(states != NULL);
     rassert(id > 0);
 
+    const int index = get_dense_index(states, id);
+    if (index >= 0)
+        return states->dense.states[index];
+
     return get_entry(states, id)->state;
 }
 
@@ -217,6 +374,8 @@ void Device_states_remove_state(Device_states* states, uint32_t id)
     rassert(states != NULL);
     rassert(id > 0);
 
+    Device_states_invalidate_dense_index(states);
+
     const uint32_t h = id_hash(id);
 
     Entry** ref = &states->entries[h];
@@ -247,6 +406,13 @@ Device_thread_state* Device_states_get_thread_state(
     rassert(thread_id < KQT_THREADS_MAX);
     rassert(device_id > 0);
 
+    const int index = get_dense_index(states, device_id);
+    if (index >= 0)
+    {
+        rassert(thread_id < states->thread_count);
+        return states->dense.thread_states[thread_id * states->dense.count + index];
+    }
+
     Entry* entry = get_entry(states, device_id);
     rassert(entry != NULL);
     rassert(entry->thread_states[thread_id] != NULL);
@@ -255,6 +421,46 @@ Device_thread_state* Device_states_get_thread_state(
 }
 
 
+const Profile_counter* Device_states_get_profile(
+        const Device_states* states, int thread_id, uint32_t device_id)
+{
+    rassert(states != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
+    rassert(device_id > 0);
+
+    const Entry* entry = find_entry(states, device_id);
+    if ((entry == NULL) || (entry->thread_states[thread_id] == NULL))
+        return NULL;
+
+    return &entry->thread_states[thread_id]->profile;
+}
+
+
+void Device_states_reset_profiles(Device_states* states)
+{
+    rassert(states != NULL);
+
+    for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
+    {
+        Entry* entry = states->entries[ei];
+        while (entry != NULL)
+        {
+            for (int ti = 0; ti < KQT_THREADS_MAX; ++ti)
+            {
+                Device_thread_state* ts = entry->thread_states[ti];
+                if (ts != NULL)
+                    Profile_counter_reset(&ts->profile);
+            }
+
+            entry = entry->next;
+        }
+    }
+
+    return;
+}
+
+
 static bool Device_states_add_audio_buffer(
         Device_states* states, uint32_t device_id, Device_port_type type, int port)
 {
@@ -345,6 +551,16 @@ void Device_states_clear_audio_buffers(
 {
     rassert(states != NULL);
 
+    if (states->is_dense_valid)
+    {
+        const int count = states->thread_count * states->dense.count;
+        for (int i = 0; i < count; ++i)
+            Device_thread_state_clear_mixed_buffers(
+                    states->dense.thread_states[i], start, stop);
+
+        return;
+    }
+
     for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
     {
         Entry* entry = states->entries[ei];
@@ -382,6 +598,9 @@ void Device_states_set_tempo(Device_states* states, double tempo)
 }
 
 
+static bool Device_states_init_buffers(Device_states* dstates, const Connections* conns);
+
+
 static bool init_buffers(Device_states* dstates, const Device_node* node)
 {
     rassert(dstates != NULL);
@@ -453,6 +672,51 @@ static bool init_buffers(Device_states* dstates, const Device_node* node)
 }
 
 
+static bool Device_states_add_voice_lanes(Device_states* states, const Audio_unit* au)
+{
+    rassert(states != NULL);
+    rassert(au != NULL);
+
+    // Voice lanes are only used by Processors of Audio units that may render
+    // Voice groups in batches
+    bool is_batchable = false;
+    for (int pi = 0; pi < KQT_PROCESSORS_MAX; ++pi)
+    {
+        const Processor* proc = Audio_unit_get_proc(au, pi);
+        if ((proc != NULL) &&
+                (proc->parent.dimpl != NULL) &&
+                (proc->parent.dimpl->render_voices_batch != NULL))
+        {
+            is_batchable = true;
+            break;
+        }
+    }
+
+    if (!is_batchable)
+        return true;
+
+    for (int pi = 0; pi < KQT_PROCESSORS_MAX; ++pi)
+    {
+        const Processor* proc = Audio_unit_get_proc(au, pi);
+        if (proc == NULL)
+            continue;
+
+        const Entry* entry = find_entry(states, Device_get_id((const Device*)proc));
+        if (entry == NULL)
+            continue;
+
+        for (int ti = 0; ti < states->thread_count; ++ti)
+        {
+            Device_thread_state* ts = entry->thread_states[ti];
+            if ((ts != NULL) && !Device_thread_state_add_voice_lanes(ts))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+
 static bool init_effect_buffers(Device_states* dstates, const Device_node* node)
 {
     rassert(dstates != NULL);
@@ -485,7 +749,8 @@ static bool init_effect_buffers(Device_states* dstates, const Device_node* node)
         const Connections* au_conns = Audio_unit_get_connections(au);
         if (au_conns != NULL)
         {
-            if (!Device_states_prepare(dstates, au_conns))
+            if (!Device_states_init_buffers(dstates, au_conns) ||
+                    !Device_states_add_voice_lanes(dstates, au))
                 return false;
         }
     }
@@ -534,50 +799,108 @@ bool Device_states_prepare(Device_states* dstates, const Connections* conns)
     rassert(dstates != NULL);
     rassert(conns != NULL);
 
-    return Device_states_init_buffers(dstates, conns);
+    return Device_states_init_buffers(dstates, conns) &&
+        Device_states_build_dense_index(dstates);
 }
 
 
-void Device_states_mix_thread_states(
-        Device_states* dstates, int32_t buf_start, int32_t buf_stop)
+static void reduce_thread_states(
+        Device_thread_state** thread_states,
+        int thread_count,
+        int stride,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(thread_states != NULL);
+    rassert(thread_count > 1);
+    rassert(stride > 0);
+
+    Device_thread_state* dest_state = thread_states[0];
+    rassert(dest_state != NULL);
+
+    // If only one thread has produced audio on top of a freshly cleared
+    // destination, take over its buffer contents instead of mixing
+    if ((buf_start == 0) && !Device_thread_state_has_mixed_audio(dest_state))
+    {
+        int src_index = -1;
+        for (int ti = 1; ti < thread_count; ++ti)
+        {
+            if (Device_thread_state_has_mixed_audio(thread_states[ti * stride]))
+            {
+                if (src_index >= 0)
+                {
+                    src_index = -1;
+                    break;
+                }
+
+                src_index = ti;
+            }
+        }
+
+        if (src_index >= 0)
+        {
+            Device_thread_state_swap_mixed_audio(
+                    dest_state, thread_states[src_index * stride]);
+            return;
+        }
+    }
+
+    for (int ti = 1; ti < thread_count; ++ti)
+        Device_thread_state_mix_thread_state(
+                dest_state, thread_states[ti * stride], buf_start, buf_stop);
+
+    return;
+}
+
+
+void Device_states_mix_thread_states_part(
+        Device_states* dstates,
+        int part_index,
+        int part_count,
+        int32_t buf_start,
+        int32_t buf_stop)
 {
     rassert(dstates != NULL);
+    rassert(part_count > 0);
+    rassert(part_index >= 0);
+    rassert(part_index < part_count);
     rassert(buf_start >= 0);
     rassert(buf_stop >= 0);
 
     if (dstates->thread_count <= 1)
         return;
 
+    if (dstates->is_dense_valid)
+    {
+        const int count = dstates->dense.count;
+        Device_thread_state** thread_states = dstates->dense.thread_states;
+
+        for (int i = part_index; i < count; i += part_count)
+            reduce_thread_states(
+                    thread_states + i,
+                    dstates->thread_count,
+                    count,
+                    buf_start,
+                    buf_stop);
+
+        return;
+    }
+
+    // Without the dense index the devices cannot be divided cheaply
+    if (part_index != 0)
+        return;
+
     for (int ei = 0; ei < ENTRY_TABLE_SIZE; ++ei)
     {
         Entry* entry = dstates->entries[ei];
         while (entry != NULL)
         {
-            Device_thread_state* dest_state = entry->thread_states[0];
-            rassert(dest_state != NULL);
-
-            for (int ti = 1; ti < dstates->thread_count; ++ti)
-            {
-                const Device_thread_state* src_state = entry->thread_states[ti];
-                rassert(src_state != NULL);
-                if (Device_thread_state_has_mixed_audio(src_state))
-                {
-                    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
-                    {
-                        Work_buffer* dest_buffer = Device_thread_state_get_mixed_buffer(
-                                dest_state, DEVICE_PORT_TYPE_SEND, port);
-                        if (dest_buffer == NULL)
-                            continue;
-
-                        const Work_buffer* src_buffer =
-                            Device_thread_state_get_mixed_buffer(
-                                    src_state, DEVICE_PORT_TYPE_SEND, port);
-                        rassert(src_buffer != NULL);
-
-                        Work_buffer_mix(dest_buffer, src_buffer, buf_start, buf_stop);
-                    }
-                }
-            }
+            reduce_thread_states(
+                    entry->thread_states,
+                    dstates->thread_count,
+                    1,
+                    buf_start,
+                    buf_stop);
 
             entry = entry->next;
         }
@@ -646,6 +969,7 @@ void del_Device_states(Device_states* states)
         }
     }
 
+    memory_free(states->dense_block);
     memory_free(states);
 
     return;
@@ -18,6 +18,7 @@
 
 #include <decl.h>
 #include <kunquat/limits.h>
+#include <player/Render_profile.h>
 
 #include <stdbool.h>
 #include <stdint.h>
@@ -93,6 +94,29 @@ Device_thread_state* Device_states_get_thread_state(
         const Device_states* states, int thread_id, uint32_t device_id);
 
 
+/**
+ * Get the render profile of a Device in a thread.
+ *
+ * \param states      The Device states -- must not be \c NULL.
+ * \param thread_id   The thread ID -- must be >= \c 0 and
+ *                    < \c KQT_THREADS_MAX.
+ * \param device_id   The Device ID -- must be > \c 0.
+ *
+ * \return   The Profile counter, or \c NULL if \a states does not contain
+ *           a thread state for the Device in the given thread.
+ */
+const Profile_counter* Device_states_get_profile(
+        const Device_states* states, int thread_id, uint32_t device_id);
+
+
+/**
+ * Reset the render profiles of all Device thread states.
+ *
+ * \param states   The Device states -- must not be \c NULL.
+ */
+void Device_states_reset_profiles(Device_states* states);
+
+
 /**
  * Set the audio rate.
  *
@@ -139,6 +163,11 @@ void Device_states_set_tempo(Device_states* states, double tempo);
 /**
  * Prepare the Device states for mixing.
  *
+ * This also builds a dense index of the Device states for fast lookups
+ * during rendering. Adding or removing states or changing the thread count
+ * discards the index, and lookups fall back to a slower search until the
+ * next call of this function.
+ *
  * \param dstates   The Device states -- must not be \c NULL.
  * \param conns     The Connections -- must not be \c NULL.
  *
@@ -148,16 +177,29 @@ bool Device_states_prepare(Device_states* dstates, const Connections* conns);
 
 
 /**
- * Mix buffers rendered by separate threads.
- *
- * \param dstates     The Device states -- must not be \c NULL.
- * \param buf_start   The start index of the buffer area to be processed
- *                    -- must be less than the buffer size.
- * \param buf_stop    The stop index of the buffer area to be processed
- *                    -- must be less than or equal to the buffer size.
- */
-void Device_states_mix_thread_states(
-        Device_states* dstates, int32_t buf_start, int32_t buf_stop);
+ * Mix buffers rendered by separate threads for a subset of devices.
+ *
+ * The devices are divided into \a part_count interleaved subsets so that
+ * each rendering thread can reduce its own subset concurrently with the
+ * others. If only one thread has produced audio for a device whose
+ * destination buffers have not been written to yet, the buffer contents
+ * are exchanged instead of mixed.
+ *
+ * \param dstates      The Device states -- must not be \c NULL.
+ * \param part_index   The index of the subset to be processed -- must be
+ *                     >= \c 0 and less than \a part_count.
+ * \param part_count   The number of subsets -- must be > \c 0.
+ * \param buf_start    The start index of the buffer area to be processed
+ *                     -- must be less than the buffer size.
+ * \param buf_stop     The stop index of the buffer area to be processed
+ *                     -- must be less than or equal to the buffer size.
+ */
+void Device_states_mix_thread_states_part(
+        Device_states* dstates,
+        int part_index,
+        int part_count,
+        int32_t buf_start,
+        int32_t buf_stop);
 
 
 /**
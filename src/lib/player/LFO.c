@@ -16,8 +16,10 @@
 
 #include <debug/assert.h>
 #include <mathnum/common.h>
+#include <mathnum/fast_math.h>
 #include <mathnum/fast_sin.h>
 #include <player/Player.h>
+#include <player/Work_buffer.h>
 
 #include <math.h>
 #include <stdbool.h>
@@ -390,6 +392,147 @@ double LFO_skip(LFO* lfo, int64_t steps)
 }
 
 
+static int32_t LFO_get_closed_form_steps(const LFO* lfo, int32_t count)
+{
+    rassert(lfo != NULL);
+    rassert(count >= 0);
+
+    // Only a steady oscillation is rendered in closed form
+    if (!lfo->on ||
+            (lfo->update <= 0) ||
+            Slider_in_progress(&lfo->speed_slider) ||
+            Slider_in_progress(&lfo->depth_slider) ||
+            (lfo->target_depth == 0))
+        return 0;
+
+    const double phase = lfo->phase;
+    const double update = lfo->update;
+
+    // Count the steps before the next phase wrap
+    const double estimate = ceil(((2 * PI) - phase) / update) - 1;
+    int32_t steps = (estimate < count) ? max(0, (int32_t)estimate) : count;
+    while ((steps < count) && (phase + (double)(steps + 1) * update < (2 * PI)))
+        ++steps;
+    while ((steps > 0) && (phase + (double)steps * update >= (2 * PI)))
+        --steps;
+
+    return steps;
+}
+
+
+#define LFO_BLOCK_SIZE 128
+
+
+static void LFO_render(LFO* lfo, float* values, int32_t count, bool mix)
+{
+    rassert(lfo != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    int32_t i = 0;
+    while (i < count)
+    {
+        const int32_t steps = LFO_get_closed_form_steps(lfo, count - i);
+        if (steps == 0)
+        {
+            // Phase wraps, slides and stopping require the full step logic
+            const float value = (float)LFO_step(lfo);
+            values[i] = mix ? values[i] + value : value;
+            ++i;
+            continue;
+        }
+
+        const double phase = lfo->phase;
+        const double update = lfo->update;
+        const double depth = lfo->target_depth;
+
+        float block[LFO_BLOCK_SIZE] = { 0.0f };
+
+        for (int32_t block_start = 0; block_start < steps; block_start += LFO_BLOCK_SIZE)
+        {
+            const int32_t block_size = min(steps - block_start, LFO_BLOCK_SIZE);
+
+            // Fill the phases and replace them with the values
+            for (int32_t k = 0; k < block_size; ++k)
+                block[k] = (float)(phase + (double)(block_start + k + 1) * update);
+
+            fast_sin_array(block, block, block_size, depth, FAST_MATH_ACCURACY_APPROX);
+
+            if (lfo->mode == LFO_MODE_EXP)
+                fast_exp2_array(block, block, block_size, 1, 1, FAST_MATH_ACCURACY_FULL);
+            else
+                rassert(lfo->mode == LFO_MODE_LINEAR);
+
+            float* dest = values + i + block_start;
+            if (mix)
+            {
+                for (int32_t k = 0; k < block_size; ++k)
+                    dest[k] += block[k];
+            }
+            else
+            {
+                for (int32_t k = 0; k < block_size; ++k)
+                    dest[k] = block[k];
+            }
+        }
+
+        lfo->phase = phase + (double)steps * update;
+        i += steps;
+    }
+
+    return;
+}
+
+
+void LFO_fill(LFO* lfo, float* values, int32_t count)
+{
+    rassert(lfo != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    LFO_render(lfo, values, count, false);
+
+    return;
+}
+
+
+void LFO_mix(LFO* lfo, float* values, int32_t count)
+{
+    rassert(lfo != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    LFO_render(lfo, values, count, true);
+
+    return;
+}
+
+
+void LFO_mix_control_points(
+        LFO* lfo, float* values, int32_t buf_start, int32_t buf_stop, int32_t period)
+{
+    rassert(lfo != NULL);
+    rassert(values != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop > buf_start);
+    rassert(period >= 1);
+
+    int32_t prev_pos = buf_start - 1;
+    for (int32_t pos = buf_start;
+            pos < buf_stop;
+            pos = Work_buffer_get_next_control_pos(pos, buf_stop, period))
+    {
+        if (LFO_estimate_active_steps_left(lfo) == 0)
+            break;
+
+        values[pos] += (float)LFO_skip(lfo, pos - prev_pos);
+        prev_pos = pos;
+    }
+
+    return;
+}
+
+
 static void LFO_update_time(LFO* lfo, int32_t audio_rate, double tempo)
 {
     rassert(lfo != NULL);
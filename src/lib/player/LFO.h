@@ -209,6 +209,56 @@ double LFO_step(LFO* lfo);
 double LFO_skip(LFO* lfo, int64_t steps);
 
 
+/**
+ * Fill a block with consecutive LFO values.
+ *
+ * The value written at index i is the value after i + 1 steps. While the LFO
+ * oscillates at constant speed and depth, the phases are calculated in closed
+ * form between phase wraps, which lets the block be computed without
+ * per-sample state updates. The phase may therefore differ from the result
+ * of \a LFO_step by the rounding error that stepping accumulates over one
+ * period, i.e. roughly \c DBL_EPSILON times the number of steps per period.
+ * Speed and depth slides as well as the final half-period after turning the
+ * LFO off are processed step by step.
+ *
+ * \param lfo      The LFO -- must not be \c NULL.
+ * \param values   The destination array -- must not be \c NULL.
+ * \param count    The number of steps to perform -- must be >= \c 0.
+ */
+void LFO_fill(LFO* lfo, float* values, int32_t count);
+
+
+/**
+ * Add a block of consecutive LFO values.
+ *
+ * This is the same as \a LFO_fill except that the values are added to the
+ * existing contents of \a values.
+ *
+ * \param lfo      The LFO -- must not be \c NULL.
+ * \param values   The destination array -- must not be \c NULL.
+ * \param count    The number of steps to perform -- must be >= \c 0.
+ */
+void LFO_mix(LFO* lfo, float* values, int32_t count);
+
+
+/**
+ * Add LFO values at control points.
+ *
+ * The value added at index i is the value after i - \a buf_start + 1
+ * steps. Nothing is added after the LFO has become inactive.
+ *
+ * \param lfo         The LFO -- must not be \c NULL.
+ * \param values      The destination array -- must not be \c NULL.
+ * \param buf_start   The start index of the area to be processed -- must be
+ *                    >= \c 0.
+ * \param buf_stop    The stop index of the area to be processed -- must be
+ *                    > \a buf_start.
+ * \param period      The control period -- must be >= \c 1.
+ */
+void LFO_mix_control_points(
+        LFO* lfo, float* values, int32_t buf_start, int32_t buf_stop, int32_t period);
+
+
 /**
  * Find out whether the LFO is still providing non-trivial values.
  *
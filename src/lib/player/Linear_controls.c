@@ -21,6 +21,7 @@
 #include <player/Work_buffer.h>
 
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -226,15 +227,62 @@ void Linear_controls_osc_depth_slide_value(Linear_controls* lc, const Tstamp* le
 }
 
 
+static void fill_control_points(
+        Linear_controls* lc,
+        Work_buffer* wb,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t control_period)
+{
+    rassert(lc != NULL);
+    rassert(wb != NULL);
+    rassert(buf_start < buf_stop);
+    rassert(control_period > 1);
+
+    const bool is_varying = Slider_in_progress(&lc->slider) ||
+        (LFO_estimate_active_steps_left(&lc->lfo) > 0);
+
+    float* values = Work_buffer_get_contents_mut(wb);
+
+    lc->value = Slider_fill_control_points(
+            &lc->slider, lc->value, values, buf_start, buf_stop, control_period);
+
+    LFO_mix_control_points(&lc->lfo, values, buf_start, buf_stop, control_period);
+
+    // Clamp values
+    const float min_value = (float)lc->min_value;
+    const float max_value = (float)lc->max_value;
+    for (int32_t i = buf_start;
+            i < buf_stop;
+            i = Work_buffer_get_next_control_pos(i, buf_stop, control_period))
+        values[i] = clamp(values[i], min_value, max_value);
+
+    Work_buffer_interpolate_control_values(wb, buf_start, buf_stop, control_period);
+
+    // Mark constant region of the buffer
+    Work_buffer_set_const_start(wb, is_varying ? buf_stop : buf_start);
+
+    return;
+}
+
+
 void Linear_controls_fill_work_buffer(
         Linear_controls* lc,
         Work_buffer* wb,
         int32_t buf_start,
-        int32_t buf_stop)
+        int32_t buf_stop,
+        int32_t control_period)
 {
     rassert(lc != NULL);
     rassert(wb != NULL);
     rassert(buf_start < buf_stop);
+    rassert(control_period >= 1);
+
+    if (control_period > 1)
+    {
+        fill_control_points(lc, wb, buf_start, buf_stop, control_period);
+        return;
+    }
 
     float* values = Work_buffer_get_contents_mut(wb);
 
@@ -253,13 +301,8 @@ void Linear_controls_fill_work_buffer(
                 if (estimated_steps < buf_stop - cur_pos)
                     slide_stop = cur_pos + estimated_steps;
 
-                double new_value = lc->value;
-                for (int32_t i = cur_pos; i < slide_stop; ++i)
-                {
-                    new_value = Slider_step(&lc->slider);
-                    values[i] = (float)new_value;
-                }
-                lc->value = new_value;
+                lc->value = Slider_fill(
+                        &lc->slider, values + cur_pos, slide_stop - cur_pos);
 
                 const_start = slide_stop;
                 cur_pos = slide_stop;
@@ -288,8 +331,7 @@ void Linear_controls_fill_work_buffer(
                 if (estimated_steps < buf_stop - cur_pos)
                     lfo_stop = cur_pos + estimated_steps;
 
-                for (int32_t i = cur_pos; i < lfo_stop; ++i)
-                    values[i] += (float)LFO_step(&lc->lfo);
+                LFO_mix(&lc->lfo, values + cur_pos, lfo_stop - cur_pos);
 
                 final_lfo_stop = lfo_stop;
                 cur_pos = lfo_stop;
@@ -326,6 +368,16 @@ void Linear_controls_fill_work_buffer(
 }
 
 
+bool Linear_controls_is_in_progress(const Linear_controls* lc)
+{
+    rassert(lc != NULL);
+
+    return Slider_in_progress(&lc->slider) ||
+        LFO_active(&lc->lfo) ||
+        (LFO_estimate_active_steps_left(&lc->lfo) > 0);
+}
+
+
 void Linear_controls_skip(Linear_controls* lc, int64_t step_count)
 {
     rassert(lc != NULL);
@@ -23,6 +23,7 @@
 #include <player/Work_buffer.h>
 
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -199,16 +200,31 @@ void Linear_controls_osc_depth_slide_value(Linear_controls* lc, const Tstamp* le
 /**
  * Fill Work buffer with updates of the Linear controls.
  *
- * \param lc          The Linear controls -- must not be \c NULL.
- * \param wb          The Work buffer -- must not be \c NULL.
- * \param buf_start   The buffer start index -- must be >= \c 0.
- * \param buf_stop    The buffer stop index -- must be >= \a buf_start.
+ * \param lc               The Linear controls -- must not be \c NULL.
+ * \param wb               The Work buffer -- must not be \c NULL.
+ * \param buf_start        The buffer start index -- must be >= \c 0.
+ * \param buf_stop         The buffer stop index -- must be >= \a buf_start.
+ * \param control_period   The distance between computed values in frames
+ *                         -- must be >= \c 1. Values between them are
+ *                         interpolated linearly.
  */
 void Linear_controls_fill_work_buffer(
         Linear_controls* lc,
         Work_buffer* wb,
         int32_t buf_start,
-        int32_t buf_stop);
+        int32_t buf_stop,
+        int32_t control_period);
+
+
+/**
+ * Check if the Linear controls change over time.
+ *
+ * \param lc   The Linear controls -- must not be \c NULL.
+ *
+ * \return   \c true if a slide or oscillation is in progress or pending,
+ *           otherwise \c false.
+ */
+bool Linear_controls_is_in_progress(const Linear_controls* lc);
 
 
 /**
@@ -52,8 +52,8 @@ static void Master_params_clear(Master_params* params)
     Tstamp_init(&params->tempo_slide_length);
     params->tempo_slide_target = 0;
     Tstamp_init(&params->tempo_slide_left);
-    Tstamp_init(&params->tempo_slide_slice_left);
-    params->tempo_slide_update = 0;
+    params->tempo_slide_current = 0;
+    params->tempo_slide_rate = 0;
 
     for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
     {
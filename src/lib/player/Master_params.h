@@ -70,8 +70,8 @@ struct Master_params
     Tstamp tempo_slide_length;
     double tempo_slide_target;
     Tstamp tempo_slide_left;
-    Tstamp tempo_slide_slice_left;
-    double tempo_slide_update;
+    double tempo_slide_current; // tempo at the current slide position
+    double tempo_slide_rate;    // tempo change per beat
 
     struct
     {
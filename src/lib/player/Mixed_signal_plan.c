@@ -29,6 +29,8 @@
 #include <player/devices/Device_state.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/Mixed_signal_plan.h>
+#include <player/Render_profile.h>
+#include <player/Render_trace.h>
 #include <player/Work_buffer.h>
 #include <threads/Mutex.h>
 
@@ -182,6 +184,8 @@ static bool Mixed_signal_task_info_add_bypass_input(
 static void Mixed_signal_task_info_execute(
         const Mixed_signal_task_info* task_info,
         Device_states* dstates,
+        int thread_id,
+        Render_trace* trace,
         Work_buffers* wbs,
         int32_t buf_start,
         int32_t buf_stop,
@@ -189,6 +193,8 @@ static void Mixed_signal_task_info_execute(
 {
     rassert(task_info != NULL);
     rassert(dstates != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
     rassert(wbs != NULL);
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
@@ -233,8 +239,22 @@ static void Mixed_signal_task_info_execute(
     Device_thread_state* target_ts =
         Device_states_get_thread_state(dstates, 0, task_info->device_id);
     Device_state* target_dstate = Device_states_get_state(dstates, task_info->device_id);
+
+    PROFILE_START(render_start_time);
+    TRACE_START(trace, trace_start_time);
+
     Device_state_render_mixed(target_dstate, target_ts, wbs, buf_start, buf_stop, tempo);
 
+    TRACE_STOP(trace, trace_start_time, TRACE_EVENT_MIXED_TASK, task_info->device_id);
+
+#ifdef ENABLE_RENDER_PROFILING
+    {
+        Device_thread_state* profile_ts =
+            Device_states_get_thread_state(dstates, thread_id, task_info->device_id);
+        PROFILE_STOP(&profile_ts->profile, render_start_time, 0);
+    }
+#endif
+
     return;
 }
 
@@ -744,6 +764,8 @@ void Mixed_signal_plan_reset(Mixed_signal_plan* plan)
 bool Mixed_signal_plan_execute_next_task(
         Mixed_signal_plan* plan,
         int level_index,
+        int thread_id,
+        Render_trace* trace,
         Work_buffers* wbs,
         int32_t buf_start,
         int32_t buf_stop,
@@ -752,11 +774,13 @@ bool Mixed_signal_plan_execute_next_task(
     rassert(plan != NULL);
     rassert(level_index >= 0);
     rassert(level_index < plan->level_count);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
     rassert(tempo > 0);
 
-    Mutex_lock(&plan->iter_lock);
+    Mutex_lock_in_render(&plan->iter_lock);
 
     if (plan->iter_level_index < 0)
     {
@@ -792,7 +816,14 @@ bool Mixed_signal_plan_execute_next_task(
     Mutex_unlock(&plan->iter_lock);
 
     Mixed_signal_task_info_execute(
-            task_info, plan->dstates, wbs, buf_start, buf_stop, tempo);
+            task_info,
+            plan->dstates,
+            thread_id,
+            trace,
+            wbs,
+            buf_start,
+            buf_stop,
+            tempo);
 
     return any_tasks_left_this_level;
 }
@@ -801,6 +832,7 @@ bool Mixed_signal_plan_execute_next_task(
 
 void Mixed_signal_plan_execute_all_tasks(
         Mixed_signal_plan* plan,
+        Render_trace* trace,
         Work_buffers* wbs,
         int32_t buf_start,
         int32_t buf_stop,
@@ -824,7 +856,14 @@ void Mixed_signal_plan_execute_all_tasks(
             rassert(task_info != NULL);
 
             Mixed_signal_task_info_execute(
-                    task_info, plan->dstates, wbs, buf_start, buf_stop, tempo);
+                    task_info,
+                    plan->dstates,
+                    0,
+                    trace,
+                    wbs,
+                    buf_start,
+                    buf_stop,
+                    tempo);
         }
     }
 
@@ -65,6 +65,9 @@ void Mixed_signal_plan_reset(Mixed_signal_plan* plan);
  *                      Mixed_signal_plan_get_level_count(\a plan) - 1, and
  *                      \a level must decrease by \c 1 after each time this function
  *                      returns \c false.
+ * \param thread_id     The ID of the calling thread -- must be >= \c 0 and
+ *                      < \c KQT_THREADS_MAX.
+ * \param trace         The Render trace of the calling thread, or \c NULL.
  * \param wbs           The Work buffers -- must not be \c NULL.
  * \param buf_start     The start index of buffer areas to be processed
  *                      -- must be less than the buffer size.
@@ -78,6 +81,8 @@ void Mixed_signal_plan_reset(Mixed_signal_plan* plan);
 bool Mixed_signal_plan_execute_next_task(
         Mixed_signal_plan* plan,
         int level_index,
+        int thread_id,
+        Render_trace* trace,
         Work_buffers* wbs,
         int32_t buf_start,
         int32_t buf_stop,
@@ -89,6 +94,7 @@ bool Mixed_signal_plan_execute_next_task(
  * Execute all tasks in the Mixed signal plan using a single thread.
  *
  * \param plan        The Mixed signal plan -- must not be \c NULL.
+ * \param trace       The Render trace, or \c NULL.
  * \param wbs         The Work buffers -- must not be \c NULL.
  * \param buf_start   The start index of buffer areas to be processed
  *                    -- must be less than the buffer size.
@@ -98,6 +104,7 @@ bool Mixed_signal_plan_execute_next_task(
  */
 void Mixed_signal_plan_execute_all_tasks(
         Mixed_signal_plan* plan,
+        Render_trace* trace,
         Work_buffers* wbs,
         int32_t buf_start,
         int32_t buf_stop,
@@ -14,10 +14,13 @@
 
 #include <player/Player.h>
 
+#include <containers/AAtree.h>
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 #include <Error.h>
 #include <init/devices/Au_params.h>
 #include <init/devices/Audio_unit.h>
+#include <init/devices/Device_impl.h>
 #include <init/sheet/Channel_defaults.h>
 #include <mathnum/common.h>
 #include <memory.h>
@@ -28,6 +31,8 @@
 #include <player/Player_private.h>
 #include <player/Player_seq.h>
 #include <player/Position.h>
+#include <player/Render_profile.h>
+#include <player/Render_trace.h>
 #include <player/Tuning_state.h>
 #include <player/Voice_group.h>
 #include <player/Work_buffer.h>
@@ -38,6 +43,8 @@
 #include <threads/Mutex.h>
 #include <threads/Thread.h>
 
+#include <inttypes.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -65,6 +72,7 @@ static void Player_thread_params_init(
     tp->work_buffers = NULL;
     for (int i = 0; i < TEST_VOICE_OUTPUTS_MAX; ++i)
         tp->test_voice_outputs[i] = NULL;
+    tp->trace = NULL;
 
     return;
 }
@@ -81,6 +89,8 @@ static void Player_thread_params_deinit(Player_thread_params* tp)
         del_Work_buffer(tp->test_voice_outputs[i]);
         tp->test_voice_outputs[i] = NULL;
     }
+    del_Render_trace(tp->trace);
+    tp->trace = NULL;
 
     return;
 }
@@ -143,6 +153,7 @@ Player* new_Player(
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         player->threads[i] = *THREAD_AUTO;
     player->ok_to_start = false;
+    player->abort_start = false;
     player->stop_threads = false;
     player->render_start = 0;
     player->render_stop = 0;
@@ -153,15 +164,17 @@ Player* new_Player(
     player->voices = NULL;
     player->mixed_signal_plan = NULL;
     Master_params_preinit(&player->master_params);
+    player->stream_names = NULL;
+    player->cv_names = NULL;
     for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
         player->channels[i] = NULL;
+    player->active_channels = NULL;
     player->event_handler = NULL;
 
     player->frame_remainder = 0.0;
 
     player->cgiters_accessed = false;
-    for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-        Cgiter_init(&player->cgiters[i], player->module, i);
+    Cgiter_init(&player->cgiter, player->module);
 
     player->audio_frames_processed = 0;
     player->nanoseconds_history = 0;
@@ -172,15 +185,26 @@ Player* new_Player(
     memset(player->susp_event_name, '\0', EVENT_NAME_MAX + 1);
     player->susp_event_value = *VALUE_AUTO;
 
+    for (int i = 0; i < RENDER_STAGE_COUNT; ++i)
+        Profile_counter_reset(&player->stage_profiles[i]);
+    player->main_trace = NULL;
+    player->report = NULL;
+    player->report_size = 0;
+    player->report_length = 0;
+
     // Init fields
     player->device_states = new_Device_states();
     player->estate = new_Env_state(player->module->env);
     player->event_buffer = new_Event_buffer(event_buffer_size);
     player->voices = new_Voice_pool(voice_count);
+    player->stream_names = new_Name_table();
+    player->cv_names = new_Name_table();
     if (player->device_states == NULL ||
             player->estate == NULL ||
             player->event_buffer == NULL ||
             player->voices == NULL ||
+            player->stream_names == NULL ||
+            player->cv_names == NULL ||
             !Voice_pool_reserve_state_space(
                 player->voices,
                 sizeof(Voice_state)))
@@ -216,6 +240,8 @@ Player* new_Player(
                 Module_get_au_table(player->module),
                 player->estate,
                 player->voices,
+                player->stream_names,
+                player->cv_names,
                 player->master_params.tempo,
                 player->audio_rate);
         if (player->channels[i] == NULL)
@@ -306,6 +332,38 @@ static bool Player_thread_params_create_buffers(
 }
 
 
+static bool Player_update_render_traces(Player* player, int thread_count)
+{
+    rassert(player != NULL);
+    rassert(thread_count >= 0);
+    rassert(thread_count <= KQT_THREADS_MAX);
+
+    const bool enabled = (player->main_trace != NULL);
+
+    for (int i = 0; i < KQT_THREADS_MAX; ++i)
+    {
+        Player_thread_params* tp = &player->thread_params[i];
+
+        if (enabled && (i < thread_count))
+        {
+            if (tp->trace == NULL)
+            {
+                tp->trace = new_Render_trace(RENDER_TRACE_CAPACITY_DEFAULT);
+                if (tp->trace == NULL)
+                    return false;
+            }
+        }
+        else
+        {
+            del_Render_trace(tp->trace);
+            tp->trace = NULL;
+        }
+    }
+
+    return true;
+}
+
+
 bool Player_set_thread_count(Player* player, int new_count, Error* error)
 {
     rassert(player != NULL);
@@ -346,6 +404,16 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
         }
     }
 
+    // (De)allocate Render traces of rendering threads as needed
+    if (!Player_update_render_traces(player, new_count))
+    {
+        Error_set(
+                error,
+                ERROR_MEMORY,
+                "Could not allocate memory for new render traces");
+        return false;
+    }
+
     // (De)allocate Work buffers of Device states as needed
     if (!Device_states_set_thread_count(player->device_states, new_count) ||
             !Player_prepare_mixing(player))
@@ -412,7 +480,7 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
             // in the destructor would get messy
             Mutex* mutex = Condition_get_mutex(&player->start_cond);
             Mutex_lock(mutex);
-            player->stop_threads = true;
+            player->abort_start = true;
             player->ok_to_start = true;
             Condition_broadcast(&player->start_cond);
             Mutex_unlock(mutex);
@@ -420,7 +488,7 @@ bool Player_set_thread_count(Player* player, int new_count, Error* error)
             for (int k = i - 1; k >= 0; --k)
                 Thread_join(&player->threads[k]);
 
-            player->stop_threads = false;
+            player->abort_start = false;
 
             player->thread_count = 1;
 
@@ -515,9 +583,13 @@ bool Player_alloc_channel_cv_state(Player* player, const Au_control_vars* aucv)
     Au_control_var_iter_get_next_var_info(iter, &var_name, &var_type);
     while (var_name != NULL)
     {
+        const int32_t var_id = Name_table_add(player->cv_names, var_name);
+        if (var_id < 0)
+            return false;
+
         for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
         {
-            if (!Channel_cv_state_add_entry(player->channels[i]->cvstate, var_name))
+            if (!Channel_cv_state_add_entry(player->channels[i]->cvstate, var_id))
                 return false;
         }
 
@@ -539,9 +611,13 @@ bool Player_alloc_channel_streams(Player* player, const Au_streams* streams)
     const char* name = Stream_target_dev_iter_get_next(iter);
     while (name != NULL)
     {
+        const int32_t stream_id = Name_table_add(player->stream_names, name);
+        if (stream_id < 0)
+            return false;
+
         for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
         {
-            if (!Channel_stream_state_add_entry(player->channels[i]->csstate, name))
+            if (!Channel_stream_state_add_entry(player->channels[i]->csstate, stream_id))
                 return false;
         }
 
@@ -628,8 +704,7 @@ void Player_reset(Player* player, int track_num)
 
     Player_reset_channels(player);
 
-    for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-        Cgiter_reset(&player->cgiters[i], &player->master_params.cur_pos);
+    Cgiter_reset(&player->cgiter, &player->master_params.cur_pos);
 
     player->cgiters_accessed = false;
 
@@ -832,6 +907,8 @@ static void Player_process_voice_group(
     rassert(render_stop >= render_start);
     rassert(stats != NULL);
 
+    TRACE_START(tparams->trace, trace_start_time);
+
     // Find the connections that contain the processors
     const Voice* first_voice = Voice_group_get_voice(vgroup, 0);
     const Processor* first_proc = Voice_get_proc(first_voice);
@@ -867,6 +944,7 @@ static void Player_process_voice_group(
         if (!is_muted && !use_test_output)
             Voice_group_mix(
                     vgroup,
+                    0,
                     player->device_states,
                     tparams->thread_id,
                     conns,
@@ -921,6 +999,203 @@ static void Player_process_voice_group(
         }
     }
 
+    TRACE_STOP(tparams->trace, trace_start_time, TRACE_EVENT_VOICE_GROUP, au_id);
+
+    return;
+}
+
+
+static void Player_process_voice_group_lanes(
+        Player* player,
+        Player_thread_params* tparams,
+        Voice_group* vgroups[],
+        int count,
+        int32_t render_start,
+        int32_t render_stop,
+        Render_stats* stats)
+{
+    rassert(player != NULL);
+    rassert(tparams != NULL);
+    rassert(vgroups != NULL);
+    rassert(count > 1);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(render_start >= 0);
+    rassert(render_stop >= render_start);
+    rassert(stats != NULL);
+
+    TRACE_START(tparams->trace, trace_start_time);
+
+    // Find the connections that contain the processors
+    const Voice* first_voice = Voice_group_get_voice(vgroups[0], 0);
+    const Processor* first_proc = Voice_get_proc(first_voice);
+    const uint32_t au_id = Processor_get_au_params(first_proc)->device_id;
+    const Device_state* au_state =
+        Device_states_get_state(player->device_states, au_id);
+    const Audio_unit* au = (const Audio_unit*)Device_state_get_device(au_state);
+    const Connections* conns = Audio_unit_get_connections(au);
+    rassert(conns != NULL);
+
+    int32_t process_stops[VOICE_LANES_MAX] = { 0 };
+    Voice_group_render_lanes(
+            vgroups,
+            count,
+            player->device_states,
+            tparams->thread_id,
+            conns,
+            tparams->work_buffers,
+            render_start,
+            render_stop,
+            player->master_params.tempo,
+            process_stops);
+
+    for (int lane = 0; lane < count; ++lane)
+    {
+        Voice_group* vgroup = vgroups[lane];
+        const int32_t process_stop = process_stops[lane];
+
+        const int ch_num = Voice_group_get_ch_num(vgroup);
+        const bool is_muted =
+            (ch_num >= 0) ? Channel_is_muted(player->channels[ch_num]) : false;
+
+        if (!is_muted)
+            Voice_group_mix(
+                    vgroup,
+                    lane,
+                    player->device_states,
+                    tparams->thread_id,
+                    conns,
+                    render_start,
+                    process_stop);
+
+        if (process_stop < render_stop)
+            Voice_group_deactivate_all(vgroup);
+        else
+            Voice_group_deactivate_unreachable(vgroup);
+
+        const int active_voice_count = Voice_group_get_active_count(vgroup);
+        stats->voice_count += active_voice_count;
+        if (active_voice_count > 0)
+            ++stats->vgroup_count;
+    }
+
+    TRACE_STOP(tparams->trace, trace_start_time, TRACE_EVENT_VOICE_GROUP, au_id);
+
+    return;
+}
+
+
+/**
+ * Voice groups collected for rendering in voice lanes.
+ */
+typedef struct Voice_group_batch
+{
+    int count;
+    Voice_group vgroups[VOICE_LANES_MAX];
+} Voice_group_batch;
+
+#define VOICE_GROUP_BATCH_AUTO (&(Voice_group_batch){ .count = 0 })
+
+
+static bool Player_is_voice_group_batchable(
+        const Player* player, int thread_id, Voice_group* vgroup)
+{
+    rassert(player != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
+    rassert(vgroup != NULL);
+
+    // Only batch Voice groups that contain a Processor that renders voices in
+    // batches, otherwise there is nothing to gain
+    const Voice* first_voice = Voice_group_get_voice(vgroup, 0);
+    if (Voice_is_using_test_output(first_voice))
+        return false;
+
+    const Processor* first_proc = Voice_get_proc(first_voice);
+    const uint32_t au_id = Processor_get_au_params(first_proc)->device_id;
+    const Audio_unit* au = (const Audio_unit*)Device_state_get_device(
+            Device_states_get_state(player->device_states, au_id));
+    if (Audio_unit_get_connections(au) == NULL)
+        return false;
+
+    for (int i = 0; i < Voice_group_get_size(vgroup); ++i)
+    {
+        const Processor* proc = Voice_get_proc(Voice_group_get_voice(vgroup, i));
+        if ((proc != NULL) && (proc->parent.dimpl->render_voices_batch != NULL))
+        {
+            // Voice lanes are missing until the Device states are prepared
+            const Device_thread_state* proc_ts = Device_states_get_thread_state(
+                    player->device_states, thread_id, Device_get_id((const Device*)proc));
+            return Device_thread_state_has_voice_lanes(proc_ts);
+        }
+    }
+
+    return false;
+}
+
+
+static void Player_flush_voice_group_batch(
+        Player* player,
+        Player_thread_params* tparams,
+        Voice_group_batch* batch,
+        int32_t render_start,
+        int32_t render_stop,
+        Render_stats* stats)
+{
+    rassert(player != NULL);
+    rassert(tparams != NULL);
+    rassert(batch != NULL);
+    rassert(stats != NULL);
+
+    if (batch->count == 1)
+    {
+        Player_process_voice_group(
+                player, tparams, &batch->vgroups[0], render_start, render_stop, stats);
+    }
+    else if (batch->count > 1)
+    {
+        Voice_group* vgroups[VOICE_LANES_MAX] = { NULL };
+        for (int i = 0; i < batch->count; ++i)
+            vgroups[i] = &batch->vgroups[i];
+
+        Player_process_voice_group_lanes(
+                player, tparams, vgroups, batch->count, render_start, render_stop, stats);
+    }
+
+    batch->count = 0;
+
+    return;
+}
+
+
+static void Player_add_voice_group_to_batch(
+        Player* player,
+        Player_thread_params* tparams,
+        Voice_group_batch* batch,
+        const Voice_group* vgroup,
+        int32_t render_start,
+        int32_t render_stop,
+        Render_stats* stats)
+{
+    rassert(player != NULL);
+    rassert(tparams != NULL);
+    rassert(batch != NULL);
+    rassert(vgroup != NULL);
+    rassert(stats != NULL);
+
+    if ((batch->count > 0) &&
+            !Voice_group_is_batchable_with(&batch->vgroups[0], vgroup))
+        Player_flush_voice_group_batch(
+                player, tparams, batch, render_start, render_stop, stats);
+
+    batch->vgroups[batch->count] = *vgroup;
+    ++batch->count;
+
+    if ((batch->count == VOICE_LANES_MAX) ||
+            !Player_is_voice_group_batchable(
+                player, tparams->thread_id, &batch->vgroups[0]))
+        Player_flush_voice_group_batch(
+                player, tparams, batch, render_start, render_stop, stats);
+
     return;
 }
 
@@ -938,18 +1213,22 @@ static void Player_process_voice_groups_synced(
     rassert(render_stop >= render_start);
 
     Voice_group* vgroup = VOICE_GROUP_AUTO;
+    Voice_group_batch* batch = VOICE_GROUP_BATCH_AUTO;
 
     Render_stats* stats = RENDER_STATS_AUTO;
 
     Voice_group* vg = Voice_pool_get_next_group_synced(player->voices, vgroup);
     while (vg != NULL)
     {
-        Player_process_voice_group(
-                player, tparams, vg, render_start, render_stop, stats);
+        Player_add_voice_group_to_batch(
+                player, tparams, batch, vg, render_start, render_stop, stats);
 
         vg = Voice_pool_get_next_group_synced(player->voices, vgroup);
     }
 
+    Player_flush_voice_group_batch(
+            player, tparams, batch, render_start, render_stop, stats);
+
     tparams->active_voices = stats->voice_count;
     tparams->active_vgroups = stats->vgroup_count;
 
@@ -975,13 +1254,21 @@ static void Player_execute_mixed_signal_tasks_synced(
         while (Mixed_signal_plan_execute_next_task(
                 player->mixed_signal_plan,
                 level_index,
+                tparams->thread_id,
+                tparams->trace,
                 tparams->work_buffers,
                 render_start,
                 render_stop,
                 player->master_params.tempo))
             ;
 
+        TRACE_START(tparams->trace, wait_start_time);
         Barrier_wait(&player->mixed_level_finished_barrier);
+        TRACE_STOP(
+                tparams->trace,
+                wait_start_time,
+                TRACE_EVENT_MIXED_LEVEL_WAIT,
+                (uint32_t)level_index);
     }
 
     return;
@@ -996,20 +1283,30 @@ static void* render_thread_func(void* arg)
     Player* player = params->player;
 
     // Wait for the initial starting call
+    bool start_aborted = false;
     {
         Mutex* cond_mutex = Condition_get_mutex(&player->start_cond);
         Mutex_lock(cond_mutex);
         while (!player->ok_to_start)
             Condition_wait(&player->start_cond);
+
+        // NOTE: We must not check stop_threads here as it may be set by
+        //       a stop request that expects us to reach vgroups_start_barrier
+        start_aborted = player->abort_start;
         Mutex_unlock(cond_mutex);
     }
 
-    if (player->stop_threads)
+    if (start_aborted)
         return NULL;
 
+    // We only leave our render section when the thread is stopped
+    rt_check_enter_render();
+
     while (true)
     {
         // Wait for our signal to start voice group processing
+        // NOTE: This wait is not traced as it spans the time between
+        //       calls of Player_play, during which our trace may be replaced
         Barrier_wait(&player->vgroups_start_barrier);
 
         rassert(params->thread_id < player->thread_count);
@@ -1017,19 +1314,42 @@ static void* render_thread_func(void* arg)
         if (player->stop_threads)
             break;
 
-        Player_process_voice_groups_synced(
-                player, params, player->render_start, player->render_stop);
+        // The render area stays the same until the next voice group signal
+        const int32_t render_start = player->render_start;
+        const int32_t render_stop = player->render_stop;
+
+        Player_process_voice_groups_synced(player, params, render_start, render_stop);
 
         // Wait to indicate that we have finished processing voice groups
+        TRACE_START(params->trace, vgroups_finished_time);
         Barrier_wait(&player->vgroups_finished_barrier);
+        TRACE_STOP(
+                params->trace,
+                vgroups_finished_time,
+                TRACE_EVENT_VGROUPS_FINISHED_WAIT,
+                0);
+
+        // Mix our share of the thread-local device buffers
+        TRACE_START(params->trace, thread_mix_time);
+        Device_states_mix_thread_states_part(
+                player->device_states,
+                params->thread_id,
+                player->thread_count,
+                render_start,
+                render_stop);
+        TRACE_STOP(params->trace, thread_mix_time, TRACE_EVENT_THREAD_MIX, 0);
 
         // Wait for our signal to start mixed signal processing
+        TRACE_START(params->trace, mixed_start_time);
         Barrier_wait(&player->mixed_start_barrier);
+        TRACE_STOP(params->trace, mixed_start_time, TRACE_EVENT_MIXED_START_WAIT, 0);
 
         Player_execute_mixed_signal_tasks_synced(
-                player, params, player->render_start, player->render_stop);
+                player, params, render_start, render_stop);
     }
 
+    rt_check_leave_render();
+
     return NULL;
 }
 #endif
@@ -1075,11 +1395,18 @@ static void Player_process_voices(
         player->render_start = render_start;
         player->render_stop = render_stop;
 
+        Render_trace* trace = player->main_trace;
+
         // Synchronise with all threads to start voice group processing
+        TRACE_START(trace, vgroups_start_time);
         Barrier_wait(&player->vgroups_start_barrier);
+        TRACE_STOP(trace, vgroups_start_time, TRACE_EVENT_VGROUPS_START_WAIT, 0);
 
         // Wait until all threads have finished
+        TRACE_START(trace, vgroups_finished_time);
         Barrier_wait(&player->vgroups_finished_barrier);
+        TRACE_STOP(
+                trace, vgroups_finished_time, TRACE_EVENT_VGROUPS_FINISHED_WAIT, 0);
 
         // Calculate active voices
         for (int i = 0; i < player->thread_count; ++i)
@@ -1093,29 +1420,25 @@ static void Player_process_voices(
     {
         // Process all voice groups in a single thread
         Render_stats* stats = RENDER_STATS_AUTO;
+        Voice_group_batch* batch = VOICE_GROUP_BATCH_AUTO;
+        Player_thread_params* tparams = &player->thread_params[0];
 
         Voice_group* vg = Voice_pool_get_next_group(player->voices);
         while (vg != NULL)
         {
-            Player_process_voice_group(
-                    player,
-                    &player->thread_params[0],
-                    vg,
-                    render_start,
-                    render_stop,
-                    stats);
+            Player_add_voice_group_to_batch(
+                    player, tparams, batch, vg, render_start, render_stop, stats);
 
             vg = Voice_pool_get_next_group(player->voices);
         }
 
+        Player_flush_voice_group_batch(
+                player, tparams, batch, render_start, render_stop, stats);
+
         active_voice_count = stats->voice_count;
         active_vgroup_count = stats->vgroup_count;
     }
 
-    if (player->thread_count > 1)
-        Device_states_mix_thread_states(
-                player->device_states, render_start, render_stop);
-
     player->master_params.active_voices =
         max(player->master_params.active_voices, active_voice_count);
     player->master_params.active_vgroups =
@@ -1139,11 +1462,16 @@ static void Player_process_mixed_signals(
 #ifdef ENABLE_THREADS
     if (player->thread_count > 1)
     {
-        player->render_start = render_start;
-        player->render_stop = render_start + frame_count;
+        // The render threads use the render area of voice group processing
+        rassert(player->render_start == render_start);
+        rassert(player->render_stop == render_start + frame_count);
+
+        Render_trace* trace = player->main_trace;
 
         // Synchronise with all threads to start mixed task execution
+        TRACE_START(trace, mixed_start_time);
         Barrier_wait(&player->mixed_start_barrier);
+        TRACE_STOP(trace, mixed_start_time, TRACE_EVENT_MIXED_START_WAIT, 0);
 
         if (frame_count > 0)
         {
@@ -1152,7 +1480,13 @@ static void Player_process_mixed_signals(
             for (int level_i = level_count - 1; level_i >= 0; --level_i)
             {
                 // Wait for each level to be finished
+                TRACE_START(trace, level_start_time);
                 Barrier_wait(&player->mixed_level_finished_barrier);
+                TRACE_STOP(
+                        trace,
+                        level_start_time,
+                        TRACE_EVENT_MIXED_LEVEL_WAIT,
+                        (uint32_t)level_i);
             }
 
             Mixed_signal_plan_reset(player->mixed_signal_plan);
@@ -1165,6 +1499,7 @@ static void Player_process_mixed_signals(
         {
             Mixed_signal_plan_execute_all_tasks(
                     player->mixed_signal_plan,
+                    player->thread_params[0].trace,
                     player->thread_params[0].work_buffers,
                     render_start,
                     render_start + frame_count,
@@ -1345,15 +1680,13 @@ static void Player_apply_master_volume(
     float* volumes = Work_buffers_get_buffer_contents_mut(
             player->thread_params[0].work_buffers, CONTROL_WB_MASTER_VOLUME);
 
-    if (Slider_in_progress(&player->master_params.volume_slider))
+    if (Slider_in_progress(&player->master_params.volume_slider) &&
+            (buf_start < buf_stop))
     {
-        double final_volume = player->master_params.volume;
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-        {
-            final_volume = Slider_step(&player->master_params.volume_slider);
-            volumes[i] = (float)final_volume;
-        }
-        player->master_params.volume = final_volume;
+        player->master_params.volume = Slider_fill(
+                &player->master_params.volume_slider,
+                volumes + buf_start,
+                buf_stop - buf_start);
     }
     else
     {
@@ -1409,8 +1742,7 @@ static void Player_init_final(Player* player)
 
     Player_reset_channels(player);
 
-    for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-        Cgiter_reset(&player->cgiters[i], &player->master_params.cur_pos);
+    Cgiter_reset(&player->cgiter, &player->master_params.cur_pos);
 
     return;
 }
@@ -1422,6 +1754,8 @@ void Player_play(Player* player, int32_t nframes)
     rassert(player->audio_buffer_size > 0);
     rassert(nframes >= 0);
 
+    rt_check_enter_render();
+
     Player_flush_receive(player);
 
     Event_buffer_clear(player->event_buffer);
@@ -1474,32 +1808,7 @@ void Player_play(Player* player, int32_t nframes)
         Player_process_voices(player, rendered, to_be_rendered);
 
         // Update carried controls
-        for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-        {
-            Channel* ch = player->channels[i];
-
-            {
-                Force_controls* fc = &ch->force_controls;
-
-                if (Slider_in_progress(&fc->slider))
-                    fc->force = (float)Slider_skip(&fc->slider, to_be_rendered);
-
-                if (LFO_active(&fc->tremolo))
-                    LFO_skip(&fc->tremolo, to_be_rendered);
-            }
-
-            {
-                Pitch_controls* pc = &ch->pitch_controls;
-
-                if (Slider_in_progress(&pc->slider))
-                    pc->pitch = Slider_skip(&pc->slider, to_be_rendered);
-
-                if (LFO_active(&pc->vibrato))
-                    LFO_skip(&pc->vibrato, to_be_rendered);
-            }
-
-            Channel_stream_state_update(ch->csstate, to_be_rendered);
-        }
+        Player_update_active_channels(player, to_be_rendered);
 
         // Process signals in the connection graph
         {
@@ -1508,12 +1817,29 @@ void Player_play(Player* player, int32_t nframes)
             const int32_t buf_start = rendered;
             const int32_t buf_stop = rendered + to_be_rendered;
 
+            PROFILE_START(volume_start_time);
             Player_apply_master_volume(player, buf_start, buf_stop);
+            PROFILE_STOP(
+                    &player->stage_profiles[RENDER_STAGE_MASTER_VOLUME],
+                    volume_start_time,
+                    0);
 
+            PROFILE_START(test_outputs_start_time);
             Player_mix_test_voice_signals(player, buf_start, buf_stop);
+            PROFILE_STOP(
+                    &player->stage_profiles[RENDER_STAGE_TEST_OUTPUTS],
+                    test_outputs_start_time,
+                    0);
 
             if (player->module->is_dc_blocker_enabled)
+            {
+                PROFILE_START(dc_blocker_start_time);
                 Player_apply_dc_blocker(player, buf_start, buf_stop);
+                PROFILE_STOP(
+                        &player->stage_profiles[RENDER_STAGE_DC_BLOCKER],
+                        dc_blocker_start_time,
+                        0);
+            }
         }
 
         rendered += to_be_rendered;
@@ -1557,6 +1883,8 @@ void Player_play(Player* player, int32_t nframes)
 
     player->events_returned = false;
 
+    rt_check_leave_render();
+
     return;
 }
 
@@ -1644,6 +1972,457 @@ const char* Player_get_events(Player* player)
 }
 
 
+static bool Player_append_report(Player* player, const char* format, ...)
+{
+    rassert(player != NULL);
+    rassert(format != NULL);
+
+    while (true)
+    {
+        const int32_t space_left = player->report_size - player->report_length;
+
+        if (space_left > 0)
+        {
+            va_list args;
+            va_start(args, format);
+            const int printed = vsnprintf(
+                    player->report + player->report_length,
+                    (size_t)space_left,
+                    format,
+                    args);
+            va_end(args);
+
+            rassert(printed >= 0);
+            if (printed < space_left)
+            {
+                player->report_length += printed;
+                return true;
+            }
+        }
+
+        const int32_t new_size = max(256, player->report_size * 2);
+        char* new_buf = memory_realloc_items(char, new_size, player->report);
+        if (new_buf == NULL)
+            return false;
+
+        player->report = new_buf;
+        player->report_size = new_size;
+        player->report[player->report_length] = '\0';
+    }
+}
+
+
+static bool Player_append_profile_counter(Player* player, const Profile_counter* counter)
+{
+    rassert(player != NULL);
+    rassert(counter != NULL);
+
+    return Player_append_report(
+            player,
+            "{\"nanoseconds\": %" PRId64 ", \"calls\": %" PRId64
+                ", \"voice_frames\": %" PRId64 "}",
+            counter->nanoseconds,
+            counter->call_count,
+            counter->voice_frames);
+}
+
+
+typedef bool Player_device_visitor(
+        Player* player, const Device* device, const char* key, void* data);
+
+
+static bool Player_visit_au_devices(
+        Player* player,
+        const Audio_unit* au,
+        const char* key,
+        Player_device_visitor* visit,
+        void* data)
+{
+    rassert(player != NULL);
+    rassert(au != NULL);
+    rassert(key != NULL);
+    rassert(visit != NULL);
+
+    if (!visit(player, (const Device*)au, key, data))
+        return false;
+
+    char sub_key[32] = "";
+
+    const Device* in_iface = Audio_unit_get_input_interface(au);
+    snprintf(sub_key, sizeof(sub_key), "%s/in", key);
+    if ((in_iface != NULL) && !visit(player, in_iface, sub_key, data))
+        return false;
+
+    const Device* out_iface = Audio_unit_get_output_interface(au);
+    snprintf(sub_key, sizeof(sub_key), "%s/out", key);
+    if ((out_iface != NULL) && !visit(player, out_iface, sub_key, data))
+        return false;
+
+    for (int i = 0; i < KQT_PROCESSORS_MAX; ++i)
+    {
+        const Processor* proc = Audio_unit_get_proc(au, i);
+        if (proc == NULL)
+            continue;
+
+        snprintf(sub_key, sizeof(sub_key), "%s/proc_%02x", key, i);
+        if (!visit(player, (const Device*)proc, sub_key, data))
+            return false;
+    }
+
+    for (int i = 0; i < KQT_AUDIO_UNITS_MAX; ++i)
+    {
+        const Audio_unit* sub_au = Audio_unit_get_au(au, i);
+        if (sub_au == NULL)
+            continue;
+
+        snprintf(sub_key, sizeof(sub_key), "%s/au_%02x", key, i);
+        if (!Player_visit_au_devices(player, sub_au, sub_key, visit, data))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool Player_visit_devices(
+        Player* player, Player_device_visitor* visit, void* data)
+{
+    rassert(player != NULL);
+    rassert(visit != NULL);
+
+    if (!visit(player, (const Device*)player->module, "master", data))
+        return false;
+
+    Au_table* au_table = Module_get_au_table(player->module);
+    for (int i = 0; i < KQT_AUDIO_UNITS_MAX; ++i)
+    {
+        const Audio_unit* au = Au_table_get(au_table, i);
+        if (au == NULL)
+            continue;
+
+        char key[8] = "";
+        snprintf(key, sizeof(key), "au_%02x", i);
+        if (!Player_visit_au_devices(player, au, key, visit, data))
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool Player_append_device_profile(
+        Player* player, const Device* device, const char* key, void* data)
+{
+    rassert(player != NULL);
+    rassert(device != NULL);
+    rassert(key != NULL);
+    rassert(data != NULL);
+
+    bool* is_first = data;
+
+    const uint32_t device_id = Device_get_id(device);
+
+    // Only report devices that have been rendered
+    bool is_used = false;
+    for (int ti = 0; ti < player->thread_count; ++ti)
+    {
+        const Profile_counter* counter =
+            Device_states_get_profile(player->device_states, ti, device_id);
+        if ((counter != NULL) && Profile_counter_is_used(counter))
+            is_used = true;
+    }
+
+    if (!is_used)
+        return true;
+
+    if (!Player_append_report(
+                player, "%s\n  \"%s\": [", (*is_first ? "" : ","), key))
+        return false;
+
+    *is_first = false;
+
+    for (int ti = 0; ti < player->thread_count; ++ti)
+    {
+        const Profile_counter* counter =
+            Device_states_get_profile(player->device_states, ti, device_id);
+        if (counter == NULL)
+            counter = PROFILE_COUNTER_AUTO;
+
+        if (!Player_append_report(player, (ti > 0) ? ", " : "") ||
+                !Player_append_profile_counter(player, counter))
+            return false;
+    }
+
+    return Player_append_report(player, "]");
+}
+
+
+const char* Player_get_profile(Player* player)
+{
+    rassert(player != NULL);
+
+    player->report_length = 0;
+    if (player->report != NULL)
+        player->report[0] = '\0';
+
+    if (!Player_append_report(
+                player,
+                "{\"enabled\": %s, \"thread_count\": %d,\n\"devices\": {",
+                Render_profile_is_enabled() ? "true" : "false",
+                player->thread_count))
+        return NULL;
+
+    bool is_first = true;
+
+    if (!Player_visit_devices(player, Player_append_device_profile, &is_first))
+        return NULL;
+
+    if (!Player_append_report(player, "},\n\"stages\": {"))
+        return NULL;
+
+    for (int i = 0; i < RENDER_STAGE_COUNT; ++i)
+    {
+        if (!Player_append_report(
+                    player,
+                    "%s\n  \"%s\": ",
+                    (i > 0) ? "," : "",
+                    Render_stage_get_name((Render_stage)i)) ||
+                !Player_append_profile_counter(player, &player->stage_profiles[i]))
+            return NULL;
+    }
+
+    if (!Player_append_report(player, "}}"))
+        return NULL;
+
+    return player->report;
+}
+
+
+void Player_reset_profile(Player* player)
+{
+    rassert(player != NULL);
+
+    Device_states_reset_profiles(player->device_states);
+
+    for (int i = 0; i < RENDER_STAGE_COUNT; ++i)
+        Profile_counter_reset(&player->stage_profiles[i]);
+
+    return;
+}
+
+
+bool Player_set_render_trace_enabled(Player* player, bool enabled)
+{
+    rassert(player != NULL);
+
+    if (enabled == (player->main_trace != NULL))
+        return true;
+
+    if (enabled)
+    {
+        player->main_trace = new_Render_trace(RENDER_TRACE_CAPACITY_DEFAULT);
+        if (player->main_trace == NULL)
+            return false;
+    }
+    else
+    {
+        del_Render_trace(player->main_trace);
+        player->main_trace = NULL;
+    }
+
+    if (!Player_update_render_traces(player, player->thread_count))
+    {
+        del_Render_trace(player->main_trace);
+        player->main_trace = NULL;
+        Player_update_render_traces(player, player->thread_count);
+        return false;
+    }
+
+    return true;
+}
+
+
+typedef struct Trace_device_name
+{
+    uint32_t device_id;
+    char key[32];
+} Trace_device_name;
+
+
+static int Trace_device_name_cmp(
+        const Trace_device_name* name1, const Trace_device_name* name2)
+{
+    rassert(name1 != NULL);
+    rassert(name2 != NULL);
+
+    if (name1->device_id < name2->device_id)
+        return -1;
+    else if (name1->device_id > name2->device_id)
+        return 1;
+    return 0;
+}
+
+
+static bool Player_add_trace_device_name(
+        Player* player, const Device* device, const char* key, void* data)
+{
+    rassert(player != NULL);
+    rassert(device != NULL);
+    rassert(key != NULL);
+    rassert(data != NULL);
+
+    AAtree* names = data;
+
+    Trace_device_name* name = memory_alloc_item(Trace_device_name);
+    if (name == NULL)
+        return false;
+
+    name->device_id = Device_get_id(device);
+    strncpy(name->key, key, sizeof(name->key) - 1);
+    name->key[sizeof(name->key) - 1] = '\0';
+
+    if (!AAtree_ins(names, name))
+    {
+        memory_free(name);
+        return false;
+    }
+
+    return true;
+}
+
+
+static bool Player_append_trace_events(
+        Player* player, Render_trace* trace, int tid, const AAtree* names)
+{
+    rassert(player != NULL);
+    rassert(trace != NULL);
+    rassert(tid >= 0);
+    rassert(names != NULL);
+
+    const int32_t event_count = Render_trace_get_event_count(trace);
+    for (int32_t i = 0; i < event_count; ++i)
+    {
+        const Trace_event* event = Render_trace_get_event(trace, i);
+        const char* type_name = Trace_event_type_get_name(event->type);
+
+        if (!Player_append_report(
+                    player,
+                    ",\n{\"ph\": \"X\", \"pid\": 1, \"tid\": %d, "
+                        "\"ts\": %.3f, \"dur\": %.3f, \"cat\": \"%s\", ",
+                    tid,
+                    (double)event->start / 1000.0,
+                    (double)(event->stop - event->start) / 1000.0,
+                    type_name))
+            return false;
+
+        bool success = true;
+
+        if ((event->type == TRACE_EVENT_VOICE_GROUP) ||
+                (event->type == TRACE_EVENT_MIXED_TASK))
+        {
+            const Trace_device_name* key = &(Trace_device_name){ .device_id = event->arg };
+            const Trace_device_name* name = AAtree_get_exact(names, key);
+            if (name != NULL)
+                success = Player_append_report(
+                        player,
+                        "\"name\": \"%s\", \"args\": {\"device\": \"%s\"}}",
+                        name->key,
+                        name->key);
+            else
+                success = Player_append_report(
+                        player,
+                        "\"name\": \"device %" PRIu32 "\", \"args\": {}}",
+                        event->arg);
+        }
+        else if (event->type == TRACE_EVENT_MIXED_LEVEL_WAIT)
+        {
+            success = Player_append_report(
+                    player,
+                    "\"name\": \"%s\", \"args\": {\"level\": %" PRIu32 "}}",
+                    type_name,
+                    event->arg);
+        }
+        else
+        {
+            success = Player_append_report(
+                    player, "\"name\": \"%s\", \"args\": {}}", type_name);
+        }
+
+        if (!success)
+            return false;
+    }
+
+    return true;
+}
+
+
+const char* Player_get_render_trace(Player* player)
+{
+    rassert(player != NULL);
+
+    player->report_length = 0;
+    if (player->report != NULL)
+        player->report[0] = '\0';
+
+    AAtree* names = new_AAtree(
+            (AAtree_item_cmp*)Trace_device_name_cmp, memory_free);
+    if ((names == NULL) ||
+            !Player_visit_devices(player, Player_add_trace_device_name, names))
+    {
+        del_AAtree(names);
+        return NULL;
+    }
+
+    // Chrome trace thread ID 0 is the caller of Player_play
+    bool success = Player_append_report(
+            player,
+            "{\"traceEvents\": [\n"
+            "{\"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"name\": \"thread_name\", "
+                "\"args\": {\"name\": \"main\"}}");
+
+    int64_t dropped_count = 0;
+
+    if (success && (player->main_trace != NULL))
+    {
+        success = Player_append_trace_events(player, player->main_trace, 0, names);
+        dropped_count += Render_trace_get_dropped_count(player->main_trace);
+        Render_trace_clear(player->main_trace);
+    }
+
+    for (int ti = 0; success && (ti < player->thread_count); ++ti)
+    {
+        Render_trace* trace = player->thread_params[ti].trace;
+        if (trace == NULL)
+            continue;
+
+        const int tid = ti + 1;
+
+        success = Player_append_report(
+                player,
+                ",\n{\"ph\": \"M\", \"pid\": 1, \"tid\": %d, \"name\": \"thread_name\", "
+                    "\"args\": {\"name\": \"render %d\"}}",
+                tid,
+                ti) &&
+            Player_append_trace_events(player, trace, tid, names);
+
+        dropped_count += Render_trace_get_dropped_count(trace);
+        Render_trace_clear(trace);
+    }
+
+    del_AAtree(names);
+
+    if (!success ||
+            !Player_append_report(
+                player,
+                "],\n\"displayTimeUnit\": \"ns\", "
+                    "\"otherData\": {\"dropped_events\": %" PRId64 "}}",
+                dropped_count))
+        return NULL;
+
+    return player->report;
+}
+
+
 bool Player_has_stopped(const Player* player)
 {
     rassert(player != NULL);
@@ -1805,6 +2584,8 @@ void del_Player(Player* player)
     del_Voice_pool(player->voices);
     for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
         del_Channel(player->channels[i]);
+    del_Name_table(player->cv_names);
+    del_Name_table(player->stream_names);
     Master_params_deinit(&player->master_params);
     for (int i = 0; i < KQT_THREADS_MAX; ++i)
         Player_thread_params_deinit(&player->thread_params[i]);
@@ -1815,6 +2596,9 @@ void del_Player(Player* player)
     for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
         memory_free(player->audio_buffers[i]);
 
+    del_Render_trace(player->main_trace);
+    memory_free(player->report);
+
     memory_free(player);
     return;
 }
@@ -317,6 +317,60 @@ const float* Player_get_audio(const Player* player, int channel);
 const char* Player_get_events(Player* player);
 
 
+/**
+ * Return a description of the render profile in JSON format.
+ *
+ * The description contains the cumulative rendering time, call count and
+ * number of active voice frames of each profiled device in each thread, as
+ * well as the time spent in the master output stages. The counters are only
+ * updated if libkunquat is built with render profiling enabled.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ *
+ * \return   The profile description, or \c NULL if memory allocation failed.
+ *           The returned string is valid until the next call of this function
+ *           or Player_get_render_trace, or until \a player is destroyed.
+ */
+const char* Player_get_profile(Player* player);
+
+
+/**
+ * Reset all render profile counters of the Player.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ */
+void Player_reset_profile(Player* player);
+
+
+/**
+ * Enable or disable render timeline tracing in the Player.
+ *
+ * When enabled, each rendering thread records the time spent in barrier
+ * waits, Voice groups and mixed signal tasks. Disabling tracing discards
+ * all recorded events.
+ *
+ * \param player    The Player -- must not be \c NULL.
+ * \param enabled   \c true if tracing is to be enabled, otherwise \c false.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Player_set_render_trace_enabled(Player* player, bool enabled);
+
+
+/**
+ * Return the recorded render timeline in Chrome trace event JSON format.
+ *
+ * The recorded events are removed from the Player.
+ *
+ * \param player   The Player -- must not be \c NULL.
+ *
+ * \return   The timeline, or \c NULL if memory allocation failed. The
+ *           returned string is valid until the next call of this function
+ *           or Player_get_profile, or until \a player is destroyed.
+ */
+const char* Player_get_render_trace(Player* player);
+
+
 /**
  * Tell whether the Player has reached the end of playback.
  *
@@ -16,6 +16,7 @@
 #define KQT_PLAYER_PRIVATE_H
 
 
+#include <containers/Name_table.h>
 #include <decl.h>
 #include <init/Environment.h>
 #include <player/Cgiter.h>
@@ -26,6 +27,8 @@
 #include <player/Event_handler.h>
 #include <player/Master_params.h>
 #include <player/Player.h>
+#include <player/Render_profile.h>
+#include <player/Render_trace.h>
 #include <player/Voice_pool.h>
 #include <player/Work_buffer.h>
 #include <player/Work_buffers.h>
@@ -48,6 +51,7 @@ typedef struct Player_thread_params
     int active_vgroups;
     Work_buffers* work_buffers;
     Work_buffer* test_voice_outputs[TEST_VOICE_OUTPUTS_MAX];
+    Render_trace* trace;
 } Player_thread_params;
 
 
@@ -69,6 +73,7 @@ struct Player
     Barrier mixed_level_finished_barrier;
     Thread threads[KQT_THREADS_MAX];
     bool ok_to_start;
+    bool abort_start;
     bool stop_threads;
     int32_t render_start;
     int32_t render_stop;
@@ -79,13 +84,16 @@ struct Player
     Voice_pool*    voices;
     Mixed_signal_plan* mixed_signal_plan;
     Master_params  master_params;
+    Name_table*    stream_names;
+    Name_table*    cv_names;
     Channel*       channels[KQT_CHANNELS_MAX];
+    Channel*       active_channels; // channels that may have controls in progress
     Event_handler* event_handler;
 
     double frame_remainder; // used for sub-frame time tracking
 
     bool cgiters_accessed;
-    Cgiter cgiters[KQT_CHANNELS_MAX];
+    Cgiter cgiter;
 
     // Position tracking
     int64_t audio_frames_processed;
@@ -97,6 +105,13 @@ struct Player
     int   susp_event_ch;
     char  susp_event_name[EVENT_NAME_MAX + 1];
     Value susp_event_value;
+
+    // Render profiling
+    Profile_counter stage_profiles[RENDER_STAGE_COUNT];
+    Render_trace* main_trace;
+    char* report;
+    int32_t report_size;
+    int32_t report_length;
 };
 
 
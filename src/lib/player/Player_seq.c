@@ -15,11 +15,13 @@
 #include <player/Player_seq.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 #include <expr.h>
 #include <mathnum/common.h>
 #include <string/common.h>
 
 #include <limits.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -127,6 +129,51 @@ static void Player_process_expr_event(
         bool external);
 
 
+static void Player_activate_channel(Player* player, int ch_num)
+{
+    rassert(player != NULL);
+    rassert(ch_num >= 0);
+    rassert(ch_num < KQT_CHANNELS_MAX);
+
+    Channel* ch = player->channels[ch_num];
+    if (ch->is_active)
+        return;
+
+    ch->next_active = player->active_channels;
+    ch->is_active = true;
+    player->active_channels = ch;
+
+    return;
+}
+
+
+void Player_update_active_channels(Player* player, int64_t step_count)
+{
+    rassert(player != NULL);
+    rassert(step_count >= 0);
+
+    Channel** link = &player->active_channels;
+    while (*link != NULL)
+    {
+        Channel* ch = *link;
+        rassert(ch->is_active);
+
+        if (Channel_update_carried_controls(ch, step_count))
+        {
+            link = &ch->next_active;
+        }
+        else
+        {
+            *link = ch->next_active;
+            ch->next_active = NULL;
+            ch->is_active = false;
+        }
+    }
+
+    return;
+}
+
+
 void Player_process_event(
         Player* player,
         int ch_num,
@@ -152,10 +199,13 @@ void Player_process_event(
                 player->event_handler, ch_num, event_name, arg, external))
     {
         // FIXME: add a proper way of reporting event errors
+        rt_check("blocking I/O");
         fprintf(stderr, "`%s` not fired\n", event_name);
         return;
     }
 
+    Player_activate_channel(player, ch_num);
+
     if (!skip)
         Event_buffer_add(player->event_buffer, ch_num, event_name, arg);
 
@@ -316,6 +366,7 @@ static void Player_process_expr_event(
         }
         else
         {
+            rt_check("blocking I/O");
             fprintf(stderr, "Trigger `%s` has a quote suffix but the"
                     " parameter type is not string", trigger_desc);
             return;
@@ -334,6 +385,7 @@ static void Player_process_expr_event(
 
     if (Streader_is_error_set(sr))
     {
+        rt_check("blocking I/O");
         fprintf(stderr,
                 "Couldn't parse `%s`: %s\n",
                 trigger_desc,
@@ -398,9 +450,8 @@ static void Player_start_pattern_playback_mode(Player* player)
             player->module, &player->master_params.cur_pos.piref, &track, &system);
     Player_reset_channels(player);
 
-    // Move cgiters to the new pattern
-    for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-        Cgiter_reset(&player->cgiters[i], &player->master_params.cur_pos);
+    // Move cgiter to the new pattern
+    Cgiter_reset(&player->cgiter, &player->master_params.cur_pos);
 
     return;
 }
@@ -442,7 +493,7 @@ static void Player_set_new_playback_position(
     }
     else
     {
-        // Move cgiters to the new position
+        // Move cgiter to the new position
         Tstamp_copy(&target_pos.pat_pos, actual_target_row);
         target_pos.piref = actual_target_piref;
 
@@ -452,8 +503,7 @@ static void Player_set_new_playback_position(
             target_pos.system = -1;
         }
 
-        for (int k = 0; k < KQT_CHANNELS_MAX; ++k)
-            Cgiter_reset(&player->cgiters[k], &target_pos);
+        Cgiter_reset(&player->cgiter, &target_pos);
 
         // Set the new position as a global reference
         player->master_params.cur_pos = target_pos;
@@ -502,7 +552,7 @@ void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
 
     // Update current position
     // FIXME: we should really have a well-defined single source of current position
-    player->master_params.cur_pos = player->cgiters[0].pos;
+    player->master_params.cur_pos = player->cgiter.pos;
 
     // Stop if we don't have anything to play
     if (player->master_params.cur_pos.piref.pat < 0)
@@ -529,194 +579,195 @@ void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
         next_jump_trigger = next_jc->order;
     }
 
+    Cgiter* cgiter = &player->cgiter;
+
     // Process trigger rows at current position
-    for (int i = player->master_params.cur_ch; i < KQT_CHANNELS_MAX; ++i)
+    const Pattern_row* tr = NULL;
+    while ((tr = Cgiter_get_trigger_row(cgiter)) != NULL)
     {
-        Cgiter* cgiter = &player->cgiters[i];
+        const int ch = tr->ch;
+        if (ch != player->master_params.cur_ch)
+        {
+            // Start processing a new row
+            player->master_params.cur_ch = ch;
+            player->master_params.cur_trigger = 0;
+        }
 
-        if (Cgiter_has_finished(cgiter)) // implies empty playback
-            break;
+        // Process trigger row
+        Column_iter* citer = Column_iter_init(COLUMN_ITER_AUTO, tr->col, tr->col_row);
 
-        const Trigger_row* tr = Cgiter_get_trigger_row(cgiter);
-        if (tr != NULL)
+        // Skip triggers if resuming
+        int trigger_index = 0;
+        while (trigger_index < player->master_params.cur_trigger &&
+                Column_iter_has_trigger(citer))
         {
-            // Process trigger row
-            rassert(tr->head->next != NULL);
-            Trigger_list* trl = tr->head->next;
-
-            // Skip triggers if resuming
-            int trigger_index = 0;
-            while (trigger_index < player->master_params.cur_trigger &&
-                    trl->trigger != NULL)
-            {
-                ++trigger_index;
-                trl = trl->next;
-            }
+            ++trigger_index;
+            Column_iter_next(citer);
+        }
 
-            // Process triggers
-            while (trl->trigger != NULL)
-            {
-                const Event_type event_type = Trigger_get_type(trl->trigger);
+        // Process triggers
+        while (Column_iter_has_trigger(citer))
+        {
+            const Event_type event_type = Column_iter_get_type(citer);
 
-                const bool at_active_jump =
-                    Tstamp_cmp(next_jump_row, &cgiter->pos.pat_pos) == 0 &&
-                    next_jump_ch == i &&
-                    next_jump_trigger == player->master_params.cur_trigger;
+            const bool at_active_jump =
+                Tstamp_cmp(next_jump_row, &cgiter->pos.pat_pos) == 0 &&
+                next_jump_ch == ch &&
+                next_jump_trigger == player->master_params.cur_trigger;
 
-                if (at_active_jump)
+            if (at_active_jump)
+            {
+                // Process our next Jump context
+                rassert(next_jc != NULL);
+                if (next_jc->counter > 0)
                 {
-                    // Process our next Jump context
-                    rassert(next_jc != NULL);
-                    if (next_jc->counter > 0)
-                    {
-                        player->master_params.do_jump = true;
-                    }
-                    else
+                    player->master_params.do_jump = true;
+                }
+                else
+                {
+                    // Release our consumed Jump context
+                    AAnode* handle = Active_jumps_remove_context(
+                            player->master_params.active_jumps, next_jc);
+                    Jump_cache_release_context(
+                            player->master_params.jump_cache, handle);
+
+                    // Update next Jump context
+                    Tstamp_set(next_jump_row, INT64_MAX, 0);
+                    next_jump_ch = KQT_CHANNELS_MAX;
+                    next_jump_trigger = INT64_MAX;
+                    next_jc = Active_jumps_get_next_context(
+                            player->master_params.active_jumps,
+                            &player->master_params.cur_pos.piref,
+                            &player->master_params.cur_pos.pat_pos,
+                            ch,
+                            player->master_params.cur_trigger);
+                    if (next_jc != NULL)
                     {
-                        // Release our consumed Jump context
-                        AAnode* handle = Active_jumps_remove_context(
-                                player->master_params.active_jumps, next_jc);
-                        Jump_cache_release_context(
-                                player->master_params.jump_cache, handle);
-
-                        // Update next Jump context
-                        Tstamp_set(next_jump_row, INT64_MAX, 0);
-                        next_jump_ch = KQT_CHANNELS_MAX;
-                        next_jump_trigger = INT64_MAX;
-                        next_jc = Active_jumps_get_next_context(
-                                player->master_params.active_jumps,
-                                &player->master_params.cur_pos.piref,
-                                &player->master_params.cur_pos.pat_pos,
-                                i,
-                                player->master_params.cur_trigger);
-                        if (next_jc != NULL)
-                        {
-                            Tstamp_copy(next_jump_row, &next_jc->row);
-                            next_jump_ch = next_jc->ch_num;
-                            next_jump_trigger = next_jc->order;
-                        }
+                        Tstamp_copy(next_jump_row, &next_jc->row);
+                        next_jump_ch = next_jc->ch_num;
+                        next_jump_trigger = next_jc->order;
                     }
                 }
-                else
+            }
+            else
+            {
+                // Process trigger normally
+                if (!skip ||
+                        Event_is_control(event_type) ||
+                        Event_is_general(event_type) ||
+                        Event_is_master(event_type))
                 {
-                    // Process trigger normally
-                    if (!skip ||
-                            Event_is_control(event_type) ||
-                            Event_is_general(event_type) ||
-                            Event_is_master(event_type))
+                    if (!Event_is_control(event_type) ||
+                            player->master_params.is_infinite)
                     {
-                        if (!Event_is_control(event_type) ||
-                                player->master_params.is_infinite)
+                        // Break if event buffer is full
+                        if (!skip && Event_buffer_is_full(player->event_buffer))
                         {
-                            // Break if event buffer is full
-                            if (!skip && Event_buffer_is_full(player->event_buffer))
-                            {
-                                Tstamp_set(limit, 0, 0);
-
-                                // Make sure we get this row again next time
-                                Cgiter_clear_returned_status(cgiter);
-                                return;
-                            }
-
-                            const bool external = false;
-
-                            Player_process_expr_event(
-                                    player,
-                                    i,
-                                    Trigger_get_desc(trl->trigger),
-                                    NULL, // no meta value
-                                    skip,
-                                    external);
-
-                            // Break if started event skipping
-                            if (Event_buffer_is_skipping(player->event_buffer))
-                            {
-                                rassert(Event_buffer_is_full(player->event_buffer));
-                                Tstamp_set(limit, 0, 0);
-
-                                // Make sure we get this row again next time
-                                Cgiter_clear_returned_status(cgiter);
-                                return;
-                            }
-
-                            // Event fully processed
-                            Event_buffer_reset_add_counter(player->event_buffer);
+                            Tstamp_set(limit, 0, 0);
+
+                            // Make sure we get this row again next time
+                            Cgiter_clear_returned_status(cgiter);
+                            return;
                         }
-                    }
-                }
 
-                // Check pattern playback start
-                if (player->master_params.pattern_playback_flag)
-                    Player_start_pattern_playback_mode(player);
+                        const bool external = false;
 
-                // Perform goto
-                if (Player_check_perform_goto(player))
-                {
-                    Tstamp_set(limit, 0, 0);
-                    return;
-                }
+                        Player_process_expr_event(
+                                player,
+                                ch,
+                                Column_iter_get_desc(citer),
+                                NULL, // no meta value
+                                skip,
+                                external);
 
-                // Perform jump
-                if (player->master_params.do_jump)
-                {
-                    player->master_params.do_jump = false;
+                        // Break if started event skipping
+                        if (Event_buffer_is_skipping(player->event_buffer))
+                        {
+                            rassert(Event_buffer_is_full(player->event_buffer));
+                            Tstamp_set(limit, 0, 0);
 
-                    if (!at_active_jump)
-                    {
-                        // We just got a new Jump context
-                        next_jc = Active_jumps_get_next_context(
-                            player->master_params.active_jumps,
-                            &player->master_params.cur_pos.piref,
-                            &player->master_params.cur_pos.pat_pos,
-                            i,
-                            player->master_params.cur_trigger);
-                        rassert(next_jc != NULL);
-                    }
+                            // Make sure we get this row again next time
+                            Cgiter_clear_returned_status(cgiter);
+                            return;
+                        }
 
-                    --next_jc->counter;
+                        // Event fully processed
+                        Event_buffer_reset_add_counter(player->event_buffer);
+                    }
+                }
+            }
 
-                    // Get target pattern instance
-                    Pat_inst_ref target_piref = next_jc->target_piref;
-                    if (target_piref.pat < 0)
-                        target_piref = player->master_params.cur_pos.piref;
+            // Check pattern playback start
+            if (player->master_params.pattern_playback_flag)
+                Player_start_pattern_playback_mode(player);
 
-                    // Get target row
-                    Tstamp* target_row = TSTAMP_AUTO;
-                    Tstamp_copy(target_row, &next_jc->target_row);
+            // Perform goto
+            if (Player_check_perform_goto(player))
+            {
+                Tstamp_set(limit, 0, 0);
+                return;
+            }
 
-                    Player_set_new_playback_position(player, &target_piref, target_row);
+            // Perform jump
+            if (player->master_params.do_jump)
+            {
+                player->master_params.do_jump = false;
 
-                    Tstamp_set(limit, 0, 0);
-                    return;
+                if (!at_active_jump)
+                {
+                    // We just got a new Jump context
+                    next_jc = Active_jumps_get_next_context(
+                        player->master_params.active_jumps,
+                        &player->master_params.cur_pos.piref,
+                        &player->master_params.cur_pos.pat_pos,
+                        ch,
+                        player->master_params.cur_trigger);
+                    rassert(next_jc != NULL);
                 }
 
-                ++player->master_params.cur_trigger;
+                --next_jc->counter;
 
-                // Break if delay was added
-                if (Tstamp_cmp(&player->master_params.delay_left,
-                            TSTAMP_AUTO) > 0)
-                {
-                    Tstamp_set(limit, 0, 0);
+                // Get target pattern instance
+                Pat_inst_ref target_piref = next_jc->target_piref;
+                if (target_piref.pat < 0)
+                    target_piref = player->master_params.cur_pos.piref;
 
-                    // Make sure we get this row again next time
-                    Cgiter_clear_returned_status(cgiter);
-                    return;
-                }
+                // Get target row
+                Tstamp* target_row = TSTAMP_AUTO;
+                Tstamp_copy(target_row, &next_jc->target_row);
+
+                Player_set_new_playback_position(player, &target_piref, target_row);
 
-                trl = trl->next;
+                Tstamp_set(limit, 0, 0);
+                return;
             }
+
+            ++player->master_params.cur_trigger;
+
+            // Break if delay was added
+            if (Tstamp_cmp(&player->master_params.delay_left,
+                        TSTAMP_AUTO) > 0)
+            {
+                Tstamp_set(limit, 0, 0);
+
+                // Make sure we get this row again next time
+                Cgiter_clear_returned_status(cgiter);
+                return;
+            }
+
+            Column_iter_next(citer);
         }
 
         // All triggers processed in this column
         player->master_params.cur_trigger = 0;
-        ++player->master_params.cur_ch;
-
-        // See how much we can move forwards
-        Tstamp* dist = Tstamp_copy(TSTAMP_AUTO, limit);
-        if (Cgiter_peek(cgiter, dist) && Tstamp_cmp(dist, limit) < 0)
-            Tstamp_copy(limit, dist);
+        player->master_params.cur_ch = ch + 1;
     }
 
+    // See how much we can move forwards
+    Tstamp* dist = Tstamp_copy(TSTAMP_AUTO, limit);
+    if (Cgiter_peek(cgiter, dist) && Tstamp_cmp(dist, limit) < 0)
+        Tstamp_copy(limit, dist);
+
     // All trigger rows processed
     player->master_params.cur_ch = 0;
     player->master_params.cur_trigger = 0;
@@ -730,18 +781,11 @@ void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
 
     // TODO: Find our next Jump context
 
-    bool any_cgiter_active = false;
+    // Move cgiter forwards and check for playback end
+    Cgiter_move(cgiter, limit);
 
-    // Move cgiters forwards and check for playback end
-    for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-    {
-        Cgiter* cgiter = &player->cgiters[i];
-        Cgiter_move(cgiter, limit);
-        any_cgiter_active |= !Cgiter_has_finished(cgiter);
-    }
-
-    // Stop if all cgiters have finished
-    if (!any_cgiter_active)
+    // Stop if cgiter has finished
+    if (Cgiter_has_finished(cgiter))
     {
         // TODO: safety check for zero-length playback!
         if (player->master_params.is_infinite)
@@ -754,12 +798,7 @@ void Player_process_cgiters(Player* player, Tstamp* limit, bool skip)
                     (int)player->master_params.start_pos.piref.pat,
                     (int)player->master_params.start_pos.piref.inst);
 #endif
-            for (int i = 0; i < KQT_CHANNELS_MAX; ++i)
-            {
-                Cgiter_reset(
-                        &player->cgiters[i],
-                        &player->master_params.start_pos);
-            }
+            Cgiter_reset(cgiter, &player->master_params.start_pos);
         }
         else
         {
@@ -784,39 +823,49 @@ static void update_tempo_slide(Master_params* master_params)
         // Finish slide
         master_params->tempo = master_params->tempo_slide_target;
         master_params->tempo_slide = 0;
-    }
-    else if (Tstamp_cmp(&master_params->tempo_slide_slice_left, TSTAMP_AUTO) <= 0)
-    {
-        // New tempo
-        master_params->tempo += master_params->tempo_slide_update;
         master_params->tempo_settings_changed = true;
-
-        const bool is_too_low = master_params->tempo_slide < 0 &&
-            master_params->tempo < master_params->tempo_slide_target;
-        const bool is_too_high = master_params->tempo_slide > 0 &&
-            master_params->tempo > master_params->tempo_slide_target;
-        if (is_too_low || is_too_high)
-        {
-            // Finish slide
-            master_params->tempo = master_params->tempo_slide_target;
-            master_params->tempo_slide = 0;
-        }
-        else
-        {
-            // Start next slice
-            Tstamp_set(
-                    &master_params->tempo_slide_slice_left,
-                    0, KQT_TEMPO_SLIDE_SLICE_LEN);
-            Tstamp_mina(
-                    &master_params->tempo_slide_slice_left,
-                    &master_params->tempo_slide_left);
-        }
     }
 
     return;
 }
 
 
+static double get_slide_tempo_over_frames(
+        const Master_params* master_params, int32_t frames, int32_t audio_rate)
+{
+    rassert(master_params != NULL);
+    rassert(master_params->tempo_slide != 0);
+    rassert(frames >= 0);
+    rassert(audio_rate > 0);
+
+    // The tempo grows exponentially in time as it is linear in beats
+    const double start_tempo = master_params->tempo_slide_current;
+    const double x = master_params->tempo_slide_rate * frames / (60.0 * audio_rate);
+    if (fabs(x) < 1e-9)
+        return start_tempo;
+
+    return start_tempo * expm1(x) / x;
+}
+
+
+static double get_slide_tempo_over_beats(
+        const Master_params* master_params, const Tstamp* beats)
+{
+    rassert(master_params != NULL);
+    rassert(master_params->tempo_slide != 0);
+    rassert(beats != NULL);
+
+    const double start_tempo = master_params->tempo_slide_current;
+    const double y = master_params->tempo_slide_rate *
+        ((double)Tstamp_get_beats(beats) +
+         Tstamp_get_rem(beats) / (double)KQT_TSTAMP_BEAT) / start_tempo;
+    if (fabs(y) < 1e-9)
+        return start_tempo;
+
+    return start_tempo * y / log1p(y);
+}
+
+
 void Player_update_sliders_and_lfos_tempo(Player* player)
 {
     rassert(player != NULL);
@@ -857,25 +906,31 @@ int32_t Player_move_forwards(Player* player, int32_t nframes, bool skip)
     }
 
     /*
-    fprintf(stderr, "Tempo: %.2f %d " PRIts " %.2f " PRIts " " PRIts " %.2f\n",
+    fprintf(stderr, "Tempo: %.2f %d " PRIts " %.2f " PRIts " %.2f %.2f\n",
             player->master_params.tempo,
             player->master_params.tempo_slide,
             PRIVALts(player->master_params.tempo_slide_length),
             player->master_params.tempo_slide_target,
             PRIVALts(player->master_params.tempo_slide_left),
-            PRIVALts(player->master_params.tempo_slide_slice_left),
-            player->master_params.tempo_slide_update);
+            player->master_params.tempo_slide_current,
+            player->master_params.tempo_slide_rate);
     // */
 
     // Get maximum duration to move forwards
-    Tstamp* limit = Tstamp_fromframes(
-            TSTAMP_AUTO, nframes, player->master_params.tempo, player->audio_rate);
+    Tstamp* limit = TSTAMP_AUTO;
 
     if (player->master_params.tempo_slide != 0)
     {
-        // Apply tempo slide slice
-        Tstamp_mina(limit, &player->master_params.tempo_slide_slice_left);
-        Tstamp_suba(&player->master_params.tempo_slide_slice_left, limit);
+        // Follow the tempo curve until the end of the slide
+        const double slide_tempo = get_slide_tempo_over_frames(
+                &player->master_params, nframes, player->audio_rate);
+        Tstamp_fromframes(limit, nframes, slide_tempo, player->audio_rate);
+        Tstamp_mina(limit, &player->master_params.tempo_slide_left);
+    }
+    else
+    {
+        Tstamp_fromframes(
+                limit, nframes, player->master_params.tempo, player->audio_rate);
     }
 
     Tstamp* delay_left = &player->master_params.delay_left;
@@ -898,6 +953,22 @@ int32_t Player_move_forwards(Player* player, int32_t nframes, bool skip)
         player->master_params.goto_safety_counter = 0;
     }
 
+    if ((player->master_params.tempo_slide != 0) &&
+            !player->master_params.tempo_settings_changed &&
+            (Tstamp_cmp(limit, TSTAMP_AUTO) > 0))
+    {
+        Master_params* mp = &player->master_params;
+
+        // Render the covered part of the slide with its average tempo
+        mp->tempo = get_slide_tempo_over_beats(mp, limit);
+        Player_update_sliders_and_lfos_tempo(player);
+
+        mp->tempo_slide_current += mp->tempo_slide_rate *
+            ((double)Tstamp_get_beats(limit) +
+             Tstamp_get_rem(limit) / (double)KQT_TSTAMP_BEAT);
+        Tstamp_suba(&mp->tempo_slide_left, limit);
+    }
+
     // Get actual number of frames to be rendered
     double dframes =
         Tstamp_toframes(limit, player->master_params.tempo, player->audio_rate);
@@ -34,6 +34,15 @@ bool get_event_type_info(
 void Player_reset_channels(Player* player);
 
 
+/**
+ * Update carried controls of the Channels that may have them in progress.
+ *
+ * A Channel is added to the set when it receives an event and removed once
+ * none of its controls change over time.
+ */
+void Player_update_active_channels(Player* player, int64_t step_count);
+
+
 void Player_process_event(
         Player* player,
         int ch_num,
@@ -0,0 +1,96 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Render_profile.h>
+
+#include <debug/assert.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+
+bool Render_profile_is_enabled(void)
+{
+#ifdef ENABLE_RENDER_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+
+int64_t Render_profile_get_time(void)
+{
+#if defined(_XOPEN_SOURCE) && (_XOPEN_SOURCE >= 600)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + (int64_t)ts.tv_nsec;
+#else
+    // Fall back to processor time, which is good enough for single-threaded use
+    return (int64_t)((double)clock() * (1000000000.0 / CLOCKS_PER_SEC));
+#endif
+}
+
+
+void Profile_counter_reset(Profile_counter* counter)
+{
+    rassert(counter != NULL);
+
+    counter->nanoseconds = 0;
+    counter->call_count = 0;
+    counter->voice_frames = 0;
+
+    return;
+}
+
+
+void Profile_counter_add(
+        Profile_counter* counter, int64_t nanoseconds, int64_t voice_frames)
+{
+    rassert(counter != NULL);
+    rassert(nanoseconds >= 0);
+    rassert(voice_frames >= 0);
+
+    counter->nanoseconds += nanoseconds;
+    ++counter->call_count;
+    counter->voice_frames += voice_frames;
+
+    return;
+}
+
+
+bool Profile_counter_is_used(const Profile_counter* counter)
+{
+    rassert(counter != NULL);
+    return (counter->call_count > 0);
+}
+
+
+const char* Render_stage_get_name(Render_stage stage)
+{
+    rassert(stage < RENDER_STAGE_COUNT);
+
+    static const char* names[] =
+    {
+        [RENDER_STAGE_MASTER_VOLUME] = "master_volume",
+        [RENDER_STAGE_TEST_OUTPUTS]  = "test_outputs",
+        [RENDER_STAGE_DC_BLOCKER]    = "dc_blocker",
+    };
+
+    return names[stage];
+}
+
+
@@ -0,0 +1,127 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_RENDER_PROFILE_H
+#define KQT_RENDER_PROFILE_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * Rendering stages of the master output that are profiled separately.
+ */
+typedef enum
+{
+    RENDER_STAGE_MASTER_VOLUME = 0,
+    RENDER_STAGE_TEST_OUTPUTS,
+    RENDER_STAGE_DC_BLOCKER,
+    RENDER_STAGE_COUNT
+} Render_stage;
+
+
+/**
+ * Cumulative rendering cost of a single device or stage in one thread.
+ */
+typedef struct Profile_counter
+{
+    int64_t nanoseconds;
+    int64_t call_count;
+    int64_t voice_frames;
+} Profile_counter;
+
+
+#define PROFILE_COUNTER_AUTO \
+    (&(Profile_counter){ .nanoseconds = 0, .call_count = 0, .voice_frames = 0 })
+
+
+/**
+ * Instrumentation macros.
+ *
+ * These expand to nothing unless libkunquat is built with
+ * ENABLE_RENDER_PROFILING, so the rendering code pays nothing for them in
+ * regular builds.
+ */
+#ifdef ENABLE_RENDER_PROFILING
+#define PROFILE_START(name) const int64_t name = Render_profile_get_time()
+#define PROFILE_STOP(counter, name, frames) \
+    Profile_counter_add((counter), Render_profile_get_time() - (name), (frames))
+#else
+#define PROFILE_START(name) do {} while (false)
+#define PROFILE_STOP(counter, name, frames) do {} while (false)
+#endif
+
+
+/**
+ * Find out whether render profiling is compiled in.
+ *
+ * \return   \c true if profiling data is collected, otherwise \c false.
+ */
+bool Render_profile_is_enabled(void);
+
+
+/**
+ * Get the current value of the profiling clock.
+ *
+ * \return   A monotonic timestamp in nanoseconds.
+ */
+int64_t Render_profile_get_time(void);
+
+
+/**
+ * Reset a Profile counter.
+ *
+ * \param counter   The Profile counter -- must not be \c NULL.
+ */
+void Profile_counter_reset(Profile_counter* counter);
+
+
+/**
+ * Add a measurement to a Profile counter.
+ *
+ * \param counter        The Profile counter -- must not be \c NULL.
+ * \param nanoseconds    The time spent -- must be >= \c 0.
+ * \param voice_frames   The number of active voice frames rendered
+ *                       -- must be >= \c 0.
+ */
+void Profile_counter_add(
+        Profile_counter* counter, int64_t nanoseconds, int64_t voice_frames);
+
+
+/**
+ * Check if a Profile counter contains any measurements.
+ *
+ * \param counter   The Profile counter -- must not be \c NULL.
+ *
+ * \return   \c true if \a counter has been updated since the last reset,
+ *           otherwise \c false.
+ */
+bool Profile_counter_is_used(const Profile_counter* counter);
+
+
+/**
+ * Get the name of a rendering stage.
+ *
+ * \param stage   The rendering stage -- must be valid.
+ *
+ * \return   The name of the stage.
+ */
+const char* Render_stage_get_name(Render_stage stage);
+
+
+#endif // KQT_RENDER_PROFILE_H
+
+
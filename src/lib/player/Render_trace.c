@@ -0,0 +1,145 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/Render_trace.h>
+
+#include <debug/assert.h>
+#include <memory.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+struct Render_trace
+{
+    int32_t capacity;
+    int64_t total_count;
+    Trace_event* events;
+};
+
+
+Render_trace* new_Render_trace(int32_t capacity)
+{
+    rassert(capacity > 0);
+
+    Render_trace* trace = memory_alloc_item(Render_trace);
+    if (trace == NULL)
+        return NULL;
+
+    trace->capacity = capacity;
+    trace->total_count = 0;
+    trace->events = memory_alloc_items(Trace_event, capacity);
+    if (trace->events == NULL)
+    {
+        del_Render_trace(trace);
+        return NULL;
+    }
+
+    return trace;
+}
+
+
+void Render_trace_add(
+        Render_trace* trace,
+        Trace_event_type type,
+        uint32_t arg,
+        int64_t start,
+        int64_t stop)
+{
+    rassert(trace != NULL);
+    rassert(type < TRACE_EVENT_COUNT);
+    rassert(stop >= start);
+
+    Trace_event* event = &trace->events[trace->total_count % trace->capacity];
+    event->start = start;
+    event->stop = stop;
+    event->arg = arg;
+    event->type = type;
+
+    ++trace->total_count;
+
+    return;
+}
+
+
+int32_t Render_trace_get_event_count(const Render_trace* trace)
+{
+    rassert(trace != NULL);
+
+    if (trace->total_count < trace->capacity)
+        return (int32_t)trace->total_count;
+
+    return trace->capacity;
+}
+
+
+const Trace_event* Render_trace_get_event(const Render_trace* trace, int32_t index)
+{
+    rassert(trace != NULL);
+    rassert(index >= 0);
+    rassert(index < Render_trace_get_event_count(trace));
+
+    const int64_t first = trace->total_count - Render_trace_get_event_count(trace);
+
+    return &trace->events[(first + index) % trace->capacity];
+}
+
+
+int64_t Render_trace_get_dropped_count(const Render_trace* trace)
+{
+    rassert(trace != NULL);
+    return trace->total_count - Render_trace_get_event_count(trace);
+}
+
+
+void Render_trace_clear(Render_trace* trace)
+{
+    rassert(trace != NULL);
+    trace->total_count = 0;
+    return;
+}
+
+
+const char* Trace_event_type_get_name(Trace_event_type type)
+{
+    rassert(type < TRACE_EVENT_COUNT);
+
+    static const char* names[] =
+    {
+        [TRACE_EVENT_VGROUPS_START_WAIT]    = "vgroups_start_wait",
+        [TRACE_EVENT_VGROUPS_FINISHED_WAIT] = "vgroups_finished_wait",
+        [TRACE_EVENT_MIXED_START_WAIT]      = "mixed_start_wait",
+        [TRACE_EVENT_MIXED_LEVEL_WAIT]      = "mixed_level_wait",
+        [TRACE_EVENT_VOICE_GROUP]           = "voice_group",
+        [TRACE_EVENT_MIXED_TASK]            = "mixed_task",
+        [TRACE_EVENT_THREAD_MIX]            = "thread_mix",
+    };
+
+    return names[type];
+}
+
+
+void del_Render_trace(Render_trace* trace)
+{
+    if (trace == NULL)
+        return;
+
+    memory_free(trace->events);
+    memory_free(trace);
+
+    return;
+}
+
+
@@ -0,0 +1,173 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_RENDER_TRACE_H
+#define KQT_RENDER_TRACE_H
+
+
+#include <decl.h>
+#include <player/Render_profile.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+/**
+ * The default number of events retained per rendering thread.
+ */
+#define RENDER_TRACE_CAPACITY_DEFAULT 16384
+
+
+/**
+ * Types of timeline events recorded during rendering.
+ */
+typedef enum
+{
+    TRACE_EVENT_VGROUPS_START_WAIT = 0,
+    TRACE_EVENT_VGROUPS_FINISHED_WAIT,
+    TRACE_EVENT_MIXED_START_WAIT,
+    TRACE_EVENT_MIXED_LEVEL_WAIT,   ///< arg: level index
+    TRACE_EVENT_VOICE_GROUP,        ///< arg: Audio unit device ID
+    TRACE_EVENT_MIXED_TASK,         ///< arg: device ID
+    TRACE_EVENT_THREAD_MIX,
+    TRACE_EVENT_COUNT
+} Trace_event_type;
+
+
+/**
+ * A single complete timeline event.
+ */
+typedef struct Trace_event
+{
+    int64_t start;
+    int64_t stop;
+    uint32_t arg;
+    Trace_event_type type;
+} Trace_event;
+
+
+/**
+ * Timeline recording macros.
+ *
+ * The clock is only read if \a trace is not \c NULL, so disabled tracing
+ * costs a single comparison per recorded phase.
+ */
+#define TRACE_START(trace, name) \
+    const int64_t name = ((trace) != NULL) ? Render_profile_get_time() : 0
+
+#define TRACE_STOP(trace, name, type, arg)                               \
+    do                                                                   \
+    {                                                                    \
+        if ((trace) != NULL)                                             \
+            Render_trace_add(                                            \
+                    (trace), (type), (arg), (name), Render_profile_get_time()); \
+    } while (false)
+
+
+/**
+ * Create a new Render trace.
+ *
+ * A Render trace is a fixed-size ring buffer of Trace events written by a
+ * single rendering thread. Once the buffer is full, the oldest events are
+ * overwritten. The trace may only be read while its writer is waiting for
+ * new work, which is the case between calls of Player_play.
+ *
+ * \param capacity   The maximum number of events retained -- must be > \c 0.
+ *
+ * \return   The new Render trace if successful, or \c NULL if memory
+ *           allocation failed.
+ */
+Render_trace* new_Render_trace(int32_t capacity);
+
+
+/**
+ * Record an event in the Render trace.
+ *
+ * \param trace   The Render trace -- must not be \c NULL.
+ * \param type    The event type -- must be valid.
+ * \param arg     The event argument.
+ * \param start   The start time of the event in nanoseconds.
+ * \param stop    The stop time of the event in nanoseconds -- must be
+ *                >= \a start.
+ */
+void Render_trace_add(
+        Render_trace* trace,
+        Trace_event_type type,
+        uint32_t arg,
+        int64_t start,
+        int64_t stop);
+
+
+/**
+ * Get the number of events retained in the Render trace.
+ *
+ * \param trace   The Render trace -- must not be \c NULL.
+ *
+ * \return   The number of events available.
+ */
+int32_t Render_trace_get_event_count(const Render_trace* trace);
+
+
+/**
+ * Get a retained event from the Render trace.
+ *
+ * \param trace   The Render trace -- must not be \c NULL.
+ * \param index   The event index, \c 0 being the oldest event -- must be
+ *                >= \c 0 and < Render_trace_get_event_count(\a trace).
+ *
+ * \return   The event.
+ */
+const Trace_event* Render_trace_get_event(const Render_trace* trace, int32_t index);
+
+
+/**
+ * Get the number of events dropped due to buffer overflow since last clear.
+ *
+ * \param trace   The Render trace -- must not be \c NULL.
+ *
+ * \return   The number of dropped events.
+ */
+int64_t Render_trace_get_dropped_count(const Render_trace* trace);
+
+
+/**
+ * Remove all events from the Render trace.
+ *
+ * \param trace   The Render trace -- must not be \c NULL.
+ */
+void Render_trace_clear(Render_trace* trace);
+
+
+/**
+ * Get the name of a Trace event type.
+ *
+ * \param type   The event type -- must be valid.
+ *
+ * \return   The name of the event type.
+ */
+const char* Trace_event_type_get_name(Trace_event_type type);
+
+
+/**
+ * Destroy an existing Render trace.
+ *
+ * \param trace   The Render trace, or \c NULL.
+ */
+void del_Render_trace(Render_trace* trace);
+
+
+#endif // KQT_RENDER_TRACE_H
+
+
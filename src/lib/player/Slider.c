@@ -17,6 +17,7 @@
 #include <debug/assert.h>
 #include <mathnum/common.h>
 #include <player/Player.h>
+#include <player/Work_buffer.h>
 
 #include <math.h>
 #include <stdbool.h>
@@ -122,6 +123,103 @@ double Slider_skip(Slider* slider, int64_t steps)
 }
 
 
+static int32_t Slider_get_block_steps_left(
+        const Slider* slider, double start, int32_t count)
+{
+    rassert(slider != NULL);
+    rassert(count >= 0);
+
+    if (start >= 1)
+        return 0;
+
+    const double update = slider->progress_update;
+
+    // Estimate first and then adjust using the same expression as the fill
+    const double estimate = ceil((1 - start) / update) - 1;
+    int32_t steps = (estimate < count) ? max(0, (int32_t)estimate) : count;
+    while ((steps < count) && (start + (double)(steps + 1) * update < 1))
+        ++steps;
+    while ((steps > 0) && (start + (double)steps * update >= 1))
+        --steps;
+
+    return steps;
+}
+
+
+double Slider_fill(Slider* slider, float* values, int32_t count)
+{
+    rassert(slider != NULL);
+    rassert(values != NULL);
+    rassert(count >= 0);
+
+    const double start = slider->progress;
+    const double update = slider->progress_update;
+
+    const int32_t active_count = Slider_get_block_steps_left(slider, start, count);
+
+    if (slider->mode == SLIDE_MODE_EXP)
+    {
+        const double log2_from = slider->log2_from;
+        const double log2_to = slider->log2_to;
+        for (int32_t i = 0; i < active_count; ++i)
+        {
+            const double progress = start + (double)(i + 1) * update;
+            values[i] = (float)exp2(lerp(log2_from, log2_to, progress));
+        }
+    }
+    else
+    {
+        // Same as lerp but without assertions that would prevent vectorisation
+        const double from = slider->from;
+        const double range = slider->to - slider->from;
+        for (int32_t i = 0; i < active_count; ++i)
+        {
+            const double progress = start + (double)(i + 1) * update;
+            values[i] = (float)(from + range * progress);
+        }
+    }
+
+    const float target = (float)slider->to;
+    for (int32_t i = active_count; i < count; ++i)
+        values[i] = target;
+
+    if (count > 0)
+        slider->progress = start + (double)count * update;
+
+    return Slider_get_value(slider);
+}
+
+
+double Slider_fill_control_points(
+        Slider* slider,
+        double value,
+        float* values,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t period)
+{
+    rassert(slider != NULL);
+    rassert(values != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop > buf_start);
+    rassert(period >= 1);
+
+    int32_t prev_pos = buf_start - 1;
+    for (int32_t pos = buf_start;
+            pos < buf_stop;
+            pos = Work_buffer_get_next_control_pos(pos, buf_stop, period))
+    {
+        if (Slider_in_progress(slider))
+            value = Slider_skip(slider, pos - prev_pos);
+
+        values[pos] = (float)value;
+        prev_pos = pos;
+    }
+
+    return value;
+}
+
+
 int32_t Slider_estimate_active_steps_left(const Slider* slider)
 {
     rassert(slider != NULL);
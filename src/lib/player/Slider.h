@@ -118,6 +118,52 @@ double Slider_step(Slider* slider);
 double Slider_skip(Slider* slider, int64_t steps);
 
 
+/**
+ * Fill a block with consecutive slide values.
+ *
+ * The value written at index i is the value after i + 1 steps. The values are
+ * calculated in closed form instead of accumulating the progress step by step,
+ * so they may differ from the results of \a Slider_step by the rounding error
+ * of the accumulated progress. With linear slides, the difference is at most
+ * a few units in the last place of a double relative to the slide range; the
+ * end of the slide may also land one step earlier or later.
+ *
+ * \param slider   The Slider -- must not be \c NULL.
+ * \param values   The destination array -- must not be \c NULL.
+ * \param count    The number of steps to perform -- must be >= \c 0.
+ *
+ * \return   The value after the last step.
+ */
+double Slider_fill(Slider* slider, float* values, int32_t count);
+
+
+/**
+ * Fill slide values at control points.
+ *
+ * The value written at index i is the value after i - \a buf_start + 1
+ * steps, so the result matches \a Slider_step at the control points. The
+ * Slider is moved forwards by \a buf_stop - \a buf_start steps in total.
+ *
+ * \param slider      The Slider -- must not be \c NULL.
+ * \param value       The value used if \a slider is not in progress.
+ * \param values      The destination array -- must not be \c NULL.
+ * \param buf_start   The start index of the area to be filled -- must be
+ *                    >= \c 0.
+ * \param buf_stop    The stop index of the area to be filled -- must be
+ *                    > \a buf_start.
+ * \param period      The control period -- must be >= \c 1.
+ *
+ * \return   The value at the last control point.
+ */
+double Slider_fill_control_points(
+        Slider* slider,
+        double value,
+        float* values,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t period);
+
+
 /**
  * Estimate the number of active steps left in the Slider.
  *
@@ -18,7 +18,9 @@
 #include <init/devices/Device_impl.h>
 #include <mathnum/common.h>
 #include <memory.h>
+#include <player/devices/Device_thread_state.h>
 #include <player/devices/Voice_state.h>
+#include <player/Render_profile.h>
 
 #include <inttypes.h>
 #include <stdint.h>
@@ -221,6 +223,33 @@ void Voice_reset(Voice* voice)
 }
 
 
+static int32_t Voice_finish_render(Voice* voice, int32_t buf_start, int32_t buf_stop)
+{
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+
+    int32_t keep_alive_stop = 0;
+
+    if (voice != NULL)
+    {
+        voice->updated = true;
+
+        if (!voice->state->active)
+        {
+            Voice_reset(voice);
+            return buf_start;
+        }
+
+        if (!voice->state->note_on)
+            voice->prio = VOICE_PRIO_BG;
+
+        keep_alive_stop = voice->state->keep_alive_stop;
+    }
+
+    return clamp(keep_alive_stop, buf_start, buf_stop);
+}
+
+
 int32_t Voice_render(
         Voice* voice,
         uint32_t proc_id,
@@ -255,29 +284,105 @@ int32_t Voice_render(
     if (vstate != NULL)
         vstate->keep_alive_stop = 0;
 
+    PROFILE_START(render_start_time);
+
     const int32_t process_stop = Voice_state_render_voice(
             vstate, pstate, proc_ts, au_state, wbs, buf_start, buf_stop, tempo);
     ignore(process_stop); // TODO: not sure if we have any use for this
 
-    int32_t keep_alive_stop = 0;
+    PROFILE_STOP(
+            &proc_ts->profile,
+            render_start_time,
+            (vstate != NULL) ? (buf_stop - buf_start) : 0);
 
-    if (voice != NULL)
+    return Voice_finish_render(voice, buf_start, buf_stop);
+}
+
+
+void Voice_render_lanes(
+        Voice* voices[],
+        int count,
+        uint32_t proc_id,
+        Device_states* dstates,
+        int thread_id,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo,
+        int32_t keep_alive_stops[])
+{
+    rassert(voices != NULL);
+    rassert(count > 0);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(proc_id > 0);
+    rassert(dstates != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+    rassert(keep_alive_stops != NULL);
+
+    Proc_state* pstate = (Proc_state*)Device_states_get_state(dstates, proc_id);
+    const Processor* proc = (const Processor*)pstate->parent.device;
+    Device_thread_state* proc_ts =
+        Device_states_get_thread_state(dstates, thread_id, proc_id);
+    const Au_state* au_state = (const Au_state*)Device_states_get_state(
+            dstates, Processor_get_au_params(proc)->device_id);
+
+    Voice_state* vstates[VOICE_LANES_MAX] = { NULL };
+    int lanes[VOICE_LANES_MAX] = { 0 };
+    int render_count = 0;
+    int32_t voice_frames = 0;
+
+    for (int lane = 0; lane < count; ++lane)
     {
-        voice->updated = true;
+        Voice* voice = voices[lane];
+        rassert(implies(voice != NULL, voice->proc != NULL));
 
-        if (!voice->state->active)
+        keep_alive_stops[lane] = buf_start;
+
+        if ((voice != NULL) && (voice->prio == VOICE_PRIO_INACTIVE))
+            continue;
+
+        Voice_state* vstate = (voice != NULL) ? voice->state : NULL;
+        if (vstate != NULL)
         {
-            Voice_reset(voice);
-            return buf_start;
+            vstate->keep_alive_stop = 0;
+            voice_frames += buf_stop - buf_start;
         }
 
-        if (!voice->state->note_on)
-            voice->prio = VOICE_PRIO_BG;
+        vstates[render_count] = vstate;
+        lanes[render_count] = lane;
+        ++render_count;
+    }
 
-        keep_alive_stop = voice->state->keep_alive_stop;
+    if (render_count == 0)
+        return;
+
+    PROFILE_START(render_start_time);
+
+    Voice_state_render_voices(
+            vstates,
+            lanes,
+            render_count,
+            pstate,
+            proc_ts,
+            au_state,
+            wbs,
+            buf_start,
+            buf_stop,
+            tempo);
+
+    PROFILE_STOP(&proc_ts->profile, render_start_time, voice_frames);
+
+    for (int i = 0; i < render_count; ++i)
+    {
+        const int lane = lanes[i];
+        keep_alive_stops[lane] = Voice_finish_render(voices[lane], buf_start, buf_stop);
     }
 
-    return clamp(keep_alive_stop, buf_start, buf_stop);
+    return;
 }
 
 
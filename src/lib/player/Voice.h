@@ -247,6 +247,40 @@ int32_t Voice_render(
         double tempo);
 
 
+/**
+ * Render the Voices of one Processor in several voice lanes.
+ *
+ * \param voices             The Voices -- must not be \c NULL. The Voice at
+ *                           index i is rendered in voice lane i. Each Voice
+ *                           may be \c NULL if the associated Processor uses
+ *                           stateless Voice rendering.
+ * \param count              The number of Voices -- must be > \c 0 and
+ *                           <= \c VOICE_LANES_MAX.
+ * \param proc_id            The Processor ID -- must be valid.
+ * \param dstates            The Device states -- must not be \c NULL.
+ * \param thread_id          The ID of the thread accessing the Device state
+ *                           -- must be a valid ID currently in use.
+ * \param wbs                The Work buffers -- must not be \c NULL.
+ * \param buf_start          The start index of the buffer area to be rendered.
+ * \param buf_stop           The stop index of the buffer area to be rendered.
+ * \param tempo              The current tempo -- must be > \c 0.
+ * \param keep_alive_stops   Destination for the stop indices for keeping each
+ *                           Voice alive, see \a Voice_render -- must not be
+ *                           \c NULL.
+ */
+void Voice_render_lanes(
+        Voice* voices[],
+        int count,
+        uint32_t proc_id,
+        Device_states* dstates,
+        int thread_id,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo,
+        int32_t keep_alive_stops[]);
+
+
 /**
  * Destroy an existing Voice.
  *
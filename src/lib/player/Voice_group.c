@@ -159,6 +159,31 @@ static void reset_subgraph(
 }
 
 
+static void pass_voice_buffer(
+        Work_buffer* recv_buf,
+        Work_buffer* send_buf,
+        bool is_exclusive,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(recv_buf != NULL);
+    rassert(send_buf != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+
+    // The receive buffer has just been cleared, so the result of mixing the
+    // only input into it would be a copy of that input. Nothing else reads
+    // the send buffer of an exclusive connection, so we can simply swap the
+    // buffers instead and let the sender clear its new buffer on next render.
+    if (is_exclusive)
+        Work_buffer_swap(recv_buf, send_buf);
+    else
+        Work_buffer_mix(recv_buf, send_buf, buf_start, buf_stop);
+
+    return;
+}
+
+
 static int32_t process_voice_group(
         const Device_node* node,
         Voice_group* vgroup,
@@ -168,7 +193,8 @@ static int32_t process_voice_group(
         int32_t buf_start,
         int32_t buf_stop,
         int32_t audio_rate,
-        double tempo)
+        double tempo,
+        bool pass_exclusive)
 {
     rassert(node != NULL);
     rassert(vgroup != NULL);
@@ -247,24 +273,29 @@ static int32_t process_voice_group(
                     buf_start,
                     buf_stop,
                     audio_rate,
-                    tempo);
+                    tempo,
+                    pass_exclusive);
 
             keep_alive_stop = max(keep_alive_stop, sub_keep_alive_stop);
 
             if ((Device_node_get_type(node) == DEVICE_NODE_TYPE_PROCESSOR) &&
                     (Device_node_get_type(edge->node) == DEVICE_NODE_TYPE_PROCESSOR))
             {
-                // Mix voice audio buffers
+                // Pass voice audio buffers to the receiver
                 const Device_thread_state* send_ts = Device_states_get_thread_state(
                         dstates, thread_id, Device_get_id(send_device));
-                const Work_buffer* send_buf = Device_thread_state_get_voice_buffer(
+                Work_buffer* send_buf = Device_thread_state_get_voice_buffer(
                         send_ts, DEVICE_PORT_TYPE_SEND, edge->port);
 
                 Work_buffer* recv_buf = Device_thread_state_get_voice_buffer(
                         node_ts, DEVICE_PORT_TYPE_RECV, port);
 
+                const bool is_exclusive =
+                    pass_exclusive && Device_node_is_receive_exclusive(node, port);
+
                 if ((send_buf != NULL) && (recv_buf != NULL))
-                    Work_buffer_mix(recv_buf, send_buf, buf_start, buf_stop);
+                    pass_voice_buffer(
+                            recv_buf, send_buf, is_exclusive, buf_start, buf_stop);
             }
 
             edge = edge->next;
@@ -336,6 +367,11 @@ int32_t Voice_group_render(
     if (buf_start >= buf_stop)
         return buf_start;
 
+    // The output of the test Processor is read after rendering,
+    // so its send buffers must stay in place
+    const bool pass_exclusive =
+        !Voice_is_using_test_output(Voice_group_get_voice(vgroup, 0));
+
     reset_subgraph(dstates, thread_id, master);
     //Device_states_reset_node_states(dstates);
     return process_voice_group(
@@ -347,7 +383,268 @@ int32_t Voice_group_render(
             buf_start,
             buf_stop,
             audio_rate,
-            tempo);
+            tempo,
+            pass_exclusive);
+}
+
+
+bool Voice_group_is_batchable_with(const Voice_group* vg, const Voice_group* other)
+{
+    rassert(vg != NULL);
+    rassert(other != NULL);
+
+    if (vg->size != other->size)
+        return false;
+
+    for (int i = 0; i < vg->size; ++i)
+    {
+        const Voice* voice = vg->voices[i];
+        const Voice* other_voice = other->voices[i];
+
+        if ((Voice_get_proc(voice) != Voice_get_proc(other_voice)) ||
+                ((voice->prio == VOICE_PRIO_INACTIVE) !=
+                    (other_voice->prio == VOICE_PRIO_INACTIVE)) ||
+                (voice->state->active != other_voice->state->active))
+            return false;
+    }
+
+    return true;
+}
+
+
+static void process_voice_group_lanes(
+        const Device_node* node,
+        Voice_group* vgroups[],
+        int count,
+        Device_states* dstates,
+        int thread_id,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo,
+        int32_t keep_alive_stops[])
+{
+    rassert(node != NULL);
+    rassert(vgroups != NULL);
+    rassert(count > 0);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(dstates != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= 0);
+    rassert(tempo > 0);
+    rassert(keep_alive_stops != NULL);
+
+    for (int lane = 0; lane < count; ++lane)
+        keep_alive_stops[lane] = buf_start;
+
+    const Device* node_device = Device_node_get_device(node);
+    if (node_device == NULL)
+        return;
+
+    Device_thread_state* node_ts =
+        Device_states_get_thread_state(dstates, thread_id, Device_get_id(node_device));
+
+    if (Device_thread_state_get_node_state(node_ts) > DEVICE_NODE_STATE_NEW)
+    {
+        rassert(Device_thread_state_get_node_state(node_ts) == DEVICE_NODE_STATE_VISITED);
+        return;
+    }
+
+    Device_thread_state_set_node_state(node_ts, DEVICE_NODE_STATE_REACHED);
+
+    const bool is_processor = (Device_node_get_type(node) == DEVICE_NODE_TYPE_PROCESSOR);
+    const bool has_voice_signals =
+        is_processor && Processor_get_voice_signals((const Processor*)node_device);
+    const bool has_vstate = is_processor &&
+        ((node_device->dimpl->get_vstate_size == NULL) ||
+         (node_device->dimpl->get_vstate_size() > 0));
+    const uint32_t proc_id = Device_get_id(node_device);
+
+    if (is_processor)
+    {
+        // Clear the voice buffers for new contents
+        for (int lane = 0; lane < count; ++lane)
+        {
+            Device_thread_state_set_voice_lane(node_ts, lane);
+            Device_thread_state_clear_voice_buffers(node_ts, buf_start, buf_stop);
+        }
+        Device_thread_state_set_voice_lane(node_ts, 0);
+
+        if (has_voice_signals && has_vstate)
+        {
+            // Stop recursing if we don't have an active Voice,
+            // the batched Voice groups agree on this by construction
+            const Voice* voice = Voice_group_get_voice_by_proc(vgroups[0], proc_id);
+            const bool is_active = (voice != NULL) && voice->state->active;
+            for (int lane = 1; lane < count; ++lane)
+            {
+                const Voice* lane_voice =
+                    Voice_group_get_voice_by_proc(vgroups[lane], proc_id);
+                ignore(lane_voice);
+                rassert(is_active == ((lane_voice != NULL) && lane_voice->state->active));
+            }
+
+            if (!is_active)
+            {
+                Device_thread_state_set_node_state(node_ts, DEVICE_NODE_STATE_VISITED);
+                return;
+            }
+        }
+    }
+
+    const int last_port = Device_node_get_last_receive_port(node);
+    for (int port = 0; port <= last_port; ++port)
+    {
+        const Connection* edge = Device_node_get_received(node, port);
+
+        if (edge != NULL)
+            Device_thread_state_mark_input_port_connected(node_ts, port);
+
+        while (edge != NULL)
+        {
+            const Device* send_device = Device_node_get_device(edge->node);
+            if (send_device == NULL)
+            {
+                edge = edge->next;
+                continue;
+            }
+
+            int32_t sub_keep_alive_stops[VOICE_LANES_MAX] = { 0 };
+            process_voice_group_lanes(
+                    edge->node,
+                    vgroups,
+                    count,
+                    dstates,
+                    thread_id,
+                    wbs,
+                    buf_start,
+                    buf_stop,
+                    tempo,
+                    sub_keep_alive_stops);
+
+            for (int lane = 0; lane < count; ++lane)
+                keep_alive_stops[lane] =
+                    max(keep_alive_stops[lane], sub_keep_alive_stops[lane]);
+
+            if (is_processor &&
+                    (Device_node_get_type(edge->node) == DEVICE_NODE_TYPE_PROCESSOR))
+            {
+                // Pass voice audio buffers to the receiver
+                const Device_thread_state* send_ts = Device_states_get_thread_state(
+                        dstates, thread_id, Device_get_id(send_device));
+                const bool is_exclusive = Device_node_is_receive_exclusive(node, port);
+
+                for (int lane = 0; lane < count; ++lane)
+                {
+                    Work_buffer* send_buf = Device_thread_state_get_voice_lane_buffer(
+                            send_ts, lane, DEVICE_PORT_TYPE_SEND, edge->port);
+                    Work_buffer* recv_buf = Device_thread_state_get_voice_lane_buffer(
+                            node_ts, lane, DEVICE_PORT_TYPE_RECV, port);
+
+                    if ((send_buf != NULL) && (recv_buf != NULL))
+                        pass_voice_buffer(
+                                recv_buf, send_buf, is_exclusive, buf_start, buf_stop);
+                }
+            }
+
+            edge = edge->next;
+        }
+    }
+
+    if (has_voice_signals)
+    {
+        Voice* voices[VOICE_LANES_MAX] = { NULL };
+        bool call_render = true;
+
+        if (has_vstate)
+        {
+            // Find the Voices that belong to the current Processor
+            for (int lane = 0; lane < count; ++lane)
+            {
+                voices[lane] = Voice_group_get_voice_by_proc(vgroups[lane], proc_id);
+                rassert((voices[lane] != NULL) == (voices[0] != NULL));
+            }
+            call_render = (voices[0] != NULL);
+        }
+
+        if (call_render)
+        {
+            int32_t voice_keep_alive_stops[VOICE_LANES_MAX] = { 0 };
+            Voice_render_lanes(
+                    voices,
+                    count,
+                    proc_id,
+                    dstates,
+                    thread_id,
+                    wbs,
+                    buf_start,
+                    buf_stop,
+                    tempo,
+                    voice_keep_alive_stops);
+
+            for (int lane = 0; lane < count; ++lane)
+                keep_alive_stops[lane] =
+                    max(keep_alive_stops[lane], voice_keep_alive_stops[lane]);
+        }
+    }
+
+    Device_thread_state_set_node_state(node_ts, DEVICE_NODE_STATE_VISITED);
+
+    return;
+}
+
+
+void Voice_group_render_lanes(
+        Voice_group* vgroups[],
+        int count,
+        Device_states* dstates,
+        int thread_id,
+        const Connections* conns,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo,
+        int32_t process_stops[])
+{
+    rassert(vgroups != NULL);
+    rassert(count > 0);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(dstates != NULL);
+    rassert(thread_id >= 0);
+    rassert(thread_id < KQT_THREADS_MAX);
+    rassert(conns != NULL);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= 0);
+    rassert(tempo > 0);
+    rassert(process_stops != NULL);
+
+    const Device_node* master = Connections_get_master(conns);
+    rassert(master != NULL);
+    if (buf_start >= buf_stop)
+    {
+        for (int lane = 0; lane < count; ++lane)
+            process_stops[lane] = buf_start;
+        return;
+    }
+
+    reset_subgraph(dstates, thread_id, master);
+    process_voice_group_lanes(
+            master,
+            vgroups,
+            count,
+            dstates,
+            thread_id,
+            wbs,
+            buf_start,
+            buf_stop,
+            tempo,
+            process_stops);
+
+    return;
 }
 
 
@@ -363,6 +660,7 @@ int Voice_group_get_ch_num(const Voice_group* vg)
 static void mix_voice_signals(
         const Device_node* node,
         Voice_group* vgroup,
+        int lane,
         Device_states* dstates,
         int thread_id,
         int32_t buf_start,
@@ -406,7 +704,11 @@ static void mix_voice_signals(
             }
 
             if (call_mix)
+            {
+                Device_thread_state_set_voice_lane(node_ts, lane);
                 Device_thread_state_mix_voice_signals(node_ts, buf_start, buf_stop);
+                Device_thread_state_set_voice_lane(node_ts, 0);
+            }
 
             // Stop recursing as we don't depend on any mixed signals
             Device_thread_state_set_node_state(node_ts, DEVICE_NODE_STATE_VISITED);
@@ -429,7 +731,7 @@ static void mix_voice_signals(
             }
 
             mix_voice_signals(
-                    edge->node, vgroup, dstates, thread_id, buf_start, buf_stop);
+                    edge->node, vgroup, lane, dstates, thread_id, buf_start, buf_stop);
 
             edge = edge->next;
         }
@@ -443,6 +745,7 @@ static void mix_voice_signals(
 
 void Voice_group_mix(
         Voice_group* vgroup,
+        int lane,
         Device_states* dstates,
         int thread_id,
         const Connections* conns,
@@ -450,6 +753,8 @@ void Voice_group_mix(
         int32_t buf_stop)
 {
     rassert(vgroup != NULL);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
     rassert(dstates != NULL);
     rassert(thread_id >= 0);
     rassert(thread_id < KQT_THREADS_MAX);
@@ -464,7 +769,7 @@ void Voice_group_mix(
 
     reset_subgraph(dstates, thread_id, master);
     //Device_states_reset_node_states(dstates);
-    mix_voice_signals(master, vgroup, dstates, thread_id, buf_start, buf_stop);
+    mix_voice_signals(master, vgroup, lane, dstates, thread_id, buf_start, buf_stop);
 
     return;
 }
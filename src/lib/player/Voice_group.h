@@ -18,6 +18,7 @@
 
 #include <player/Voice.h>
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -125,6 +126,55 @@ int32_t Voice_group_render(
         double tempo);
 
 
+/**
+ * Check if two Voice groups can be rendered together in voice lanes.
+ *
+ * \param vg      The Voice group -- must not be \c NULL.
+ * \param other   The other Voice group -- must not be \c NULL.
+ *
+ * \return   \c true if the Voice groups contain Voices of the same Processors
+ *           in the same order and activity, otherwise \c false.
+ */
+bool Voice_group_is_batchable_with(const Voice_group* vg, const Voice_group* other);
+
+
+/**
+ * Process several batchable Voice groups inside the Connections.
+ *
+ * The Voice group at index i is rendered to voice lane i. Each lane gives
+ * the same result as processing the Voice group with \a Voice_group_render,
+ * but each Processor renders all lanes before moving on, which allows it to
+ * process the Voices in parallel.
+ *
+ * \param vgroups         The Voice groups -- must not be \c NULL and each
+ *                        pair of Voice groups must be batchable.
+ * \param count           The number of Voice groups -- must be > \c 0 and
+ *                        <= \c VOICE_LANES_MAX.
+ * \param dstates         The Device states -- must not be \c NULL.
+ * \param thread_id       The ID of the rendering thread -- must be valid.
+ * \param conns           The Connections -- must not be \c NULL.
+ * \param wbs             The Work buffers -- must not be \c NULL.
+ * \param buf_start       The start index of the buffer area to be processed
+ *                        -- must not be negative.
+ * \param buf_stop        The stop index of the buffer area to be processed
+ *                        -- must not be negative.
+ * \param tempo           The current tempo -- must be finite and > \c 0.
+ * \param process_stops   Destination for the stop index of each Voice group,
+ *                        see \a Voice_group_render -- must not be \c NULL.
+ */
+void Voice_group_render_lanes(
+        Voice_group* vgroups[],
+        int count,
+        Device_states* dstates,
+        int thread_id,
+        const Connections* conns,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo,
+        int32_t process_stops[]);
+
+
 /**
  * Get the Channel number associated with the Voice group.
  *
@@ -139,6 +189,8 @@ int Voice_group_get_ch_num(const Voice_group* vg);
  * Add Voice signals to mixed signal input buffers.
  *
  * \param vgroup      The Voice group -- must not be \c NULL.
+ * \param lane        The voice lane that contains the Voice signals -- must be
+ *                    >= \c 0 and < \c VOICE_LANES_MAX.
  * \param dstates     The Device states -- must not be \c NULL.
  * \param thread_id    The ID of the rendering thread -- must be valid.
  * \param conns       The Connections -- must not be \c NULL.
@@ -147,6 +199,7 @@ int Voice_group_get_ch_num(const Voice_group* vg);
  */
 void Voice_group_mix(
         Voice_group* vgroup,
+        int lane,
         Device_states* dstates,
         int thread_id,
         const Connections* conns,
@@ -331,7 +331,7 @@ Voice_group* Voice_pool_get_next_group_synced(Voice_pool* pool, Voice_group* vgr
     rassert(pool != NULL);
     rassert(vgroup != NULL);
 
-    Mutex_lock(&pool->group_iter_lock);
+    Mutex_lock_in_render(&pool->group_iter_lock);
 
     if (pool->group_iter_offset >= pool->size)
     {
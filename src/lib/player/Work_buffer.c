@@ -19,6 +19,7 @@
 #include <memory.h>
 #include <player/Work_buffer_private.h>
 
+#include <math.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
@@ -43,6 +44,7 @@ Work_buffer* new_Work_buffer(int32_t size)
     // Sanitise fields
     buffer->size = size;
     buffer->const_start = 0;
+    buffer->control_period = 1;
     buffer->is_final = true;
     buffer->is_unbounded = false;
     buffer->contents = NULL;
@@ -93,6 +95,7 @@ void Work_buffer_init_with_memory(
 
     buffer->size = raw_elem_count - 2;
     buffer->const_start = 0;
+    buffer->control_period = 1;
     buffer->is_final = true;
     buffer->is_unbounded = false;
     buffer->contents = space;
@@ -131,6 +134,7 @@ bool Work_buffer_resize(Work_buffer* buffer, int32_t new_size)
 
     Work_buffer_clear_const_start(buffer);
     Work_buffer_set_final(buffer, false);
+    buffer->control_period = 1;
 
     return true;
 }
@@ -175,6 +179,7 @@ float* Work_buffer_get_contents_mut(Work_buffer* buffer)
 
     Work_buffer_clear_const_start(buffer);
     Work_buffer_set_final(buffer, false);
+    buffer->control_period = 1;
 
     return (float*)buffer->contents + 1;
 }
@@ -186,6 +191,7 @@ int32_t* Work_buffer_get_contents_int_mut(Work_buffer* buffer)
 
     Work_buffer_clear_const_start(buffer);
     Work_buffer_set_final(buffer, false);
+    buffer->control_period = 1;
 
     return (int32_t*)buffer->contents + 1;
 }
@@ -219,6 +225,7 @@ void Work_buffer_copy(
     memcpy(dest_start, src_start, (size_t)(elem_count * WORK_BUFFER_ELEM_SIZE));
 
     Work_buffer_set_const_start(dest, Work_buffer_get_const_start(src));
+    dest->control_period = src->control_period;
 
     return;
 }
@@ -265,6 +272,76 @@ bool Work_buffer_is_final(const Work_buffer* buffer)
 }
 
 
+void Work_buffer_set_control_period(Work_buffer* buffer, int32_t period)
+{
+    rassert(buffer != NULL);
+    rassert(period >= 1);
+
+    buffer->control_period = period;
+
+    return;
+}
+
+
+int32_t Work_buffer_get_control_period(const Work_buffer* buffer)
+{
+    rassert(buffer != NULL);
+    return buffer->control_period;
+}
+
+
+int32_t Work_buffer_get_next_control_pos(
+        int32_t pos, int32_t buf_stop, int32_t period)
+{
+    rassert(pos < buf_stop);
+    rassert(period >= 1);
+
+    if (pos < buf_stop - 1)
+        return min(pos + period, buf_stop - 1);
+
+    return buf_stop;
+}
+
+
+void Work_buffer_interpolate_control_values(
+        Work_buffer* buffer, int32_t buf_start, int32_t buf_stop, int32_t period)
+{
+    rassert(buffer != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop <= Work_buffer_get_size(buffer));
+    rassert(period >= 1);
+
+    float* values = Work_buffer_get_contents_mut(buffer);
+
+    int32_t pos = buf_start;
+    while (pos < buf_stop - 1)
+    {
+        const int32_t next_pos = Work_buffer_get_next_control_pos(pos, buf_stop, period);
+        const float start_value = values[pos];
+        const float stop_value = values[next_pos];
+
+        if ((start_value == stop_value) ||
+                !isfinite(start_value) || !isfinite(stop_value))
+        {
+            for (int32_t i = pos + 1; i < next_pos; ++i)
+                values[i] = start_value;
+        }
+        else
+        {
+            const float step = (stop_value - start_value) / (float)(next_pos - pos);
+            for (int32_t i = 1; i < next_pos - pos; ++i)
+                values[pos + i] = start_value + step * (float)i;
+        }
+
+        pos = next_pos;
+    }
+
+    buffer->control_period = period;
+
+    return;
+}
+
+
 void Work_buffer_mix(
         Work_buffer* buffer,
         const Work_buffer* in,
@@ -283,6 +360,7 @@ void Work_buffer_mix(
         return;
 
     const int32_t orig_const_start = Work_buffer_get_const_start(buffer);
+    const int32_t orig_control_period = buffer->control_period;
 
     const bool buffer_has_final_value =
         (Work_buffer_is_final(buffer) && (orig_const_start < buf_stop));
@@ -326,6 +404,31 @@ void Work_buffer_mix(
     Work_buffer_set_const_start(buffer, new_const_start);
     Work_buffer_set_final(buffer, result_is_const_final);
 
+    // Adding a constant keeps the control points of the other input intact
+    if (!buffer_has_neg_inf_final_value && !in_has_neg_inf_final_value)
+    {
+        if (orig_const_start <= buf_start)
+            buffer->control_period = in->control_period;
+        else if ((in->const_start <= buf_start) ||
+                (in->control_period == orig_control_period))
+            buffer->control_period = orig_control_period;
+    }
+
+    return;
+}
+
+
+void Work_buffer_swap(Work_buffer* buffer, Work_buffer* other)
+{
+    rassert(buffer != NULL);
+    rassert(other != NULL);
+    rassert(Work_buffer_get_size(buffer) == Work_buffer_get_size(other));
+    rassert(buffer->is_unbounded == other->is_unbounded);
+
+    const Work_buffer temp = *buffer;
+    *buffer = *other;
+    *other = temp;
+
     return;
 }
 
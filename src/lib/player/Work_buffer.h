@@ -122,11 +122,11 @@ const float* Work_buffer_get_contents(const Work_buffer* buffer);
 /**
  * Get the mutable contents of the Work buffer.
  *
- * Note: This function clears the const start index and final status of the
- *       buffer as it no longer makes any assumptions of the buffer contents.
- *       If you wish to utilise these optimisation features, retrieve the
- *       state first by calling \a Work_buffer_get_const_start and
- *       \a Work_buffer_is_final.
+ * Note: This function clears the const start index, final status and control
+ *       period of the buffer as it no longer makes any assumptions of the
+ *       buffer contents. If you wish to utilise these optimisation features,
+ *       retrieve the state first by calling \a Work_buffer_get_const_start,
+ *       \a Work_buffer_is_final and \a Work_buffer_get_control_period.
  *
  * \param buffer   The Work buffer -- must not be \c NULL.
  *
@@ -216,6 +216,68 @@ void Work_buffer_set_final(Work_buffer* buffer, bool is_final);
 bool Work_buffer_is_final(const Work_buffer* buffer);
 
 
+/**
+ * Mark the Work buffer contents as control values computed at a lower rate.
+ *
+ * Control values are exact at the control points buf_start + n * \a period
+ * and at the last frame of the rendered area, and linearly interpolated
+ * between them. Consumers may process the control points only and
+ * interpolate their own results.
+ *
+ * NOTE: This is used as an optional performance optimisation. The caller
+ * must still fill the whole buffer area for code that does not take
+ * advantage of this information.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ * \param period   The distance between control points in frames
+ *                 -- must be >= \c 1. The value \c 1 indicates that every
+ *                 frame is computed separately.
+ */
+void Work_buffer_set_control_period(Work_buffer* buffer, int32_t period);
+
+
+/**
+ * Get the control period of the Work buffer.
+ *
+ * \param buffer   The Work buffer -- must not be \c NULL.
+ *
+ * \return   The distance between control points in frames, or \c 1 if the
+ *           buffer contents are not interpolated.
+ */
+int32_t Work_buffer_get_control_period(const Work_buffer* buffer);
+
+
+/**
+ * Get the next control point position.
+ *
+ * \param pos        The current control point position -- must be less
+ *                   than \a buf_stop.
+ * \param buf_stop   The stop index of the rendered area.
+ * \param period     The control period -- must be >= \c 1.
+ *
+ * \return   The next control point position, or \a buf_stop if \a pos is
+ *           the last control point.
+ */
+int32_t Work_buffer_get_next_control_pos(
+        int32_t pos, int32_t buf_stop, int32_t period);
+
+
+/**
+ * Fill the Work buffer between control points with interpolated values.
+ *
+ * The values at the control points must be set before calling this
+ * function. The buffer is marked with the control period afterwards.
+ *
+ * \param buffer      The Work buffer -- must not be \c NULL.
+ * \param buf_start   The start index of the rendered area -- must be >= \c 0.
+ * \param buf_stop    The stop index of the rendered area -- must not exceed
+ *                    the buffer size.
+ * \param period      The control period -- must be >= \c 1.
+ */
+void Work_buffer_interpolate_control_values(
+        Work_buffer* buffer, int32_t buf_start, int32_t buf_stop, int32_t period);
+
+
 /**
  * Mix the contents of a Work buffer into another as floating-point data.
  *
@@ -237,6 +299,21 @@ void Work_buffer_mix(
         int32_t buf_stop);
 
 
+/**
+ * Exchange the contents of two Work buffers.
+ *
+ * The Work buffer objects stay in place, so any references to them remain
+ * valid.
+ *
+ * \param buffer   The first Work buffer -- must not be \c NULL and must have
+ *                 been created with \a new_Work_buffer.
+ * \param other    The second Work buffer -- must not be \c NULL, must have
+ *                 been created with \a new_Work_buffer and must have the same
+ *                 size as \a buffer.
+ */
+void Work_buffer_swap(Work_buffer* buffer, Work_buffer* other);
+
+
 /**
  * Destroy an existing Work buffer.
  *
@@ -24,6 +24,7 @@ struct Work_buffer
 {
     int32_t size;
     int32_t const_start;
+    int32_t control_period;
     bool is_final;
     bool is_unbounded;
     void* contents;
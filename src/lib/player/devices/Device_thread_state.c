@@ -17,6 +17,7 @@
 #include <containers/Bit_array.h>
 #include <containers/Etable.h>
 #include <debug/assert.h>
+#include <mathnum/common.h>
 #include <memory.h>
 #include <player/Work_buffer.h>
 
@@ -39,6 +40,8 @@ Device_thread_state* new_Device_thread_state(
     ts->node_state = DEVICE_NODE_STATE_NEW;
     ts->has_mixed_audio = false;
     ts->in_connected = NULL;
+    ts->voice_lane = 0;
+    Profile_counter_reset(&ts->profile);
 
     for (Device_buffer_type buf_type = DEVICE_BUFFER_MIXED;
             buf_type < DEVICE_BUFFER_TYPES; ++buf_type)
@@ -48,6 +51,13 @@ Device_thread_state* new_Device_thread_state(
             ts->buffers[buf_type][port_type] = NULL;
     }
 
+    for (int lane = 1; lane < VOICE_LANES_MAX; ++lane)
+    {
+        for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
+                port_type < DEVICE_PORT_TYPES; ++port_type)
+            ts->lane_buffers[lane - 1][port_type] = NULL;
+    }
+
     ts->in_connected = new_Bit_array(KQT_DEVICE_PORTS_MAX);
     if (ts->in_connected == NULL)
     {
@@ -75,6 +85,26 @@ Device_thread_state* new_Device_thread_state(
 }
 
 
+static Etable* Device_thread_state_get_buffer_table(
+        const Device_thread_state* ts,
+        Device_buffer_type buf_type,
+        int lane,
+        Device_port_type port_type)
+{
+    rassert(ts != NULL);
+    rassert(buf_type < DEVICE_BUFFER_TYPES);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
+    rassert(implies(buf_type == DEVICE_BUFFER_MIXED, lane == 0));
+    rassert(port_type < DEVICE_PORT_TYPES);
+
+    if (lane == 0)
+        return ts->buffers[buf_type][port_type];
+
+    return ts->lane_buffers[lane - 1][port_type];
+}
+
+
 void Device_thread_state_set_node_state(
         Device_thread_state* ts, Device_node_state node_state)
 {
@@ -102,16 +132,25 @@ bool Device_thread_state_set_audio_buffer_size(Device_thread_state* ts, int size
     for (Device_buffer_type buf_type = DEVICE_BUFFER_MIXED;
             buf_type < DEVICE_BUFFER_TYPES; ++buf_type)
     {
-        for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
-                port_type < DEVICE_PORT_TYPES; ++port_type)
+        const int lane_count = (buf_type == DEVICE_BUFFER_VOICE) ? VOICE_LANES_MAX : 1;
+
+        for (int lane = 0; lane < lane_count; ++lane)
         {
-            Etable* bufs = ts->buffers[buf_type][port_type];
-            const int cap = Etable_get_capacity(bufs);
-            for (int port = 0; port < cap; ++port)
+            for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
+                    port_type < DEVICE_PORT_TYPES; ++port_type)
             {
-                Work_buffer* buffer = Etable_get(bufs, port);
-                if ((buffer != NULL) && !Work_buffer_resize(buffer, size))
-                    return false;
+                Etable* bufs = Device_thread_state_get_buffer_table(
+                        ts, buf_type, lane, port_type);
+                if (bufs == NULL)
+                    continue;
+
+                const int cap = Etable_get_capacity(bufs);
+                for (int port = 0; port < cap; ++port)
+                {
+                    Work_buffer* buffer = Etable_get(bufs, port);
+                    if ((buffer != NULL) && !Work_buffer_resize(buffer, size))
+                        return false;
+                }
             }
         }
     }
@@ -123,20 +162,25 @@ bool Device_thread_state_set_audio_buffer_size(Device_thread_state* ts, int size
 static bool Device_thread_state_add_buffer(
         Device_thread_state* ts,
         Device_buffer_type buf_type,
+        int lane,
         Device_port_type port_type,
         int port)
 {
     rassert(ts != NULL);
     rassert(buf_type < DEVICE_BUFFER_TYPES);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
     rassert(port_type < DEVICE_PORT_TYPES);
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
 
-    if (Etable_get(ts->buffers[buf_type][port_type], port) != NULL)
+    Etable* bufs = Device_thread_state_get_buffer_table(ts, buf_type, lane, port_type);
+    rassert(bufs != NULL);
+    if (Etable_get(bufs, port) != NULL)
         return true;
 
     Work_buffer* wb = new_Work_buffer(ts->audio_buffer_size);
-    if ((wb == NULL) || !Etable_set(ts->buffers[buf_type][port_type], port, wb))
+    if ((wb == NULL) || !Etable_set(bufs, port, wb))
     {
         del_Work_buffer(wb);
         return false;
@@ -149,18 +193,25 @@ static bool Device_thread_state_add_buffer(
 static void Device_thread_state_clear_buffers(
         Device_thread_state* ts,
         Device_buffer_type buf_type,
+        int lane,
         int32_t buf_start,
         int32_t buf_stop)
 {
     rassert(ts != NULL);
     rassert(buf_type < DEVICE_BUFFER_TYPES);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
 
     for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
             port_type < DEVICE_PORT_TYPES; ++port_type)
     {
-        Etable* bufs = ts->buffers[buf_type][port_type];
+        Etable* bufs =
+            Device_thread_state_get_buffer_table(ts, buf_type, lane, port_type);
+        if (bufs == NULL)
+            continue;
+
         const int cap = Etable_get_capacity(bufs);
         for (int port = 0; port < cap; ++port)
         {
@@ -179,11 +230,14 @@ static void Device_thread_state_clear_buffers(
 static Work_buffer* Device_thread_state_get_buffer(
         const Device_thread_state* ts,
         Device_buffer_type buf_type,
+        int lane,
         Device_port_type port_type,
         int port)
 {
     rassert(ts != NULL);
     rassert(buf_type < DEVICE_BUFFER_TYPES);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
     rassert(port_type < DEVICE_PORT_TYPES);
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
@@ -192,7 +246,12 @@ static Work_buffer* Device_thread_state_get_buffer(
             !Device_thread_state_is_input_port_connected(ts, port))
         return NULL;
 
-    return Etable_get(ts->buffers[buf_type][port_type], port);
+    const Etable* bufs =
+        Device_thread_state_get_buffer_table(ts, buf_type, lane, port_type);
+    if (bufs == NULL)
+        return NULL;
+
+    return Etable_get(bufs, port);
 }
 
 
@@ -204,7 +263,7 @@ bool Device_thread_state_add_mixed_buffer(
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
 
-    return Device_thread_state_add_buffer(ts, DEVICE_BUFFER_MIXED, type, port);
+    return Device_thread_state_add_buffer(ts, DEVICE_BUFFER_MIXED, 0, type, port);
 }
 
 
@@ -215,7 +274,7 @@ void Device_thread_state_clear_mixed_buffers(
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
 
-    Device_thread_state_clear_buffers(ts, DEVICE_BUFFER_MIXED, buf_start, buf_stop);
+    Device_thread_state_clear_buffers(ts, DEVICE_BUFFER_MIXED, 0, buf_start, buf_stop);
 
     ts->has_mixed_audio = false;
 
@@ -243,7 +302,7 @@ Work_buffer* Device_thread_state_get_connected_mixed_buffer(
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
 
-    return Device_thread_state_get_buffer(ts, DEVICE_BUFFER_MIXED, type, port);
+    return Device_thread_state_get_buffer(ts, DEVICE_BUFFER_MIXED, 0, type, port);
 }
 
 
@@ -271,7 +330,88 @@ bool Device_thread_state_add_voice_buffer(
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
 
-    return Device_thread_state_add_buffer(ts, DEVICE_BUFFER_VOICE, type, port);
+    const int lane_count =
+        Device_thread_state_has_voice_lanes(ts) ? VOICE_LANES_MAX : 1;
+
+    for (int lane = 0; lane < lane_count; ++lane)
+    {
+        if (!Device_thread_state_add_buffer(ts, DEVICE_BUFFER_VOICE, lane, type, port))
+            return false;
+    }
+
+    return true;
+}
+
+
+bool Device_thread_state_add_voice_lanes(Device_thread_state* ts)
+{
+    rassert(ts != NULL);
+
+    for (int lane = 1; lane < VOICE_LANES_MAX; ++lane)
+    {
+        for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
+                port_type < DEVICE_PORT_TYPES; ++port_type)
+        {
+            if (ts->lane_buffers[lane - 1][port_type] != NULL)
+                continue;
+
+            ts->lane_buffers[lane - 1][port_type] =
+                new_Etable(KQT_DEVICE_PORTS_MAX, (void (*)(void*))del_Work_buffer);
+            if (ts->lane_buffers[lane - 1][port_type] == NULL)
+                return false;
+        }
+    }
+
+    // Match the voice buffers of the first lane
+    for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
+            port_type < DEVICE_PORT_TYPES; ++port_type)
+    {
+        const Etable* bufs = ts->buffers[DEVICE_BUFFER_VOICE][port_type];
+        const int cap = Etable_get_capacity(bufs);
+        for (int port = 0; port < cap; ++port)
+        {
+            if (Etable_get(bufs, port) == NULL)
+                continue;
+
+            for (int lane = 1; lane < VOICE_LANES_MAX; ++lane)
+            {
+                if (!Device_thread_state_add_buffer(
+                            ts, DEVICE_BUFFER_VOICE, lane, port_type, port))
+                    return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+
+bool Device_thread_state_has_voice_lanes(const Device_thread_state* ts)
+{
+    rassert(ts != NULL);
+
+    // Lane tables are only created together
+    return (ts->lane_buffers[VOICE_LANES_MAX - 2][DEVICE_PORT_TYPES - 1] != NULL);
+}
+
+
+void Device_thread_state_set_voice_lane(Device_thread_state* ts, int lane)
+{
+    rassert(ts != NULL);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
+    rassert(implies(lane > 0, Device_thread_state_has_voice_lanes(ts)));
+
+    ts->voice_lane = lane;
+
+    return;
+}
+
+
+int Device_thread_state_get_voice_lane(const Device_thread_state* ts)
+{
+    rassert(ts != NULL);
+    return ts->voice_lane;
 }
 
 
@@ -282,12 +422,27 @@ void Device_thread_state_clear_voice_buffers(
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
 
-    Device_thread_state_clear_buffers(ts, DEVICE_BUFFER_VOICE, buf_start, buf_stop);
+    Device_thread_state_clear_buffers(
+            ts, DEVICE_BUFFER_VOICE, ts->voice_lane, buf_start, buf_stop);
 
     return;
 }
 
 
+Work_buffer* Device_thread_state_get_voice_lane_buffer(
+        const Device_thread_state* ts, int lane, Device_port_type type, int port)
+{
+    rassert(ts != NULL);
+    rassert(lane >= 0);
+    rassert(lane < VOICE_LANES_MAX);
+    rassert(type < DEVICE_PORT_TYPES);
+    rassert(port >= 0);
+    rassert(port < KQT_DEVICE_PORTS_MAX);
+
+    return Device_thread_state_get_buffer(ts, DEVICE_BUFFER_VOICE, lane, type, port);
+}
+
+
 Work_buffer* Device_thread_state_get_voice_buffer(
         const Device_thread_state* ts, Device_port_type type, int port)
 {
@@ -296,7 +451,8 @@ Work_buffer* Device_thread_state_get_voice_buffer(
     rassert(port >= 0);
     rassert(port < KQT_DEVICE_PORTS_MAX);
 
-    return Device_thread_state_get_buffer(ts, DEVICE_BUFFER_VOICE, type, port);
+    return Device_thread_state_get_buffer(
+            ts, DEVICE_BUFFER_VOICE, ts->voice_lane, type, port);
 }
 
 
@@ -361,6 +517,70 @@ bool Device_thread_state_has_mixed_audio(const Device_thread_state* ts)
 }
 
 
+void Device_thread_state_mix_thread_state(
+        Device_thread_state* ts,
+        const Device_thread_state* src,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(ts != NULL);
+    rassert(src != NULL);
+    rassert(ts->device_id == src->device_id);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= buf_start);
+
+    if (!src->has_mixed_audio)
+        return;
+
+    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
+    {
+        Work_buffer* dest_buffer =
+            Device_thread_state_get_mixed_buffer(ts, DEVICE_PORT_TYPE_SEND, port);
+        if (dest_buffer == NULL)
+            continue;
+
+        const Work_buffer* src_buffer =
+            Device_thread_state_get_mixed_buffer(src, DEVICE_PORT_TYPE_SEND, port);
+        rassert(src_buffer != NULL);
+
+        Work_buffer_mix(dest_buffer, src_buffer, buf_start, buf_stop);
+    }
+
+    Device_thread_state_mark_mixed_audio(ts);
+
+    return;
+}
+
+
+void Device_thread_state_swap_mixed_audio(
+        Device_thread_state* ts, Device_thread_state* other)
+{
+    rassert(ts != NULL);
+    rassert(other != NULL);
+    rassert(ts->device_id == other->device_id);
+
+    for (int port = 0; port < KQT_DEVICE_PORTS_MAX; ++port)
+    {
+        Work_buffer* buffer =
+            Device_thread_state_get_mixed_buffer(ts, DEVICE_PORT_TYPE_SEND, port);
+        if (buffer == NULL)
+            continue;
+
+        Work_buffer* other_buffer =
+            Device_thread_state_get_mixed_buffer(other, DEVICE_PORT_TYPE_SEND, port);
+        rassert(other_buffer != NULL);
+
+        Work_buffer_swap(buffer, other_buffer);
+    }
+
+    const bool has_mixed_audio = ts->has_mixed_audio;
+    ts->has_mixed_audio = other->has_mixed_audio;
+    other->has_mixed_audio = has_mixed_audio;
+
+    return;
+}
+
+
 void Device_thread_state_mark_input_port_connected(Device_thread_state* ts, int port)
 {
     rassert(ts != NULL);
@@ -399,6 +619,13 @@ void del_Device_thread_state(Device_thread_state* ts)
             del_Etable(ts->buffers[buf_type][port_type]);
     }
 
+    for (int lane = 1; lane < VOICE_LANES_MAX; ++lane)
+    {
+        for (Device_port_type port_type = DEVICE_PORT_TYPE_RECV;
+                port_type < DEVICE_PORT_TYPES; ++port_type)
+            del_Etable(ts->lane_buffers[lane - 1][port_type]);
+    }
+
     memory_free(ts);
 
     return;
@@ -20,12 +20,21 @@
 #include <init/devices/port_type.h>
 #include <kunquat/limits.h>
 #include <player/devices/Device_node_state.h>
+#include <player/Render_profile.h>
 
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
 
+/**
+ * The number of voice buffer sets in a Device thread state. Voice groups with
+ * identical structure may be rendered together so that each group uses its
+ * own set of voice buffers, called a lane.
+ */
+#define VOICE_LANES_MAX 4
+
+
 typedef enum
 {
     DEVICE_BUFFER_MIXED = 0,
@@ -49,6 +58,10 @@ struct Device_thread_state
     Bit_array* in_connected;
 
     Etable* buffers[DEVICE_BUFFER_TYPES][DEVICE_PORT_TYPES];
+    Etable* lane_buffers[VOICE_LANES_MAX - 1][DEVICE_PORT_TYPES]; // NULL if unused
+    int voice_lane;
+
+    Profile_counter profile;
 };
 
 
@@ -164,7 +177,7 @@ float* Device_thread_state_get_mixed_buffer_contents_mut(
 
 
 /**
- * Add a voice audio buffer into the Device thread state.
+ * Add a voice audio buffer into all lanes of the Device thread state.
  *
  * \param ts     The Device thread state -- must not be \c NULL.
  * \param type   The port type -- must be valid.
@@ -177,7 +190,54 @@ bool Device_thread_state_add_voice_buffer(
 
 
 /**
- * Clear voice audio buffers in the Device thread state.
+ * Add voice lanes beyond the first one into the Device thread state.
+ *
+ * The voice buffers of the new lanes match the existing voice buffers, and
+ * voice buffers added afterwards are added to all lanes. Voice lanes are only
+ * needed by Devices that may render Voice groups in batches.
+ *
+ * \param ts   The Device thread state -- must not be \c NULL.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Device_thread_state_add_voice_lanes(Device_thread_state* ts);
+
+
+/**
+ * Check if the Device thread state has voice lanes beyond the first one.
+ *
+ * \param ts   The Device thread state -- must not be \c NULL.
+ *
+ * \return   \c true if \a ts has all voice lanes, otherwise \c false.
+ */
+bool Device_thread_state_has_voice_lanes(const Device_thread_state* ts);
+
+
+/**
+ * Set the voice lane used by the Device thread state.
+ *
+ * The voice buffer functions that do not take a lane argument access the
+ * buffers of the current lane. The initial lane is \c 0.
+ *
+ * \param ts     The Device thread state -- must not be \c NULL.
+ * \param lane   The lane index -- must be >= \c 0 and < \c VOICE_LANES_MAX,
+ *               and \c 0 if \a ts does not have voice lanes.
+ */
+void Device_thread_state_set_voice_lane(Device_thread_state* ts, int lane);
+
+
+/**
+ * Get the current voice lane of the Device thread state.
+ *
+ * \param ts   The Device thread state -- must not be \c NULL.
+ *
+ * \return   The current lane index.
+ */
+int Device_thread_state_get_voice_lane(const Device_thread_state* ts);
+
+
+/**
+ * Clear voice audio buffers of the current lane in the Device thread state.
  *
  * \param ts          The Device state -- must not be \c NULL.
  * \param buf_start   The first frame to be cleared.
@@ -189,7 +249,21 @@ void Device_thread_state_clear_voice_buffers(
 
 
 /**
- * Return a voice audio buffer of the Device thread state.
+ * Return a voice audio buffer of a specific lane in the Device thread state.
+ *
+ * \param ts     The Device thread state -- must not be \c NULL.
+ * \param lane   The lane index -- must be >= \c 0 and < \c VOICE_LANES_MAX.
+ * \param type   The port type -- must be valid.
+ * \param port   The port number -- must be >= \c 0 and < \c KQT_DEVICE_PORTS_MAX.
+ *
+ * \return   The Work buffer if one exists, otherwise \c NULL.
+ */
+Work_buffer* Device_thread_state_get_voice_lane_buffer(
+        const Device_thread_state* ts, int lane, Device_port_type type, int port);
+
+
+/**
+ * Return a voice audio buffer of the current lane in the Device thread state.
  *
  * \param ts     The Device thread state -- must not be \c NULL.
  * \param type   The port type -- must be valid.
@@ -215,7 +289,7 @@ float* Device_thread_state_get_voice_buffer_contents(
 
 
 /**
- * Mix rendered Voice signals to mixed signal buffers.
+ * Mix rendered Voice signals of the current lane to mixed signal buffers.
  *
  * \param ts          The Device thread state -- must not be \c NULL.
  * \param buf_start   The start index of mixing -- must be >= \c 0.
@@ -236,6 +310,38 @@ void Device_thread_state_mix_voice_signals(
 bool Device_thread_state_has_mixed_audio(const Device_thread_state* ts);
 
 
+/**
+ * Mix the mixed audio output of another Device thread state.
+ *
+ * \param ts          The Device thread state -- must not be \c NULL.
+ * \param src         The source Device thread state -- must not be \c NULL
+ *                    and must belong to the same Device as \a ts.
+ * \param buf_start   The start index of the buffer area to be mixed
+ *                    -- must be >= \c 0.
+ * \param buf_stop    The stop index of the buffer area to be mixed
+ *                    -- must be >= \a buf_start.
+ */
+void Device_thread_state_mix_thread_state(
+        Device_thread_state* ts,
+        const Device_thread_state* src,
+        int32_t buf_start,
+        int32_t buf_stop);
+
+
+/**
+ * Exchange the mixed audio output of two Device thread states.
+ *
+ * This swaps the contents of the mixed send buffers along with the mixed
+ * audio status.
+ *
+ * \param ts      The Device thread state -- must not be \c NULL.
+ * \param other   The other Device thread state -- must not be \c NULL and
+ *                must belong to the same Device as \a ts.
+ */
+void Device_thread_state_swap_mixed_audio(
+        Device_thread_state* ts, Device_thread_state* other);
+
+
 /**
  * Mark input port as connected.
  *
@@ -115,23 +115,15 @@ static bool is_proc_filtered(
 }
 
 
-int32_t Voice_state_render_voice(
+static bool Voice_state_is_renderable(
         Voice_state* vstate,
-        Proc_state* proc_state,
-        const Device_thread_state* proc_ts,
+        const Proc_state* proc_state,
         const Au_state* au_state,
-        const Work_buffers* wbs,
         int32_t buf_start,
-        int32_t buf_stop,
-        double tempo)
+        int32_t buf_stop)
 {
     rassert(proc_state != NULL);
-    rassert(proc_ts != NULL);
     rassert(au_state != NULL);
-    rassert(wbs != NULL);
-    rassert(buf_start >= 0);
-    rassert(isfinite(tempo));
-    rassert(tempo > 0);
 
     const Device* device = proc_state->parent.device;
     rassert(device != NULL);
@@ -148,7 +140,7 @@ int32_t Voice_state_render_voice(
     {
         if (vstate != NULL)
             vstate->active = false;
-        return buf_start;
+        return false;
     }
 
     if ((vstate != NULL) && !vstate->expr_filters_applied)
@@ -162,17 +154,40 @@ int32_t Voice_state_render_voice(
                     is_proc_filtered(proc, ae, vstate->note_expr_name))
             {
                 vstate->active = false;
-                return buf_start;
+                return false;
             }
         }
 
         vstate->expr_filters_applied = true;
     }
 
-    if (buf_start >= buf_stop)
+    return (buf_start < buf_stop);
+}
+
+
+int32_t Voice_state_render_voice(
+        Voice_state* vstate,
+        Proc_state* proc_state,
+        const Device_thread_state* proc_ts,
+        const Au_state* au_state,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo)
+{
+    rassert(proc_state != NULL);
+    rassert(proc_ts != NULL);
+    rassert(au_state != NULL);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(isfinite(tempo));
+    rassert(tempo > 0);
+
+    if (!Voice_state_is_renderable(vstate, proc_state, au_state, buf_start, buf_stop))
         return buf_start;
 
     // Call the implementation
+    const Device_impl* dimpl = proc_state->parent.device->dimpl;
     const int32_t impl_render_stop = dimpl->render_voice(
             vstate, proc_state, proc_ts, au_state, wbs, buf_start, buf_stop, tempo);
     rassert(impl_render_stop <= buf_stop);
@@ -181,6 +196,92 @@ int32_t Voice_state_render_voice(
 }
 
 
+void Voice_state_render_voices(
+        Voice_state* vstates[],
+        const int lanes[],
+        int count,
+        Proc_state* proc_state,
+        Device_thread_state* proc_ts,
+        const Au_state* au_state,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo)
+{
+    rassert(vstates != NULL);
+    rassert(lanes != NULL);
+    rassert(count > 0);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(proc_state != NULL);
+    rassert(proc_ts != NULL);
+    rassert(au_state != NULL);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(isfinite(tempo));
+    rassert(tempo > 0);
+
+    const Device_impl* dimpl = proc_state->parent.device->dimpl;
+
+    // Leave out the Voice states that do not need rendering
+    Voice_state* render_vstates[VOICE_LANES_MAX] = { NULL };
+    int render_lanes[VOICE_LANES_MAX] = { 0 };
+    int render_count = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        if (Voice_state_is_renderable(
+                    vstates[i], proc_state, au_state, buf_start, buf_stop))
+        {
+            render_vstates[render_count] = vstates[i];
+            render_lanes[render_count] = lanes[i];
+            ++render_count;
+        }
+    }
+
+    if (render_count == 0)
+        return;
+
+    bool use_batch = (render_count > 1) && (dimpl->render_voices_batch != NULL);
+    for (int i = 0; i < render_count; ++i)
+        use_batch = use_batch && (render_vstates[i] != NULL);
+
+    if (use_batch)
+    {
+        dimpl->render_voices_batch(
+                render_vstates,
+                render_lanes,
+                render_count,
+                proc_state,
+                proc_ts,
+                au_state,
+                wbs,
+                buf_start,
+                buf_stop,
+                tempo);
+        return;
+    }
+
+    for (int i = 0; i < render_count; ++i)
+    {
+        Device_thread_state_set_voice_lane(proc_ts, render_lanes[i]);
+        const int32_t impl_render_stop = dimpl->render_voice(
+                render_vstates[i],
+                proc_state,
+                proc_ts,
+                au_state,
+                wbs,
+                buf_start,
+                buf_stop,
+                tempo);
+        rassert(impl_render_stop <= buf_stop);
+    }
+
+    Device_thread_state_set_voice_lane(proc_ts, 0);
+
+    return;
+}
+
+
 void Voice_state_set_keep_alive_stop(Voice_state* vstate, int32_t stop)
 {
     rassert(vstate != NULL);
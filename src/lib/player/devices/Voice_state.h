@@ -50,6 +50,27 @@ typedef int32_t Voice_state_render_voice_func(
         double tempo);
 
 
+/**
+ * Render the voice signals of several Voice states of the same Processor.
+ *
+ * The Voice state at index i renders to the voice buffers of lane \a lanes[i]
+ * of the Processor thread state. The implementation may process the voices in
+ * any interleaved order as long as the result of each voice matches the
+ * result of the corresponding single voice rendering function.
+ */
+typedef void Voice_state_render_voices_batch_func(
+        Voice_state* vstates[],
+        const int lanes[],
+        int count,
+        Proc_state*,
+        const Device_thread_state*,
+        const Au_state*,
+        const Work_buffers*,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo);
+
+
 typedef void Voice_state_set_cv_bool_func(
         Voice_state*, const Device_state*, const Key_indices, bool);
 typedef void Voice_state_set_cv_int_func(
@@ -153,6 +174,40 @@ int32_t Voice_state_render_voice(
         double tempo);
 
 
+/**
+ * Render voice signals of several Voice states of the same Processor.
+ *
+ * The Voice states are rendered with the batch rendering function of the
+ * Processor if it has one, otherwise they are rendered one at a time.
+ *
+ * \param vstates      The Voice states -- must not be \c NULL and must
+ *                     contain \a count Voice states.
+ * \param lanes        The voice lanes of the Voice states -- must not be
+ *                     \c NULL and must contain \a count distinct lanes.
+ * \param count        The number of Voice states -- must be > \c 0 and
+ *                     <= \c VOICE_LANES_MAX.
+ * \param proc_state   The Processor state -- must not be \c NULL.
+ * \param proc_ts      The Device thread state -- must not be \c NULL.
+ * \param au_state     The Audio unit state -- must not be \c NULL.
+ * \param wbs          The Work buffers -- must not be \c NULL.
+ * \param buf_start    The start index of rendering -- must be >= \c 0.
+ * \param buf_stop     The stop index of rendering -- must be less than or equal
+ *                     to the audio buffer size.
+ * \param tempo        The current tempo -- must be finite and > \c 0.
+ */
+void Voice_state_render_voices(
+        Voice_state* vstates[],
+        const int lanes[],
+        int count,
+        Proc_state* proc_state,
+        Device_thread_state* proc_ts,
+        const Au_state* au_state,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo);
+
+
 /**
  * Set request to keep the Voice state alive.
  *
@@ -23,6 +23,8 @@
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/Work_buffers.h>
 
+#include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
 
@@ -71,84 +73,61 @@ static const int ADD_WORK_BUFFER_MOD_L = WORK_BUFFER_IMPL_3;
 //static const int ADD_WORK_BUFFER_MOD_R = WORK_BUFFER_IMPL_4;
 
 
-int32_t Add_vstate_render_voice(
-        Voice_state* vstate,
-        Proc_state* proc_state,
-        const Device_thread_state* proc_ts,
-        const Au_state* au_state,
-        const Work_buffers* wbs,
-        int32_t buf_start,
-        int32_t buf_stop,
-        double tempo)
+static const float* get_base_func(
+        const float* base,
+        float phase_shift_abs,
+        int32_t* size,
+        float* min_phase_shift_abs,
+        float* max_phase_shift_abs)
 {
-    rassert(vstate != NULL);
-    rassert(proc_state != NULL);
-    rassert(proc_ts != NULL);
-    rassert(au_state != NULL);
-    rassert(wbs != NULL);
-    rassert(tempo > 0);
-
-    const Device_state* dstate = &proc_state->parent;
-    const Proc_add* add = (Proc_add*)proc_state->parent.device->dimpl;
-    Add_vstate* add_state = (Add_vstate*)vstate;
-    rassert(is_p2(ADD_BASE_FUNC_SIZE));
-
-    // Get frequencies
-    Work_buffer* freqs_wb = Device_thread_state_get_voice_buffer(
-            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PITCH);
-    Work_buffer* pitches_wb = freqs_wb;
-    if (freqs_wb == NULL)
-        freqs_wb = Work_buffers_get_buffer_mut(wbs, ADD_WORK_BUFFER_FIXED_PITCH);
-    Proc_fill_freq_buffer(freqs_wb, pitches_wb, buf_start, buf_stop);
-    const float* freqs = Work_buffer_get_contents(freqs_wb);
-
-    // Get volume scales
-    Work_buffer* scales_wb = Device_thread_state_get_voice_buffer(
-            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_FORCE);
-    Work_buffer* dBs_wb = scales_wb;
-    if ((dBs_wb != NULL) &&
-            Work_buffer_is_final(dBs_wb) &&
-            (Work_buffer_get_const_start(dBs_wb) <= buf_start) &&
-            (Work_buffer_get_contents(dBs_wb)[buf_start] == -INFINITY))
+    rassert(base != NULL);
+    rassert(size != NULL);
+    rassert(min_phase_shift_abs != NULL);
+    rassert(max_phase_shift_abs != NULL);
+
+    // Get current pitch range
+    int shift_exp = 0;
+    const float shift_norm = frexpf(phase_shift_abs, &shift_exp);
+    *min_phase_shift_abs = ldexpf(0.5f, shift_exp);
+    *max_phase_shift_abs = *min_phase_shift_abs * 2.0f;
+
+    // Choose appropriate waveform resolution for current pitch range
+    int32_t cur_size = ADD_BASE_FUNC_SIZE;
+    if (isfinite(shift_norm) && (shift_norm > 0.0f))
     {
-        // We are only getting silent force from this point onwards
-        vstate->active = false;
-        return buf_start;
+        cur_size = (int32_t)ipowi(2, clamp(-shift_exp + 1, 3, 30));
+        cur_size = min(cur_size, ADD_BASE_FUNC_SIZE * 2);
+        rassert(is_p2(cur_size));
     }
+    const int base_offset = (ADD_BASE_FUNC_SIZE * 4 - cur_size * 2);
+    rassert(base_offset >= 0);
+    rassert(base_offset < (ADD_BASE_FUNC_SIZE * 4) - 1);
 
-    if (scales_wb == NULL)
-        scales_wb = Work_buffers_get_buffer_mut(wbs, ADD_WORK_BUFFER_FIXED_FORCE);
-    Proc_fill_scale_buffer(scales_wb, dBs_wb, buf_start, buf_stop);
-    const float* scales = Work_buffer_get_contents(scales_wb);
+    *size = cur_size;
 
-    // Get output buffer for writing
-    float* out_bufs[2] = { NULL };
-    Proc_state_get_voice_audio_out_buffers(
-            proc_ts, PORT_OUT_AUDIO_L, PORT_OUT_COUNT, out_bufs);
+    return base + base_offset;
+}
 
-    // Get phase modulation signal
-    const Work_buffer* mod_wbs[] =
-    {
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PHASE_MOD_L),
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PHASE_MOD_R),
-    };
 
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        if (mod_wbs[ch] == NULL)
-        {
-            Work_buffer* zero_buf = Work_buffers_get_buffer_mut(
-                    wbs, (Work_buffer_type)(ADD_WORK_BUFFER_MOD_L + ch));
-            Work_buffer_clear(zero_buf, buf_start, buf_stop);
-            mod_wbs[ch] = zero_buf;
-        }
-    }
-
-    // Add base waveform tones
-    const double inv_audio_rate = 1.0 / dstate->audio_rate;
+static void Add_vstate_render_tones(
+        Add_vstate* add_state,
+        const Proc_add* add,
+        const Work_buffer* freqs_wb,
+        const float* scales,
+        const Work_buffer* mod_wbs[2],
+        float* out_bufs[2],
+        double inv_audio_rate,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(add_state != NULL);
+    rassert(add != NULL);
+    rassert(freqs_wb != NULL);
+    rassert(scales != NULL);
+    rassert(mod_wbs != NULL);
+    rassert(out_bufs != NULL);
 
+    const float* freqs = Work_buffer_get_contents(freqs_wb);
     const float* base = Sample_get_buffer(add->base, 0);
 
     for (int h = 0; h < add_state->tone_limit; ++h)
@@ -186,30 +165,21 @@ int32_t Add_vstate_render_voice(
             {
                 int32_t res_slice_stop = buf_stop;
 
-                // Get current pitch range
                 const float first_mod_shift =
                     mod_values_ch[res_slice_start] - add_state->prev_mod[ch];
                 const float first_phase_shift_abs = (float)fabs(
                         first_mod_shift +
                         (freqs[res_slice_start] * pitch_factor_inv_audio_rate));
-                int shift_exp = 0;
-                const float shift_norm = frexpf(first_phase_shift_abs, &shift_exp);
-                const float min_phase_shift_abs = ldexpf(0.5f, shift_exp);
-                const float max_phase_shift_abs = min_phase_shift_abs * 2.0f;
-
-                // Choose appropriate waveform resolution for current pitch range
-                int32_t cur_size = ADD_BASE_FUNC_SIZE;
-                if (isfinite(shift_norm) && (shift_norm > 0.0f))
-                {
-                    cur_size = (int32_t)ipowi(2, clamp(-shift_exp + 1, 3, 30));
-                    cur_size = min(cur_size, ADD_BASE_FUNC_SIZE * 2);
-                    rassert(is_p2(cur_size));
-                }
+                int32_t cur_size = 0;
+                float min_phase_shift_abs = 0;
+                float max_phase_shift_abs = 0;
+                const float* cur_base = get_base_func(
+                        base,
+                        first_phase_shift_abs,
+                        &cur_size,
+                        &min_phase_shift_abs,
+                        &max_phase_shift_abs);
                 const uint32_t cur_size_mask = (uint32_t)cur_size - 1;
-                const int base_offset = (ADD_BASE_FUNC_SIZE * 4 - cur_size * 2);
-                rassert(base_offset >= 0);
-                rassert(base_offset < (ADD_BASE_FUNC_SIZE * 4) - 1);
-                const float* cur_base = base + base_offset;
 
                 // Get length of input compatible with current waveform resolution
                 const int32_t res_check_stop = min(res_slice_stop,
@@ -274,6 +244,389 @@ int32_t Add_vstate_render_voice(
         }
     }
 
+    return;
+}
+
+
+#define ADD_TONE_LANES 4
+
+
+typedef struct Add_tone_lanes
+{
+    int count;
+    int tone_indices[ADD_TONES_MAX];
+    double phase_steps[ADD_TONES_MAX];
+    double volumes[ADD_TONES_MAX];
+    double pannings[2][ADD_TONES_MAX];
+    double init_phases[ADD_TONES_MAX];
+    double phases[ADD_TONES_MAX];
+    const float* bases[ADD_TONES_MAX];
+    int32_t sizes[ADD_TONES_MAX];
+    float min_phase_shifts[ADD_TONES_MAX];
+    float max_phase_shifts[ADD_TONES_MAX];
+} Add_tone_lanes;
+
+
+static bool Add_tone_lanes_init(
+        Add_tone_lanes* lanes,
+        const Add_vstate* add_state,
+        const Proc_add* add,
+        float* out_bufs[2],
+        double inv_audio_rate)
+{
+    rassert(lanes != NULL);
+    rassert(add_state != NULL);
+    rassert(add != NULL);
+    rassert(out_bufs != NULL);
+
+    // Without phase modulation, both channels follow the same phase
+    if ((add_state->prev_mod[0] != 0) || (add_state->prev_mod[1] != 0))
+        return false;
+
+    const int phase_ch = (out_bufs[0] != NULL) ? 0 : 1;
+    const bool check_phases = (out_bufs[0] != NULL) && (out_bufs[1] != NULL);
+
+    lanes->count = 0;
+
+    for (int h = 0; h < add_state->tone_limit; ++h)
+    {
+        const Add_tone* tone = &add->tones[h];
+        if ((tone->pitch_factor <= 0) || (tone->volume_factor <= 0))
+            continue;
+
+        const Add_tone_state* tone_state = &add_state->tones[h];
+        if (check_phases && (tone_state->phase[0] != tone_state->phase[1]))
+            return false;
+
+        const int lane = lanes->count;
+        lanes->tone_indices[lane] = h;
+        lanes->phase_steps[lane] = tone->pitch_factor * inv_audio_rate;
+        lanes->volumes[lane] = tone->volume_factor;
+        lanes->pannings[0][lane] = 1 + -tone->panning;
+        lanes->pannings[1][lane] = 1 + tone->panning;
+        lanes->init_phases[lane] = tone_state->phase[phase_ch];
+        lanes->phases[lane] = tone_state->phase[phase_ch];
+        lanes->bases[lane] = NULL;
+        lanes->sizes[lane] = 0;
+        lanes->min_phase_shifts[lane] = 0;
+        lanes->max_phase_shifts[lane] = 0;
+        ++lanes->count;
+    }
+
+    return true;
+}
+
+
+static void Add_tone_lanes_select_base_func(
+        Add_tone_lanes* lanes, int lane, const float* base, float freq)
+{
+    rassert(lanes != NULL);
+    rassert(lane >= 0);
+    rassert(lane < lanes->count);
+    rassert(base != NULL);
+
+    const float phase_shift_abs = (float)fabs(freq * lanes->phase_steps[lane]);
+    lanes->bases[lane] = get_base_func(
+            base,
+            phase_shift_abs,
+            &lanes->sizes[lane],
+            &lanes->min_phase_shifts[lane],
+            &lanes->max_phase_shifts[lane]);
+
+    return;
+}
+
+
+static bool Add_tone_lanes_is_base_func_valid(
+        const Add_tone_lanes* lanes, int lane, float freq)
+{
+    rassert(lanes != NULL);
+    rassert(lane >= 0);
+    rassert(lane < lanes->count);
+
+    const float phase_shift_abs = (float)fabs(freq * lanes->phase_steps[lane]);
+    return (phase_shift_abs >= lanes->min_phase_shifts[lane]) &&
+        (phase_shift_abs <= lanes->max_phase_shifts[lane]);
+}
+
+
+static void Add_tone_lanes_render(
+        Add_tone_lanes* lanes,
+        int first_lane,
+        int lane_count,
+        const float* freqs,
+        const float* scales,
+        float* out_bufs[2],
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(lanes != NULL);
+    rassert(first_lane >= 0);
+    rassert(lane_count > 0);
+    rassert(lane_count <= ADD_TONE_LANES);
+    rassert(first_lane + lane_count <= lanes->count);
+    rassert(freqs != NULL);
+    rassert(scales != NULL);
+    rassert(out_bufs != NULL);
+
+    double phases[ADD_TONE_LANES] = { 0 };
+    const float* bases[ADD_TONE_LANES] = { NULL };
+    double sizes[ADD_TONE_LANES] = { 0 };
+    uint32_t size_masks[ADD_TONE_LANES] = { 0 };
+
+    for (int i = 0; i < lane_count; ++i)
+    {
+        const int lane = first_lane + i;
+        phases[i] = lanes->phases[lane];
+        bases[i] = lanes->bases[lane];
+        sizes[i] = lanes->sizes[lane];
+        size_masks[i] = (uint32_t)lanes->sizes[lane] - 1;
+    }
+
+    const double* phase_steps = lanes->phase_steps + first_lane;
+    const double* volumes = lanes->volumes + first_lane;
+    const double* pannings_l = lanes->pannings[0] + first_lane;
+    const double* pannings_r = lanes->pannings[1] + first_lane;
+    const double* init_phases = lanes->init_phases + first_lane;
+
+    float* out_l = out_bufs[0];
+    float* out_r = out_bufs[1];
+
+    for (int32_t i = buf_start; i < buf_stop; ++i)
+    {
+        const float freq = freqs[i];
+        const float vol_scale = scales[i];
+
+        float sum_l = (out_l != NULL) ? out_l[i] : 0.0f;
+        float sum_r = (out_r != NULL) ? out_r[i] : 0.0f;
+
+        // Tones are added in the same order as in Add_vstate_render_tones
+        for (int lane = 0; lane < lane_count; ++lane)
+        {
+            const double pos = phases[lane] * sizes[lane];
+
+            const uint32_t pos1 = (uint32_t)(int32_t)floor(pos) & size_masks[lane];
+            const uint32_t pos2 = (pos1 + 1) & size_masks[lane];
+
+            const float* cur_base = bases[lane];
+            const float item1 = cur_base[pos1];
+            const float item_diff = cur_base[pos2] - item1;
+            const double lerp_val = pos - floor(pos);
+            const double value = (item1 + (lerp_val * item_diff)) * volumes[lane];
+
+            sum_l += (float)(value * pannings_l[lane]) * vol_scale;
+            sum_r += (float)(value * pannings_r[lane]) * vol_scale;
+
+            double phase = phases[lane] + freq * phase_steps[lane];
+
+            // Normalise to range [0, 1)
+            if (phase >= 1)
+            {
+                phase -= 1;
+
+                // Don't bother updating the phase if our frequency is too high
+                if (phase >= 1)
+                    phase = init_phases[lane];
+            }
+
+            phases[lane] = phase;
+        }
+
+        if (out_l != NULL)
+            out_l[i] = sum_l;
+        if (out_r != NULL)
+            out_r[i] = sum_r;
+    }
+
+    for (int i = 0; i < lane_count; ++i)
+        lanes->phases[first_lane + i] = phases[i];
+
+    return;
+}
+
+
+static void Add_vstate_render_tone_lanes(
+        Add_vstate* add_state,
+        Add_tone_lanes* lanes,
+        const Proc_add* add,
+        const Work_buffer* freqs_wb,
+        const float* scales,
+        float* out_bufs[2],
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(add_state != NULL);
+    rassert(lanes != NULL);
+    rassert(add != NULL);
+    rassert(freqs_wb != NULL);
+    rassert(scales != NULL);
+    rassert(out_bufs != NULL);
+
+    const float* freqs = Work_buffer_get_contents(freqs_wb);
+    const float* base = Sample_get_buffer(add->base, 0);
+
+    for (int lane = 0; lane < lanes->count; ++lane)
+        Add_tone_lanes_select_base_func(lanes, lane, base, freqs[buf_start]);
+
+    // The waveform resolutions can only change before the frequency settles
+    const int32_t res_check_stop =
+        min(buf_stop, max(Work_buffer_get_const_start(freqs_wb), buf_start) + 1);
+
+    int32_t res_slice_start = buf_start;
+    while (res_slice_start < buf_stop)
+    {
+        // Find the first frame that requires a new resolution for any tone
+        int32_t res_slice_stop = buf_stop;
+        for (int32_t i = res_slice_start + 1; i < res_check_stop; ++i)
+        {
+            bool is_valid = true;
+            for (int lane = 0; lane < lanes->count; ++lane)
+                is_valid &= Add_tone_lanes_is_base_func_valid(lanes, lane, freqs[i]);
+
+            if (!is_valid)
+            {
+                res_slice_stop = i;
+                break;
+            }
+        }
+
+        for (int first_lane = 0; first_lane < lanes->count; first_lane += ADD_TONE_LANES)
+            Add_tone_lanes_render(
+                    lanes,
+                    first_lane,
+                    min(ADD_TONE_LANES, lanes->count - first_lane),
+                    freqs,
+                    scales,
+                    out_bufs,
+                    res_slice_start,
+                    res_slice_stop);
+
+        if (res_slice_stop < buf_stop)
+        {
+            const float freq = freqs[res_slice_stop];
+            for (int lane = 0; lane < lanes->count; ++lane)
+            {
+                if (!Add_tone_lanes_is_base_func_valid(lanes, lane, freq))
+                    Add_tone_lanes_select_base_func(lanes, lane, base, freq);
+            }
+        }
+
+        res_slice_start = res_slice_stop;
+    }
+
+    for (int lane = 0; lane < lanes->count; ++lane)
+    {
+        Add_tone_state* tone_state = &add_state->tones[lanes->tone_indices[lane]];
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (out_bufs[ch] != NULL)
+                tone_state->phase[ch] = lanes->phases[lane];
+        }
+    }
+
+    return;
+}
+
+
+int32_t Add_vstate_render_voice(
+        Voice_state* vstate,
+        Proc_state* proc_state,
+        const Device_thread_state* proc_ts,
+        const Au_state* au_state,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo)
+{
+    rassert(vstate != NULL);
+    rassert(proc_state != NULL);
+    rassert(proc_ts != NULL);
+    rassert(au_state != NULL);
+    rassert(wbs != NULL);
+    rassert(tempo > 0);
+
+    const Device_state* dstate = &proc_state->parent;
+    const Proc_add* add = (Proc_add*)proc_state->parent.device->dimpl;
+    Add_vstate* add_state = (Add_vstate*)vstate;
+    rassert(is_p2(ADD_BASE_FUNC_SIZE));
+
+    // Get frequencies
+    Work_buffer* freqs_wb = Device_thread_state_get_voice_buffer(
+            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PITCH);
+    Work_buffer* pitches_wb = freqs_wb;
+    if (freqs_wb == NULL)
+        freqs_wb = Work_buffers_get_buffer_mut(wbs, ADD_WORK_BUFFER_FIXED_PITCH);
+    Proc_fill_freq_buffer(freqs_wb, pitches_wb, buf_start, buf_stop);
+
+    // Get volume scales
+    Work_buffer* scales_wb = Device_thread_state_get_voice_buffer(
+            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_FORCE);
+    Work_buffer* dBs_wb = scales_wb;
+    if ((dBs_wb != NULL) &&
+            Work_buffer_is_final(dBs_wb) &&
+            (Work_buffer_get_const_start(dBs_wb) <= buf_start) &&
+            (Work_buffer_get_contents(dBs_wb)[buf_start] == -INFINITY))
+    {
+        // We are only getting silent force from this point onwards
+        vstate->active = false;
+        return buf_start;
+    }
+
+    if (scales_wb == NULL)
+        scales_wb = Work_buffers_get_buffer_mut(wbs, ADD_WORK_BUFFER_FIXED_FORCE);
+    Proc_fill_scale_buffer(scales_wb, dBs_wb, buf_start, buf_stop);
+    const float* scales = Work_buffer_get_contents(scales_wb);
+
+    // Get output buffer for writing
+    float* out_bufs[2] = { NULL };
+    Proc_state_get_voice_audio_out_buffers(
+            proc_ts, PORT_OUT_AUDIO_L, PORT_OUT_COUNT, out_bufs);
+
+    // Get phase modulation signal
+    const Work_buffer* mod_wbs[] =
+    {
+        Device_thread_state_get_voice_buffer(
+                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PHASE_MOD_L),
+        Device_thread_state_get_voice_buffer(
+                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_PHASE_MOD_R),
+    };
+
+    // Add base waveform tones
+    const double inv_audio_rate = 1.0 / dstate->audio_rate;
+
+    Add_tone_lanes* lanes = &(Add_tone_lanes){ .count = 0 };
+    if ((mod_wbs[0] == NULL) && (mod_wbs[1] == NULL) &&
+            ((out_bufs[0] != NULL) || (out_bufs[1] != NULL)) &&
+            Add_tone_lanes_init(lanes, add_state, add, out_bufs, inv_audio_rate))
+    {
+        Add_vstate_render_tone_lanes(
+                add_state, lanes, add, freqs_wb, scales, out_bufs, buf_start, buf_stop);
+    }
+    else
+    {
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (mod_wbs[ch] == NULL)
+            {
+                Work_buffer* zero_buf = Work_buffers_get_buffer_mut(
+                        wbs, (Work_buffer_type)(ADD_WORK_BUFFER_MOD_L + ch));
+                Work_buffer_clear(zero_buf, buf_start, buf_stop);
+                mod_wbs[ch] = zero_buf;
+            }
+        }
+
+        Add_vstate_render_tones(
+                add_state,
+                add,
+                freqs_wb,
+                scales,
+                mod_wbs,
+                out_bufs,
+                inv_audio_rate,
+                buf_start,
+                buf_stop);
+    }
+
     if (add->is_ramp_attack_enabled)
         Proc_ramp_attack(vstate, 2, out_bufs, buf_start, buf_stop, dstate->audio_rate);
 
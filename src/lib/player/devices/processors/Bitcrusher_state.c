@@ -19,6 +19,7 @@
 #include <init/devices/processors/Proc_bitcrusher.h>
 #include <mathnum/common.h>
 #include <mathnum/fast_exp2.h>
+#include <mathnum/fast_math.h>
 #include <memory.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/Proc_state.h>
@@ -217,8 +218,19 @@ static void Bitcrusher_state_impl_render(
         const float* res_buf = Work_buffer_get_contents(resolution_wb);
         float* mults = Work_buffer_get_contents_mut(mults_wb);
 
-        for (int32_t i = buf_start; i < const_start; ++i)
-            mults[i] = (float)fast_exp2(max(1, res_buf[i]));
+        if (buf_start < const_start)
+        {
+            for (int32_t i = buf_start; i < const_start; ++i)
+                mults[i] = max(1, res_buf[i]);
+
+            fast_exp2_array(
+                    mults + buf_start,
+                    mults + buf_start,
+                    const_start - buf_start,
+                    1,
+                    1,
+                    FAST_MATH_ACCURACY_APPROX);
+        }
 
         if (const_start < buf_stop)
         {
@@ -0,0 +1,433 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/devices/processors/Conv_state.h>
+
+#include <debug/assert.h>
+#include <init/devices/Device.h>
+#include <init/devices/processors/Proc_conv.h>
+#include <mathnum/common.h>
+#include <mathnum/fft.h>
+#include <memory.h>
+#include <player/devices/Device_thread_state.h>
+#include <player/devices/processors/Proc_state_utils.h>
+#include <player/Work_buffers.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/*
+ * The convolution is calculated with uniformly partitioned overlap-save.
+ *
+ * Input is collected into blocks of part_size frames. When a block is full,
+ * the spectrum of the last two blocks is added to a frequency-domain delay
+ * line, the delay line is multiplied with the partition spectra of the
+ * impulse response, and the second half of the inverse transform of the sum
+ * is the output of the next part_size frames.
+ */
+
+
+typedef struct Conv_pstate
+{
+    Proc_state parent;
+
+    FFT_worker fft_worker;
+    bool has_fft_worker;
+
+    int32_t part_size;
+    int32_t part_count;
+    int32_t block_pos;
+    int32_t fdl_pos;
+
+    float* buffer;
+    float* in_blocks[2];
+    float* out_blocks[2];
+    float* fdls[2];
+    float* acc;
+} Conv_pstate;
+
+
+static void Conv_pstate_clear(Conv_pstate* cpstate)
+{
+    rassert(cpstate != NULL);
+
+    cpstate->block_pos = 0;
+    cpstate->fdl_pos = 0;
+
+    if (cpstate->buffer != NULL)
+    {
+        const int64_t spectrum_size = cpstate->part_size * 2;
+        const int64_t ch_size =
+            spectrum_size + cpstate->part_size + spectrum_size * cpstate->part_count;
+        memset(cpstate->buffer, 0, sizeof(float) * (size_t)(ch_size * 2 + spectrum_size));
+    }
+
+    return;
+}
+
+
+static bool Conv_pstate_resize(Conv_pstate* cpstate)
+{
+    rassert(cpstate != NULL);
+
+    const Proc_conv* conv = (const Proc_conv*)cpstate->parent.parent.device->dimpl;
+
+    // Release the old buffers first so that we always end up in a valid state
+    memory_free(cpstate->buffer);
+    cpstate->buffer = NULL;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        cpstate->in_blocks[ch] = NULL;
+        cpstate->out_blocks[ch] = NULL;
+        cpstate->fdls[ch] = NULL;
+    }
+    cpstate->acc = NULL;
+    cpstate->part_count = 0;
+
+    if ((cpstate->part_size != conv->part_size) && cpstate->has_fft_worker)
+    {
+        FFT_worker_deinit(&cpstate->fft_worker);
+        cpstate->has_fft_worker = false;
+    }
+
+    cpstate->part_size = conv->part_size;
+
+    if (conv->part_count == 0)
+    {
+        Conv_pstate_clear(cpstate);
+        return true;
+    }
+
+    const int32_t spectrum_size = conv->part_size * 2;
+
+    if (!cpstate->has_fft_worker)
+    {
+        if (FFT_worker_init(&cpstate->fft_worker, spectrum_size) == NULL)
+            return false;
+        cpstate->has_fft_worker = true;
+    }
+
+    const int64_t ch_size =
+        spectrum_size + conv->part_size + (int64_t)spectrum_size * conv->part_count;
+    cpstate->buffer = memory_alloc_items(float, ch_size * 2 + spectrum_size);
+    if (cpstate->buffer == NULL)
+        return false;
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        float* ch_buffer = cpstate->buffer + ch * ch_size;
+        cpstate->in_blocks[ch] = ch_buffer;
+        cpstate->out_blocks[ch] = ch_buffer + spectrum_size;
+        cpstate->fdls[ch] = ch_buffer + spectrum_size + conv->part_size;
+    }
+    cpstate->acc = cpstate->buffer + ch_size * 2;
+    cpstate->part_count = conv->part_count;
+
+    Conv_pstate_clear(cpstate);
+
+    return true;
+}
+
+
+static void del_Conv_pstate(Device_state* dstate)
+{
+    rassert(dstate != NULL);
+
+    Conv_pstate* cpstate = (Conv_pstate*)dstate;
+
+    if (cpstate->has_fft_worker)
+        FFT_worker_deinit(&cpstate->fft_worker);
+    memory_free(cpstate->buffer);
+    memory_free(cpstate);
+
+    return;
+}
+
+
+static void Conv_pstate_reset(Device_state* dstate)
+{
+    rassert(dstate != NULL);
+
+    Conv_pstate_clear((Conv_pstate*)dstate);
+
+    return;
+}
+
+
+static void Conv_pstate_clear_history(Proc_state* proc_state)
+{
+    rassert(proc_state != NULL);
+
+    Conv_pstate_clear((Conv_pstate*)proc_state);
+
+    return;
+}
+
+
+static void multiply_add_spectra(
+        float* restrict acc,
+        const float* restrict x,
+        const float* restrict h,
+        int32_t spectrum_size)
+{
+    rassert(acc != NULL);
+    rassert(x != NULL);
+    rassert(h != NULL);
+    rassert(spectrum_size >= 2);
+
+    // The spectra are in the format of FFT_worker_rfft:
+    // DC, (real, imaginary) pairs and the Nyquist frequency
+    acc[0] += x[0] * h[0];
+
+    for (int32_t i = 1; i < spectrum_size - 1; i += 2)
+    {
+        const float xr = x[i];
+        const float xi = x[i + 1];
+        const float hr = h[i];
+        const float hi = h[i + 1];
+        acc[i] += (xr * hr) - (xi * hi);
+        acc[i + 1] += (xr * hi) + (xi * hr);
+    }
+
+    acc[spectrum_size - 1] += x[spectrum_size - 1] * h[spectrum_size - 1];
+
+    return;
+}
+
+
+static void Conv_pstate_process_block(
+        Conv_pstate* cpstate, int ch, const float* ir_spectra)
+{
+    rassert(cpstate != NULL);
+    rassert(ch >= 0);
+    rassert(ch < 2);
+    rassert(ir_spectra != NULL);
+
+    const int32_t part_size = cpstate->part_size;
+    const int32_t spectrum_size = part_size * 2;
+    const int32_t part_count = cpstate->part_count;
+
+    float* in_block = cpstate->in_blocks[ch];
+    float* fdl = cpstate->fdls[ch];
+    float* acc = cpstate->acc;
+
+    // Add the spectrum of the latest two input blocks to the delay line
+    float* spectrum = fdl + (int64_t)cpstate->fdl_pos * spectrum_size;
+    memcpy(spectrum, in_block, sizeof(float) * (size_t)spectrum_size);
+    FFT_worker_rfft(&cpstate->fft_worker, spectrum, spectrum_size);
+
+    memmove(in_block, in_block + part_size, sizeof(float) * (size_t)part_size);
+
+    // Multiply the delay line with the impulse response partitions
+    for (int32_t i = 0; i < spectrum_size; ++i)
+        acc[i] = 0;
+
+    int32_t fdl_pos = cpstate->fdl_pos;
+    for (int32_t part = 0; part < part_count; ++part)
+    {
+        multiply_add_spectra(
+                acc,
+                fdl + (int64_t)fdl_pos * spectrum_size,
+                ir_spectra + (int64_t)part * spectrum_size,
+                spectrum_size);
+
+        fdl_pos = (fdl_pos > 0) ? (fdl_pos - 1) : (part_count - 1);
+    }
+
+    FFT_worker_irfft(&cpstate->fft_worker, acc, spectrum_size);
+
+    // The second half contains the valid part of the circular convolution
+    memcpy(cpstate->out_blocks[ch], acc + part_size, sizeof(float) * (size_t)part_size);
+
+    return;
+}
+
+
+enum
+{
+    PORT_IN_AUDIO_L = 0,
+    PORT_IN_AUDIO_R,
+    PORT_IN_COUNT
+};
+
+enum
+{
+    PORT_OUT_AUDIO_L = 0,
+    PORT_OUT_AUDIO_R,
+    PORT_OUT_COUNT
+};
+
+
+static void Conv_pstate_render_mixed(
+        Device_state* dstate,
+        Device_thread_state* proc_ts,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo)
+{
+    rassert(dstate != NULL);
+    rassert(proc_ts != NULL);
+    rassert(wbs != NULL);
+    rassert(buf_start <= buf_stop);
+    rassert(tempo > 0);
+
+    Conv_pstate* cpstate = (Conv_pstate*)dstate;
+
+    const Proc_conv* conv = (const Proc_conv*)dstate->device->dimpl;
+
+    float* in_data[2] = { NULL };
+    Proc_state_get_mixed_audio_in_buffers(
+            proc_ts, PORT_IN_AUDIO_L, PORT_IN_COUNT, in_data);
+
+    float* out_data[2] = { NULL };
+    Proc_state_get_mixed_audio_out_buffers(
+            proc_ts, PORT_OUT_AUDIO_L, PORT_OUT_COUNT, out_data);
+
+    if (cpstate->part_count == 0)
+    {
+        // No impulse response
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (out_data[ch] != NULL)
+            {
+                for (int32_t i = buf_start; i < buf_stop; ++i)
+                    out_data[ch][i] = 0;
+            }
+        }
+
+        return;
+    }
+
+    rassert(cpstate->part_size == conv->part_size);
+    rassert(cpstate->part_count == conv->part_count);
+
+    const int32_t part_size = cpstate->part_size;
+
+    int32_t i = buf_start;
+    while (i < buf_stop)
+    {
+        const int32_t block_pos = cpstate->block_pos;
+        const int32_t chunk_size = min(buf_stop - i, part_size - block_pos);
+
+        // Output the previous block while collecting the current input block
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if (out_data[ch] == NULL)
+                continue;
+
+            float* in_block_part = cpstate->in_blocks[ch] + part_size + block_pos;
+            if (in_data[ch] != NULL)
+                memcpy(in_block_part, in_data[ch] + i, sizeof(float) * (size_t)chunk_size);
+            else
+                memset(in_block_part, 0, sizeof(float) * (size_t)chunk_size);
+
+            memcpy(out_data[ch] + i,
+                    cpstate->out_blocks[ch] + block_pos,
+                    sizeof(float) * (size_t)chunk_size);
+        }
+
+        cpstate->block_pos += chunk_size;
+        i += chunk_size;
+
+        if (cpstate->block_pos == part_size)
+        {
+            cpstate->fdl_pos = (cpstate->fdl_pos + 1 < cpstate->part_count)
+                ? (cpstate->fdl_pos + 1) : 0;
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                if (out_data[ch] != NULL)
+                    Conv_pstate_process_block(
+                            cpstate, ch, Proc_conv_get_ir_spectra(conv, ch));
+            }
+
+            cpstate->block_pos = 0;
+        }
+    }
+
+    return;
+}
+
+
+Device_state* new_Conv_pstate(
+        const Device* device, int32_t audio_rate, int32_t audio_buffer_size)
+{
+    rassert(device != NULL);
+    rassert(audio_rate > 0);
+    rassert(audio_buffer_size >= 0);
+
+    Conv_pstate* cpstate = memory_alloc_item(Conv_pstate);
+    if (cpstate == NULL)
+        return NULL;
+
+    if (!Proc_state_init(&cpstate->parent, device, audio_rate, audio_buffer_size))
+    {
+        memory_free(cpstate);
+        return NULL;
+    }
+
+    cpstate->parent.destroy = del_Conv_pstate;
+    cpstate->parent.reset = Conv_pstate_reset;
+    cpstate->parent.render_mixed = Conv_pstate_render_mixed;
+    cpstate->parent.clear_history = Conv_pstate_clear_history;
+
+    cpstate->has_fft_worker = false;
+    cpstate->part_size = 0;
+    cpstate->part_count = 0;
+    cpstate->block_pos = 0;
+    cpstate->fdl_pos = 0;
+    cpstate->buffer = NULL;
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        cpstate->in_blocks[ch] = NULL;
+        cpstate->out_blocks[ch] = NULL;
+        cpstate->fdls[ch] = NULL;
+    }
+    cpstate->acc = NULL;
+
+    if (!Conv_pstate_resize(cpstate))
+    {
+        del_Device_state(&cpstate->parent.parent);
+        return NULL;
+    }
+
+    return &cpstate->parent.parent;
+}
+
+
+bool Conv_pstate_set_ir(Device_state* dstate, const Key_indices indices, const Sample* value)
+{
+    rassert(dstate != NULL);
+    ignore(indices);
+    ignore(value);
+
+    return Conv_pstate_resize((Conv_pstate*)dstate);
+}
+
+
+bool Conv_pstate_set_part_size(
+        Device_state* dstate, const Key_indices indices, int64_t value)
+{
+    rassert(dstate != NULL);
+    ignore(indices);
+    ignore(value);
+
+    return Conv_pstate_resize((Conv_pstate*)dstate);
+}
+
+
@@ -0,0 +1,39 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_CONV_STATE_H
+#define KQT_CONV_STATE_H
+
+
+#include <decl.h>
+#include <player/devices/Device_state.h>
+#include <player/devices/Proc_state.h>
+#include <string/key_pattern.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+Device_state* new_Conv_pstate(
+        const Device* device, int32_t audio_rate, int32_t audio_buffer_size);
+
+bool Conv_pstate_set_ir(Device_state* dstate, const Key_indices indices, const Sample* value);
+
+bool Conv_pstate_set_part_size(
+        Device_state* dstate, const Key_indices indices, int64_t value);
+
+
+#endif // KQT_CONV_STATE_H
+
+
@@ -30,6 +30,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 typedef struct Delay_pstate
@@ -37,10 +38,41 @@ typedef struct Delay_pstate
     Proc_state parent;
 
     Work_buffer* bufs[KQT_BUFFERS_MAX];
+    int32_t delay_max;
+    int32_t buf_mask;
     int32_t buf_pos;
 } Delay_pstate;
 
 
+static bool Delay_pstate_resize_history(Delay_pstate* dpstate, int32_t audio_rate)
+{
+    rassert(dpstate != NULL);
+    rassert(audio_rate > 0);
+
+    const Proc_delay* delay = (const Proc_delay*)dpstate->parent.parent.device->dimpl;
+
+    // The history is a power-of-two ring buffer so that positions can be masked
+    const int32_t delay_buf_size = (int32_t)(delay->max_delay * audio_rate + 1);
+    const int32_t history_size = (int32_t)ceil_p2(delay_buf_size);
+
+    for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
+    {
+        Work_buffer* buf = dpstate->bufs[i];
+
+        if (!Work_buffer_resize(buf, history_size))
+            return false;
+
+        Work_buffer_clear(buf, 0, Work_buffer_get_size(buf));
+    }
+
+    dpstate->delay_max = delay_buf_size - 1;
+    dpstate->buf_mask = history_size - 1;
+    dpstate->buf_pos = 0;
+
+    return true;
+}
+
+
 static void del_Delay_pstate(Device_state* dstate)
 {
     rassert(dstate != NULL);
@@ -67,25 +99,7 @@ static bool Delay_pstate_set_audio_rate(Device_state* dstate, int32_t audio_rate
     rassert(dstate != NULL);
     rassert(audio_rate > 0);
 
-    Delay_pstate* dpstate = (Delay_pstate*)dstate;
-
-    const Proc_delay* delay = (const Proc_delay*)dstate->device->dimpl;
-
-    const int32_t delay_buf_size = (int32_t)(delay->max_delay * audio_rate + 1);
-
-    for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
-    {
-        Work_buffer* buf = dpstate->bufs[i];
-
-        if (!Work_buffer_resize(buf, delay_buf_size))
-            return false;
-
-        Work_buffer_clear(buf, 0, Work_buffer_get_size(buf));
-    }
-
-    dpstate->buf_pos = 0;
-
-    return true;
+    return Delay_pstate_resize_history((Delay_pstate*)dstate, audio_rate);
 }
 
 
@@ -126,7 +140,160 @@ enum
 
 
 static const int DELAY_WORK_BUFFER_TOTAL_OFFSETS = WORK_BUFFER_IMPL_1;
-static const int DELAY_WORK_BUFFER_FIXED_DELAY = WORK_BUFFER_IMPL_2;
+static const int DELAY_WORK_BUFFER_SOURCE = WORK_BUFFER_IMPL_2;
+
+
+static void copy_from_history(
+        float* dest,
+        const float* history,
+        int32_t buf_mask,
+        int32_t history_pos,
+        int32_t count)
+{
+    rassert(dest != NULL);
+    rassert(history != NULL);
+    rassert(history_pos >= 0);
+    rassert(history_pos <= buf_mask);
+    rassert(count >= 0);
+    rassert(count <= buf_mask + 1);
+
+    const int32_t first_count = min(count, buf_mask + 1 - history_pos);
+    memcpy(dest, history + history_pos, sizeof(float) * (size_t)first_count);
+    memcpy(dest + first_count,
+            history,
+            sizeof(float) * (size_t)(count - first_count));
+
+    return;
+}
+
+
+static void Delay_pstate_apply_constant_delay(
+        const Delay_pstate* dpstate,
+        const float* history,
+        const float* in,
+        float* out,
+        float* source,
+        float delay_frames,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(dpstate != NULL);
+    rassert(history != NULL);
+    rassert(in != NULL);
+    rassert(out != NULL);
+    rassert(source != NULL);
+    rassert(delay_frames >= 0);
+    rassert(delay_frames <= dpstate->delay_max);
+    rassert(buf_start < buf_stop);
+
+    const int32_t frame_count = buf_stop - buf_start;
+
+    // Split the delay so that output frame i is interpolated between source
+    // frames i - whole_delay - 1 and i - whole_delay
+    const int32_t whole_delay = (int32_t)floor(delay_frames);
+    const double remainder = 1.0 - (delay_frames - (double)whole_delay);
+
+    // Gather the source signal into one contiguous area, starting from frame
+    // buf_start - whole_delay - 1
+    const int32_t source_count = frame_count + 1;
+    const int32_t history_count = min(whole_delay + 1, source_count);
+    const int32_t history_pos =
+        (dpstate->buf_pos - whole_delay - 1 + dpstate->buf_mask + 1) & dpstate->buf_mask;
+    copy_from_history(
+            source, history, dpstate->buf_mask, history_pos, history_count);
+    memcpy(source + history_count,
+            in + buf_start,
+            sizeof(float) * (size_t)(source_count - history_count));
+
+    if (remainder == 1.0)
+    {
+        memcpy(out + buf_start, source + 1, sizeof(float) * (size_t)frame_count);
+    }
+    else
+    {
+        const double prev_scale = 1 - remainder;
+        for (int32_t i = 0; i < frame_count; ++i)
+        {
+            const double val = (prev_scale * source[i]) + (remainder * source[i + 1]);
+            out[buf_start + i] = (float)val;
+        }
+    }
+
+    return;
+}
+
+
+static void Delay_pstate_apply_delays(
+        const Delay_pstate* dpstate,
+        const float* history,
+        const float* in,
+        float* out,
+        const float* total_offsets,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(dpstate != NULL);
+    rassert(history != NULL);
+    rassert(in != NULL);
+    rassert(out != NULL);
+    rassert(total_offsets != NULL);
+
+    const int32_t history_size = dpstate->buf_mask + 1;
+
+    for (int32_t i = buf_start; i < buf_stop; ++i)
+    {
+        const float total_offset = total_offsets[i];
+
+        // Get buffer positions
+        const int32_t cur_pos = (int32_t)floor(total_offset);
+        const double remainder = total_offset - (double)cur_pos;
+        rassert(cur_pos <= (int32_t)i);
+        rassert(implies(cur_pos == (int32_t)i, remainder == 0));
+        const int32_t next_pos = cur_pos + 1;
+
+        // Get audio frames
+        double cur_val = 0;
+        double next_val = 0;
+
+        if (cur_pos >= 0)
+        {
+            const int32_t in_cur_pos = buf_start + cur_pos;
+            rassert(in_cur_pos < (int32_t)buf_stop);
+            cur_val = in[in_cur_pos];
+
+            const int32_t in_next_pos = min(buf_start + next_pos, i);
+            rassert(in_next_pos < (int32_t)buf_stop);
+            next_val = in[in_next_pos];
+        }
+        else
+        {
+            const int32_t cur_delay_buf_pos =
+                (dpstate->buf_pos + cur_pos + history_size) & dpstate->buf_mask;
+            cur_val = history[cur_delay_buf_pos];
+
+            if (next_pos < 0)
+            {
+                const int32_t next_delay_buf_pos =
+                    (dpstate->buf_pos + next_pos + history_size) & dpstate->buf_mask;
+                next_val = history[next_delay_buf_pos];
+            }
+            else
+            {
+                rassert(next_pos == 0);
+                next_val = in[buf_start];
+            }
+        }
+
+        // Create output frame
+        const double prev_scale = 1 - remainder;
+        const double val =
+            (prev_scale * cur_val) + (remainder * next_val);
+
+        out[i] = (float)val;
+    }
+
+    return;
+}
 
 
 static void Delay_pstate_render_mixed(
@@ -143,6 +310,9 @@ static void Delay_pstate_render_mixed(
     rassert(buf_start <= buf_stop);
     rassert(tempo > 0);
 
+    if (buf_start >= buf_stop)
+        return;
+
     Delay_pstate* dpstate = (Delay_pstate*)dstate;
 
     const Proc_delay* delay = (const Proc_delay*)dstate->device->dimpl;
@@ -161,36 +331,46 @@ static void Delay_pstate_render_mixed(
         Work_buffer_get_contents_mut(dpstate->bufs[1]),
     };
 
-    const int32_t delay_buf_size = Work_buffer_get_size(dpstate->bufs[0]);
-    rassert(delay_buf_size == Work_buffer_get_size(dpstate->bufs[1]));
-    const int32_t delay_max = delay_buf_size - 1;
+    rassert(Work_buffer_get_size(dpstate->bufs[0]) == dpstate->buf_mask + 1);
+    rassert(Work_buffer_get_size(dpstate->bufs[1]) == dpstate->buf_mask + 1);
+    const int32_t delay_max = dpstate->delay_max;
 
-    float* total_offsets = Work_buffers_get_buffer_contents_mut(
-            wbs, DELAY_WORK_BUFFER_TOTAL_OFFSETS);
+    const int32_t audio_rate = dstate->audio_rate;
 
-    // Get delay stream
-    float* delays = Device_thread_state_get_mixed_buffer_contents_mut(
+    // Get delay stream, the delay is constant if the stream is missing or if
+    // it has a constant value in the whole area
+    const Work_buffer* delays_wb = Device_thread_state_get_mixed_buffer(
             proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_DELAY);
-    if (delays == NULL)
-    {
-        delays =
-            Work_buffers_get_buffer_contents_mut(wbs, DELAY_WORK_BUFFER_FIXED_DELAY);
-        const float init_delay = (float)delay->init_delay;
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-            delays[i] = init_delay;
-    }
+    const bool is_delay_constant = (delays_wb == NULL) ||
+        (Work_buffer_get_const_start(delays_wb) <= buf_start);
 
-    int32_t cur_dpstate_buf_pos = dpstate->buf_pos;
+    float* total_offsets = NULL;
+    float const_delay_frames = 0;
 
-    const int32_t audio_rate = dstate->audio_rate;
+    if (is_delay_constant)
+    {
+        const float cur_delay = (delays_wb != NULL)
+            ? Work_buffer_get_contents(delays_wb)[buf_start]
+            : (float)delay->init_delay;
+        const double delay_frames = clamp(cur_delay * (double)audio_rate, 0, delay_max);
 
-    // Get total offsets
-    for (int32_t i = buf_start, chunk_offset = 0; i < buf_stop; ++i, ++chunk_offset)
+        // Match the precision of the offsets used with varying delays
+        const_delay_frames = (float)delay_frames;
+    }
+    else
     {
-        const float cur_delay = delays[i];
-        double delay_frames = cur_delay * (double)audio_rate;
-        delay_frames = clamp(delay_frames, 0, delay_max);
-        total_offsets[i] = (float)(chunk_offset - delay_frames);
+        const float* delays = Work_buffer_get_contents(delays_wb);
+        total_offsets =
+            Work_buffers_get_buffer_contents_mut(wbs, DELAY_WORK_BUFFER_TOTAL_OFFSETS);
+
+        // Get total offsets
+        for (int32_t i = buf_start, chunk_offset = 0; i < buf_stop; ++i, ++chunk_offset)
+        {
+            const float cur_delay = delays[i];
+            double delay_frames = cur_delay * (double)audio_rate;
+            delay_frames = clamp(delay_frames, 0, delay_max);
+            total_offsets[i] = (float)(chunk_offset - delay_frames);
+        }
     }
 
     for (int ch = 0; ch < 2; ++ch)
@@ -208,65 +388,27 @@ static void Delay_pstate_render_mixed(
         const float* history = history_data[ch];
         rassert(history != NULL);
 
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-        {
-            const float total_offset = total_offsets[i];
-
-            // Get buffer positions
-            const int32_t cur_pos = (int32_t)floor(total_offset);
-            const double remainder = total_offset - (double)cur_pos;
-            rassert(cur_pos <= (int32_t)i);
-            rassert(implies(cur_pos == (int32_t)i, remainder == 0));
-            const int32_t next_pos = cur_pos + 1;
-
-            // Get audio frames
-            double cur_val = 0;
-            double next_val = 0;
-
-            if (cur_pos >= 0)
-            {
-                const int32_t in_cur_pos = buf_start + cur_pos;
-                rassert(in_cur_pos < (int32_t)buf_stop);
-                cur_val = in[in_cur_pos];
-
-                const int32_t in_next_pos = min(buf_start + next_pos, i);
-                rassert(in_next_pos < (int32_t)buf_stop);
-                next_val = in[in_next_pos];
-            }
-            else
-            {
-                const int32_t cur_delay_buf_pos =
-                    (cur_dpstate_buf_pos + cur_pos + delay_buf_size) % delay_buf_size;
-                rassert(cur_delay_buf_pos >= 0);
-
-                cur_val = history[cur_delay_buf_pos];
-
-                if (next_pos < 0)
-                {
-                    const int32_t next_delay_buf_pos =
-                        (cur_dpstate_buf_pos + next_pos + delay_buf_size) %
-                        delay_buf_size;
-                    rassert(next_delay_buf_pos >= 0);
-
-                    next_val = history[next_delay_buf_pos];
-                }
-                else
-                {
-                    rassert(next_pos == 0);
-                    next_val = in[buf_start];
-                }
-            }
-
-            // Create output frame
-            const double prev_scale = 1 - remainder;
-            const double val =
-                (prev_scale * cur_val) + (remainder * next_val);
-
-            out[i] = (float)val;
-        }
+        if (is_delay_constant)
+            Delay_pstate_apply_constant_delay(
+                    dpstate,
+                    history,
+                    in,
+                    out,
+                    Work_buffers_get_buffer_contents_mut(wbs, DELAY_WORK_BUFFER_SOURCE),
+                    const_delay_frames,
+                    buf_start,
+                    buf_stop);
+        else
+            Delay_pstate_apply_delays(
+                    dpstate, history, in, out, total_offsets, buf_start, buf_stop);
     }
 
     // Update the delay state buffers
+    const int32_t frame_count = buf_stop - buf_start;
+    const int32_t history_size = dpstate->buf_mask + 1;
+    const int32_t write_count = min(frame_count, history_size);
+    const int32_t write_pos = (dpstate->buf_pos + frame_count - write_count) & dpstate->buf_mask;
+
     for (int ch = 0; ch < 2; ++ch)
     {
         const float* in = in_data[ch];
@@ -276,22 +418,16 @@ static void Delay_pstate_render_mixed(
         float* history = history_data[ch];
         rassert(history != NULL);
 
-        cur_dpstate_buf_pos = dpstate->buf_pos;
-
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-        {
-            history[cur_dpstate_buf_pos] = in[i];
-
-            ++cur_dpstate_buf_pos;
-            if (cur_dpstate_buf_pos >= delay_buf_size)
-            {
-                rassert(cur_dpstate_buf_pos == delay_buf_size);
-                cur_dpstate_buf_pos = 0;
-            }
-        }
+        // Only the most recent frames fit in the history
+        const float* write_in = in + buf_stop - write_count;
+        const int32_t first_count = min(write_count, history_size - write_pos);
+        memcpy(history + write_pos, write_in, sizeof(float) * (size_t)first_count);
+        memcpy(history,
+                write_in + first_count,
+                sizeof(float) * (size_t)(write_count - first_count));
     }
 
-    dpstate->buf_pos = cur_dpstate_buf_pos;
+    dpstate->buf_pos = (dpstate->buf_pos + frame_count) & dpstate->buf_mask;
 
     return;
 }
@@ -337,18 +473,16 @@ Device_state* new_Delay_pstate(
     dpstate->parent.reset = Delay_pstate_reset;
     dpstate->parent.render_mixed = Delay_pstate_render_mixed;
     dpstate->parent.clear_history = Delay_pstate_clear_history;
+    dpstate->delay_max = 0;
+    dpstate->buf_mask = 0;
     dpstate->buf_pos = 0;
 
     for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
         dpstate->bufs[i] = NULL;
 
-    const Proc_delay* delay = (const Proc_delay*)device->dimpl;
-
-    const int32_t delay_buf_size = (int32_t)(delay->max_delay * audio_rate + 1);
-
     for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
     {
-        dpstate->bufs[i] = new_Work_buffer_unbounded(delay_buf_size);
+        dpstate->bufs[i] = new_Work_buffer_unbounded(1);
         if (dpstate->bufs[i] == NULL)
         {
             del_Device_state(&dpstate->parent.parent);
@@ -356,6 +490,12 @@ Device_state* new_Delay_pstate(
         }
     }
 
+    if (!Delay_pstate_resize_history(dpstate, audio_rate))
+    {
+        del_Device_state(&dpstate->parent.parent);
+        return NULL;
+    }
+
     return &dpstate->parent.parent;
 }
 
@@ -367,25 +507,7 @@ bool Delay_pstate_set_max_delay(
     ignore(indices);
     ignore(value);
 
-    Delay_pstate* dpstate = (Delay_pstate*)dstate;
-
-    const Proc_delay* delay = (const Proc_delay*)dstate->device->dimpl;
-
-    const int32_t delay_buf_size = (int32_t)(delay->max_delay * dstate->audio_rate + 1);
-
-    for (int i = 0; i < KQT_BUFFERS_MAX; ++i)
-    {
-        Work_buffer* buf = dpstate->bufs[i];
-
-        if (!Work_buffer_resize(buf, delay_buf_size))
-            return false;
-
-        Work_buffer_clear(buf, 0, Work_buffer_get_size(buf));
-    }
-
-    dpstate->buf_pos = 0;
-
-    return true;
+    return Delay_pstate_resize_history((Delay_pstate*)dstate, dstate->audio_rate);
 }
 
 
@@ -368,8 +368,16 @@ int32_t Envgen_vstate_render_voice(
 
                 const int32_t fast_stop = min(const_start, slice_stop);
 
-                for (int32_t i = slice_start; i < fast_stop; ++i)
-                    out_buffer[i] = (float)fast_scale_to_dB(out_buffer[i]) + add;
+                if (slice_start < fast_stop)
+                {
+                    fast_scale_to_dB_array(
+                            out_buffer + slice_start,
+                            out_buffer + slice_start,
+                            fast_stop - slice_start);
+
+                    for (int32_t i = slice_start; i < fast_stop; ++i)
+                        out_buffer[i] += add;
+                }
 
                 if (fast_stop < slice_stop)
                 {
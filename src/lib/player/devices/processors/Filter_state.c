@@ -22,419 +22,514 @@
 #include <memory.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/devices/Proc_state.h>
-#include <player/devices/processors/Filter.h>
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/devices/Voice_state.h>
 #include <player/Work_buffers.h>
 
 #include <math.h>
+#include <stdbool.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 
-#define FILTER_ORDER 2
+/*
+ * The filters are trapezoidal state variable filters. They have the same
+ * frequency response as the bilinear two-pole filters we used to create with
+ * two_pole_filter_create, but their coefficients can be changed at every
+ * sample without crossfading between two filter instances.
+ *
+ * The coefficients are looked up from tables indexed by the cutoff and
+ * resonance parameters so that modulated filters do not need to evaluate
+ * transcendental functions.
+ */
 
 
-typedef struct Single_filter_state
+#define CUTOFF_INF_LIMIT 100.0
+#define CUTOFF_MIN (-100.0)
+#define CUTOFF_BIAS 81.37631656229591
+#define CUTOFF_TABLE_STEPS_PER_UNIT 8
+#define CUTOFF_TABLE_SIZE (200 * CUTOFF_TABLE_STEPS_PER_UNIT + 1)
+
+#define RESONANCE_MIN 0.0
+#define RESONANCE_MAX 100.0
+#define RESONANCE_TABLE_STEPS_PER_UNIT 4
+#define RESONANCE_TABLE_SIZE (100 * RESONANCE_TABLE_STEPS_PER_UNIT + 1)
+
+// The prewarped gain grows without bound near the Nyquist frequency
+#define CUTOFF_NORM_MAX 0.49
+
+
+typedef struct Filter_tables
 {
-    Filter_type type;
-    double coeffs[FILTER_ORDER];
-    double mul;
-    double history1[KQT_BUFFERS_MAX][FILTER_ORDER];
-    double history2[KQT_BUFFERS_MAX][FILTER_ORDER];
-} Single_filter_state;
+    double bypass_cutoff;
+    double gains[CUTOFF_TABLE_SIZE];
+    double dampings[RESONANCE_TABLE_SIZE];
+} Filter_tables;
 
 
-typedef struct Filter_state_impl
+static double get_cutoff_freq(double param)
 {
-    bool anything_rendered;
+    rassert(!isnan(param));
 
-    Filter_type applied_type;
-    double applied_cutoff;
-    double applied_resonance;
-    double true_cutoff;
-    double true_resonance;
-    double filter_xfade_pos;
-    double filter_xfade_update;
-    int filter_xfade_state_used;
-    int filter_state_used;
-    Single_filter_state sf_state[2];
+    if (param >= CUTOFF_INF_LIMIT)
+        return INFINITY;
 
-    Filter_type type;
-    double def_cutoff;
-    double def_resonance;
-} Filter_state_impl;
+    param = max(CUTOFF_MIN, param);
+    return exp2((param + CUTOFF_BIAS) / 12.0);
+}
 
 
-static void Filter_state_impl_init(Filter_state_impl* fimpl, const Proc_filter* filter)
+static double get_resonance(double param)
 {
-    rassert(fimpl != NULL);
-    rassert(filter != NULL);
+    const double clamped_res = clamp(param, RESONANCE_MIN, RESONANCE_MAX);
+    const double resonance = pow(1.055, clamped_res) * 0.5;
+    return resonance;
+}
 
-    fimpl->anything_rendered = false;
 
-    fimpl->applied_type = filter->type;
-    fimpl->applied_cutoff = FILTER_DEFAULT_CUTOFF;
-    fimpl->applied_resonance = FILTER_DEFAULT_RESONANCE;
-    fimpl->true_cutoff = INFINITY;
-    fimpl->true_resonance = 0.5;
-    fimpl->filter_state_used = -1;
-    fimpl->filter_xfade_state_used = -1;
-    fimpl->filter_xfade_pos = 1;
-    fimpl->filter_xfade_update = 0;
+static void Filter_tables_init(Filter_tables* tables, int32_t audio_rate)
+{
+    rassert(tables != NULL);
+    rassert(audio_rate > 0);
 
-    // Hack: Make sure that interesting highpass cutoff values are applied
-    if (filter->type == FILTER_TYPE_HIGHPASS)
-        fimpl->applied_cutoff = -100.0;
+    const double nyquist = (double)audio_rate * 0.5;
 
-    for (int si = 0; si < 2; ++si)
-    {
-        fimpl->sf_state[si].type = filter->type;
-        fimpl->sf_state[si].mul = 0;
+    // Lowpass filters are bypassed at and above the Nyquist frequency
+    tables->bypass_cutoff = min(
+            CUTOFF_INF_LIMIT, 12.0 * log2(nyquist) - CUTOFF_BIAS);
 
-        for (int i = 0; i < FILTER_ORDER; ++i)
-        {
-            fimpl->sf_state[si].coeffs[i] = 0;
-
-            for (int ch = 0; ch < KQT_BUFFERS_MAX; ++ch)
-            {
-                fimpl->sf_state[si].history1[ch][i] = 0;
-                fimpl->sf_state[si].history2[ch][i] = 0;
-            }
-        }
+    for (int i = 0; i < CUTOFF_TABLE_SIZE; ++i)
+    {
+        const double param = CUTOFF_MIN + (double)i / CUTOFF_TABLE_STEPS_PER_UNIT;
+        const double true_cutoff = max(get_cutoff_freq(param), 1);
+        const double cutoff_norm = min(true_cutoff / audio_rate, CUTOFF_NORM_MAX);
+        tables->gains[i] = tan(PI * cutoff_norm);
     }
 
-    fimpl->type = filter->type;
-    fimpl->def_cutoff = filter->cutoff;
-    fimpl->def_resonance = filter->resonance;
+    for (int i = 0; i < RESONANCE_TABLE_SIZE; ++i)
+    {
+        const double param = RESONANCE_MIN + (double)i / RESONANCE_TABLE_STEPS_PER_UNIT;
+        tables->dampings[i] = 1.0 / get_resonance(param);
+    }
 
     return;
 }
 
 
-static const int CONTROL_WB_CUTOFF = WORK_BUFFER_IMPL_1;
-static const int CONTROL_WB_RESONANCE = WORK_BUFFER_IMPL_2;
+static double lookup(const double* table, int size, double pos)
+{
+    rassert(table != NULL);
+    rassert(size >= 2);
+    dassert(pos >= 0);
+    dassert(pos <= size - 1);
+
+    const int index = min((int)pos, size - 2);
+    const double remainder = pos - index;
+    return table[index] + (table[index + 1] - table[index]) * remainder;
+}
 
 
-static void Filter_state_impl_apply_filter_settings(
-        Filter_state_impl* fimpl,
-        Work_buffer* in_buffers[2],
-        Work_buffer* out_buffers[2],
-        double xfade_start,
-        double xfade_step,
-        int32_t buf_start,
-        int32_t buf_stop)
+static double Filter_tables_get_gain(const Filter_tables* tables, double cutoff)
 {
-    rassert(fimpl != NULL);
-    rassert(in_buffers != NULL);
-    rassert(out_buffers != NULL);
+    rassert(tables != NULL);
+    dassert(!isnan(cutoff));
 
-    if ((fimpl->filter_state_used == -1) && (fimpl->filter_xfade_state_used == -1))
-    {
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            if ((in_buffers[ch] != NULL) && (out_buffers[ch] != NULL))
-                Work_buffer_copy(out_buffers[ch], in_buffers[ch], buf_start, buf_stop);
-        }
-        return;
-    }
+    const double pos =
+        (clamp(cutoff, CUTOFF_MIN, CUTOFF_INF_LIMIT) - CUTOFF_MIN) *
+        CUTOFF_TABLE_STEPS_PER_UNIT;
+    return lookup(tables->gains, CUTOFF_TABLE_SIZE, pos);
+}
 
-    rassert(fimpl->filter_state_used != fimpl->filter_xfade_state_used);
 
-    // Get filter states used
-    Single_filter_state* in_fst = (fimpl->filter_state_used > -1) ?
-        &fimpl->sf_state[fimpl->filter_state_used] : NULL;
-    Single_filter_state* out_fst = (fimpl->filter_xfade_state_used > -1) ?
-        &fimpl->sf_state[fimpl->filter_xfade_state_used] : NULL;
+static double Filter_tables_get_damping(const Filter_tables* tables, double resonance)
+{
+    rassert(tables != NULL);
+    dassert(!isnan(resonance));
 
-    const double xfade_start_clamped = min(xfade_start, 1);
+    const double pos =
+        (clamp(resonance, RESONANCE_MIN, RESONANCE_MAX) - RESONANCE_MIN) *
+        RESONANCE_TABLE_STEPS_PER_UNIT;
+    return lookup(tables->dampings, RESONANCE_TABLE_SIZE, pos);
+}
 
-    for (int32_t ch = 0; ch < 2; ++ch)
-    {
-        double xfade = xfade_start_clamped;
 
-        if ((in_buffers[ch] == NULL) || (out_buffers[ch] == NULL))
-            continue;
+typedef struct Filter_coeffs
+{
+    bool bypass;
+    double a1;
+    double a2;
+    double a3;
 
-        const float* in_buf = Work_buffer_get_contents(in_buffers[ch]);
-        float* out_buf = Work_buffer_get_contents_mut(out_buffers[ch]);
+    // Output mix of the input, bandpass and lowpass signals
+    double m0;
+    double m1;
+    double m2;
+} Filter_coeffs;
 
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-        {
-            const float input = in_buf[i];
-            double result = input;
 
-            // Apply primary filter
-            if (in_fst != NULL)
-            {
-                if (in_fst->type == FILTER_TYPE_LOWPASS)
-                    result = nq_zero_filter(
-                            FILTER_ORDER, in_fst->history1[ch], input);
-                else
-                    result = dc_zero_filter(
-                            FILTER_ORDER, in_fst->history1[ch], input);
-
-                result = iir_filter_strict_cascade_even_order(
-                        FILTER_ORDER, in_fst->coeffs, in_fst->history2[ch], result);
-                result *= in_fst->mul;
-            }
+static void Filter_coeffs_init(
+        Filter_coeffs* coeffs, Filter_type type, double gain, double damping)
+{
+    rassert(coeffs != NULL);
+    dassert(gain > 0);
 
-            // Apply secondary filter with crossfade
-            if (xfade < 1)
-            {
-                result *= xfade;
-
-                double fade_result = input;
-
-                if (out_fst != NULL)
-                {
-                    if (out_fst->type == FILTER_TYPE_LOWPASS)
-                        fade_result = nq_zero_filter(
-                                FILTER_ORDER, out_fst->history1[ch], input);
-                    else
-                        fade_result = dc_zero_filter(
-                                FILTER_ORDER, out_fst->history1[ch], input);
-
-                    fade_result = iir_filter_strict_cascade_even_order(
-                            FILTER_ORDER,
-                            out_fst->coeffs,
-                            out_fst->history2[ch],
-                            fade_result);
-                    fade_result *= out_fst->mul;
-                }
-
-                result += fade_result * (1 - xfade);
-
-                xfade += xfade_step;
-            }
+    coeffs->bypass = false;
+    coeffs->a1 = 1.0 / (1.0 + gain * (gain + damping));
+    coeffs->a2 = gain * coeffs->a1;
+    coeffs->a3 = gain * coeffs->a2;
 
-            out_buf[i] = (float)result;
-        }
+    if (type == FILTER_TYPE_LOWPASS)
+    {
+        coeffs->m0 = 0;
+        coeffs->m1 = 0;
+        coeffs->m2 = 1;
+    }
+    else
+    {
+        coeffs->m0 = 1;
+        coeffs->m1 = -damping;
+        coeffs->m2 = -1;
     }
 
     return;
 }
 
 
-#define CUTOFF_INF_LIMIT 100.0
-#define CUTOFF_BIAS 81.37631656229591
-
-
-static double get_cutoff_freq(double param)
+static void Filter_coeffs_init_from_params(
+        Filter_coeffs* coeffs,
+        const Filter_tables* tables,
+        Filter_type type,
+        double cutoff,
+        double resonance)
 {
-    rassert(!isnan(param));
+    rassert(coeffs != NULL);
+    rassert(tables != NULL);
 
-    if (param >= CUTOFF_INF_LIMIT)
-        return INFINITY;
+    if ((type == FILTER_TYPE_LOWPASS) && (cutoff >= tables->bypass_cutoff))
+    {
+        coeffs->bypass = true;
+        return;
+    }
 
-    param = max(-100, param);
-    return exp2((param + CUTOFF_BIAS) / 12.0);
+    Filter_coeffs_init(
+            coeffs,
+            type,
+            Filter_tables_get_gain(tables, cutoff),
+            Filter_tables_get_damping(tables, resonance));
+
+    return;
 }
 
 
-static double get_resonance(double param)
+typedef struct Filter_state_impl
 {
-    const double clamped_res = clamp(param, 0, 100);
-    const double resonance = pow(1.055, clamped_res) * 0.5;
-    return resonance;
-}
-
+    Filter_type type;
+    double def_cutoff;
+    double def_resonance;
 
-#define FILTER_XFADE_SPEED_MIN 40.0
-#define FILTER_XFADE_SPEED_MAX 200.0
+    double int1[KQT_BUFFERS_MAX];
+    double int2[KQT_BUFFERS_MAX];
+} Filter_state_impl;
 
 
-static double get_xfade_step(double audio_rate, double true_cutoff, double resonance)
+static void Filter_state_impl_init(Filter_state_impl* fimpl, const Proc_filter* filter)
 {
-    rassert(audio_rate > 0);
-
-    if (true_cutoff >= audio_rate * 0.5)
-        return FILTER_XFADE_SPEED_MAX / audio_rate;
+    rassert(fimpl != NULL);
+    rassert(filter != NULL);
 
-    const double xfade_range = FILTER_XFADE_SPEED_MAX - FILTER_XFADE_SPEED_MIN;
+    fimpl->type = filter->type;
+    fimpl->def_cutoff = filter->cutoff;
+    fimpl->def_resonance = filter->resonance;
 
-    const double clamped_res = clamp(resonance, 0, 100);
-    const double xfade_norm = clamped_res / 100;
-    const double xfade_speed = FILTER_XFADE_SPEED_MAX - xfade_norm * xfade_range;
+    for (int ch = 0; ch < KQT_BUFFERS_MAX; ++ch)
+    {
+        fimpl->int1[ch] = 0;
+        fimpl->int2[ch] = 0;
+    }
 
-    return xfade_speed / audio_rate;
+    return;
 }
 
 
-static void Filter_state_impl_apply_input_buffers(
-        Filter_state_impl* fimpl,
+static bool Filter_state_impl_get_constant_params(
+        const Filter_state_impl* fimpl,
         const float* cutoff_buf,
         const float* resonance_buf,
-        const Work_buffers* wbs,
-        Work_buffer* in_buffers[2],
-        Work_buffer* out_buffers[2],
         int32_t buf_start,
         int32_t buf_stop,
-        int32_t audio_rate)
+        double* cutoff,
+        double* resonance)
 {
     rassert(fimpl != NULL);
-    rassert(wbs != NULL);
-    rassert(in_buffers != NULL);
-    rassert(out_buffers != NULL);
-    rassert(audio_rate > 0);
+    rassert(cutoff != NULL);
+    rassert(resonance != NULL);
+
+    *cutoff = fimpl->def_cutoff;
+    *resonance = fimpl->def_resonance;
 
-    float* cutoffs = Work_buffers_get_buffer_contents_mut(wbs, CONTROL_WB_CUTOFF);
+    if (buf_start >= buf_stop)
+        return true;
 
     if (cutoff_buf != NULL)
     {
-        // Get cutoff values from input
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-            cutoffs[i] = cutoff_buf[i];
-    }
-    else
-    {
-        // Get our default cutoff
-        const float def_cutoff = (float)fimpl->def_cutoff;
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-            cutoffs[i] = def_cutoff;
-    }
+        const float first = cutoff_buf[buf_start];
+        for (int32_t i = buf_start + 1; i < buf_stop; ++i)
+        {
+            if (cutoff_buf[i] != first)
+                return false;
+        }
 
-    float* resonances = Work_buffers_get_buffer_contents_mut(wbs, CONTROL_WB_RESONANCE);
+        *cutoff = first;
+    }
 
     if (resonance_buf != NULL)
     {
-        // Get resonance values from input
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-            resonances[i] = resonance_buf[i];
+        const float first = resonance_buf[buf_start];
+        for (int32_t i = buf_start + 1; i < buf_stop; ++i)
+        {
+            if (resonance_buf[i] != first)
+                return false;
+        }
+
+        *resonance = first;
     }
-    else
+
+    return true;
+}
+
+
+static void apply_bypass(
+        double* int1,
+        double* int2,
+        const float* in_buf,
+        float* out_buf,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(int1 != NULL);
+    rassert(int2 != NULL);
+    rassert(in_buf != NULL);
+    rassert(out_buf != NULL);
+
+    if (buf_start >= buf_stop)
+        return;
+
+    if (out_buf != in_buf)
+        memcpy(out_buf + buf_start,
+                in_buf + buf_start,
+                sizeof(float) * (size_t)(buf_stop - buf_start));
+
+    // Keep the filter settled to the input so that it can be enabled smoothly
+    *int1 = 0;
+    *int2 = in_buf[buf_stop - 1];
+
+    return;
+}
+
+
+static void apply_constant_filter(
+        const Filter_coeffs* coeffs,
+        double* int1,
+        double* int2,
+        const float* in_buf,
+        float* out_buf,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(coeffs != NULL);
+    rassert(!coeffs->bypass);
+    rassert(int1 != NULL);
+    rassert(int2 != NULL);
+    rassert(in_buf != NULL);
+    rassert(out_buf != NULL);
+
+    const double a1 = coeffs->a1;
+    const double a2 = coeffs->a2;
+    const double a3 = coeffs->a3;
+    const double m0 = coeffs->m0;
+    const double m1 = coeffs->m1;
+    const double m2 = coeffs->m2;
+
+    double s1 = *int1;
+    double s2 = *int2;
+
+    for (int32_t i = buf_start; i < buf_stop; ++i)
     {
-        // Get our default resonance
-        const float def_resonance = (float)fimpl->def_resonance;
-        for (int32_t i = buf_start; i < buf_stop; ++i)
-            resonances[i] = def_resonance;
+        const double v0 = in_buf[i];
+        const double v3 = v0 - s2;
+        const double v1 = a1 * s1 + a2 * v3;
+        const double v2 = s2 + a2 * s1 + a3 * v3;
+        s1 = 2 * v1 - s1;
+        s2 = 2 * v2 - s2;
+
+        out_buf[i] = (float)(m0 * v0 + m1 * v1 + m2 * v2);
     }
 
-    const double max_true_cutoff_change = 0.01;
-    const double max_resonance_change = 0.01;
+    *int1 = s1;
+    *int2 = s2;
 
-    fimpl->filter_xfade_update = get_xfade_step(
-            audio_rate, fimpl->true_cutoff, fimpl->applied_resonance);
+    return;
+}
 
-    const double nyquist = (double)audio_rate * 0.5;
 
-    int32_t apply_filter_start = buf_start;
-    int32_t apply_filter_stop = buf_stop;
-    double xfade_start = fimpl->filter_xfade_pos;
+static void apply_modulated_filter(
+        Filter_type type,
+        double* int1,
+        double* int2,
+        const float* gains,
+        const float* dampings,
+        const float* in_buf,
+        float* out_buf,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(int1 != NULL);
+    rassert(int2 != NULL);
+    rassert(gains != NULL);
+    rassert(dampings != NULL);
+    rassert(in_buf != NULL);
+    rassert(out_buf != NULL);
+
+    const double m0 = (type == FILTER_TYPE_LOWPASS) ? 0 : 1;
+    const double m2 = (type == FILTER_TYPE_LOWPASS) ? 1 : -1;
+
+    double s1 = *int1;
+    double s2 = *int2;
 
     for (int32_t i = buf_start; i < buf_stop; ++i)
     {
-        float cutoff = cutoffs[i];
-        const float resonance = resonances[i];
+        const double v0 = in_buf[i];
 
-        // TODO: apply force->filter envelope if applicable
-        /*
-        if (proc->au_params->env_force_filter_enabled &&
-                fimpl->filter_xfade_pos >= 1)
+        const double gain = gains[i];
+        if (gain <= 0)
         {
-            double force = Cond_work_buffer_get_value(actual_forces, i);
-            if (force > 1)
-                force = 1;
-
-            double factor = Envelope_get_value(proc->au_params->env_force_filter, force);
-            rassert(isfinite(factor));
-            cutoff += (factor * 100) - 100;
+            // Bypassed lowpass filter
+            s1 = 0;
+            s2 = v0;
+            out_buf[i] = (float)v0;
+            continue;
         }
-        // */
-
-        // Initialise new filter settings if needed
-        if (fimpl->filter_xfade_pos >= 1 &&
-                ((fimpl->applied_type != fimpl->type) ||
-                 (fabs(cutoff - fimpl->applied_cutoff) >
-                    max_true_cutoff_change) ||
-                 (fabs(resonance - fimpl->applied_resonance) >
-                    max_resonance_change)))
-        {
-            // Apply previous filter settings to the signal
-            apply_filter_stop = i;
-            Filter_state_impl_apply_filter_settings(
-                    fimpl,
-                    in_buffers,
-                    out_buffers,
-                    xfade_start,
-                    fimpl->filter_xfade_update,
-                    apply_filter_start,
-                    apply_filter_stop);
-
-            // Set up new range for next filter processing
-            apply_filter_start = i;
-            apply_filter_stop = buf_stop;
-
-            fimpl->filter_xfade_state_used = fimpl->filter_state_used;
-
-            // Only apply crossfade if we have rendered audio
-            if (fimpl->anything_rendered)
-                fimpl->filter_xfade_pos = 0;
-            else
-                fimpl->filter_xfade_pos = 1;
 
-            fimpl->applied_type = fimpl->type;
+        const double damping = dampings[i];
+        const double a1 = 1.0 / (1.0 + gain * (gain + damping));
+        const double a2 = gain * a1;
+        const double a3 = gain * a2;
+        const double m1 = (type == FILTER_TYPE_LOWPASS) ? 0 : -damping;
+
+        const double v3 = v0 - s2;
+        const double v1 = a1 * s1 + a2 * v3;
+        const double v2 = s2 + a2 * s1 + a3 * v3;
+        s1 = 2 * v1 - s1;
+        s2 = 2 * v2 - s2;
 
-            fimpl->applied_cutoff = cutoff;
-            fimpl->true_cutoff = get_cutoff_freq(fimpl->applied_cutoff);
-            if (fimpl->applied_type == FILTER_TYPE_HIGHPASS)
-                fimpl->true_cutoff = min(fimpl->true_cutoff, nyquist - 1.0);
+        out_buf[i] = (float)(m0 * v0 + m1 * v1 + m2 * v2);
+    }
 
-            fimpl->applied_resonance = resonance;
-            fimpl->true_resonance = get_resonance(fimpl->applied_resonance);
+    *int1 = s1;
+    *int2 = s2;
 
-            fimpl->filter_xfade_update = get_xfade_step(
-                    audio_rate, fimpl->true_cutoff, fimpl->applied_resonance);
+    return;
+}
 
-            if (fimpl->true_cutoff < nyquist)
-            {
-                const int new_state = 1 - abs(fimpl->filter_state_used);
-                const double true_cutoff = max(fimpl->true_cutoff, 1);
-                const int bandform =
-                    (fimpl->applied_type == FILTER_TYPE_HIGHPASS) ? 1 : 0;
-                fimpl->sf_state[new_state].type = fimpl->applied_type;
-                two_pole_filter_create(
-                        true_cutoff / audio_rate,
-                        fimpl->true_resonance,
-                        bandform,
-                        fimpl->sf_state[new_state].coeffs,
-                        &fimpl->sf_state[new_state].mul);
-                for (int a = 0; a < KQT_BUFFERS_MAX; ++a)
-                {
-                    for (int k = 0; k < FILTER_ORDER; ++k)
-                    {
-                        fimpl->sf_state[new_state].history1[a][k] = 0;
-                        fimpl->sf_state[new_state].history2[a][k] = 0;
-                    }
-                }
-                fimpl->filter_state_used = new_state;
-                //fprintf(stderr, "created filter with cutoff %f\n", cutoff);
-            }
-            else
-            {
-                if (fimpl->filter_state_used == -1)
-                    fimpl->filter_xfade_pos = 1;
 
-                fimpl->filter_state_used = -1;
-            }
+static const int CONTROL_WB_CUTOFF = WORK_BUFFER_IMPL_1;
+static const int CONTROL_WB_RESONANCE = WORK_BUFFER_IMPL_2;
+
 
-            xfade_start = fimpl->filter_xfade_pos;
+static void Filter_state_impl_apply_input_buffers(
+        Filter_state_impl* fimpl,
+        const Filter_tables* tables,
+        const float* cutoff_buf,
+        const float* resonance_buf,
+        const Work_buffers* wbs,
+        Work_buffer* in_buffers[2],
+        Work_buffer* out_buffers[2],
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(fimpl != NULL);
+    rassert(tables != NULL);
+    rassert(wbs != NULL);
+    rassert(in_buffers != NULL);
+    rassert(out_buffers != NULL);
+
+    double cutoff = fimpl->def_cutoff;
+    double resonance = fimpl->def_resonance;
+    if (Filter_state_impl_get_constant_params(
+                fimpl, cutoff_buf, resonance_buf, buf_start, buf_stop, &cutoff, &resonance))
+    {
+        Filter_coeffs* coeffs = &(Filter_coeffs){ .bypass = false };
+        Filter_coeffs_init_from_params(coeffs, tables, fimpl->type, cutoff, resonance);
+
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            if ((in_buffers[ch] == NULL) || (out_buffers[ch] == NULL))
+                continue;
+
+            const float* in_buf = Work_buffer_get_contents(in_buffers[ch]);
+            float* out_buf = Work_buffer_get_contents_mut(out_buffers[ch]);
+
+            if (coeffs->bypass)
+                apply_bypass(
+                        &fimpl->int1[ch],
+                        &fimpl->int2[ch],
+                        in_buf,
+                        out_buf,
+                        buf_start,
+                        buf_stop);
+            else
+                apply_constant_filter(
+                        coeffs,
+                        &fimpl->int1[ch],
+                        &fimpl->int2[ch],
+                        in_buf,
+                        out_buf,
+                        buf_start,
+                        buf_stop);
         }
 
-        fimpl->anything_rendered = true;
+        return;
+    }
 
-        fimpl->filter_xfade_pos += fimpl->filter_xfade_update;
+    // Get filter coefficients, non-positive gains mark bypassed lowpass filtering
+    float* gains = Work_buffers_get_buffer_contents_mut(wbs, CONTROL_WB_CUTOFF);
+    float* dampings = Work_buffers_get_buffer_contents_mut(wbs, CONTROL_WB_RESONANCE);
+
+    const bool can_bypass = (fimpl->type == FILTER_TYPE_LOWPASS);
+    const float def_cutoff = (float)fimpl->def_cutoff;
+    const float def_resonance = (float)fimpl->def_resonance;
+
+    for (int32_t i = buf_start; i < buf_stop; ++i)
+    {
+        const float cur_cutoff = (cutoff_buf != NULL) ? cutoff_buf[i] : def_cutoff;
+        const float cur_resonance =
+            (resonance_buf != NULL) ? resonance_buf[i] : def_resonance;
+
+        if (can_bypass && (cur_cutoff >= tables->bypass_cutoff))
+            gains[i] = 0;
+        else
+            gains[i] = (float)Filter_tables_get_gain(tables, cur_cutoff);
+
+        dampings[i] = (float)Filter_tables_get_damping(tables, cur_resonance);
     }
 
-    // Apply previous filter settings to the remaining signal
-    Filter_state_impl_apply_filter_settings(
-            fimpl,
-            in_buffers,
-            out_buffers,
-            xfade_start,
-            fimpl->filter_xfade_update,
-            apply_filter_start,
-            apply_filter_stop);
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        if ((in_buffers[ch] == NULL) || (out_buffers[ch] == NULL))
+            continue;
+
+        apply_modulated_filter(
+                fimpl->type,
+                &fimpl->int1[ch],
+                &fimpl->int2[ch],
+                gains,
+                dampings,
+                Work_buffer_get_contents(in_buffers[ch]),
+                Work_buffer_get_contents_mut(out_buffers[ch]),
+                buf_start,
+                buf_stop);
+    }
 
     return;
 }
@@ -445,9 +540,22 @@ typedef struct Filter_pstate
     Proc_state parent;
 
     Filter_state_impl state_impl;
+    Filter_tables tables;
 } Filter_pstate;
 
 
+static bool Filter_pstate_set_audio_rate(Device_state* dstate, int32_t audio_rate)
+{
+    rassert(dstate != NULL);
+    rassert(audio_rate > 0);
+
+    Filter_pstate* fpstate = (Filter_pstate*)dstate;
+    Filter_tables_init(&fpstate->tables, audio_rate);
+
+    return true;
+}
+
+
 static void Filter_pstate_reset(Device_state* dstate)
 {
     rassert(dstate != NULL);
@@ -519,14 +627,14 @@ static void Filter_pstate_render_mixed(
 
     Filter_state_impl_apply_input_buffers(
             &fpstate->state_impl,
+            &fpstate->tables,
             cutoff_buf,
             resonance_buf,
             wbs,
             in_buffers,
             out_buffers,
             buf_start,
-            buf_stop,
-            dstate->audio_rate);
+            buf_stop);
 
     return;
 }
@@ -591,11 +699,13 @@ Device_state* new_Filter_pstate(
         return NULL;
     }
 
+    fpstate->parent.set_audio_rate = Filter_pstate_set_audio_rate;
     fpstate->parent.reset = Filter_pstate_reset;
     fpstate->parent.render_mixed = Filter_pstate_render_mixed;
 
     const Proc_filter* filter = (const Proc_filter*)device->dimpl;
     Filter_state_impl_init(&fpstate->state_impl, filter);
+    Filter_tables_init(&fpstate->tables, audio_rate);
 
     return (Device_state*)fpstate;
 }
@@ -615,6 +725,44 @@ int32_t Filter_vstate_get_size(void)
 }
 
 
+typedef struct Filter_voice_buffers
+{
+    const float* cutoff_buf;
+    const float* resonance_buf;
+    Work_buffer* in_buffers[2];
+    Work_buffer* out_buffers[2];
+} Filter_voice_buffers;
+
+
+static void Filter_voice_buffers_init(
+        Filter_voice_buffers* bufs, const Device_thread_state* proc_ts, int lane)
+{
+    rassert(bufs != NULL);
+    rassert(proc_ts != NULL);
+
+    const Work_buffer* cutoff_wb = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_RECV, PORT_IN_CUTOFF);
+    const Work_buffer* resonance_wb = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_RECV, PORT_IN_RESONANCE);
+    bufs->cutoff_buf =
+        (cutoff_wb != NULL) ? Work_buffer_get_contents(cutoff_wb) : NULL;
+    bufs->resonance_buf =
+        (resonance_wb != NULL) ? Work_buffer_get_contents(resonance_wb) : NULL;
+
+    bufs->in_buffers[0] = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_RECV, PORT_IN_AUDIO_L);
+    bufs->in_buffers[1] = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_RECV, PORT_IN_AUDIO_R);
+
+    bufs->out_buffers[0] = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_SEND, PORT_OUT_AUDIO_L);
+    bufs->out_buffers[1] = Device_thread_state_get_voice_lane_buffer(
+            proc_ts, lane, DEVICE_PORT_TYPE_SEND, PORT_OUT_AUDIO_R);
+
+    return;
+}
+
+
 int32_t Filter_vstate_render_voice(
         Voice_state* vstate,
         Proc_state* proc_state,
@@ -637,51 +785,254 @@ int32_t Filter_vstate_render_voice(
 
     Filter_vstate* fvstate = (Filter_vstate*)vstate;
 
-    // Get parameter inputs
-    const float* cutoff_buf = Device_thread_state_get_voice_buffer_contents(
-            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_CUTOFF);
-    const float* resonance_buf = Device_thread_state_get_voice_buffer_contents(
-            proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_RESONANCE);
-
-    // Get input
-    Work_buffer* in_buffers[2] =
-    {
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_AUDIO_L),
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_RECV, PORT_IN_AUDIO_R),
-    };
-    if ((in_buffers[0] == NULL) && (in_buffers[1] == NULL))
+    Filter_voice_buffers* bufs = &(Filter_voice_buffers){ .cutoff_buf = NULL };
+    Filter_voice_buffers_init(bufs, proc_ts, Device_thread_state_get_voice_lane(proc_ts));
+    if ((bufs->in_buffers[0] == NULL) && (bufs->in_buffers[1] == NULL))
     {
         vstate->active = false;
         return buf_start;
     }
 
-    // Get output
-    Work_buffer* out_buffers[2] =
-    {
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_SEND, PORT_OUT_AUDIO_L),
-        Device_thread_state_get_voice_buffer(
-                proc_ts, DEVICE_PORT_TYPE_SEND, PORT_OUT_AUDIO_R),
-    };
-
-    const Device_state* dstate = (const Device_state*)proc_state;
+    const Filter_pstate* fpstate = (const Filter_pstate*)proc_state;
     Filter_state_impl_apply_input_buffers(
             &fvstate->state_impl,
-            cutoff_buf,
-            resonance_buf,
+            &fpstate->tables,
+            bufs->cutoff_buf,
+            bufs->resonance_buf,
             wbs,
-            in_buffers,
-            out_buffers,
+            bufs->in_buffers,
+            bufs->out_buffers,
             buf_start,
-            buf_stop,
-            dstate->audio_rate);
+            buf_stop);
 
     return buf_stop;
 }
 
 
+static void apply_constant_filters(
+        const Filter_coeffs* coeffs[VOICE_LANES_MAX],
+        double* int1s[VOICE_LANES_MAX],
+        double* int2s[VOICE_LANES_MAX],
+        const float* in_bufs[VOICE_LANES_MAX],
+        float* out_bufs[VOICE_LANES_MAX],
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(coeffs != NULL);
+    rassert(int1s != NULL);
+    rassert(int2s != NULL);
+    rassert(in_bufs != NULL);
+    rassert(out_bufs != NULL);
+
+    // Filter states in lanes, unused lanes have zero coefficients
+    double a1s[VOICE_LANES_MAX] = { 0 };
+    double a2s[VOICE_LANES_MAX] = { 0 };
+    double a3s[VOICE_LANES_MAX] = { 0 };
+    double m0s[VOICE_LANES_MAX] = { 0 };
+    double m1s[VOICE_LANES_MAX] = { 0 };
+    double m2s[VOICE_LANES_MAX] = { 0 };
+    double s1s[VOICE_LANES_MAX] = { 0 };
+    double s2s[VOICE_LANES_MAX] = { 0 };
+
+    for (int lane = 0; lane < VOICE_LANES_MAX; ++lane)
+    {
+        const Filter_coeffs* lane_coeffs = coeffs[lane];
+        if (lane_coeffs == NULL)
+            continue;
+
+        a1s[lane] = lane_coeffs->a1;
+        a2s[lane] = lane_coeffs->a2;
+        a3s[lane] = lane_coeffs->a3;
+        m0s[lane] = lane_coeffs->m0;
+        m1s[lane] = lane_coeffs->m1;
+        m2s[lane] = lane_coeffs->m2;
+        s1s[lane] = *int1s[lane];
+        s2s[lane] = *int2s[lane];
+    }
+
+    for (int32_t i = buf_start; i < buf_stop; ++i)
+    {
+        for (int lane = 0; lane < VOICE_LANES_MAX; ++lane)
+        {
+            const double v0 = in_bufs[lane][i];
+            const double v3 = v0 - s2s[lane];
+            const double v1 = a1s[lane] * s1s[lane] + a2s[lane] * v3;
+            const double v2 = s2s[lane] + a2s[lane] * s1s[lane] + a3s[lane] * v3;
+            s1s[lane] = 2 * v1 - s1s[lane];
+            s2s[lane] = 2 * v2 - s2s[lane];
+
+            out_bufs[lane][i] =
+                (float)(m0s[lane] * v0 + m1s[lane] * v1 + m2s[lane] * v2);
+        }
+    }
+
+    for (int lane = 0; lane < VOICE_LANES_MAX; ++lane)
+    {
+        if (coeffs[lane] == NULL)
+            continue;
+
+        *int1s[lane] = s1s[lane];
+        *int2s[lane] = s2s[lane];
+    }
+
+    return;
+}
+
+
+static const int BATCH_WB_UNUSED_OUT = WORK_BUFFER_IMPL_3;
+
+
+void Filter_vstate_render_voices_batch(
+        Voice_state* vstates[],
+        const int lanes[],
+        int count,
+        Proc_state* proc_state,
+        const Device_thread_state* proc_ts,
+        const Au_state* au_state,
+        const Work_buffers* wbs,
+        int32_t buf_start,
+        int32_t buf_stop,
+        double tempo)
+{
+    rassert(vstates != NULL);
+    rassert(lanes != NULL);
+    rassert(count > 0);
+    rassert(count <= VOICE_LANES_MAX);
+    rassert(proc_state != NULL);
+    rassert(proc_ts != NULL);
+    rassert(au_state != NULL);
+    rassert(wbs != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop >= 0);
+    rassert(isfinite(tempo));
+    rassert(tempo > 0);
+
+    const Filter_tables* tables = &((const Filter_pstate*)proc_state)->tables;
+
+    Filter_voice_buffers lane_bufs[VOICE_LANES_MAX];
+    Filter_state_impl* const_fimpls[VOICE_LANES_MAX] = { NULL };
+    Filter_coeffs const_coeffs[VOICE_LANES_MAX];
+    int const_indices[VOICE_LANES_MAX] = { 0 };
+    int const_count = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        Filter_vstate* fvstate = (Filter_vstate*)vstates[i];
+        Filter_state_impl* fimpl = &fvstate->state_impl;
+        Filter_voice_buffers* bufs = &lane_bufs[i];
+        Filter_voice_buffers_init(bufs, proc_ts, lanes[i]);
+
+        if ((bufs->in_buffers[0] == NULL) && (bufs->in_buffers[1] == NULL))
+        {
+            vstates[i]->active = false;
+            continue;
+        }
+
+        // Collect filters with constant coefficients for processing in lanes
+        double cutoff = fimpl->def_cutoff;
+        double resonance = fimpl->def_resonance;
+        if (Filter_state_impl_get_constant_params(
+                    fimpl,
+                    bufs->cutoff_buf,
+                    bufs->resonance_buf,
+                    buf_start,
+                    buf_stop,
+                    &cutoff,
+                    &resonance))
+        {
+            Filter_coeffs* coeffs = &const_coeffs[const_count];
+            Filter_coeffs_init_from_params(coeffs, tables, fimpl->type, cutoff, resonance);
+            if (!coeffs->bypass)
+            {
+                const_fimpls[const_count] = fimpl;
+                const_indices[const_count] = i;
+                ++const_count;
+                continue;
+            }
+        }
+
+        Filter_state_impl_apply_input_buffers(
+                fimpl,
+                tables,
+                bufs->cutoff_buf,
+                bufs->resonance_buf,
+                wbs,
+                bufs->in_buffers,
+                bufs->out_buffers,
+                buf_start,
+                buf_stop);
+    }
+
+    if (const_count == 1)
+    {
+        // Not worth running in lanes
+        Filter_voice_buffers* bufs = &lane_bufs[const_indices[0]];
+        Filter_state_impl_apply_input_buffers(
+                const_fimpls[0],
+                tables,
+                bufs->cutoff_buf,
+                bufs->resonance_buf,
+                wbs,
+                bufs->in_buffers,
+                bufs->out_buffers,
+                buf_start,
+                buf_stop);
+        return;
+    }
+    else if (const_count == 0)
+    {
+        return;
+    }
+
+    // Process the constant filters in parallel, one channel at a time
+    float* unused_out = Work_buffers_get_buffer_contents_mut(wbs, BATCH_WB_UNUSED_OUT);
+    double unused_ints[VOICE_LANES_MAX][2] = { { 0 } };
+
+    for (int ch = 0; ch < 2; ++ch)
+    {
+        const Filter_coeffs* coeffs[VOICE_LANES_MAX] = { NULL };
+        double* int1s[VOICE_LANES_MAX] = { NULL };
+        double* int2s[VOICE_LANES_MAX] = { NULL };
+        const float* in_bufs[VOICE_LANES_MAX] = { NULL };
+        float* out_bufs[VOICE_LANES_MAX] = { NULL };
+        const float* any_in_buf = NULL;
+
+        for (int ci = 0; ci < const_count; ++ci)
+        {
+            const Filter_voice_buffers* bufs = &lane_bufs[const_indices[ci]];
+            if ((bufs->in_buffers[ch] == NULL) || (bufs->out_buffers[ch] == NULL))
+                continue;
+
+            Filter_state_impl* fimpl = const_fimpls[ci];
+            coeffs[ci] = &const_coeffs[ci];
+            int1s[ci] = &fimpl->int1[ch];
+            int2s[ci] = &fimpl->int2[ch];
+            in_bufs[ci] = Work_buffer_get_contents(bufs->in_buffers[ch]);
+            out_bufs[ci] = Work_buffer_get_contents_mut(bufs->out_buffers[ch]);
+            any_in_buf = in_bufs[ci];
+        }
+
+        if (any_in_buf == NULL)
+            continue;
+
+        for (int lane = 0; lane < VOICE_LANES_MAX; ++lane)
+        {
+            if (coeffs[lane] == NULL)
+            {
+                int1s[lane] = &unused_ints[lane][0];
+                int2s[lane] = &unused_ints[lane][1];
+                in_bufs[lane] = any_in_buf;
+                out_bufs[lane] = unused_out;
+            }
+        }
+
+        apply_constant_filters(coeffs, int1s, int2s, in_bufs, out_bufs, buf_start, buf_stop);
+    }
+
+    return;
+}
+
+
 void Filter_vstate_init(Voice_state* vstate, const Proc_state* proc_state)
 {
     rassert(vstate != NULL);
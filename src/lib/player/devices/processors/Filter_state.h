@@ -32,6 +32,7 @@ Set_state_float_func Filter_pstate_set_resonance;
 Voice_state_get_size_func Filter_vstate_get_size;
 Voice_state_init_func Filter_vstate_init;
 Voice_state_render_voice_func Filter_vstate_render_voice;
+Voice_state_render_voices_batch_func Filter_vstate_render_voices_batch;
 
 
 #endif // KQT_FILTER_STATE_H
@@ -25,6 +25,7 @@
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/Force_controls.h>
 #include <player/Time_env_state.h>
+#include <player/Work_buffer.h>
 #include <player/Work_buffers.h>
 
 #include <stdio.h>
@@ -146,71 +147,101 @@ int32_t Force_vstate_render_voice(
 
     int32_t new_buf_stop = buf_stop;
 
-    // Apply force slide & fixed adjust
+    const int32_t control_period =
+        Processor_get_control_period((const Processor*)proc_state->parent.device);
+
+    if (control_period > 1)
     {
-        const double fixed_adjust = fvstate->fixed_adjust;
+        // Compute the control points only and interpolate the rest
+        const bool is_varying = Slider_in_progress(&fc->slider) ||
+            (LFO_estimate_active_steps_left(&fc->tremolo) > 0);
+
+        fc->force = Slider_fill_control_points(
+                &fc->slider, fc->force, out_buf, buf_start, buf_stop, control_period);
+
+        const float fixed_adjust = (float)fvstate->fixed_adjust;
+        for (int32_t i = buf_start;
+                i < buf_stop;
+                i = Work_buffer_get_next_control_pos(i, buf_stop, control_period))
+            out_buf[i] += fixed_adjust;
+
+        LFO_mix_control_points(
+                &fc->tremolo, out_buf, buf_start, buf_stop, control_period);
 
-        int32_t cur_pos = buf_start;
-        while (cur_pos < buf_stop)
+        Work_buffer_interpolate_control_values(
+                out_wb, buf_start, buf_stop, control_period);
+
+        const_start = is_varying ? buf_stop : buf_start;
+    }
+    else
+    {
+        // Apply force slide & fixed adjust
         {
-            const int32_t estimated_steps =
-                Slider_estimate_active_steps_left(&fc->slider);
-            if (estimated_steps > 0)
-            {
-                int32_t slide_stop = buf_stop;
-                if (estimated_steps < buf_stop - cur_pos)
-                    slide_stop = cur_pos + estimated_steps;
+            const double fixed_adjust = fvstate->fixed_adjust;
 
-                double new_force = fc->force;
-                for (int32_t i = cur_pos; i < slide_stop; ++i)
+            int32_t cur_pos = buf_start;
+            while (cur_pos < buf_stop)
+            {
+                const int32_t estimated_steps =
+                    Slider_estimate_active_steps_left(&fc->slider);
+                if (estimated_steps > 0)
                 {
-                    new_force = Slider_step(&fc->slider);
-                    out_buf[i] = (float)(new_force + fixed_adjust);
+                    int32_t slide_stop = buf_stop;
+                    if (estimated_steps < buf_stop - cur_pos)
+                        slide_stop = cur_pos + estimated_steps;
+
+                    fc->force = Slider_fill(
+                            &fc->slider, out_buf + cur_pos, slide_stop - cur_pos);
+
+                    if (fixed_adjust != 0)
+                    {
+                        const float adjust = (float)fixed_adjust;
+                        for (int32_t i = cur_pos; i < slide_stop; ++i)
+                            out_buf[i] += adjust;
+                    }
+
+                    const_start = slide_stop;
+                    cur_pos = slide_stop;
                 }
-                fc->force = new_force;
-
-                const_start = slide_stop;
-                cur_pos = slide_stop;
-            }
-            else
-            {
-                const float actual_force = (float)(fc->force + fixed_adjust);
-                for (int32_t i = cur_pos; i < buf_stop; ++i)
-                    out_buf[i] = actual_force;
+                else
+                {
+                    const float actual_force = (float)(fc->force + fixed_adjust);
+                    for (int32_t i = cur_pos; i < buf_stop; ++i)
+                        out_buf[i] = actual_force;
 
-                cur_pos = buf_stop;
+                    cur_pos = buf_stop;
+                }
             }
         }
-    }
 
-    // Apply tremolo
-    {
-        int32_t cur_pos = buf_start;
-        int32_t final_lfo_stop = buf_start;
-        while (cur_pos < buf_stop)
+        // Apply tremolo
         {
-            const int32_t estimated_steps =
-                LFO_estimate_active_steps_left(&fc->tremolo);
-            if (estimated_steps > 0)
+            int32_t cur_pos = buf_start;
+            int32_t final_lfo_stop = buf_start;
+            while (cur_pos < buf_stop)
             {
-                int32_t lfo_stop = buf_stop;
-                if (estimated_steps < buf_stop - cur_pos)
-                    lfo_stop = cur_pos + estimated_steps;
+                const int32_t estimated_steps =
+                    LFO_estimate_active_steps_left(&fc->tremolo);
+                if (estimated_steps > 0)
+                {
+                    int32_t lfo_stop = buf_stop;
+                    if (estimated_steps < buf_stop - cur_pos)
+                        lfo_stop = cur_pos + estimated_steps;
 
-                for (int32_t i = cur_pos; i < lfo_stop; ++i)
-                    out_buf[i] += (float)LFO_step(&fc->tremolo);
+                    LFO_mix(&fc->tremolo, out_buf + cur_pos, lfo_stop - cur_pos);
 
-                final_lfo_stop = lfo_stop;
-                cur_pos = lfo_stop;
-            }
-            else
-            {
-                final_lfo_stop = cur_pos;
-                break;
+                    final_lfo_stop = lfo_stop;
+                    cur_pos = lfo_stop;
+                }
+                else
+                {
+                    final_lfo_stop = cur_pos;
+                    break;
+                }
             }
-        }
 
-        const_start = max(const_start, final_lfo_stop);
+            const_start = max(const_start, final_lfo_stop);
+        }
     }
 
     int32_t keep_alive_stop = buf_stop;
@@ -239,8 +270,11 @@ int32_t Force_vstate_render_voice(
         float* time_env = Work_buffer_get_contents_mut(wb_time_env);
 
         // Convert envelope data to dB
-        for (int32_t i = buf_start; i < env_force_stop; ++i)
-            time_env[i] = (float)fast_scale_to_dB(time_env[i]);
+        if (buf_start < env_force_stop)
+            fast_scale_to_dB_array(
+                    time_env + buf_start,
+                    time_env + buf_start,
+                    env_force_stop - buf_start);
 
         // Check the end of envelope processing
         if (fvstate->env_state.is_finished)
@@ -300,8 +334,11 @@ int32_t Force_vstate_render_voice(
             float* time_env = Work_buffer_get_contents_mut(wb_time_env);
 
             // Convert envelope data to dB
-            for (int32_t i = buf_start; i < new_buf_stop; ++i)
-                time_env[i] = (float)fast_scale_to_dB(time_env[i]);
+            if (buf_start < new_buf_stop)
+                fast_scale_to_dB_array(
+                        time_env + buf_start,
+                        time_env + buf_start,
+                        new_buf_stop - buf_start);
 
             for (int32_t i = buf_start; i < new_buf_stop; ++i)
                 out_buf[i] += time_env[i];
@@ -348,6 +385,13 @@ int32_t Force_vstate_render_voice(
         }
     }
 
+    // Envelopes and release processing are applied to every frame
+    const bool has_frame_rate_stages =
+        (force->is_force_env_enabled && (force->force_env != NULL)) ||
+        !vstate->note_on;
+    if (has_frame_rate_stages)
+        Work_buffer_set_control_period(out_wb, 1);
+
     // Mark constant region of the buffer
     Work_buffer_set_const_start(out_wb, const_start);
     Work_buffer_set_final(out_wb, keep_alive_stop < buf_stop);
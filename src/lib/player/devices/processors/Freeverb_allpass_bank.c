@@ -0,0 +1,215 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2010-2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/devices/processors/Freeverb_allpass_bank.h>
+
+#include <debug/assert.h>
+#include <intrinsics.h>
+#include <mathnum/common.h>
+#include <memory.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+struct Freeverb_allpass_bank
+{
+    float feedback;
+    float* buffer;
+    int64_t total_size;
+
+    int32_t offsets[FREEVERB_ALLPASS_BANK_LANES];
+    int32_t sizes[FREEVERB_ALLPASS_BANK_LANES];
+    int32_t positions[FREEVERB_ALLPASS_BANK_LANES];
+};
+
+
+Freeverb_allpass_bank* new_Freeverb_allpass_bank(
+        const int32_t buffer_sizes[FREEVERB_ALLPASS_BANK_LANES])
+{
+    rassert(buffer_sizes != NULL);
+
+    Freeverb_allpass_bank* bank = memory_alloc_item(Freeverb_allpass_bank);
+    if (bank == NULL)
+        return NULL;
+
+    bank->feedback = 0;
+    bank->buffer = NULL;
+    bank->total_size = 0;
+
+    for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+    {
+        bank->offsets[lane] = 0;
+        bank->sizes[lane] = 0;
+        bank->positions[lane] = 0;
+    }
+
+    if (!Freeverb_allpass_bank_resize_buffers(bank, buffer_sizes))
+    {
+        del_Freeverb_allpass_bank(bank);
+        return NULL;
+    }
+
+    return bank;
+}
+
+
+void Freeverb_allpass_bank_set_feedback(Freeverb_allpass_bank* bank, float feedback)
+{
+    rassert(bank != NULL);
+    rassert(feedback > -1);
+    rassert(feedback < 1);
+
+    bank->feedback = feedback;
+
+    return;
+}
+
+
+void Freeverb_allpass_bank_process(
+        Freeverb_allpass_bank* bank,
+        float* bufs[FREEVERB_ALLPASS_BANK_CHANNELS],
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(bank != NULL);
+    rassert(bufs != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop > buf_start);
+
+#ifdef KQT_SSE
+    dassert(_MM_GET_FLUSH_ZERO_MODE() == _MM_FLUSH_ZERO_ON);
+#endif
+
+    const float feedback = bank->feedback;
+
+    int32_t i = buf_start;
+    while (i < buf_stop)
+    {
+        // Find the longest run in which none of the delay lines wrap around
+        int32_t run_length = buf_stop - i;
+        for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+            run_length = min(run_length, bank->sizes[lane] - bank->positions[lane]);
+
+        float* lines[FREEVERB_ALLPASS_BANK_LANES];
+        for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+            lines[lane] = bank->buffer + bank->offsets[lane] + bank->positions[lane];
+
+        const int32_t run_stop = i + run_length;
+        for (int32_t k = 0; i < run_stop; ++i, ++k)
+        {
+            for (int ch = 0; ch < FREEVERB_ALLPASS_BANK_CHANNELS; ++ch)
+            {
+                float* const* ch_lines = lines + ch * FREEVERB_ALLPASSES;
+
+                float value = bufs[ch][i];
+
+                for (int allpass = 0; allpass < FREEVERB_ALLPASSES; ++allpass)
+                {
+                    float bufout = ch_lines[allpass][k];
+#ifndef KQT_SSE
+                    bufout = undenormalise(bufout);
+#endif
+                    ch_lines[allpass][k] = value + (bufout * feedback);
+
+                    value = -value + bufout;
+                }
+
+                bufs[ch][i] = value;
+            }
+        }
+
+        for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+        {
+            bank->positions[lane] += run_length;
+            if (bank->positions[lane] >= bank->sizes[lane])
+                bank->positions[lane] = 0;
+        }
+    }
+
+    return;
+}
+
+
+bool Freeverb_allpass_bank_resize_buffers(
+        Freeverb_allpass_bank* bank,
+        const int32_t buffer_sizes[FREEVERB_ALLPASS_BANK_LANES])
+{
+    rassert(bank != NULL);
+    rassert(buffer_sizes != NULL);
+
+    bool sizes_changed = (bank->buffer == NULL);
+    int64_t total_size = 0;
+    for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+    {
+        rassert(buffer_sizes[lane] > 0);
+        sizes_changed |= (buffer_sizes[lane] != bank->sizes[lane]);
+        total_size += buffer_sizes[lane];
+    }
+
+    if (!sizes_changed)
+        return true;
+
+    if (total_size != bank->total_size)
+    {
+        float* buffer = memory_realloc_items(float, total_size, bank->buffer);
+        if (buffer == NULL)
+            return false;
+
+        bank->buffer = buffer;
+        bank->total_size = total_size;
+    }
+
+    int32_t offset = 0;
+    for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+    {
+        bank->offsets[lane] = offset;
+        bank->sizes[lane] = buffer_sizes[lane];
+        offset += buffer_sizes[lane];
+    }
+
+    Freeverb_allpass_bank_clear(bank);
+
+    return true;
+}
+
+
+void Freeverb_allpass_bank_clear(Freeverb_allpass_bank* bank)
+{
+    rassert(bank != NULL);
+    rassert(bank->buffer != NULL);
+
+    for (int lane = 0; lane < FREEVERB_ALLPASS_BANK_LANES; ++lane)
+        bank->positions[lane] = 0;
+
+    for (int64_t i = 0; i < bank->total_size; ++i)
+        bank->buffer[i] = 0;
+
+    return;
+}
+
+
+void del_Freeverb_allpass_bank(Freeverb_allpass_bank* bank)
+{
+    if (bank == NULL)
+        return;
+
+    memory_free(bank->buffer);
+    memory_free(bank);
+
+    return;
+}
+
+
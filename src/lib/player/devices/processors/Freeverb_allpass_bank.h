@@ -0,0 +1,112 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2010-2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_FREEVERB_ALLPASS_BANK_H
+#define KQT_FREEVERB_ALLPASS_BANK_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define FREEVERB_ALLPASS_BANK_CHANNELS 2
+#define FREEVERB_ALLPASSES 4
+#define FREEVERB_ALLPASS_BANK_LANES \
+    (FREEVERB_ALLPASS_BANK_CHANNELS * FREEVERB_ALLPASSES)
+
+
+/**
+ * This is the bank of allpass filters used by the Freeverb processor. The bank
+ * contains a series of \a FREEVERB_ALLPASSES allpass filters for each channel.
+ * The delay lines of all filters are stored in a single allocation, and each
+ * sample is passed through the whole series of both channels at once.
+ */
+typedef struct Freeverb_allpass_bank Freeverb_allpass_bank;
+
+
+/**
+ * Create a new Freeverb allpass bank.
+ *
+ * \param buffer_sizes   The buffer sizes of the allpass filters, indexed by
+ *                       channel * \a FREEVERB_ALLPASSES + allpass -- must not
+ *                       be \c NULL and each size must be > \c 0.
+ *
+ * \return   The new Freeverb allpass bank if successful, or \c NULL if memory
+ *           allocation failed.
+ */
+Freeverb_allpass_bank* new_Freeverb_allpass_bank(
+        const int32_t buffer_sizes[FREEVERB_ALLPASS_BANK_LANES]);
+
+
+/**
+ * Set the feedback of the allpass filters.
+ *
+ * \param bank       The Freeverb allpass bank -- must not be \c NULL.
+ * \param feedback   The feedback value -- must be > \c -1 and < \c 1.
+ */
+void Freeverb_allpass_bank_set_feedback(Freeverb_allpass_bank* bank, float feedback);
+
+
+/**
+ * Process data buffers in place.
+ *
+ * \param bank        The Freeverb allpass bank -- must not be \c NULL.
+ * \param bufs        The signal buffers, one for each channel -- must not be
+ *                    \c NULL.
+ * \param buf_start   The buffer start position -- must be >= \c 0.
+ * \param buf_stop    The buffer stop position -- must be > \a buf_start.
+ */
+void Freeverb_allpass_bank_process(
+        Freeverb_allpass_bank* bank,
+        float* bufs[FREEVERB_ALLPASS_BANK_CHANNELS],
+        int32_t buf_start,
+        int32_t buf_stop);
+
+
+/**
+ * Resize the internal buffers of the Freeverb allpass bank.
+ *
+ * The buffers are cleared if any of the sizes change.
+ *
+ * \param bank           The Freeverb allpass bank -- must not be \c NULL.
+ * \param buffer_sizes   The new buffer sizes -- must not be \c NULL and each
+ *                       size must be > \c 0.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Freeverb_allpass_bank_resize_buffers(
+        Freeverb_allpass_bank* bank,
+        const int32_t buffer_sizes[FREEVERB_ALLPASS_BANK_LANES]);
+
+
+/**
+ * Clear the internal buffers of the Freeverb allpass bank.
+ *
+ * \param bank   The Freeverb allpass bank -- must not be \c NULL.
+ */
+void Freeverb_allpass_bank_clear(Freeverb_allpass_bank* bank);
+
+
+/**
+ * Destroy an existing Freeverb allpass bank.
+ *
+ * \param bank   The Freeverb allpass bank, or \c NULL.
+ */
+void del_Freeverb_allpass_bank(Freeverb_allpass_bank* bank);
+
+
+#endif // KQT_FREEVERB_ALLPASS_BANK_H
+
+
@@ -0,0 +1,229 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2010-2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <player/devices/processors/Freeverb_comb_bank.h>
+
+#include <debug/assert.h>
+#include <intrinsics.h>
+#include <mathnum/common.h>
+#include <memory.h>
+
+#include <stdint.h>
+#include <stdlib.h>
+
+
+struct Freeverb_comb_bank
+{
+    float* buffer;
+    int64_t total_size;
+
+    float filter_stores[FREEVERB_COMB_BANK_LANES];
+    int32_t offsets[FREEVERB_COMB_BANK_LANES];
+    int32_t sizes[FREEVERB_COMB_BANK_LANES];
+    int32_t positions[FREEVERB_COMB_BANK_LANES];
+};
+
+
+Freeverb_comb_bank* new_Freeverb_comb_bank(
+        const int32_t buffer_sizes[FREEVERB_COMB_BANK_LANES])
+{
+    rassert(buffer_sizes != NULL);
+
+    Freeverb_comb_bank* bank = memory_alloc_item(Freeverb_comb_bank);
+    if (bank == NULL)
+        return NULL;
+
+    bank->buffer = NULL;
+    bank->total_size = 0;
+
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+    {
+        bank->filter_stores[lane] = 0;
+        bank->offsets[lane] = 0;
+        bank->sizes[lane] = 0;
+        bank->positions[lane] = 0;
+    }
+
+    if (!Freeverb_comb_bank_resize_buffers(bank, buffer_sizes))
+    {
+        del_Freeverb_comb_bank(bank);
+        return NULL;
+    }
+
+    return bank;
+}
+
+
+void Freeverb_comb_bank_process(
+        Freeverb_comb_bank* bank,
+        float* out_bufs[FREEVERB_COMB_BANK_CHANNELS],
+        const float* in_buf,
+        const float* refls,
+        const float* damps,
+        int32_t buf_start,
+        int32_t buf_stop)
+{
+    rassert(bank != NULL);
+    rassert(out_bufs != NULL);
+    rassert(in_buf != NULL);
+    rassert(refls != NULL);
+    rassert(damps != NULL);
+    rassert(buf_start >= 0);
+    rassert(buf_stop > buf_start);
+
+#ifdef KQT_SSE
+    dassert(_MM_GET_FLUSH_ZERO_MODE() == _MM_FLUSH_ZERO_ON);
+#endif
+
+    float filter_stores[FREEVERB_COMB_BANK_LANES];
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+        filter_stores[lane] = bank->filter_stores[lane];
+
+    int32_t i = buf_start;
+    while (i < buf_stop)
+    {
+        // Find the longest run in which none of the delay lines wrap around
+        int32_t run_length = buf_stop - i;
+        for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+            run_length = min(run_length, bank->sizes[lane] - bank->positions[lane]);
+
+        float* lines[FREEVERB_COMB_BANK_LANES];
+        for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+            lines[lane] = bank->buffer + bank->offsets[lane] + bank->positions[lane];
+
+        const int32_t run_stop = i + run_length;
+        for (int32_t k = 0; i < run_stop; ++i, ++k)
+        {
+            const float input = in_buf[i];
+            const float refl = refls[i];
+            const float damp1 = damps[i];
+            const float damp2 = 1 - damp1;
+
+            float outputs[FREEVERB_COMB_BANK_LANES];
+
+            for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+            {
+                float output = lines[lane][k];
+#ifndef KQT_SSE
+                output = undenormalise(output);
+#endif
+                float filter_store = (output * damp2) + (filter_stores[lane] * damp1);
+#ifndef KQT_SSE
+                filter_store = undenormalise(filter_store);
+#endif
+                filter_stores[lane] = filter_store;
+                lines[lane][k] = input + (filter_store * refl);
+
+                outputs[lane] = output;
+            }
+
+            for (int ch = 0; ch < FREEVERB_COMB_BANK_CHANNELS; ++ch)
+            {
+                const float* ch_outputs = outputs + ch * FREEVERB_COMBS;
+
+                float sum = 0;
+                for (int comb = 0; comb < FREEVERB_COMBS; ++comb)
+                    sum += ch_outputs[comb];
+
+                out_bufs[ch][i] = sum;
+            }
+        }
+
+        for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+        {
+            bank->positions[lane] += run_length;
+            if (bank->positions[lane] >= bank->sizes[lane])
+                bank->positions[lane] = 0;
+        }
+    }
+
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+        bank->filter_stores[lane] = filter_stores[lane];
+
+    return;
+}
+
+
+bool Freeverb_comb_bank_resize_buffers(
+        Freeverb_comb_bank* bank, const int32_t buffer_sizes[FREEVERB_COMB_BANK_LANES])
+{
+    rassert(bank != NULL);
+    rassert(buffer_sizes != NULL);
+
+    bool sizes_changed = (bank->buffer == NULL);
+    int64_t total_size = 0;
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+    {
+        rassert(buffer_sizes[lane] > 0);
+        sizes_changed |= (buffer_sizes[lane] != bank->sizes[lane]);
+        total_size += buffer_sizes[lane];
+    }
+
+    if (!sizes_changed)
+        return true;
+
+    if (total_size != bank->total_size)
+    {
+        float* buffer = memory_realloc_items(float, total_size, bank->buffer);
+        if (buffer == NULL)
+            return false;
+
+        bank->buffer = buffer;
+        bank->total_size = total_size;
+    }
+
+    int32_t offset = 0;
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+    {
+        bank->offsets[lane] = offset;
+        bank->sizes[lane] = buffer_sizes[lane];
+        offset += buffer_sizes[lane];
+    }
+
+    Freeverb_comb_bank_clear(bank);
+
+    return true;
+}
+
+
+void Freeverb_comb_bank_clear(Freeverb_comb_bank* bank)
+{
+    rassert(bank != NULL);
+    rassert(bank->buffer != NULL);
+
+    for (int lane = 0; lane < FREEVERB_COMB_BANK_LANES; ++lane)
+    {
+        bank->filter_stores[lane] = 0;
+        bank->positions[lane] = 0;
+    }
+
+    for (int64_t i = 0; i < bank->total_size; ++i)
+        bank->buffer[i] = 0;
+
+    return;
+}
+
+
+void del_Freeverb_comb_bank(Freeverb_comb_bank* bank)
+{
+    if (bank == NULL)
+        return;
+
+    memory_free(bank->buffer);
+    memory_free(bank);
+
+    return;
+}
+
+
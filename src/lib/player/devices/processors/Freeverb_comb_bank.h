@@ -0,0 +1,108 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2010-2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#ifndef KQT_FREEVERB_COMB_BANK_H
+#define KQT_FREEVERB_COMB_BANK_H
+
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define FREEVERB_COMB_BANK_CHANNELS 2
+#define FREEVERB_COMBS 8
+#define FREEVERB_COMB_BANK_LANES (FREEVERB_COMB_BANK_CHANNELS * FREEVERB_COMBS)
+
+
+/**
+ * This is the bank of lowpass-feedback-comb filters used by the Freeverb
+ * processor. The bank contains \a FREEVERB_COMBS parallel combs for each
+ * output channel. The delay lines of all combs are stored in a single
+ * allocation and the combs are processed side by side, one sample at a time,
+ * as their feedback loops are independent of each other.
+ */
+typedef struct Freeverb_comb_bank Freeverb_comb_bank;
+
+
+/**
+ * Create a new Freeverb comb bank.
+ *
+ * \param buffer_sizes   The buffer sizes of the combs, indexed by
+ *                       channel * \a FREEVERB_COMBS + comb -- must not be
+ *                       \c NULL and each size must be > \c 0.
+ *
+ * \return   The new Freeverb comb bank if successful, or \c NULL if memory
+ *           allocation failed.
+ */
+Freeverb_comb_bank* new_Freeverb_comb_bank(
+        const int32_t buffer_sizes[FREEVERB_COMB_BANK_LANES]);
+
+
+/**
+ * Process data buffers.
+ *
+ * \param bank        The Freeverb comb bank -- must not be \c NULL.
+ * \param out_bufs    The output buffers, one for each channel, where the sum
+ *                    of the comb outputs is written -- must not be \c NULL.
+ * \param in_buf      The input signal buffer -- must not be \c NULL.
+ * \param refls       The reflectivity parameter buffer -- must not be \c NULL.
+ * \param damps       The damp parameter buffer -- must not be \c NULL.
+ * \param buf_start   The buffer start position -- must be >= \c 0.
+ * \param buf_stop    The buffer stop position -- must be > \a buf_start.
+ */
+void Freeverb_comb_bank_process(
+        Freeverb_comb_bank* bank,
+        float* out_bufs[FREEVERB_COMB_BANK_CHANNELS],
+        const float* in_buf,
+        const float* refls,
+        const float* damps,
+        int32_t buf_start,
+        int32_t buf_stop);
+
+
+/**
+ * Resize the internal buffers of the Freeverb comb bank.
+ *
+ * The buffers are cleared if any of the sizes change.
+ *
+ * \param bank           The Freeverb comb bank -- must not be \c NULL.
+ * \param buffer_sizes   The new buffer sizes -- must not be \c NULL and each
+ *                       size must be > \c 0.
+ *
+ * \return   \c true if successful, or \c false if memory allocation failed.
+ */
+bool Freeverb_comb_bank_resize_buffers(
+        Freeverb_comb_bank* bank, const int32_t buffer_sizes[FREEVERB_COMB_BANK_LANES]);
+
+
+/**
+ * Clear the internal buffers of the Freeverb comb bank.
+ *
+ * \param bank   The Freeverb comb bank -- must not be \c NULL.
+ */
+void Freeverb_comb_bank_clear(Freeverb_comb_bank* bank);
+
+
+/**
+ * Destroy an existing Freeverb comb bank.
+ *
+ * \param bank   The Freeverb comb bank, or \c NULL.
+ */
+void del_Freeverb_comb_bank(Freeverb_comb_bank* bank);
+
+
+#endif // KQT_FREEVERB_COMB_BANK_H
+
+
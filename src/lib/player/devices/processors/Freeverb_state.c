@@ -21,16 +21,12 @@
 #include <mathnum/fast_exp2.h>
 #include <memory.h>
 #include <player/devices/Device_thread_state.h>
-#include <player/devices/processors/Freeverb_allpass.h>
-#include <player/devices/processors/Freeverb_comb.h>
+#include <player/devices/processors/Freeverb_allpass_bank.h>
+#include <player/devices/processors/Freeverb_comb_bank.h>
 #include <player/devices/processors/Proc_state_utils.h>
 #include <player/Work_buffers.h>
 
 
-#define FREEVERB_COMBS 8
-#define FREEVERB_ALLPASSES 4
-
-
 // The following constants are in seconds.
 static const double stereo_spread = 0.000521542;
 
@@ -59,26 +55,52 @@ typedef struct Freeverb_pstate
 {
     Proc_state parent;
 
-    Freeverb_comb* combs[2][FREEVERB_COMBS];
-    Freeverb_allpass* allpasses[2][FREEVERB_ALLPASSES];
+    Freeverb_comb_bank* combs;
+    Freeverb_allpass_bank* allpasses;
 } Freeverb_pstate;
 
 
-static void del_Freeverb_pstate(Device_state* dstate)
+static void get_comb_sizes(int32_t audio_rate, int32_t sizes[FREEVERB_COMB_BANK_LANES])
 {
-    rassert(dstate != NULL);
-
-    Freeverb_pstate* fpstate = (Freeverb_pstate*)dstate;
+    rassert(audio_rate > 0);
+    rassert(sizes != NULL);
 
-    for (int ch = 0; ch < 2; ++ch)
+    for (int i = 0; i < FREEVERB_COMBS; ++i)
     {
-        for (int i = 0; i < FREEVERB_COMBS; ++i)
-            del_Freeverb_comb(fpstate->combs[ch][i]);
+        sizes[i] = (int32_t)max(1, comb_tuning[i] * audio_rate);
+        sizes[FREEVERB_COMBS + i] =
+            (int32_t)max(1, (comb_tuning[i] + stereo_spread) * audio_rate);
+    }
+
+    return;
+}
+
 
-        for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
-            del_Freeverb_allpass(fpstate->allpasses[ch][i]);
+static void get_allpass_sizes(
+        int32_t audio_rate, int32_t sizes[FREEVERB_ALLPASS_BANK_LANES])
+{
+    rassert(audio_rate > 0);
+    rassert(sizes != NULL);
+
+    for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
+    {
+        sizes[i] = (int32_t)max(1, allpass_tuning[i] * audio_rate);
+        sizes[FREEVERB_ALLPASSES + i] =
+            (int32_t)max(1, (allpass_tuning[i] + stereo_spread) * audio_rate);
     }
 
+    return;
+}
+
+
+static void del_Freeverb_pstate(Device_state* dstate)
+{
+    rassert(dstate != NULL);
+
+    Freeverb_pstate* fpstate = (Freeverb_pstate*)dstate;
+
+    del_Freeverb_comb_bank(fpstate->combs);
+    del_Freeverb_allpass_bank(fpstate->allpasses);
     memory_free(fpstate);
 
     return;
@@ -91,19 +113,9 @@ static void Freeverb_pstate_reset(Device_state* dstate)
 
     Freeverb_pstate* fstate = (Freeverb_pstate*)dstate;
 
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        for (int i = 0; i < FREEVERB_COMBS; ++i)
-        {
-            Freeverb_comb_clear(fstate->combs[ch][i]);
-        }
-
-        for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
-        {
-            Freeverb_allpass_clear(fstate->allpasses[ch][i]);
-            Freeverb_allpass_set_feedback(fstate->allpasses[ch][i], 0.5);
-        }
-    }
+    Freeverb_comb_bank_clear(fstate->combs);
+    Freeverb_allpass_bank_clear(fstate->allpasses);
+    Freeverb_allpass_bank_set_feedback(fstate->allpasses, 0.5);
 
     return;
 }
@@ -116,33 +128,15 @@ static bool Freeverb_pstate_set_audio_rate(Device_state* dstate, int32_t audio_r
 
     Freeverb_pstate* fstate = (Freeverb_pstate*)dstate;
 
-    for (int i = 0; i < FREEVERB_COMBS; ++i)
-    {
-        const int32_t left_size = (int32_t)max(1, comb_tuning[i] * audio_rate);
-
-        if (!Freeverb_comb_resize_buffer(fstate->combs[0][i], left_size))
-            return false;
-
-        const int32_t right_size =
-            (int32_t)max(1, (comb_tuning[i] + stereo_spread) * audio_rate);
-
-        if (!Freeverb_comb_resize_buffer(fstate->combs[1][i], right_size))
-            return false;
-    }
-
-    for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
-    {
-        const int32_t left_size = (int32_t)max(1, allpass_tuning[i] * audio_rate);
-
-        if (!Freeverb_allpass_resize_buffer(fstate->allpasses[0][i], left_size))
-            return false;
+    int32_t comb_sizes[FREEVERB_COMB_BANK_LANES] = { 0 };
+    get_comb_sizes(audio_rate, comb_sizes);
+    if (!Freeverb_comb_bank_resize_buffers(fstate->combs, comb_sizes))
+        return false;
 
-        const int32_t right_size =
-            (int32_t)max(1, (allpass_tuning[i] + stereo_spread) * audio_rate);
-
-        if (!Freeverb_allpass_resize_buffer(fstate->allpasses[1][i], right_size))
-            return false;
-    }
+    int32_t allpass_sizes[FREEVERB_ALLPASS_BANK_LANES] = { 0 };
+    get_allpass_sizes(audio_rate, allpass_sizes);
+    if (!Freeverb_allpass_bank_resize_buffers(fstate->allpasses, allpass_sizes))
+        return false;
 
     Freeverb_pstate_reset(dstate);
 
@@ -323,26 +317,9 @@ static void Freeverb_pstate_render_mixed(
         _MM_SET_FLUSH_ZERO_MODE(_MM_FLUSH_ZERO_ON);
 #endif
 
-        for (int ch = 0; ch < 2; ++ch)
-        {
-            float* ws_buf = ws[ch];
-            for (int32_t i = buf_start; i < buf_stop; ++i)
-                ws_buf[i] = 0;
-
-            for (int comb = 0; comb < FREEVERB_COMBS; ++comb)
-                Freeverb_comb_process(
-                        fstate->combs[ch][comb],
-                        ws_buf,
-                        comb_input,
-                        refls,
-                        damps,
-                        buf_start,
-                        buf_stop);
-
-            for (int allpass = 0; allpass < FREEVERB_ALLPASSES; ++allpass)
-                Freeverb_allpass_process(
-                        fstate->allpasses[ch][allpass], ws_buf, buf_start, buf_stop);
-        }
+        Freeverb_comb_bank_process(
+                fstate->combs, ws, comb_input, refls, damps, buf_start, buf_stop);
+        Freeverb_allpass_bank_process(fstate->allpasses, ws, buf_start, buf_stop);
 
 #ifdef KQT_SSE
         _MM_SET_FLUSH_ZERO_MODE(old_ftoz);
@@ -389,63 +366,21 @@ Device_state* new_Freeverb_pstate(
     fpstate->parent.render_mixed = Freeverb_pstate_render_mixed;
     fpstate->parent.clear_history = Freeverb_pstate_clear_history;
 
-    for (int ch = 0; ch < 2; ++ch)
-    {
-        for (int i = 0; i < FREEVERB_COMBS; ++i)
-            fpstate->combs[ch][i] = NULL;
+    fpstate->combs = NULL;
+    fpstate->allpasses = NULL;
 
-        for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
-            fpstate->allpasses[ch][i] = NULL;
-    }
+    int32_t comb_sizes[FREEVERB_COMB_BANK_LANES] = { 0 };
+    get_comb_sizes(audio_rate, comb_sizes);
+    fpstate->combs = new_Freeverb_comb_bank(comb_sizes);
 
-    for (int i = 0; i < FREEVERB_COMBS; ++i)
-    {
-        const int32_t left_size = (int32_t)max(1, comb_tuning[i] * audio_rate);
+    int32_t allpass_sizes[FREEVERB_ALLPASS_BANK_LANES] = { 0 };
+    get_allpass_sizes(audio_rate, allpass_sizes);
+    fpstate->allpasses = new_Freeverb_allpass_bank(allpass_sizes);
 
-        fpstate->combs[0][i] = new_Freeverb_comb(left_size);
-        if (fpstate->combs[0][i] == NULL)
-        {
-            del_Device_state(&fpstate->parent.parent);
-            return NULL;
-        }
-
-        const int32_t right_size =
-            (int32_t)max(1, (comb_tuning[i] + stereo_spread) * audio_rate);
-
-        fpstate->combs[1][i] = new_Freeverb_comb(right_size);
-        if (fpstate->combs[1][i] == NULL)
-        {
-            del_Device_state(&fpstate->parent.parent);
-            return NULL;
-        }
-    }
-
-    for (int i = 0; i < FREEVERB_ALLPASSES; ++i)
+    if ((fpstate->combs == NULL) || (fpstate->allpasses == NULL))
     {
-        const int32_t left_size = (int32_t)max(1, allpass_tuning[i] * audio_rate);
-
-        if (fpstate->allpasses[0][i] == NULL)
-        {
-            fpstate->allpasses[0][i] = new_Freeverb_allpass(left_size);
-            if (fpstate->allpasses[0][i] == NULL)
-            {
-                del_Device_state(&fpstate->parent.parent);
-                return NULL;
-            }
-        }
-
-        const int32_t right_size =
-            (int32_t)max(1, (allpass_tuning[i] + stereo_spread) * audio_rate);
-
-        if (fpstate->allpasses[1][i] == NULL)
-        {
-            fpstate->allpasses[1][i] = new_Freeverb_allpass(right_size);
-            if (fpstate->allpasses[1][i] == NULL)
-            {
-                del_Device_state(&fpstate->parent.parent);
-                return NULL;
-            }
-        }
+        del_Device_state(&fpstate->parent.parent);
+        return NULL;
     }
 
     return &fpstate->parent.parent;
@@ -51,24 +51,30 @@ static void distort(
         {
             // Asymmetric distortion
             for (int32_t i = buf_start; i < buf_stop; ++i)
-            {
-                const float clamped_in_value = clamp(in_values[i], -1.0f, 1.0f);
-                out_values[i] = (float)Envelope_get_value(gc->map, clamped_in_value);
-            }
+                out_values[i] = clamp(in_values[i], -1.0f, 1.0f);
+
+            Envelope_get_values(
+                    gc->map,
+                    out_values + buf_start,
+                    out_values + buf_start,
+                    buf_stop - buf_start);
         }
         else
         {
             // Symmetric distortion
             for (int32_t i = buf_start; i < buf_stop; ++i)
-            {
-                const float in_value = in_values[i];
-                const float abs_value = fabsf(in_value);
+                out_values[i] = min(fabsf(in_values[i]), 1);
 
-                float out_value = (float)Envelope_get_value(gc->map, min(abs_value, 1));
-                if (in_value < 0)
-                    out_value = -out_value;
+            Envelope_get_values(
+                    gc->map,
+                    out_values + buf_start,
+                    out_values + buf_start,
+                    buf_stop - buf_start);
 
-                out_values[i] = out_value;
+            for (int32_t i = buf_start; i < buf_stop; ++i)
+            {
+                if (in_values[i] < 0)
+                    out_values[i] = -out_values[i];
             }
         }
     }
@@ -148,28 +148,24 @@ int32_t Noise_vstate_render_voice(
         if (out_buffer == NULL)
             continue;
 
-        if (noise_state->order >= 0)
+        Random_fill_float_signal(
+                &noise_vstate->rands[ch], out_buffer + buf_start, buf_stop - buf_start);
+
+        if (noise_state->order > 0)
         {
             for (int32_t i = buf_start; i < buf_stop; ++i)
-            {
-                const double val = dc_zero_filter(
-                        noise_state->order,
-                        noise_vstate->buf[ch],
-                        Random_get_float_signal(&noise_vstate->rands[ch]));
-                out_buffer[i] = (float)val * scales[i];
-            }
+                out_buffer[i] = (float)dc_zero_filter(
+                        noise_state->order, noise_vstate->buf[ch], out_buffer[i]);
         }
-        else
+        else if (noise_state->order < 0)
         {
             for (int32_t i = buf_start; i < buf_stop; ++i)
-            {
-                const double val = dc_pole_filter(
-                        -noise_state->order,
-                        noise_vstate->buf[ch],
-                        Random_get_float_signal(&noise_vstate->rands[ch]));
-                out_buffer[i] = (float)val * scales[i];
-            }
+                out_buffer[i] = (float)dc_pole_filter(
+                        -noise_state->order, noise_vstate->buf[ch], out_buffer[i]);
         }
+
+        for (int32_t i = buf_start; i < buf_stop; ++i)
+            out_buffer[i] *= scales[i];
     }
 
     const int32_t audio_rate = proc_state->parent.audio_rate;
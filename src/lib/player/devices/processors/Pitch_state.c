@@ -15,11 +15,13 @@
 #include <player/devices/processors/Pitch_state.h>
 
 #include <debug/assert.h>
+#include <init/devices/Processor.h>
 #include <init/devices/processors/Proc_pitch.h>
 #include <mathnum/common.h>
 #include <mathnum/conversions.h>
 #include <player/devices/Device_thread_state.h>
 #include <player/Pitch_controls.h>
+#include <player/Work_buffer.h>
 
 #include <math.h>
 #include <stdio.h>
@@ -57,6 +59,50 @@ enum
 };
 
 
+static void render_control_points(
+        Pitch_vstate* pvstate,
+        Work_buffer* out_wb,
+        int32_t buf_start,
+        int32_t buf_stop,
+        int32_t control_period)
+{
+    rassert(pvstate != NULL);
+    rassert(out_wb != NULL);
+    rassert(!pvstate->is_arpeggio_enabled);
+    rassert(control_period > 1);
+
+    Pitch_controls* pc = &pvstate->controls;
+
+    const bool is_varying = Slider_in_progress(&pc->slider) ||
+        (LFO_estimate_active_steps_left(&pc->vibrato) > 0);
+
+    float* out_buf = Work_buffer_get_contents_mut(out_wb);
+
+    pc->pitch = Slider_fill_control_points(
+            &pc->slider, pc->pitch, out_buf, buf_start, buf_stop, control_period);
+
+    if (pc->pitch_add != 0)
+    {
+        for (int32_t i = buf_start;
+                i < buf_stop;
+                i = Work_buffer_get_next_control_pos(i, buf_stop, control_period))
+            out_buf[i] += (float)pc->pitch_add;
+    }
+
+    LFO_mix_control_points(
+            &pc->vibrato, out_buf, buf_start, buf_stop, control_period);
+
+    Work_buffer_interpolate_control_values(
+            out_wb, buf_start, buf_stop, control_period);
+
+    pvstate->pitch = out_buf[buf_stop - 1];
+
+    Work_buffer_set_const_start(out_wb, is_varying ? buf_stop : buf_start);
+
+    return;
+}
+
+
 int32_t Pitch_vstate_render_voice(
         Voice_state* vstate,
         Proc_state* proc_state,
@@ -103,6 +149,14 @@ int32_t Pitch_vstate_render_voice(
 
     out_buf[buf_start - 1] = (float)pc->pitch;
 
+    const int32_t control_period =
+        Processor_get_control_period((const Processor*)dstate->device);
+    if ((control_period > 1) && !pvstate->is_arpeggio_enabled)
+    {
+        render_control_points(pvstate, out_wb, buf_start, buf_stop, control_period);
+        return buf_stop;
+    }
+
     int32_t const_start = buf_start;
 
     // Apply pitch slide
@@ -118,13 +172,8 @@ int32_t Pitch_vstate_render_voice(
                 if (estimated_steps < buf_stop - cur_pos)
                     slide_stop = cur_pos + estimated_steps;
 
-                double new_pitch = pc->pitch;
-                for (int32_t i = cur_pos; i < slide_stop; ++i)
-                {
-                    new_pitch = Slider_step(&pc->slider);
-                    out_buf[i] = (float)new_pitch;
-                }
-                pc->pitch = new_pitch;
+                pc->pitch = Slider_fill(
+                        &pc->slider, out_buf + cur_pos, slide_stop - cur_pos);
 
                 const_start = slide_stop;
                 cur_pos = slide_stop;
@@ -161,8 +210,7 @@ int32_t Pitch_vstate_render_voice(
                 if (estimated_steps < buf_stop - cur_pos)
                     lfo_stop = cur_pos + estimated_steps;
 
-                for (int32_t i = cur_pos; i < lfo_stop; ++i)
-                    out_buf[i] += (float)LFO_step(&pc->vibrato);
+                LFO_mix(&pc->vibrato, out_buf + cur_pos, lfo_stop - cur_pos);
 
                 final_lfo_stop = lfo_stop;
                 cur_pos = lfo_stop;
@@ -226,6 +226,8 @@ void Proc_fill_freq_buffer(
 
     if (pitches != NULL)
     {
+        const int32_t control_period = Work_buffer_get_control_period(pitches);
+
         Proc_clamp_pitch_values(pitches, buf_start, buf_stop);
 
         const int32_t const_start = Work_buffer_get_const_start(pitches);
@@ -235,8 +237,25 @@ void Proc_fill_freq_buffer(
 
         const int32_t fast_stop = clamp(const_start, buf_start, buf_stop);
 
-        for (int32_t i = buf_start; i < fast_stop; ++i)
-            freqs_data[i] = (float)fast_cents_to_Hz(pitches_data[i]);
+        if (control_period > 1)
+        {
+            // Convert only the control points, the rest follows linearly
+            for (int32_t i = buf_start;
+                    i < fast_stop;
+                    i = Work_buffer_get_next_control_pos(i, fast_stop, control_period))
+                freqs_data[i] = (float)fast_cents_to_Hz(pitches_data[i]);
+
+            if (buf_start < fast_stop)
+                Work_buffer_interpolate_control_values(
+                        freqs, buf_start, fast_stop, control_period);
+        }
+        else
+        {
+            fast_cents_to_Hz_array(
+                    freqs_data + buf_start,
+                    pitches_data + buf_start,
+                    fast_stop - buf_start);
+        }
 
         //fprintf(stdout, "%d %d %d\n", (int)buf_start, (int)fast_stop, (int)buf_stop);
 
@@ -276,6 +295,7 @@ void Proc_fill_scale_buffer(
 
     if (dBs != NULL)
     {
+        const int32_t control_period = Work_buffer_get_control_period(dBs);
         const int32_t const_start = Work_buffer_get_const_start(dBs);
         float* scales_data = Work_buffer_get_contents_mut(scales);
 
@@ -298,8 +318,25 @@ void Proc_fill_scale_buffer(
             }
         }
 
-        for (int32_t i = buf_start; i < fast_stop; ++i)
-            scales_data[i] = (float)fast_dB_to_scale(dBs_data[i]);
+        if (control_period > 1)
+        {
+            // Convert only the control points, the rest follows linearly
+            for (int32_t i = buf_start;
+                    i < fast_stop;
+                    i = Work_buffer_get_next_control_pos(i, fast_stop, control_period))
+                scales_data[i] = (float)fast_dB_to_scale(dBs_data[i]);
+
+            if (buf_start < fast_stop)
+                Work_buffer_interpolate_control_values(
+                        scales, buf_start, fast_stop, control_period);
+        }
+        else
+        {
+            fast_dB_to_scale_array(
+                    scales_data + buf_start,
+                    dBs_data + buf_start,
+                    fast_stop - buf_start);
+        }
 
         //fprintf(stdout, "%d %d %d\n", (int)buf_start, (int)fast_stop, (int)buf_stop);
 
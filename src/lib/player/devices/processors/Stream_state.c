@@ -16,6 +16,7 @@
 
 #include <debug/assert.h>
 #include <init/devices/Device.h>
+#include <init/devices/Processor.h>
 #include <init/devices/processors/Proc_stream.h>
 #include <memory.h>
 #include <player/devices/Device_thread_state.h>
@@ -37,19 +38,26 @@ enum
 
 static void apply_controls(
         Linear_controls* controls,
+        const Device_state* dstate,
         Work_buffer* out_wb,
         int32_t buf_start,
         int32_t buf_stop,
         double tempo)
 {
     rassert(controls != NULL);
+    rassert(dstate != NULL);
     rassert(buf_start >= 0);
     rassert(buf_stop >= buf_start);
 
     Linear_controls_set_tempo(controls, tempo);
 
     if (out_wb != NULL)
-        Linear_controls_fill_work_buffer(controls, out_wb, buf_start, buf_stop);
+    {
+        const int32_t control_period =
+            Processor_get_control_period((const Processor*)dstate->device);
+        Linear_controls_fill_work_buffer(
+                controls, out_wb, buf_start, buf_stop, control_period);
+    }
     else
         Linear_controls_skip(controls, buf_stop - buf_start);
 
@@ -120,7 +128,7 @@ static void Stream_pstate_render_mixed(
     Work_buffer* out_wb = Device_thread_state_get_mixed_buffer(
             proc_ts, DEVICE_PORT_TYPE_SEND, PORT_OUT_STREAM);
 
-    apply_controls(&spstate->controls, out_wb, buf_start, buf_stop, tempo);
+    apply_controls(&spstate->controls, dstate, out_wb, buf_start, buf_stop, tempo);
 
     return;
 }
@@ -349,7 +357,8 @@ int32_t Stream_vstate_render_voice(
         return buf_start;
     }
 
-    apply_controls(&svstate->controls, out_wb, buf_start, buf_stop, tempo);
+    apply_controls(
+            &svstate->controls, &proc_state->parent, out_wb, buf_start, buf_stop, tempo);
 
     return buf_stop;
 }
@@ -38,7 +38,7 @@ static bool try_update_cv(Channel* ch, const Value* value)
         return false;
 
     const bool was_value_set =
-        Channel_cv_state_set_value(ch->cvstate, var_name, value);
+        Channel_cv_state_set_value(ch->cvstate, Channel_get_active_cv_id(ch), value);
 
     return was_value_set;
 }
@@ -85,7 +85,8 @@ static void set_cv_carry(Channel* ch, Device_states* dstates, bool enabled)
     if (var_name == NULL)
         return;
 
-    Channel_cv_state_set_carrying_enabled(ch->cvstate, var_name, enabled);
+    Channel_cv_state_set_carrying_enabled(
+            ch->cvstate, Channel_get_active_cv_id(ch), enabled);
 
     return;
 }
@@ -104,6 +105,8 @@ bool Event_channel_set_cv_name_process(
     rassert(params->arg != NULL);
     rassert(params->arg->type == VALUE_TYPE_STRING);
 
+    Channel_reset_active_ids(ch);
+
     return set_active_name(&ch->parent, ACTIVE_CAT_CONTROL_VAR, params->arg);
 }
 
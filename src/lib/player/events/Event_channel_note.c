@@ -82,9 +82,11 @@ static void init_streams(Channel* ch, const Audio_unit* au)
             Voice_state* vstate = get_target_stream_vstate(ch, stream_name);
             if (vstate != NULL)
             {
+                const int32_t stream_id =
+                    Channel_stream_state_get_id(stream_state, stream_name);
                 const Linear_controls* cs_controls =
-                    Channel_stream_state_get_controls(stream_state, stream_name);
-                if (Channel_stream_state_is_carrying_enabled(stream_state, stream_name))
+                    Channel_stream_state_get_controls(stream_state, stream_id);
+                if (Channel_stream_state_is_carrying_enabled(stream_state, stream_id))
                 {
                     if (!isnan(Linear_controls_get_value(cs_controls)))
                         Stream_vstate_set_controls(vstate, cs_controls);
@@ -94,10 +96,10 @@ static void init_streams(Channel* ch, const Audio_unit* au)
                     Linear_controls new_lc;
                     Linear_controls_copy(&new_lc, Stream_vstate_get_controls(vstate));
                     Channel_stream_state_apply_overrides(
-                            stream_state, stream_name, &new_lc);
+                            stream_state, stream_id, &new_lc);
 
                     Channel_stream_state_set_controls(
-                            stream_state, stream_name, &new_lc);
+                            stream_state, stream_id, &new_lc);
                     Stream_vstate_set_controls(vstate, &new_lc);
                 }
             }
@@ -42,6 +42,8 @@ bool Event_channel_set_stream_name_process(
     rassert(params->arg != NULL);
     rassert(params->arg->type == VALUE_TYPE_STRING);
 
+    Channel_reset_active_ids(channel);
+
     return set_active_name(&channel->parent, ACTIVE_CAT_STREAM, params->arg);
 }
 
@@ -65,15 +67,17 @@ bool Event_channel_set_stream_value_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
-    if (!Channel_stream_state_set_value(ss, stream_name, params->arg->value.float_type))
+    if (!Channel_stream_state_set_value(ss, stream_id, params->arg->value.float_type))
         return true;
 
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -81,12 +85,11 @@ bool Event_channel_set_stream_value_process(
 
 
 static void ensure_valid_stream(
-        Channel_stream_state* ss, const char* stream_name, const Voice_state* vstate)
+        Channel_stream_state* ss, int32_t stream_id, const Voice_state* vstate)
 {
     rassert(ss != NULL);
-    rassert(stream_name != NULL);
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     if (controls == NULL)
         return;
 
@@ -94,9 +97,9 @@ static void ensure_valid_stream(
     {
         if (vstate != NULL)
             Channel_stream_state_set_controls(
-                    ss, stream_name, Stream_vstate_get_controls(vstate));
+                    ss, stream_id, Stream_vstate_get_controls(vstate));
         else
-            Channel_stream_state_set_value(ss, stream_name, 0);
+            Channel_stream_state_set_value(ss, stream_id, 0);
     }
 
     return;
@@ -122,19 +125,21 @@ bool Event_channel_slide_stream_target_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_slide_target(
-                ss, stream_name, params->arg->value.float_type))
+                ss, stream_id, params->arg->value.float_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -160,19 +165,21 @@ bool Event_channel_slide_stream_length_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_slide_length(
-                ss, stream_name, &params->arg->value.Tstamp_type))
+                ss, stream_id, &params->arg->value.Tstamp_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -198,19 +205,21 @@ bool Event_channel_stream_osc_speed_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_set_osc_speed(
-                ss, stream_name, params->arg->value.float_type))
+                ss, stream_id, params->arg->value.float_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -236,19 +245,21 @@ bool Event_channel_stream_osc_depth_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_set_osc_depth(
-                ss, stream_name, params->arg->value.float_type))
+                ss, stream_id, params->arg->value.float_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -274,19 +285,21 @@ bool Event_channel_stream_osc_speed_slide_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_set_osc_speed_slide(
-                ss, stream_name, &params->arg->value.Tstamp_type))
+                ss, stream_id, &params->arg->value.Tstamp_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -312,19 +325,21 @@ bool Event_channel_stream_osc_depth_slide_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
     Voice_state* vstate = get_target_stream_vstate(channel, stream_name);
 
-    ensure_valid_stream(ss, stream_name, vstate);
+    ensure_valid_stream(ss, stream_id, vstate);
 
     if (!Channel_stream_state_set_osc_depth_slide(
-                ss, stream_name, &params->arg->value.Tstamp_type))
+                ss, stream_id, &params->arg->value.Tstamp_type))
         return true;
 
     if (vstate == NULL)
         return true;
 
-    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_name);
+    const Linear_controls* controls = Channel_stream_state_get_controls(ss, stream_id);
     Stream_vstate_set_controls(vstate, controls);
 
     return true;
@@ -348,8 +363,10 @@ bool Event_channel_carry_stream_on_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
-    return Channel_stream_state_set_carrying_enabled(ss, stream_name, true);
+    return Channel_stream_state_set_carrying_enabled(ss, stream_id, true);
 }
 
 
@@ -370,8 +387,10 @@ bool Event_channel_carry_stream_off_process(
     if ((stream_name == NULL) || !is_valid_var_name(stream_name))
         return false;
 
+    const int32_t stream_id = Channel_get_active_stream_id(channel);
+
     Channel_stream_state* ss = Channel_get_stream_state_mut(channel);
-    return Channel_stream_state_set_carrying_enabled(ss, stream_name, false);
+    return Channel_stream_state_set_carrying_enabled(ss, stream_id, false);
 }
 
 
@@ -15,6 +15,7 @@
 #include <player/events/Event_master_decl.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 #include <kunquat/limits.h>
 #include <player/events/Event_common.h>
 #include <player/events/Event_params.h>
@@ -81,6 +82,7 @@ bool Event_master_jump_process(Master_params* master_params, const Event_params*
     AAnode* handle = Jump_cache_acquire_context(master_params->jump_cache);
     if (handle == NULL)
     {
+        rt_check("blocking I/O");
         fprintf(stderr, "Error: Out of jump contexts!\n");
         return false;
     }
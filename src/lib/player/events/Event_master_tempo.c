@@ -42,17 +42,33 @@ bool Event_master_set_tempo_process(
 }
 
 
-static void set_tempo_slide_update(Master_params* master_params)
+static void set_tempo_slide_rate(Master_params* master_params)
 {
     rassert(master_params != NULL);
 
-    const double rems_total =
-            (double)Tstamp_get_beats(&master_params->tempo_slide_length) *
-            (double)KQT_TSTAMP_BEAT +
-            Tstamp_get_rem(&master_params->tempo_slide_length);
-    const double slices = rems_total / KQT_TEMPO_SLIDE_SLICE_LEN;
-    master_params->tempo_slide_update =
-        (master_params->tempo_slide_target - master_params->tempo) / slices;
+    const double start_tempo = (master_params->tempo_slide != 0)
+        ? master_params->tempo_slide_current : master_params->tempo;
+    const double beats =
+            (double)Tstamp_get_beats(&master_params->tempo_slide_length) +
+            Tstamp_get_rem(&master_params->tempo_slide_length) /
+            (double)KQT_TSTAMP_BEAT;
+
+    if (start_tempo == master_params->tempo_slide_target)
+    {
+        master_params->tempo = master_params->tempo_slide_target;
+        master_params->tempo_slide = 0;
+        return;
+    }
+
+    // The tempo changes linearly with respect to the beat position
+    // NOTE: A zero-length slide is kept active until the next update
+    //       so that a following slide length event can still extend it
+    master_params->tempo = start_tempo;
+    master_params->tempo_slide_current = start_tempo;
+    master_params->tempo_slide_rate = (beats > 0)
+        ? (master_params->tempo_slide_target - start_tempo) / beats : 0;
+    master_params->tempo_slide =
+        (master_params->tempo_slide_target < start_tempo) ? -1 : 1;
 
     return;
 }
@@ -68,21 +84,10 @@ bool Event_master_slide_tempo_process(
 
     master_params->tempo_settings_changed = true;
 
-    Tstamp_init(&master_params->tempo_slide_slice_left);
     Tstamp_copy(&master_params->tempo_slide_left, &master_params->tempo_slide_length);
     master_params->tempo_slide_target = params->arg->value.float_type;
 
-    set_tempo_slide_update(master_params);
-
-    if (master_params->tempo_slide_update < 0)
-        master_params->tempo_slide = -1;
-    else if (master_params->tempo_slide_update > 0)
-        master_params->tempo_slide = 1;
-    else
-    {
-        master_params->tempo_slide = 0;
-        master_params->tempo = master_params->tempo_slide_target;
-    }
+    set_tempo_slide_rate(master_params);
 
     return true;
 }
@@ -102,11 +107,10 @@ bool Event_master_slide_tempo_length_process(
 
     if (master_params->tempo_slide != 0)
     {
-        Tstamp_init(&master_params->tempo_slide_slice_left);
         Tstamp_copy(
                 &master_params->tempo_slide_left, &master_params->tempo_slide_length);
 
-        set_tempo_slide_update(master_params);
+        set_tempo_slide_rate(master_params);
     }
 
     return true;
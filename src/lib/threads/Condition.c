@@ -15,6 +15,7 @@
 #include <threads/Condition.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 #include <threads/Mutex.h>
 
 #ifdef WITH_PTHREAD
@@ -71,6 +72,8 @@ void Condition_wait(Condition* cond)
     rassert(cond != NULL);
     rassert(cond->initialised);
 
+    rt_check("Condition_wait");
+
 #ifdef WITH_PTHREAD
     int status = pthread_cond_wait(&cond->cond, &cond->mutex.mutex);
     rassert(status == 0);
@@ -15,6 +15,7 @@
 #include <threads/Mutex.h>
 
 #include <debug/assert.h>
+#include <debug/rt_check.h>
 
 #ifdef WITH_PTHREAD
 #include <errno.h>
@@ -48,6 +49,19 @@ void Mutex_init(Mutex* mutex)
 
 
 void Mutex_lock(Mutex* mutex)
+{
+    rassert(mutex != NULL);
+    rassert(mutex->initialised);
+
+    rt_check("Mutex_lock");
+
+    Mutex_lock_in_render(mutex);
+
+    return;
+}
+
+
+void Mutex_lock_in_render(Mutex* mutex)
 {
     rassert(mutex != NULL);
     rassert(mutex->initialised);
@@ -55,6 +55,19 @@ void Mutex_init(Mutex* mutex);
 void Mutex_lock(Mutex* mutex);
 
 
+/**
+ * Lock the Mutex inside a render section.
+ *
+ * This is identical to \a Mutex_lock except that it is not reported by the
+ * real-time safety checks. It should only be used for the short critical
+ * sections that distribute rendering work between the render threads.
+ *
+ * \param mutex   The Mutex -- must not be \c NULL and must not be locked by
+ *                the calling thread.
+ */
+void Mutex_lock_in_render(Mutex* mutex);
+
+
 /**
  * Unlock the Mutex.
  *
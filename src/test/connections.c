@@ -18,6 +18,8 @@
 #include <kunquat/Handle.h>
 #include <kunquat/Player.h>
 
+#include <stdbool.h>
+
 
 #define buf_len 128
 
@@ -204,6 +206,67 @@ START_TEST(Connect_instrument_effect_with_unconnected_dsp_and_mix)
 END_TEST
 
 
+START_TEST(Voice_processor_chain_passes_signal_with_and_without_fan_out)
+{
+    const bool use_fan_out = (_i == 1);
+
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_control_map.json", "[ [0, 0] ]");
+    set_data("control_00/p_manifest.json", "{}");
+
+    make_debug_instrument();
+
+    set_data("au_00/proc_02/p_manifest.json", "{ \"type\": \"volume\" }");
+    set_data("au_00/proc_02/p_signal_type.json", "\"voice\"");
+    set_data("au_00/proc_02/in_00/p_manifest.json", "{}");
+    set_data("au_00/proc_02/out_00/p_manifest.json", "{}");
+
+    set_data("au_00/proc_03/p_manifest.json", "{ \"type\": \"volume\" }");
+    set_data("au_00/proc_03/p_signal_type.json", "\"voice\"");
+    set_data("au_00/proc_03/in_00/p_manifest.json", "{}");
+    set_data("au_00/proc_03/out_00/p_manifest.json", "{}");
+
+    // The debug output is either passed through the volume chain as is
+    // or also mixed directly to the instrument output
+    set_data("au_00/p_connections.json", use_fan_out ?
+            "[ [\"proc_01/C/out_00\", \"proc_00/C/in_00\"]"
+            ", [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+            ", [\"proc_02/C/out_00\", \"proc_03/C/in_00\"]"
+            ", [\"proc_03/C/out_00\", \"out_00\"]"
+            ", [\"proc_00/C/out_00\", \"out_00\"]"
+            "]" :
+            "[ [\"proc_01/C/out_00\", \"proc_00/C/in_00\"]"
+            ", [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+            ", [\"proc_02/C/out_00\", \"proc_03/C/in_00\"]"
+            ", [\"proc_03/C/out_00\", \"out_00\"]"
+            "]");
+
+    set_data("out_00/p_manifest.json", "{}");
+    set_data("p_connections.json", "[ [\"au_00/out_00\", \"out_00\"] ]");
+
+    validate();
+
+    float actual_buf[buf_len] = { 0.0f };
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    check_unexpected_error();
+    mix_and_fill(actual_buf, buf_len);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float seq[] = { 1.0f, 0.5f, 0.5f, 0.5f };
+    float fan_out_seq[] = { 2.0f, 1.0f, 1.0f, 1.0f };
+    if (use_fan_out)
+        repeat_seq_local(expected_buf, 10, fan_out_seq);
+    else
+        repeat_seq_local(expected_buf, 10, seq);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0f);
+}
+END_TEST
+
+
 static Suite* Connections_suite(void)
 {
     Suite* s = suite_create("Connections");
@@ -224,6 +287,16 @@ static Suite* Connections_suite(void)
             tc_effects,
             Connect_instrument_effect_with_unconnected_dsp_and_mix);
 
+    TCase* tc_chains = tcase_create("chains");
+    suite_add_tcase(s, tc_chains);
+    tcase_set_timeout(tc_chains, timeout);
+    tcase_add_checked_fixture(tc_chains, setup_empty, handle_teardown);
+
+    tcase_add_loop_test(
+            tc_chains,
+            Voice_processor_chain_passes_signal_with_and_without_fan_out,
+            0, 2);
+
     return s;
 }
 
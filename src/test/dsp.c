@@ -18,6 +18,11 @@
 #include <kunquat/Handle.h>
 #include <kunquat/Player.h>
 
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
 
 #define buf_len 128
 
@@ -46,9 +51,46 @@ static void make_debug_instrument(void)
 }
 
 
-START_TEST(Trivial_delay_is_identity)
+static void render_in_chunks(float* buf, long nframes, long chunk_size, long note_pos)
 {
-    set_audio_rate(220);
+    assert(buf != NULL);
+    assert(nframes >= 0);
+    assert(chunk_size > 0);
+    assert(note_pos >= 0);
+    assert(note_pos < nframes);
+
+    long pos = 0;
+    while (pos < nframes)
+    {
+        if (pos == note_pos)
+        {
+            kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+            check_unexpected_error();
+        }
+
+        // Stop at the note position so that the note starts at the exact frame
+        const long stop = (pos < note_pos) ? note_pos : nframes;
+        const long frames = (chunk_size < stop - pos) ? chunk_size : stop - pos;
+        kqt_Handle_play(handle, frames);
+        check_unexpected_error();
+
+        const long frames_available = kqt_Handle_get_frames_available(handle);
+        fail_if(frames_available <= 0, "Could not render audio at frame %ld", pos);
+
+        const float* ret_buf = kqt_Handle_get_audio(handle, 0);
+        check_unexpected_error();
+        memcpy(buf + pos, ret_buf, (size_t)frames_available * sizeof(float));
+
+        pos += frames_available;
+    }
+
+    return;
+}
+
+
+static void setup_delay(long audio_rate)
+{
+    set_audio_rate(audio_rate);
     set_mix_volume(0);
     pause();
 
@@ -73,6 +115,13 @@ START_TEST(Trivial_delay_is_identity)
     set_data("p_control_map.json", "[ [0, 2] ]");
     set_data("control_00/p_manifest.json", "{}");
 
+    return;
+}
+
+
+START_TEST(Trivial_delay_is_identity)
+{
+    setup_delay(220);
     validate();
 
     float actual_buf[buf_len] = { 0.0f };
@@ -89,6 +138,253 @@ START_TEST(Trivial_delay_is_identity)
 END_TEST
 
 
+#define delay_buf_len 320
+
+
+START_TEST(Delayed_impulse_lands_at_delay_across_history_wrap)
+{
+    // The delays are exact in frames at this audio rate
+    static const long audio_rate = 256;
+    static const double delay_frames[] = { 48, 31.25 };
+    static const long chunk_sizes[] = { 1, 13, 64, 100 };
+    const double delay = delay_frames[_i / 4];
+    const long chunk_size = chunk_sizes[_i % 4];
+
+    setup_delay(audio_rate);
+
+    // 0.25 seconds fit in a history of 64 frames, which wraps several times below
+    set_data("au_03/proc_01/c/p_f_max_delay.json", "0.25");
+    char data[32] = "";
+    snprintf(data, sizeof(data), "%.10f", delay / (double)audio_rate);
+    set_data("au_03/proc_01/c/p_f_init_delay.json", data);
+    set_data("au_02/proc_00/c/p_b_single_pulse.json", "true");
+    validate();
+
+    // Start the impulse near the end of the history so that it is read after a wrap
+    static const long impulse_pos = 200;
+    static float actual_buf[delay_buf_len] = { 0.0f };
+    render_in_chunks(actual_buf, delay_buf_len, chunk_size, impulse_pos);
+
+    static float expected_buf[delay_buf_len] = { 0.0f };
+    for (long i = 0; i < delay_buf_len; ++i)
+        expected_buf[i] = 0;
+    const long whole_delay = (long)floor(delay);
+    const float frac_delay = (float)(delay - (double)whole_delay);
+    expected_buf[impulse_pos + whole_delay] = 1.0f - frac_delay;
+    expected_buf[impulse_pos + whole_delay + 1] = frac_delay;
+
+    check_buffers_equal(expected_buf, actual_buf, delay_buf_len, 0.0f);
+}
+END_TEST
+
+
+#ifdef WITH_SNDFILE
+
+
+#define conv_part_size_default 1024
+#define conv_buf_len (16384 + 256)
+#define conv_ir_len_max 256
+
+
+static void write_le(unsigned char* dest, uint32_t value, int byte_count)
+{
+    for (int i = 0; i < byte_count; ++i)
+        dest[i] = (unsigned char)((value >> (i * 8)) & 0xff);
+
+    return;
+}
+
+
+static void set_conv_ir(const float* ir, int length)
+{
+    assert(ir != NULL);
+    assert(length > 0);
+    assert(length <= conv_ir_len_max);
+
+    // Build a mono WAV file with 32-bit float samples
+    static unsigned char data[44 + conv_ir_len_max * 4] = { 0 };
+    const uint32_t data_size = (uint32_t)length * 4;
+
+    memcpy(data, "RIFF", 4);
+    write_le(data + 4, 36 + data_size, 4);
+    memcpy(data + 8, "WAVEfmt ", 8);
+    write_le(data + 16, 16, 4);
+    write_le(data + 20, 3, 2); // IEEE float
+    write_le(data + 22, 1, 2);
+    write_le(data + 24, 220, 4);
+    write_le(data + 28, 220 * 4, 4);
+    write_le(data + 32, 4, 2);
+    write_le(data + 34, 32, 2);
+    memcpy(data + 36, "data", 4);
+    write_le(data + 40, data_size, 4);
+
+    for (int i = 0; i < length; ++i)
+    {
+        uint32_t bits = 0;
+        memcpy(&bits, &ir[i], sizeof(float));
+        write_le(data + 44 + i * 4, bits, 4);
+    }
+
+    kqt_Handle_set_data(handle, "au_03/proc_00/c/p_ir.wav", data, 44 + (long)data_size);
+    check_unexpected_error();
+
+    return;
+}
+
+
+static void setup_conv(void)
+{
+    set_audio_rate(220);
+    set_mix_volume(0);
+    pause();
+
+    set_data("au_03/proc_00/in_00/p_manifest.json", "{}");
+    set_data("au_03/proc_00/out_00/p_manifest.json", "{}");
+    set_data("au_03/proc_00/p_manifest.json", "{ \"type\": \"conv\" }");
+    set_data("au_03/proc_00/p_signal_type.json", "\"mixed\"");
+
+    set_data("au_03/p_connections.json",
+            "[ [\"in_00\", \"proc_00/C/in_00\"], "
+            "  [\"proc_00/C/out_00\", \"out_00\"] ]");
+    set_data("au_03/in_00/p_manifest.json", "{}");
+    set_data("au_03/out_00/p_manifest.json", "{}");
+    set_data("au_03/p_manifest.json", "{ \"type\": \"effect\" }");
+
+    make_debug_instrument();
+
+    set_data("out_00/p_manifest.json", "{}");
+    set_data("p_connections.json",
+            "[ [\"au_02/out_00\", \"au_03/in_00\"], "
+            "  [\"au_03/out_00\", \"out_00\"] ]");
+    set_data("p_control_map.json", "[ [0, 2] ]");
+    set_data("control_00/p_manifest.json", "{}");
+
+    return;
+}
+
+
+static void set_conv_part_size(long part_size)
+{
+    char data[32] = "";
+    snprintf(data, sizeof(data), "%ld", part_size);
+    set_data("au_03/proc_00/c/p_i_part_size.json", data);
+
+    return;
+}
+
+
+// The debug instrument outputs 10 periods of this sequence after a note on
+static float conv_input_seq[] = { 1.0f, 0.5f, 0.5f, 0.5f };
+#define conv_input_len (10 * 4)
+
+
+static void get_delayed_conv(
+        float* dest, long len, const float* ir, int ir_len, long delay)
+{
+    assert(dest != NULL);
+    assert(ir != NULL);
+
+    float input[conv_input_len] = { 0.0f };
+    repeat_seq_local(input, 10, conv_input_seq);
+
+    for (long i = 0; i < len; ++i)
+        dest[i] = 0;
+
+    for (long n = 0; n < conv_input_len; ++n)
+    {
+        for (int k = 0; k < ir_len; ++k)
+        {
+            const long pos = delay + n + k;
+            if (pos < len)
+                dest[pos] += input[n] * ir[k];
+        }
+    }
+
+    return;
+}
+
+
+static float conv_expected_buf[conv_buf_len] = { 0.0f };
+static float conv_actual_buf[conv_buf_len] = { 0.0f };
+
+
+START_TEST(Conv_with_unit_impulse_delays_input_by_part_size)
+{
+    static const long part_sizes[] = { 64, 256, 1024, 16384 };
+    const long part_size = part_sizes[_i];
+
+    setup_conv();
+    set_conv_part_size(part_size);
+    const float ir[] = { 1.0f };
+    set_conv_ir(ir, 1);
+    validate();
+
+    const long len = part_size + 128;
+    render_in_chunks(conv_actual_buf, len, 128, 0);
+
+    get_delayed_conv(conv_expected_buf, len, ir, 1, part_size);
+
+    check_buffers_equal(conv_expected_buf, conv_actual_buf, len, 1e-6f);
+}
+END_TEST
+
+
+START_TEST(Conv_with_multiple_taps_matches_direct_convolution)
+{
+    static const long chunk_sizes[] = { 1, 13, 64, 100, 512 };
+    const long chunk_size = chunk_sizes[_i];
+
+    static const long part_size = 64;
+
+    // The taps span three partitions
+    float ir[150] = { 0.0f };
+    ir[0] = 0.5f;
+    ir[3] = -0.25f;
+    ir[63] = 0.125f;
+    ir[64] = 0.75f;
+    ir[100] = -0.5f;
+    ir[149] = 0.25f;
+
+    setup_conv();
+    set_conv_part_size(part_size);
+    set_conv_ir(ir, 150);
+    validate();
+
+    const long len = 512;
+    render_in_chunks(conv_actual_buf, len, chunk_size, 0);
+
+    get_delayed_conv(conv_expected_buf, len, ir, 150, part_size);
+
+    check_buffers_equal(conv_expected_buf, conv_actual_buf, len, 1e-5f);
+}
+END_TEST
+
+
+START_TEST(Conv_part_size_outside_valid_values_is_rejected)
+{
+    static const long part_sizes[] = { 32, 100, 1000, 32768 };
+    const long part_size = part_sizes[_i];
+
+    setup_conv();
+    set_conv_part_size(part_size);
+    const float ir[] = { 1.0f };
+    set_conv_ir(ir, 1);
+    validate();
+
+    // The default partition size is used instead
+    const long len = conv_part_size_default + 128;
+    render_in_chunks(conv_actual_buf, len, 128, 0);
+
+    get_delayed_conv(conv_expected_buf, len, ir, 1, conv_part_size_default);
+
+    check_buffers_equal(conv_expected_buf, conv_actual_buf, len, 1e-6f);
+}
+END_TEST
+
+
+#endif // WITH_SNDFILE
+
+
 static Suite* DSP_suite(void)
 {
     Suite* s = suite_create("DSP");
@@ -101,6 +397,20 @@ static Suite* DSP_suite(void)
     tcase_add_checked_fixture(tc_chorus, setup_empty, handle_teardown);
 
     tcase_add_test(tc_chorus, Trivial_delay_is_identity);
+    tcase_add_loop_test(
+            tc_chorus, Delayed_impulse_lands_at_delay_across_history_wrap, 0, 8);
+
+#ifdef WITH_SNDFILE
+    TCase* tc_conv = tcase_create("conv");
+    suite_add_tcase(s, tc_conv);
+    tcase_set_timeout(tc_conv, timeout);
+    tcase_add_checked_fixture(tc_conv, setup_empty, handle_teardown);
+
+    tcase_add_loop_test(tc_conv, Conv_with_unit_impulse_delays_input_by_part_size, 0, 4);
+    tcase_add_loop_test(
+            tc_conv, Conv_with_multiple_taps_matches_direct_convolution, 0, 5);
+    tcase_add_loop_test(tc_conv, Conv_part_size_outside_valid_values_is_rejected, 0, 4);
+#endif
 
     return s;
 }
@@ -0,0 +1,264 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <init/devices/param_types/Envelope.h>
+#include <string/Streader.h>
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+#define nodes_max 16
+
+#define sweep_min (-2.0)
+#define sweep_steps_per_unit 16
+#define sweep_count (10 * sweep_steps_per_unit + 1)
+
+
+static const Envelope_int interps[] = { ENVELOPE_INT_NEAREST, ENVELOPE_INT_LINEAR };
+
+#define interp_count ((int)(sizeof(interps) / sizeof(interps[0])))
+
+
+static float monotonic_xs[sweep_count] = { 0.0f };
+static float shuffled_xs[sweep_count] = { 0.0f };
+
+
+static void init_xs(void)
+{
+    // The sweep hits the node positions exactly and goes outside the nodes
+    for (int32_t i = 0; i < sweep_count; ++i)
+        monotonic_xs[i] = (float)(sweep_min + (double)i / sweep_steps_per_unit);
+
+    // Jump back and forth so that the segment search moves in both directions
+    for (int32_t i = 0; i < sweep_count; ++i)
+        shuffled_xs[i] = monotonic_xs[(i * 37) % sweep_count];
+
+    return;
+}
+
+
+static double get_node_value(const Envelope* env, Envelope_int interp, double x)
+{
+    // Interpolate directly between the nodes so that stale slopes are noticed
+    const int node_count = Envelope_node_count(env);
+    for (int i = 0; i < node_count; ++i)
+    {
+        const double* next = Envelope_get_node(env, i);
+        if (x > next[0])
+            continue;
+        if (x == next[0])
+            return next[1];
+        if (i == 0)
+            return NAN;
+
+        const double* prev = Envelope_get_node(env, i - 1);
+        if (interp == ENVELOPE_INT_NEAREST)
+            return (x - prev[0] < next[0] - x) ? prev[1] : next[1];
+
+        const double slope = (next[1] - prev[1]) / (next[0] - prev[0]);
+        return prev[1] + (x - prev[0]) * slope;
+    }
+
+    return NAN;
+}
+
+
+static void check_values_with_xs(
+        const Envelope* env, Envelope_int interp, const float* xs, const char* desc)
+{
+    float values[sweep_count] = { 0.0f };
+    Envelope_get_values(env, xs, values, sweep_count);
+
+    // The values may also replace the positions
+    float in_place[sweep_count] = { 0.0f };
+    memcpy(in_place, xs, sizeof(in_place));
+    Envelope_get_values(env, in_place, in_place, sweep_count);
+
+    for (int32_t i = 0; i < sweep_count; ++i)
+    {
+        const double expected = get_node_value(env, interp, xs[i]);
+        const double single = Envelope_get_value(env, xs[i]);
+        if (isnan(expected))
+        {
+            fail_if(!isnan(single) || !isnan(values[i]) || !isnan(in_place[i]),
+                    "%s: expected NAN at %.4f, got %.6f, %.6f and %.6f",
+                    desc, xs[i], single, values[i], in_place[i]);
+        }
+        else
+        {
+            fail_if((single != expected)
+                        || (values[i] != (float)expected)
+                        || (in_place[i] != (float)expected),
+                    "%s: expected %.6f at %.4f, got %.6f, %.6f and %.6f",
+                    desc, expected, xs[i], single, values[i], in_place[i]);
+        }
+    }
+
+    return;
+}
+
+
+static void check_values(const Envelope* env, Envelope_int interp, const char* desc)
+{
+    check_values_with_xs(env, interp, monotonic_xs, desc);
+    check_values_with_xs(env, interp, shuffled_xs, desc);
+
+    return;
+}
+
+
+static Envelope* new_test_envelope(Envelope_int interp)
+{
+    Envelope* env = new_Envelope(
+            nodes_max, -INFINITY, INFINITY, 0, -INFINITY, INFINITY, 0);
+    fail_if(env == NULL, "Could not create an envelope");
+    Envelope_set_interp(env, interp);
+
+    return env;
+}
+
+
+START_TEST(Values_match_single_values_after_editing)
+{
+    init_xs();
+
+    Envelope* env = new_test_envelope(interps[_i]);
+    check_values(env, interps[_i], "Empty envelope");
+
+    Envelope_set_node(env, 1, 0.5);
+    check_values(env, interps[_i], "Single node");
+
+    Envelope_set_node(env, 0, 0);
+    Envelope_set_node(env, 2, 1);
+    Envelope_set_node(env, 4, -1);
+    Envelope_set_node(env, 6, 0.25);
+    check_values(env, interps[_i], "Added nodes");
+
+    Envelope_set_node(env, 3, 2);
+    check_values(env, interps[_i], "Inserted node");
+
+    Envelope_set_node(env, 2, -0.5);
+    check_values(env, interps[_i], "Replaced node");
+
+    Envelope_del_node(env, 1);
+    check_values(env, interps[_i], "Removed node");
+
+    Envelope_del_node(env, 0);
+    check_values(env, interps[_i], "Removed first node");
+
+    Envelope_del_node(env, Envelope_node_count(env) - 1);
+    check_values(env, interps[_i], "Removed last node");
+
+    Envelope_move_node(env, 1, 2.5, -2);
+    check_values(env, interps[_i], "Moved node");
+
+    Envelope_move_node(env, 0, -1, 3);
+    check_values(env, interps[_i], "Moved first node");
+
+    Envelope_move_node(env, Envelope_node_count(env) - 1, 7, 0);
+    check_values(env, interps[_i], "Moved last node");
+
+    del_Envelope(env);
+}
+END_TEST
+
+
+START_TEST(Values_match_single_values_with_temporary_nodes)
+{
+    init_xs();
+
+    Envelope* env = new_test_envelope(interps[_i]);
+
+    // Follow the steps of reading nodes from JSON data, which starts with
+    // temporary nodes at the limits of the value range
+    Envelope_set_node(env, -DBL_MAX, -DBL_MAX);
+    Envelope_set_node(env, DBL_MAX, DBL_MAX);
+    check_values(env, interps[_i], "Temporary nodes");
+
+    Envelope_move_node(env, 0, 0, 1);
+    check_values(env, interps[_i], "Moved first temporary node");
+
+    Envelope_set_node(env, 2, 0);
+    Envelope_set_node(env, 3, 0.5);
+    check_values(env, interps[_i], "Added nodes between temporary nodes");
+
+    Envelope_move_node(env, Envelope_node_count(env) - 1, 5, -1);
+    check_values(env, interps[_i], "Moved last temporary node");
+
+    del_Envelope(env);
+}
+END_TEST
+
+
+START_TEST(Values_match_single_values_after_reading)
+{
+    init_xs();
+
+    Envelope* env = new_test_envelope(ENVELOPE_INT_LINEAR);
+
+    const char* data = "{ \"nodes\": [[0, 1], [0.5, 0], [2, 3], [2.25, -1], [6, 0]] }";
+    Streader* sr = Streader_init(STREADER_AUTO, data, (int64_t)strlen(data));
+    fail_if(!Envelope_read(env, sr),
+            "Could not read envelope: %s", Streader_get_error_desc(sr));
+
+    // The interpolation method is set by the envelope data
+    Envelope_set_interp(env, interps[_i]);
+    check_values(env, interps[_i], "Read envelope");
+
+    del_Envelope(env);
+}
+END_TEST
+
+
+static Suite* Envelope_suite(void)
+{
+    Suite* s = suite_create("Envelope");
+
+    const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_values = tcase_create("values");
+    suite_add_tcase(s, tc_values);
+    tcase_set_timeout(tc_values, timeout);
+
+    tcase_add_loop_test(
+            tc_values, Values_match_single_values_after_editing, 0, interp_count);
+    tcase_add_loop_test(
+            tc_values, Values_match_single_values_with_temporary_nodes, 0, interp_count);
+    tcase_add_loop_test(
+            tc_values, Values_match_single_values_after_reading, 0, interp_count);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Envelope_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
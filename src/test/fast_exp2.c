@@ -14,7 +14,9 @@
 
 #include <test_common.h>
 
+#include <mathnum/common.h>
 #include <mathnum/fast_exp2.h>
+#include <mathnum/fast_math.h>
 
 #include <math.h>
 #include <stdint.h>
@@ -41,6 +43,92 @@ START_TEST(Maximum_relative_error_is_small)
 END_TEST
 
 
+#define ARRAY_LENGTH 4099
+
+
+START_TEST(Array_results_match_scalar_results)
+{
+    static const int32_t test_count = 1048577;
+
+    float src[ARRAY_LENGTH] = { 0 };
+    float dest[ARRAY_LENGTH] = { 0 };
+
+    static const double muls[][2] =
+    {
+        { 1.0, 1.0 },
+        { 1.0 / 1200.0, 440.0 },
+        { 1.0 / 6.0, 1.0 },
+    };
+
+    for (int mi = 0; mi < (int)(sizeof(muls) / sizeof(muls[0])); ++mi)
+    {
+        const double in_mul = muls[mi][0];
+        const double out_mul = muls[mi][1];
+        const double range = 240.0 / in_mul;
+
+        for (int32_t start = 0; start < test_count; start += ARRAY_LENGTH)
+        {
+            const int32_t count = min(test_count - start, ARRAY_LENGTH);
+            for (int32_t i = 0; i < count; ++i)
+                src[i] = (float)((range * (start + i) / test_count) - (range / 2));
+
+            fast_exp2_array(
+                    dest, src, count, in_mul, out_mul, FAST_MATH_ACCURACY_APPROX);
+
+            for (int32_t i = 0; i < count; ++i)
+            {
+                const float expected = (float)(out_mul * fast_exp2(in_mul * src[i]));
+                fail_unless(dest[i] == expected,
+                        "fast_exp2_array with multipliers %.17g and %.17g"
+                        " yields %.9g for %.9g instead of %.9g",
+                        in_mul, out_mul, dest[i], src[i], expected);
+            }
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Full_accuracy_array_results_are_accurate)
+{
+    static const int32_t test_count = 1048577;
+
+    float values[ARRAY_LENGTH] = { 0 };
+
+    for (int32_t start = 0; start < test_count; start += ARRAY_LENGTH)
+    {
+        const int32_t count = min(test_count - start, ARRAY_LENGTH);
+        for (int32_t i = 0; i < count; ++i)
+            values[i] = (float)((240.0 * (start + i) / test_count) - 120.0);
+
+        fast_exp2_array(values, values, count, 1, 1, FAST_MATH_ACCURACY_FULL);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const float x = (float)((240.0 * (start + i) / test_count) - 120.0);
+            const float expected = (float)exp2(x);
+            fail_unless(values[i] == expected,
+                    "fast_exp2_array yields %.9g for %.9g instead of %.9g",
+                    values[i], x, expected);
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Array_maps_nan_to_zero)
+{
+    float values[] = { NAN, 0, NAN };
+
+    fast_exp2_array(values, values, 3, 1, 1, FAST_MATH_ACCURACY_APPROX);
+
+    fail_unless(values[0] == 0, "fast_exp2_array yields %.9g for NaN", values[0]);
+    fail_unless(values[1] == 1, "fast_exp2_array yields %.9g for 0", values[1]);
+    fail_unless(values[2] == 0, "fast_exp2_array yields %.9g for NaN", values[2]);
+}
+END_TEST
+
+
 static Suite* Fast_exp2_suite(void)
 {
     Suite* s = suite_create("Fast_exp2");
@@ -52,6 +140,9 @@ static Suite* Fast_exp2_suite(void)
     tcase_set_timeout(tc_correctness, timeout);
 
     tcase_add_test(tc_correctness, Maximum_relative_error_is_small);
+    tcase_add_test(tc_correctness, Array_results_match_scalar_results);
+    tcase_add_test(tc_correctness, Full_accuracy_array_results_are_accurate);
+    tcase_add_test(tc_correctness, Array_maps_nan_to_zero);
 
     return s;
 }
@@ -14,7 +14,9 @@
 
 #include <test_common.h>
 
+#include <mathnum/common.h>
 #include <mathnum/fast_log2.h>
+#include <mathnum/fast_math.h>
 
 #include <math.h>
 #include <stdint.h>
@@ -41,6 +43,65 @@ START_TEST(Maximum_absolute_error_is_small)
 END_TEST
 
 
+#define ARRAY_LENGTH 4099
+
+
+START_TEST(Array_results_match_scalar_results)
+{
+    static const int32_t test_count = 1048574;
+
+    float src[ARRAY_LENGTH] = { 0 };
+    float dest[ARRAY_LENGTH] = { 0 };
+
+    // Cover a wide range of exponents as well as zero
+    for (int32_t start = 0; start < test_count + 1; start += ARRAY_LENGTH)
+    {
+        const int32_t count = min(test_count + 1 - start, ARRAY_LENGTH);
+        for (int32_t i = 0; i < count; ++i)
+            src[i] = (float)(((start + i) / (double)test_count) * exp2((i % 200) - 100));
+
+        fast_log2_array(dest, src, count, 6, FAST_MATH_ACCURACY_APPROX);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const float expected =
+                (src[i] > 0) ? (float)(fast_log2(src[i]) * 6) : -INFINITY;
+            fail_unless(dest[i] == expected,
+                    "fast_log2_array yields %.9g for %.9g instead of %.9g",
+                    dest[i], src[i], expected);
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Full_accuracy_array_results_are_accurate)
+{
+    static const int32_t test_count = 1048574;
+
+    float src[ARRAY_LENGTH] = { 0 };
+    float dest[ARRAY_LENGTH] = { 0 };
+
+    for (int32_t start = 0; start < test_count + 1; start += ARRAY_LENGTH)
+    {
+        const int32_t count = min(test_count + 1 - start, ARRAY_LENGTH);
+        for (int32_t i = 0; i < count; ++i)
+            src[i] = (float)((start + i) / (double)test_count);
+
+        fast_log2_array(dest, src, count, 1, FAST_MATH_ACCURACY_FULL);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const float expected = (float)log2(src[i]);
+            fail_unless(dest[i] == expected,
+                    "fast_log2_array yields %.9g for %.9g instead of %.9g",
+                    dest[i], src[i], expected);
+        }
+    }
+}
+END_TEST
+
+
 static Suite* Fast_log2_suite(void)
 {
     Suite* s = suite_create("Fast_log2");
@@ -52,6 +113,8 @@ static Suite* Fast_log2_suite(void)
     tcase_set_timeout(tc_correctness, timeout);
 
     tcase_add_test(tc_correctness, Maximum_absolute_error_is_small);
+    tcase_add_test(tc_correctness, Array_results_match_scalar_results);
+    tcase_add_test(tc_correctness, Full_accuracy_array_results_are_accurate);
 
     return s;
 }
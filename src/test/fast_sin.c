@@ -15,6 +15,7 @@
 #include <test_common.h>
 
 #include <mathnum/common.h>
+#include <mathnum/fast_math.h>
 #include <mathnum/fast_sin.h>
 
 #include <inttypes.h>
@@ -65,6 +66,63 @@ START_TEST(Maximum_absolute_error_is_small)
 END_TEST
 
 
+#define ARRAY_LENGTH 4099
+
+
+START_TEST(Array_results_match_scalar_results)
+{
+    static const int32_t test_count = 1048577;
+
+    float src[ARRAY_LENGTH] = { 0 };
+    float dest[ARRAY_LENGTH] = { 0 };
+
+    for (int32_t start = 0; start < test_count; start += ARRAY_LENGTH)
+    {
+        const int32_t count = min(test_count - start, ARRAY_LENGTH);
+        for (int32_t i = 0; i < count; ++i)
+            src[i] = (float)(2.0 * PI * (double)(start + i) / (double)test_count);
+
+        fast_sin_array(dest, src, count, 0.5, FAST_MATH_ACCURACY_APPROX);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const float expected = (float)(fast_sin(src[i]) * 0.5);
+            fail_unless(dest[i] == expected,
+                    "fast_sin_array yields %.9g for %.9g instead of %.9g",
+                    dest[i], src[i], expected);
+        }
+    }
+}
+END_TEST
+
+
+START_TEST(Full_accuracy_array_results_are_accurate)
+{
+    static const int32_t test_count = 1048577;
+
+    float src[ARRAY_LENGTH] = { 0 };
+    float dest[ARRAY_LENGTH] = { 0 };
+
+    for (int32_t start = 0; start < test_count; start += ARRAY_LENGTH)
+    {
+        const int32_t count = min(test_count - start, ARRAY_LENGTH);
+        for (int32_t i = 0; i < count; ++i)
+            src[i] = (float)(2.0 * PI * (double)(start + i) / (double)(test_count - 1));
+
+        fast_sin_array(dest, src, count, 1, FAST_MATH_ACCURACY_FULL);
+
+        for (int32_t i = 0; i < count; ++i)
+        {
+            const float expected = (float)sin(src[i]);
+            fail_unless(dest[i] == expected,
+                    "fast_sin_array yields %.9g for %.9g instead of %.9g",
+                    dest[i], src[i], expected);
+        }
+    }
+}
+END_TEST
+
+
 static Suite* Fast_sin_suite(void)
 {
     Suite* s = suite_create("Fast_sin");
@@ -77,6 +135,8 @@ static Suite* Fast_sin_suite(void)
 
     tcase_add_test(tc_correctness, Sine_values_have_maximum_magnitude_of_one);
     tcase_add_test(tc_correctness, Maximum_absolute_error_is_small);
+    tcase_add_test(tc_correctness, Array_results_match_scalar_results);
+    tcase_add_test(tc_correctness, Full_accuracy_array_results_are_accurate);
 
     return s;
 }
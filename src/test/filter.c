@@ -13,8 +13,12 @@
  */
 
 
+#include <handle_utils.h>
 #include <test_common.h>
 
+#include <init/devices/processors/Proc_filter.h>
+#include <kunquat/Handle.h>
+#include <kunquat/Player.h>
 #include <kunquat/testing.h>
 #include <mathnum/common.h>
 #include <player/devices/processors/Filter.h>
@@ -108,6 +112,265 @@ START_TEST(Two_Pole_Frequency_Response)
 END_TEST
 
 
+#define proc_rate 48000
+#define proc_buf_len 4096
+#define proc_step_pos 2048
+
+#define cutoff_bias 81.37631656229591
+
+
+static void setup_filter_effect(int type, double cutoff, double resonance)
+{
+    set_audio_rate(proc_rate);
+    set_mix_volume(0);
+    pause();
+
+    setup_debug_instrument();
+
+    set_data("au_01/proc_00/in_00/p_manifest.json", "{}");
+    set_data("au_01/proc_00/out_00/p_manifest.json", "{}");
+    set_data("au_01/proc_00/p_manifest.json", "{ \"type\": \"filter\" }");
+    set_data("au_01/proc_00/p_signal_type.json", "\"mixed\"");
+
+    char data[64] = "";
+    snprintf(data, sizeof(data), "%d", type);
+    set_data("au_01/proc_00/c/p_i_type.json", data);
+    snprintf(data, sizeof(data), "%.6f", cutoff);
+    set_data("au_01/proc_00/c/p_f_cutoff.json", data);
+    snprintf(data, sizeof(data), "%.6f", resonance);
+    set_data("au_01/proc_00/c/p_f_resonance.json", data);
+
+    set_data("au_01/p_connections.json",
+            "[ [\"in_00\", \"proc_00/C/in_00\"], "
+            "  [\"proc_00/C/out_00\", \"out_00\"] ]");
+    set_data("au_01/in_00/p_manifest.json", "{}");
+    set_data("au_01/out_00/p_manifest.json", "{}");
+    set_data("au_01/p_manifest.json", "{ \"type\": \"effect\" }");
+
+    // The unfiltered signal goes to out_00 and the filtered signal to out_01
+    set_data("p_connections.json",
+            "[ [\"au_00/out_00\", \"out_00\"]"
+            ", [\"au_00/out_00\", \"au_01/in_00\"]"
+            ", [\"au_01/out_00\", \"out_01\"]"
+            "]");
+
+    validate();
+
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    check_unexpected_error();
+
+    return;
+}
+
+
+static void set_filter_cutoff(double cutoff)
+{
+    char data[64] = "";
+    snprintf(data, sizeof(data), "%.6f", cutoff);
+    set_data("au_01/proc_00/c/p_f_cutoff.json", data);
+    validate();
+
+    return;
+}
+
+
+static void render_filter(float* in_buf, float* out_buf, long nframes)
+{
+    assert(in_buf != NULL);
+    assert(out_buf != NULL);
+    assert(nframes >= 0);
+
+    long pos = 0;
+    while (pos < nframes)
+    {
+        kqt_Handle_play(handle, nframes - pos);
+        check_unexpected_error();
+
+        const long frames_available = kqt_Handle_get_frames_available(handle);
+        fail_if(frames_available <= 0, "Could not render audio at frame %ld", pos);
+
+        const float* ret_in = kqt_Handle_get_audio(handle, 0);
+        const float* ret_out = kqt_Handle_get_audio(handle, 1);
+        check_unexpected_error();
+        memcpy(in_buf + pos, ret_in, (size_t)frames_available * sizeof(float));
+        memcpy(out_buf + pos, ret_out, (size_t)frames_available * sizeof(float));
+
+        pos += frames_available;
+    }
+
+    return;
+}
+
+
+// The bilinear two-pole filter used by the filter processor before the state
+// variable filters
+static void apply_two_pole_filter(
+        int type,
+        double cutoff,
+        double resonance,
+        const float* in_buf,
+        float* out_buf,
+        long nframes)
+{
+    assert(in_buf != NULL);
+    assert(out_buf != NULL);
+
+    const double true_cutoff = max(exp2((cutoff + cutoff_bias) / 12.0), 1);
+    const double true_resonance = pow(1.055, resonance) * 0.5;
+
+    double coeffs[2] = { 0.0 };
+    double mul = 0.0;
+    two_pole_filter_create(
+            true_cutoff / proc_rate, true_resonance, type, coeffs, &mul);
+
+    double history1[2] = { 0.0 };
+    double history2[2] = { 0.0 };
+
+    for (long i = 0; i < nframes; ++i)
+    {
+        double result = (type == FILTER_TYPE_LOWPASS)
+            ? nq_zero_filter(2, history1, in_buf[i])
+            : dc_zero_filter(2, history1, in_buf[i]);
+        result = iir_filter_strict_cascade_even_order(2, coeffs, history2, result);
+        out_buf[i] = (float)(result * mul);
+    }
+
+    return;
+}
+
+
+static float get_max_diff(const float* buf1, const float* buf2, long start, long stop)
+{
+    float max_diff = 0;
+    for (long i = start; i < stop; ++i)
+        max_diff = max(max_diff, fabsf(buf1[i] - buf2[i]));
+
+    return max_diff;
+}
+
+
+static float proc_in_buf[proc_buf_len] = { 0.0f };
+static float proc_out_buf[proc_buf_len] = { 0.0f };
+static float proc_expected_buf[proc_buf_len] = { 0.0f };
+
+
+START_TEST(Static_cutoff_matches_two_pole_response)
+{
+    static const struct
+    {
+        int type;
+        double cutoff;
+        double resonance;
+    } settings[] =
+    {
+        { FILTER_TYPE_LOWPASS, 24, 0 },
+        { FILTER_TYPE_LOWPASS, -12.5, 0 },
+        { FILTER_TYPE_LOWPASS, 60, 40.25 },
+        { FILTER_TYPE_LOWPASS, 85.375, 90 },
+        { FILTER_TYPE_HIGHPASS, 24, 0 },
+        { FILTER_TYPE_HIGHPASS, 48.125, 60.5 },
+    };
+
+    const int type = settings[_i].type;
+    const double cutoff = settings[_i].cutoff;
+    const double resonance = settings[_i].resonance;
+
+    setup_filter_effect(type, cutoff, resonance);
+    render_filter(proc_in_buf, proc_out_buf, proc_buf_len);
+
+    apply_two_pole_filter(
+            type, cutoff, resonance, proc_in_buf, proc_expected_buf, proc_buf_len);
+
+    check_buffers_equal(proc_expected_buf, proc_out_buf, proc_buf_len, 1e-5f);
+}
+END_TEST
+
+
+START_TEST(Cutoff_change_between_blocks_is_continuous)
+{
+    static const double cutoffs[][2] =
+    {
+        { 24, 48 },
+        { 48, 24 },
+        { -24, 80 },
+        { 80, -24 },
+    };
+
+    const double cutoff1 = cutoffs[_i][0];
+    const double cutoff2 = cutoffs[_i][1];
+
+    setup_filter_effect(FILTER_TYPE_LOWPASS, cutoff1, 0);
+    render_filter(proc_in_buf, proc_out_buf, proc_step_pos);
+    set_filter_cutoff(cutoff2);
+    render_filter(
+            proc_in_buf + proc_step_pos,
+            proc_out_buf + proc_step_pos,
+            proc_buf_len - proc_step_pos);
+
+    // The filter settings are applied without resetting the filter state
+    const float jump =
+        fabsf(proc_out_buf[proc_step_pos] - proc_out_buf[proc_step_pos - 1]);
+    fail_if(jump > 0.001f,
+            "Filter output jumps by %.6f after changing cutoff from %.2f to %.2f",
+            jump, cutoff1, cutoff2);
+
+    // Make sure that the new cutoff is used
+    apply_two_pole_filter(
+            FILTER_TYPE_LOWPASS,
+            cutoff1,
+            0,
+            proc_in_buf,
+            proc_expected_buf,
+            proc_buf_len);
+    fail_if(get_max_diff(proc_expected_buf, proc_out_buf, proc_step_pos, proc_buf_len)
+                < 0.001f,
+            "Filter output did not change after changing cutoff");
+}
+END_TEST
+
+
+START_TEST(Lowpass_at_or_above_nyquist_passes_input)
+{
+    // The Nyquist frequency at our audio rate is at cutoff 93.23
+    static const double cutoffs[] = { 93.5, 100, 150 };
+    const double cutoff = cutoffs[_i];
+
+    setup_filter_effect(FILTER_TYPE_LOWPASS, cutoff, 50);
+    render_filter(proc_in_buf, proc_out_buf, proc_buf_len);
+
+    check_buffers_equal(proc_in_buf, proc_out_buf, proc_buf_len, 0.0f);
+}
+END_TEST
+
+
+START_TEST(Enabling_bypassed_lowpass_is_continuous)
+{
+    static const double cutoffs[] = { 12, 60, 90 };
+    const double cutoff = cutoffs[_i];
+
+    setup_filter_effect(FILTER_TYPE_LOWPASS, 100, 0);
+    render_filter(proc_in_buf, proc_out_buf, proc_step_pos);
+    check_buffers_equal(proc_in_buf, proc_out_buf, proc_step_pos, 0.0f);
+
+    set_filter_cutoff(cutoff);
+    render_filter(
+            proc_in_buf + proc_step_pos,
+            proc_out_buf + proc_step_pos,
+            proc_buf_len - proc_step_pos);
+
+    const float jump =
+        fabsf(proc_out_buf[proc_step_pos] - proc_out_buf[proc_step_pos - 1]);
+    fail_if(jump > 0.001f,
+            "Filter output jumps by %.6f after enabling the filter with cutoff %.2f",
+            jump, cutoff);
+
+    fail_if(get_max_diff(proc_in_buf, proc_out_buf, proc_step_pos, proc_buf_len)
+                < 0.001f,
+            "Filter was not enabled after changing cutoff");
+}
+END_TEST
+
+
 static Suite* Filter_suite(void)
 {
     Suite* s = suite_create("Filter");
@@ -123,6 +386,16 @@ static Suite* Filter_suite(void)
             tc_two_pole, Two_Pole_Frequency_Response,
             1, cutoff_count + 1);
 
+    TCase* tc_proc = tcase_create("proc");
+    suite_add_tcase(s, tc_proc);
+    tcase_set_timeout(tc_proc, timeout);
+    tcase_add_checked_fixture(tc_proc, setup_empty, handle_teardown);
+
+    tcase_add_loop_test(tc_proc, Static_cutoff_matches_two_pole_response, 0, 6);
+    tcase_add_loop_test(tc_proc, Cutoff_change_between_blocks_is_continuous, 0, 4);
+    tcase_add_loop_test(tc_proc, Lowpass_at_or_above_nyquist_passes_input, 0, 3);
+    tcase_add_loop_test(tc_proc, Enabling_bypassed_lowpass_is_continuous, 0, 3);
+
     return s;
 }
 
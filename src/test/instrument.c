@@ -18,6 +18,9 @@
 #include <kunquat/Handle.h>
 #include <kunquat/Player.h>
 
+#include <stdbool.h>
+#include <string.h>
+
 
 #define buf_len 128
 
@@ -196,6 +199,75 @@ START_TEST(Input_map_maintains_indices)
 END_TEST
 
 
+START_TEST(Control_period_interpolates_stream_slide)
+{
+    set_audio_rate(256);
+    set_mix_volume(0);
+    pause();
+
+    // Set up identical streams with and without a control period
+    set_data("p_dc_blocker_enabled.json", "false");
+
+    set_data("out_00/p_manifest.json", "{}");
+    set_data("out_01/p_manifest.json", "{}");
+    set_data("p_connections.json",
+            "[ [\"au_00/out_00\", \"out_00\"],"
+            "  [\"au_00/out_01\", \"out_01\"] ]");
+
+    set_data("p_control_map.json", "[ [0, 0] ]");
+    set_data("control_00/p_manifest.json", "{}");
+
+    set_data("au_00/p_manifest.json", "{ \"type\": \"instrument\" }");
+    set_data("au_00/out_00/p_manifest.json", "{}");
+    set_data("au_00/out_01/p_manifest.json", "{}");
+    set_data("au_00/p_connections.json",
+            "[ [\"proc_00/C/out_00\", \"out_00\"]"
+            ", [\"proc_01/C/out_00\", \"out_01\"]"
+            "]");
+    set_data("au_00/p_streams.json", "[ [\"a\", 0], [\"b\", 1] ]");
+
+    set_data("au_00/proc_00/p_manifest.json", "{ \"type\": \"stream\" }");
+    set_data("au_00/proc_00/p_signal_type.json", "\"mixed\"");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "{}");
+
+    set_data("au_00/proc_01/p_manifest.json", "{ \"type\": \"stream\" }");
+    set_data("au_00/proc_01/p_signal_type.json", "\"mixed\"");
+    set_data("au_00/proc_01/p_control_period.json", "16");
+    set_data("au_00/proc_01/out_00/p_manifest.json", "{}");
+
+    validate();
+    check_unexpected_error();
+
+    kqt_Handle_fire_event(handle, 0, "[\".a\", 0]");
+    kqt_Handle_fire_event(handle, 0, "[\".sn\", \"a\"]");
+    kqt_Handle_fire_event(handle, 0, "[\"a/=s\", [1, 0]]");
+    kqt_Handle_fire_event(handle, 0, "[\"a/s\", 1]");
+    kqt_Handle_fire_event(handle, 0, "[\".sn\", \"b\"]");
+    kqt_Handle_fire_event(handle, 0, "[\"a/=s\", [1, 0]]");
+    kqt_Handle_fire_event(handle, 0, "[\"a/s\", 1]");
+    check_unexpected_error();
+
+    kqt_Handle_play(handle, buf_len);
+    check_unexpected_error();
+    const long frames_available = kqt_Handle_get_frames_available(handle);
+    fail_if(frames_available != buf_len,
+            "Wrong number of frames rendered: %ld", frames_available);
+
+    float expected_buf[buf_len] = { 0.0f };
+    float actual_buf[buf_len] = { 0.0f };
+    memcpy(expected_buf, kqt_Handle_get_audio(handle, 0), sizeof(expected_buf));
+    memcpy(actual_buf, kqt_Handle_get_audio(handle, 1), sizeof(actual_buf));
+    check_unexpected_error();
+
+    fail_if(expected_buf[buf_len - 1] < 0.5f,
+            "Stream slide did not progress, final value was %.4f",
+            expected_buf[buf_len - 1]);
+
+    check_buffers_equal(expected_buf, actual_buf, buf_len, 0.0001f);
+}
+END_TEST
+
+
 START_TEST(Add_and_remove_internal_effect_and_render)
 {
     set_audio_rate(220);
@@ -277,6 +349,129 @@ START_TEST(Read_audio_unit_control_vars)
 END_TEST
 
 
+#define lanes_buf_len 2048
+#define lanes_chunk_len 512
+#define lanes_note_count 4
+#define lanes_slide_ch 1
+
+
+static void setup_filtered_debug_instrument(void)
+{
+    set_audio_rate(48000);
+    set_mix_volume(0);
+    pause();
+
+    set_data("p_dc_blocker_enabled.json", "false");
+
+    set_data("out_00/p_manifest.json", "{}");
+    set_data("p_connections.json", "[ [\"au_00/out_00\", \"out_00\"] ]");
+
+    set_data("p_control_map.json", "[ [0, 0] ]");
+    set_data("control_00/p_manifest.json", "{}");
+
+    set_data("au_00/p_manifest.json", "{ \"type\": \"instrument\" }");
+    set_data("au_00/out_00/p_manifest.json", "{}");
+
+    // The pitch also controls the cutoff of the filter, so a pitch slide
+    // changes the filter settings of a single voice
+    set_data("au_00/p_connections.json",
+            "[ [\"proc_02/C/out_00\", \"out_00\"]"
+            ", [\"proc_00/C/out_00\", \"proc_02/C/in_00\"]"
+            ", [\"proc_01/C/out_00\", \"proc_00/C/in_00\"]"
+            ", [\"proc_01/C/out_00\", \"proc_02/C/in_02\"]"
+            "]");
+
+    set_data("au_00/proc_00/p_manifest.json", "{ \"type\": \"debug\" }");
+    set_data("au_00/proc_00/p_signal_type.json", "\"voice\"");
+    set_data("au_00/proc_00/in_00/p_manifest.json", "{}");
+    set_data("au_00/proc_00/out_00/p_manifest.json", "{}");
+
+    set_data("au_00/proc_01/p_manifest.json", "{ \"type\": \"pitch\" }");
+    set_data("au_00/proc_01/p_signal_type.json", "\"voice\"");
+    set_data("au_00/proc_01/out_00/p_manifest.json", "{}");
+
+    set_data("au_00/proc_02/p_manifest.json", "{ \"type\": \"filter\" }");
+    set_data("au_00/proc_02/p_signal_type.json", "\"voice\"");
+    set_data("au_00/proc_02/in_00/p_manifest.json", "{}");
+    set_data("au_00/proc_02/in_02/p_manifest.json", "{}");
+    set_data("au_00/proc_02/out_00/p_manifest.json", "{}");
+    set_data("au_00/proc_02/c/p_f_resonance.json", "40");
+
+    validate();
+    check_unexpected_error();
+
+    return;
+}
+
+
+static void render_filtered_notes(float* buf, bool is_note_ch[lanes_note_count])
+{
+    assert(buf != NULL);
+    assert(is_note_ch != NULL);
+
+    static const char* notes[lanes_note_count] =
+    {
+        "[\"n+\", -90]",
+        "[\"n+\", -30]",
+        "[\"n+\", 30]",
+        "[\"n+\", 90]",
+    };
+
+    setup_filtered_debug_instrument();
+
+    for (int ch = 0; ch < lanes_note_count; ++ch)
+    {
+        if (is_note_ch[ch])
+            kqt_Handle_fire_event(handle, ch, notes[ch]);
+    }
+    check_unexpected_error();
+
+    for (long pos = 0; pos < lanes_buf_len; pos += lanes_chunk_len)
+    {
+        if ((pos == lanes_chunk_len) && is_note_ch[lanes_slide_ch])
+        {
+            kqt_Handle_fire_event(handle, lanes_slide_ch, "[\"/=p\", [0, 220540320]]");
+            kqt_Handle_fire_event(handle, lanes_slide_ch, "[\"/p\", 60]");
+            check_unexpected_error();
+        }
+
+        const long frames_available = mix_and_fill(buf + pos, lanes_chunk_len);
+        fail_if(frames_available != lanes_chunk_len,
+                "Wrong number of frames rendered: %ld", frames_available);
+    }
+
+    return;
+}
+
+
+START_TEST(Voices_in_lanes_match_separate_voices)
+{
+    // Render all notes at once so that the identical voice groups form a batch
+    float actual_buf[lanes_buf_len] = { 0.0f };
+    bool all_notes[lanes_note_count] = { true, true, true, true };
+    render_filtered_notes(actual_buf, all_notes);
+
+    // Render each note separately
+    float expected_buf[lanes_buf_len] = { 0.0f };
+    for (int ch = 0; ch < lanes_note_count; ++ch)
+    {
+        handle_teardown();
+        setup_empty();
+
+        float voice_buf[lanes_buf_len] = { 0.0f };
+        bool single_note[lanes_note_count] = { false };
+        single_note[ch] = true;
+        render_filtered_notes(voice_buf, single_note);
+
+        for (int i = 0; i < lanes_buf_len; ++i)
+            expected_buf[i] += voice_buf[i];
+    }
+
+    check_buffers_equal(expected_buf, actual_buf, lanes_buf_len, 0.00001f);
+}
+END_TEST
+
+
 static Suite* Instrument_suite(void)
 {
     Suite* s = suite_create("Instrument");
@@ -292,8 +487,10 @@ static Suite* Instrument_suite(void)
     tcase_add_test(tc_general, Adding_manifest_enables_instrument);
     //tcase_add_test(tc_general, Removing_manifest_disables_instrument);
     tcase_add_test(tc_general, Input_map_maintains_indices);
+    tcase_add_test(tc_general, Control_period_interpolates_stream_slide);
     tcase_add_test(tc_general, Add_and_remove_internal_effect_and_render);
     tcase_add_test(tc_general, Read_audio_unit_control_vars);
+    tcase_add_test(tc_general, Voices_in_lanes_match_separate_voices);
 
     return s;
 }
@@ -0,0 +1,223 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <init/devices/param_types/Note_map.h>
+#include <init/devices/param_types/Sample_entry.h>
+#include <mathnum/common.h>
+#include <mathnum/Random.h>
+#include <string/Streader.h>
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define point_count_max 16
+
+
+typedef struct Map_point
+{
+    double cents;
+    double force;
+} Map_point;
+
+
+typedef struct Map_point_set
+{
+    int count;
+    Map_point points[point_count_max];
+    Map_point extra_point;
+} Map_point_set;
+
+
+/*
+ * The grid cells of the point sets are aligned with the sweep steps below,
+ * so the sweep also hits positions exactly on cell edges. Most of the points
+ * are on cell edges as well, and the sets contain positions with equal
+ * distances to several points.
+ */
+static const Map_point_set point_sets[] =
+{
+    // 300 cents x 24 dB cells
+    {
+        6,
+        {
+            { 0, -16 }, { 600, -16 }, { 1200, -8 }, { 1200, 0 }, { 1800, 0 }, { 2400, 0 },
+        },
+        { 900, -12 },
+    },
+
+    // 200 cents x 16 dB cells
+    {
+        9,
+        {
+            { -1200, -16 }, { -1200, -8 }, { -1200, 0 },
+            { 0, -16 }, { 0, -8 }, { 0, 0 },
+            { 1200, -16 }, { 1200, -8 }, { 1200, 0 },
+        },
+        { 600, -4 },
+    },
+
+    // A single point
+    {
+        1,
+        {
+            { 0, 0 },
+        },
+        { 0, -8 },
+    },
+};
+
+#define point_set_count ((int)(sizeof(point_sets) / sizeof(point_sets[0])))
+
+
+#define sweep_cents_margin 3000
+#define sweep_cents_step 25
+#define sweep_force_min (-100)
+#define sweep_force_max 40
+#define sweep_force_step 0.5
+
+
+static Note_map* new_empty_map(void)
+{
+    Streader* sr = Streader_init(STREADER_AUTO, NULL, 0);
+    Note_map* map = new_Note_map_from_string(sr);
+    fail_if(map == NULL, "Could not create a note map");
+
+    return map;
+}
+
+
+static void add_point(Note_map* map, const Map_point* point, int sample)
+{
+    Sample_entry* entry = &(Sample_entry)
+    {
+        .ref_freq = 0,
+        .sample = sample,
+        .cents = 0,
+        .vol_scale = 1,
+    };
+
+    fail_if(!Note_map_add_entry(map, point->cents, point->force, entry),
+            "Could not add entry at (%.2f, %.2f)", point->cents, point->force);
+
+    return;
+}
+
+
+static void check_lookups(
+        const Note_map* grid_map,
+        const Note_map* tree_map,
+        double min_cents,
+        double max_cents)
+{
+    Random* random = Random_init(RANDOM_AUTO, "test");
+
+    for (double cents = min_cents - sweep_cents_margin;
+            cents <= max_cents + sweep_cents_margin;
+            cents += sweep_cents_step)
+    {
+        for (double force = sweep_force_min;
+                force <= sweep_force_max;
+                force += sweep_force_step)
+        {
+            const Sample_entry* expected =
+                Note_map_get_entry(tree_map, cents, force, random);
+            const Sample_entry* actual =
+                Note_map_get_entry(grid_map, cents, force, random);
+            fail_if(expected == NULL, "No entry found at (%.2f, %.2f)", cents, force);
+            fail_if(actual == NULL, "No entry found at (%.2f, %.2f)", cents, force);
+
+            fail_if(actual->sample != expected->sample,
+                    "Wrong entry at (%.2f, %.2f): expected %d, got %d",
+                    cents, force, expected->sample, actual->sample);
+        }
+    }
+
+    return;
+}
+
+
+START_TEST(Grid_lookup_matches_tree_lookup)
+{
+    const Map_point_set* set = &point_sets[_i];
+
+    // The map without a lookup grid is searched from the tree
+    Note_map* grid_map = new_empty_map();
+    Note_map* tree_map = new_empty_map();
+
+    double min_cents = INFINITY;
+    double max_cents = -INFINITY;
+
+    for (int i = 0; i < set->count; ++i)
+    {
+        const Map_point* point = &set->points[i];
+        add_point(grid_map, point, i);
+        add_point(tree_map, point, i);
+
+        min_cents = min(min_cents, point->cents);
+        max_cents = max(max_cents, point->cents);
+    }
+
+    fail_if(!Note_map_build_grid(grid_map), "Could not build note map grid");
+
+    check_lookups(grid_map, tree_map, min_cents, max_cents);
+
+    // Adding a point discards the grid until it is built again
+    add_point(grid_map, &set->extra_point, set->count);
+    add_point(tree_map, &set->extra_point, set->count);
+    check_lookups(grid_map, tree_map, min_cents, max_cents);
+
+    fail_if(!Note_map_build_grid(grid_map), "Could not build note map grid");
+    check_lookups(grid_map, tree_map, min_cents, max_cents);
+
+    del_Note_map(grid_map);
+    del_Note_map(tree_map);
+}
+END_TEST
+
+
+static Suite* Note_map_suite(void)
+{
+    Suite* s = suite_create("Note_map");
+
+    const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_lookup = tcase_create("lookup");
+    suite_add_tcase(s, tc_lookup);
+    tcase_set_timeout(tc_lookup, timeout);
+
+    tcase_add_loop_test(tc_lookup, Grid_lookup_matches_tree_lookup, 0, point_set_count);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Note_map_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
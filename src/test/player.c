@@ -18,6 +18,7 @@
 #include <kunquat/Handle.h>
 #include <string/Streader.h>
 
+#include <math.h>
 #include <stdint.h>
 #include <string.h>
 
@@ -368,6 +369,100 @@ START_TEST(Note_on_at_pattern_start_is_handled)
 END_TEST
 
 
+START_TEST(Trigger_rows_are_processed_in_position_and_channel_order)
+{
+    set_data("album/p_manifest.json", "{}");
+    set_data("album/p_tracks.json", "[0]");
+    set_data("song_00/p_manifest.json", "{}");
+    set_data("song_00/p_order_list.json", "[ [0, 0] ]");
+    set_data("pat_000/p_manifest.json", "{}");
+    set_data("pat_000/p_length.json", "[2, 0]");
+    set_data("pat_000/instance_000/p_manifest.json", "{}");
+    set_data("pat_000/col_02/p_triggers.json",
+            "[ [[0, 0], [\".arpi\", \"0\"]], [[1, 0], [\".arpi\", \"1\"]] ]");
+    set_data("pat_000/col_00/p_triggers.json",
+            "[ [[1, 0], [\".arpi\", \"2\"]], [[2, 0], [\".arpi\", \"3\"]] ]");
+
+    // Replace a column to make sure that its old rows are no longer played
+    set_data("pat_000/col_01/p_triggers.json", "[ [[0, 0], [\".arpi\", \"7\"]] ]");
+    set_data("pat_000/col_01/p_triggers.json",
+            "[ [[0, 0], [\".arpi\", \"4\"]], [[1, 0], [\".arpi\", \"5\"]] ]");
+
+    validate();
+
+    char actual_events[1024] = "";
+    while (!kqt_Handle_has_stopped(handle))
+    {
+        kqt_Handle_play(handle, 4096);
+        check_unexpected_error();
+
+        const char* events = kqt_Handle_receive_events(handle);
+        while (strcmp(events, "[]") != 0)
+        {
+            strncat(actual_events, events,
+                    sizeof(actual_events) - strlen(actual_events) - 1);
+            events = kqt_Handle_receive_events(handle);
+        }
+    }
+
+    const char expected_events[] =
+        "[[1, [\".arpi\", 4]], [2, [\".arpi\", 0]]]"
+        "[[0, [\".arpi\", 2]], [1, [\".arpi\", 5]], [2, [\".arpi\", 1]]]"
+        "[[0, [\".arpi\", 3]]]";
+
+    fail_unless(strcmp(actual_events, expected_events) == 0,
+            "Wrong events received"
+            KT_VALUES("%s", expected_events, actual_events));
+}
+END_TEST
+
+
+START_TEST(Unordered_triggers_are_processed_in_position_order)
+{
+    set_data("album/p_manifest.json", "{}");
+    set_data("album/p_tracks.json", "[0]");
+    set_data("song_00/p_manifest.json", "{}");
+    set_data("song_00/p_order_list.json", "[ [0, 0] ]");
+    set_data("pat_000/p_manifest.json", "{}");
+    set_data("pat_000/p_length.json", "[2, 0]");
+    set_data("pat_000/instance_000/p_manifest.json", "{}");
+    set_data("pat_000/col_00/p_triggers.json",
+            "[ [[2, 0], [\".arpi\", \"4\"]]"
+            ", [[1, 0], [\".arpi\", \"2\"]]"
+            ", [[0, 0], [\".arpi\", \"0\"]]"
+            ", [[1, 0], [\".arpi\", \"3\"]]"
+            ", [[0, 0], [\".arpi\", \"1\"]]"
+            "]");
+
+    validate();
+
+    char actual_events[1024] = "";
+    while (!kqt_Handle_has_stopped(handle))
+    {
+        kqt_Handle_play(handle, 4096);
+        check_unexpected_error();
+
+        const char* events = kqt_Handle_receive_events(handle);
+        while (strcmp(events, "[]") != 0)
+        {
+            strncat(actual_events, events,
+                    sizeof(actual_events) - strlen(actual_events) - 1);
+            events = kqt_Handle_receive_events(handle);
+        }
+    }
+
+    const char expected_events[] =
+        "[[0, [\".arpi\", 0]], [0, [\".arpi\", 1]]]"
+        "[[0, [\".arpi\", 2]], [0, [\".arpi\", 3]]]"
+        "[[0, [\".arpi\", 4]]]";
+
+    fail_unless(strcmp(actual_events, expected_events) == 0,
+            "Wrong events received"
+            KT_VALUES("%s", expected_events, actual_events));
+}
+END_TEST
+
+
 START_TEST(Pattern_playback_repeats_pattern)
 {
     set_audio_rate(mixing_rates[MIXING_RATE_LOW]);
@@ -798,6 +893,64 @@ START_TEST(Tempo_slide_affects_playback_cursor)
 END_TEST
 
 
+START_TEST(Tempo_slide_follows_linear_tempo_curve)
+{
+    const long audio_rate = 1000;
+    set_audio_rate(audio_rate);
+    set_mix_volume(0);
+    setup_debug_instrument();
+    setup_debug_single_pulse();
+
+    int tempos[] = { 30, 60, 120, 240, 0 }; // 0 is guard, shouldn't be used
+
+    set_data("album/p_manifest.json", "{}");
+    set_data("album/p_tracks.json", "[0]");
+    set_data("song_00/p_manifest.json", "{}");
+    set_data("song_00/p_order_list.json", "[ [0, 0] ]");
+    set_data("pat_000/p_manifest.json", "{}");
+    set_data("pat_000/p_length.json", "[4, 0]");
+    set_data("pat_000/instance_000/p_manifest.json", "{}");
+    char triggers[256] = "";
+    snprintf(triggers, sizeof(triggers),
+            "[ [[0, 0], [\"n+\", \"0\"]],"
+            "  [[1, 0], [\"n+\", \"0\"]],"
+            "  [[1, 0], [\"m/t\", \"%d\"]],"
+            "  [[1, 0], [\"m/=t\", \"1\"]],"
+            "  [[2, 0], [\"n+\", \"0\"]] ]", tempos[_i]);
+    set_data("pat_000/col_00/p_triggers.json", triggers);
+
+    validate();
+
+    float actual_buf[2048] = { 0.0f };
+    const long frame_count = mix_and_fill(actual_buf, 2048);
+
+    const long second_offset = audio_rate / 2;
+
+    long third_offset = 0;
+    for (long i = second_offset + 1; i < frame_count; ++i)
+    {
+        if (actual_buf[i] == 1.0f)
+        {
+            third_offset = i;
+            break;
+        }
+    }
+    fail_if(third_offset == 0, "Third pulse not found");
+
+    // The tempo changes linearly in beats, so the slide lasts
+    // 60 / k * ln(end / start) seconds where k is the change per beat
+    const double tempo_diff = tempos[_i] - 120;
+    const double slide_dur = (tempo_diff != 0)
+        ? 60.0 / tempo_diff * log(tempos[_i] / 120.0) : 0.5;
+    const long expected_offset =
+        second_offset + (long)floor(slide_dur * (double)audio_rate + 0.5);
+    fail_if(labs(third_offset - expected_offset) > 1,
+            "Third pulse was at frame %ld instead of %ld",
+            third_offset, expected_offset);
+}
+END_TEST
+
+
 START_TEST(Jump_backwards_creates_a_loop)
 {
     set_audio_rate(mixing_rates[MIXING_RATE_LOW]);
@@ -1378,6 +1531,84 @@ START_TEST(Query_note_force)
 END_TEST
 
 
+START_TEST(Render_profile_reports_rendered_devices)
+{
+    setup_debug_instrument();
+    pause();
+
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    kqt_Handle_play(handle, 128);
+    check_unexpected_error();
+
+    const char* profile = kqt_Handle_get_profile(handle);
+    check_unexpected_error();
+    fail_if(profile == NULL, "Render profile was not returned");
+    fail_if(strstr(profile, "\"stages\"") == NULL,
+            "Render profile does not contain master stages: %s", profile);
+
+    const bool is_enabled = (strstr(profile, "\"enabled\": true") != NULL);
+    if (is_enabled)
+    {
+        fail_if(strstr(profile, "\"au_00/proc_00\"") == NULL,
+                "Render profile does not contain the rendered processor: %s",
+                profile);
+    }
+
+    kqt_Handle_reset_profile(handle);
+    check_unexpected_error();
+
+    profile = kqt_Handle_get_profile(handle);
+    check_unexpected_error();
+    fail_if(strstr(profile, "\"au_00/proc_00\"") != NULL,
+            "Render profile was not reset: %s", profile);
+}
+END_TEST
+
+
+START_TEST(Render_trace_records_thread_timeline)
+{
+    setup_debug_instrument();
+    pause();
+
+    kqt_Handle_set_thread_count(handle, 2);
+    check_unexpected_error();
+    kqt_Handle_set_render_trace_enabled(handle, 1);
+    check_unexpected_error();
+
+    kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    kqt_Handle_play(handle, 128);
+    check_unexpected_error();
+
+    const char* trace = kqt_Handle_get_render_trace(handle);
+    check_unexpected_error();
+    fail_if(trace == NULL, "Render trace was not returned");
+    fail_if(strstr(trace, "\"traceEvents\"") == NULL,
+            "Render trace is not in trace event format: %s", trace);
+    fail_if(strstr(trace, "\"name\": \"au_00\"") == NULL,
+            "Render trace does not contain the rendered voice group: %s", trace);
+    fail_if(strstr(trace, "\"name\": \"master\"") == NULL,
+            "Render trace does not contain the master mixed task: %s", trace);
+    fail_if(strstr(trace, "\"mixed_level_wait\"") == NULL,
+            "Render trace does not contain barrier waits: %s", trace);
+
+    trace = kqt_Handle_get_render_trace(handle);
+    check_unexpected_error();
+    fail_if(strstr(trace, "\"voice_group\"") != NULL,
+            "Render trace was not cleared after retrieval: %s", trace);
+
+    kqt_Handle_set_render_trace_enabled(handle, 0);
+    check_unexpected_error();
+    kqt_Handle_play(handle, 128);
+    check_unexpected_error();
+
+    trace = kqt_Handle_get_render_trace(handle);
+    check_unexpected_error();
+    fail_if(strstr(trace, "\"ph\": \"X\"") != NULL,
+            "Render trace contains events after disabling: %s", trace);
+}
+END_TEST
+
+
 static Suite* Player_suite(void)
 {
     Suite* s = suite_create("Player");
@@ -1395,6 +1626,7 @@ static Suite* Player_suite(void)
     BUILD_TCASE(patterns);
     BUILD_TCASE(songs);
     BUILD_TCASE(events);
+    BUILD_TCASE(profile);
 
 #undef BUILD_TCASE
 
@@ -1413,6 +1645,10 @@ static Suite* Player_suite(void)
     tcase_add_loop_test(tc_patterns, Note_on_at_pattern_end_is_handled, 0, 4);
     tcase_add_loop_test(tc_patterns, Note_on_after_pattern_end_is_ignored, 0, 4);
     tcase_add_test(tc_patterns, Note_on_at_pattern_start_is_handled);
+    tcase_add_test(
+            tc_patterns, Trigger_rows_are_processed_in_position_and_channel_order);
+    tcase_add_test(
+            tc_patterns, Unordered_triggers_are_processed_in_position_order);
     tcase_add_test(tc_patterns, Pattern_playback_repeats_pattern);
     tcase_add_test(tc_patterns, Pattern_playback_pauses_zero_length_pattern);
 
@@ -1436,6 +1672,9 @@ static Suite* Player_suite(void)
     tcase_add_loop_test(
             tc_events, Tempo_slide_affects_playback_cursor,
             0, 4);
+    tcase_add_loop_test(
+            tc_events, Tempo_slide_follows_linear_tempo_curve,
+            0, 4);
     tcase_add_loop_test(
             tc_events, Jump_backwards_creates_a_loop,
             0, 4);
@@ -1458,6 +1697,9 @@ static Suite* Player_suite(void)
     tcase_add_test(tc_events, Query_voice_count_with_note);
     tcase_add_test(tc_events, Query_note_force);
 
+    tcase_add_test(tc_profile, Render_profile_reports_rendered_devices);
+    tcase_add_test(tc_profile, Render_trace_records_thread_timeline);
+
     return s;
 }
 
@@ -0,0 +1,119 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <mathnum/Random.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define max_test_length 1000
+
+
+START_TEST(Filled_signal_matches_single_values)
+{
+    const int32_t test_length = _i;
+
+    Random* block_random = Random_init(RANDOM_AUTO, "test");
+    Random* single_random = Random_init(RANDOM_AUTO, "test");
+    Random_set_seed(block_random, 42);
+    Random_set_seed(single_random, 42);
+
+    // Fill twice to check that the block function continues the sequence
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        float values[max_test_length] = { 0 };
+        Random_fill_float_signal(block_random, values, test_length);
+
+        for (int32_t i = 0; i < test_length; ++i)
+        {
+            const float expected = (float)Random_get_float_signal(single_random);
+            fail_if(values[i] != expected,
+                    "Value %d of block of length %d is %.9g instead of %.9g",
+                    (int)i, (int)test_length, values[i], expected);
+        }
+    }
+
+    fail_if(Random_get_uint64(block_random) != Random_get_uint64(single_random),
+            "Filling a block of length %d left the generator in a different state",
+            (int)test_length);
+}
+END_TEST
+
+
+START_TEST(Filled_gaussian_has_standard_normal_distribution)
+{
+    static float values[100001] = { 0 };
+    const int32_t count = (int32_t)(sizeof(values) / sizeof(*values));
+
+    Random* random = Random_init(RANDOM_AUTO, "test");
+    Random_fill_float_gaussian(random, values, count);
+
+    double sum = 0;
+    double square_sum = 0;
+    for (int32_t i = 0; i < count; ++i)
+    {
+        fail_if(!isfinite(values[i]), "Value %d is not finite: %.9g", (int)i, values[i]);
+        sum += values[i];
+        square_sum += (double)values[i] * values[i];
+    }
+
+    const double mean = sum / count;
+    const double variance = (square_sum / count) - (mean * mean);
+
+    fail_if(fabs(mean) > 0.02, "Mean of the values is %.6f", mean);
+    fail_if(fabs(variance - 1) > 0.02, "Variance of the values is %.6f", variance);
+}
+END_TEST
+
+
+static Suite* Random_suite(void)
+{
+    Suite* s = suite_create("Random");
+
+    static const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_block = tcase_create("block");
+    suite_add_tcase(s, tc_block);
+    tcase_set_timeout(tc_block, timeout);
+
+    tcase_add_loop_test(tc_block, Filled_signal_matches_single_values, 0, 20);
+    tcase_add_loop_test(
+            tc_block,
+            Filled_signal_matches_single_values,
+            max_test_length - 1,
+            max_test_length + 1);
+    tcase_add_test(tc_block, Filled_gaussian_has_standard_normal_distribution);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Random_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    const int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
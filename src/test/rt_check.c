@@ -0,0 +1,285 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <handle_utils.h>
+#include <test_common.h>
+
+#include <debug/rt_check.h>
+#include <kunquat/Handle.h>
+#include <kunquat/Player.h>
+#include <kunquat/testing.h>
+#include <memory.h>
+
+#include <dirent.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+
+// The checks are only meaningful if libkunquat detects violations
+#ifdef ENABLE_RT_CHECKS
+
+
+#define EXAMPLES_DIR "examples"
+
+#define PATH_LENGTH_MAX 4096
+
+#define EXAMPLE_FRAMES_MAX (48000L * 20)
+
+
+static bool has_suffix(const char* str, const char* suffix)
+{
+    const size_t str_len = strlen(str);
+    const size_t suffix_len = strlen(suffix);
+    return (str_len >= suffix_len) &&
+        (strcmp(str + str_len - suffix_len, suffix) == 0);
+}
+
+
+static void load_example_data(
+        const char* dir_path, const char* key_prefix, const char* rel_path)
+{
+    char path[PATH_LENGTH_MAX] = "";
+    if (rel_path[0] != '\0')
+        snprintf(path, PATH_LENGTH_MAX, "%s/%s", dir_path, rel_path);
+    else
+        snprintf(path, PATH_LENGTH_MAX, "%s", dir_path);
+
+    struct stat info;
+    fail_if(stat(path, &info) != 0, "Could not access %s", path);
+
+    if (S_ISDIR(info.st_mode))
+    {
+        DIR* dir = opendir(path);
+        fail_if(dir == NULL, "Could not open directory %s", path);
+
+        const struct dirent* entry = NULL;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            if (entry->d_name[0] == '.')
+                continue;
+
+            char sub_path[PATH_LENGTH_MAX] = "";
+            if (rel_path[0] != '\0')
+                snprintf(sub_path, PATH_LENGTH_MAX, "%s/%s", rel_path, entry->d_name);
+            else
+                snprintf(sub_path, PATH_LENGTH_MAX, "%s", entry->d_name);
+
+            load_example_data(dir_path, key_prefix, sub_path);
+        }
+
+        closedir(dir);
+        return;
+    }
+
+    // Sample formats depend on build options and are not needed for checking
+    if (has_suffix(rel_path, ".wav") || has_suffix(rel_path, ".wv"))
+        return;
+
+    FILE* in = fopen(path, "rb");
+    fail_if(in == NULL, "Could not open %s", path);
+
+    char* data = malloc((size_t)info.st_size + 1);
+    fail_if(data == NULL, "Could not allocate memory for %s", path);
+    const size_t read_size = fread(data, 1, (size_t)info.st_size, in);
+    fclose(in);
+    fail_if(read_size != (size_t)info.st_size, "Could not read %s", path);
+
+    char key[PATH_LENGTH_MAX] = "";
+    snprintf(key, PATH_LENGTH_MAX, "%s%s", key_prefix, rel_path);
+
+    const int success = kqt_Handle_set_data(handle, key, data, (long)read_size);
+    free(data);
+    fail_if(!success,
+            "Could not set data of %s: %s", key, kqt_Handle_get_error(handle));
+
+    return;
+}
+
+
+static void setup_instrument_example(const char* dir_path)
+{
+    assert(handle != 0);
+
+    set_data("out_00/p_manifest.json", "{}");
+    set_data("out_01/p_manifest.json", "{}");
+    set_data("p_connections.json",
+            "[ [\"au_00/out_00\", \"out_00\"]"
+            ", [\"au_00/out_01\", \"out_01\"]"
+            "]");
+
+    set_data("p_control_map.json", "[ [0, 0] ]");
+    set_data("control_00/p_manifest.json", "{}");
+
+    load_example_data(dir_path, "au_00/", "");
+
+    return;
+}
+
+
+static void play_example(const char* name, int thread_count)
+{
+    char dir_path[PATH_LENGTH_MAX] = "";
+    snprintf(dir_path, PATH_LENGTH_MAX, "%s/%s", EXAMPLES_DIR, name);
+
+    handle = kqt_new_Handle();
+    fail_if(handle == 0, "Could not create a handle: %s", kqt_Handle_get_error(0));
+
+    const bool is_instrument = (strncmp(name, "kqti", 4) == 0);
+    if (is_instrument)
+        setup_instrument_example(dir_path);
+    else
+        load_example_data(dir_path, "", "");
+
+    validate();
+
+    fail_if(!kqt_Handle_set_thread_count(handle, thread_count),
+            "Could not set thread count to %d: %s",
+            thread_count, kqt_Handle_get_error(handle));
+
+    // Instruments are played with a single note as they contain no music
+    if (is_instrument)
+        kqt_Handle_fire_event(handle, 0, Note_On_55_Hz);
+    bool is_note_on = is_instrument;
+
+    long frames_played = 0;
+    while ((is_instrument || !kqt_Handle_has_stopped(handle)) &&
+            (frames_played < EXAMPLE_FRAMES_MAX))
+    {
+        if (is_note_on && (frames_played >= EXAMPLE_FRAMES_MAX / 2))
+        {
+            kqt_Handle_fire_event(handle, 0, "[\"n-\", null]");
+            check_unexpected_error();
+            is_note_on = false;
+        }
+
+        kqt_Handle_play(handle, 4096);
+        check_unexpected_error();
+        frames_played += kqt_Handle_get_frames_available(handle);
+    }
+
+    handle_teardown();
+
+    return;
+}
+
+
+START_TEST(Examples_play_without_rt_safety_violations)
+{
+    const int thread_count = _i;
+
+    kqt_set_rt_check_abort(0);
+    kqt_reset_rt_check_violation_count();
+
+    DIR* examples = opendir(EXAMPLES_DIR);
+    fail_if(examples == NULL, "Could not open directory " EXAMPLES_DIR);
+
+    int example_count = 0;
+
+    const struct dirent* entry = NULL;
+    while ((entry = readdir(examples)) != NULL)
+    {
+        if (strncmp(entry->d_name, "kqt", 3) != 0)
+            continue;
+
+        play_example(entry->d_name, thread_count);
+
+        const long violation_count = kqt_get_rt_check_violation_count();
+        fail_if(violation_count != 0,
+                "Playing example %s with %d thread%s caused %ld real-time"
+                " safety violation%s",
+                entry->d_name,
+                thread_count,
+                (thread_count == 1) ? "" : "s",
+                violation_count,
+                (violation_count == 1) ? "" : "s");
+
+        ++example_count;
+    }
+
+    closedir(examples);
+
+    fail_if(example_count == 0, "No examples found in " EXAMPLES_DIR);
+}
+END_TEST
+
+
+START_TEST(Allocation_in_render_section_is_detected)
+{
+    kqt_set_rt_check_abort(0);
+    kqt_reset_rt_check_violation_count();
+
+    void* outside = memory_alloc(16);
+    fail_if(kqt_get_rt_check_violation_count() != 0,
+            "Allocation outside a render section was reported as a violation");
+
+    rt_check_enter_render();
+    void* inside = memory_alloc(16);
+    rt_check_leave_render();
+
+    memory_free(inside);
+    memory_free(outside);
+
+    const long violation_count = kqt_get_rt_check_violation_count();
+    fail_if(violation_count != 1,
+            "Allocation inside a render section caused %ld violations instead of 1",
+            violation_count);
+}
+END_TEST
+
+
+#endif // ENABLE_RT_CHECKS
+
+
+Suite* Rt_check_suite(void)
+{
+    Suite* s = suite_create("Rt_check");
+
+#ifdef ENABLE_RT_CHECKS
+    const int timeout = LONG_TIMEOUT;
+
+    TCase* tc_detect = tcase_create("detect");
+    suite_add_tcase(s, tc_detect);
+    tcase_set_timeout(tc_detect, timeout);
+
+    tcase_add_test(tc_detect, Allocation_in_render_section_is_detected);
+
+    TCase* tc_examples = tcase_create("examples");
+    suite_add_tcase(s, tc_examples);
+    tcase_set_timeout(tc_examples, timeout);
+
+    tcase_add_loop_test(
+            tc_examples, Examples_play_without_rt_safety_violations, 1, 3);
+#endif
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Rt_check_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
@@ -0,0 +1,196 @@
+
+
+/*
+ * Author: Tomi Jylhä-Ollila, Finland 2017
+ *
+ * This file is part of Kunquat.
+ *
+ * CC0 1.0 Universal, http://creativecommons.org/publicdomain/zero/1.0/
+ *
+ * To the extent possible under law, Kunquat Affirmers have waived all
+ * copyright and related or neighboring rights to Kunquat.
+ */
+
+
+#include <test_common.h>
+
+#include <kunquat/limits.h>
+#include <mathnum/Tstamp.h>
+#include <player/LFO.h>
+#include <player/Slider.h>
+
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+
+#define block_length_max 1000
+
+
+static const double tolerance = 1e-6;
+
+
+static void setup_slider(Slider* slider, Slide_mode mode)
+{
+    Slider_init(slider, mode);
+    Slider_set_audio_rate(slider, 48000);
+    Slider_set_tempo(slider, 120);
+    Slider_set_length(slider, Tstamp_set(TSTAMP_AUTO, 1, 0));
+
+    if (mode == SLIDE_MODE_EXP)
+        Slider_start(slider, 880, 110);
+    else
+        Slider_start(slider, -1200, 2400);
+
+    return;
+}
+
+
+START_TEST(Filled_slide_matches_steps)
+{
+    const Slide_mode mode = (_i == 0) ? SLIDE_MODE_LINEAR : SLIDE_MODE_EXP;
+    const double range = (mode == SLIDE_MODE_LINEAR) ? 3600 : 880;
+
+    Slider* block_slider = &(Slider){ .mode = SLIDE_MODE_LINEAR };
+    Slider* step_slider = &(Slider){ .mode = SLIDE_MODE_LINEAR };
+    setup_slider(block_slider, mode);
+    setup_slider(step_slider, mode);
+
+    // The slide lasts 24000 steps, so the blocks also cover the end of it
+    int32_t block_length = 1;
+    for (int32_t pos = 0; pos < 30000; pos += block_length)
+    {
+        block_length = (block_length * 7 + 3) % block_length_max + 1;
+
+        float values[block_length_max] = { 0 };
+        const double last_value = Slider_fill(block_slider, values, block_length);
+
+        double expected = 0;
+        for (int32_t i = 0; i < block_length; ++i)
+        {
+            expected = Slider_step(step_slider);
+            fail_if(fabs(values[i] - expected) > range * tolerance,
+                    "Slide value at %ld is %.9g instead of %.9g",
+                    (long)(pos + i), values[i], expected);
+        }
+
+        fail_if(fabs(last_value - expected) > range * tolerance,
+                "Slider_fill returned %.17g instead of %.17g at %ld",
+                last_value, expected, (long)(pos + block_length));
+    }
+
+    fail_if(Slider_in_progress(block_slider), "Slide did not finish");
+}
+END_TEST
+
+
+static void setup_lfo(LFO* lfo, LFO_mode mode)
+{
+    LFO_init(lfo, mode);
+    LFO_set_audio_rate(lfo, 48000);
+    LFO_set_tempo(lfo, 120);
+    LFO_set_speed_slide(lfo, Tstamp_set(TSTAMP_AUTO, 0, KQT_TSTAMP_BEAT / 4));
+    LFO_set_depth_slide(lfo, Tstamp_set(TSTAMP_AUTO, 0, KQT_TSTAMP_BEAT / 8));
+    LFO_set_speed(lfo, 7);
+    LFO_set_depth(lfo, (mode == LFO_MODE_LINEAR) ? 100 : 0.5);
+    LFO_turn_on(lfo);
+
+    return;
+}
+
+
+START_TEST(Filled_oscillation_matches_steps)
+{
+    const LFO_mode mode = (_i == 0) ? LFO_MODE_LINEAR : LFO_MODE_EXP;
+    const double depth = (mode == LFO_MODE_LINEAR) ? 100 : 2;
+
+    LFO* block_lfo = &(LFO){ .mode = LFO_MODE_LINEAR };
+    LFO* step_lfo = &(LFO){ .mode = LFO_MODE_LINEAR };
+    setup_lfo(block_lfo, mode);
+    setup_lfo(step_lfo, mode);
+
+    int32_t block_length = 1;
+    for (int32_t pos = 0; pos < 200000; pos += block_length)
+    {
+        // Exercise the stepping after turning the LFO off as well
+        if (pos >= 150000)
+        {
+            LFO_turn_off(block_lfo);
+            LFO_turn_off(step_lfo);
+        }
+
+        block_length = (block_length * 7 + 3) % block_length_max + 1;
+
+        float values[block_length_max] = { 0 };
+        LFO_fill(block_lfo, values, block_length);
+
+        for (int32_t i = 0; i < block_length; ++i)
+        {
+            const double expected = LFO_step(step_lfo);
+            fail_if(fabs(values[i] - expected) > depth * tolerance,
+                    "LFO value at %ld is %.9g instead of %.9g",
+                    (long)(pos + i), values[i], expected);
+        }
+    }
+
+    fail_if(LFO_active(block_lfo) != LFO_active(step_lfo),
+            "Filled and stepped LFOs ended up in different activity states");
+}
+END_TEST
+
+
+START_TEST(Mixed_oscillation_is_added_to_contents)
+{
+    LFO* fill_lfo = &(LFO){ .mode = LFO_MODE_LINEAR };
+    LFO* mix_lfo = &(LFO){ .mode = LFO_MODE_LINEAR };
+    setup_lfo(fill_lfo, LFO_MODE_LINEAR);
+    setup_lfo(mix_lfo, LFO_MODE_LINEAR);
+
+    float filled[block_length_max] = { 0 };
+    float mixed[block_length_max] = { 0 };
+    for (int32_t i = 0; i < block_length_max; ++i)
+        mixed[i] = 0.5f;
+
+    LFO_fill(fill_lfo, filled, block_length_max);
+    LFO_mix(mix_lfo, mixed, block_length_max);
+
+    for (int32_t i = 0; i < block_length_max; ++i)
+        fail_if(mixed[i] != 0.5f + filled[i],
+                "Mixed value at %ld is %.9g instead of %.9g",
+                (long)i, mixed[i], 0.5f + filled[i]);
+}
+END_TEST
+
+
+static Suite* Slider_suite(void)
+{
+    Suite* s = suite_create("Slider");
+
+    static const int timeout = DEFAULT_TIMEOUT;
+
+    TCase* tc_block = tcase_create("block");
+    suite_add_tcase(s, tc_block);
+    tcase_set_timeout(tc_block, timeout);
+
+    tcase_add_loop_test(tc_block, Filled_slide_matches_steps, 0, 2);
+    tcase_add_loop_test(tc_block, Filled_oscillation_matches_steps, 0, 2);
+    tcase_add_test(tc_block, Mixed_oscillation_is_added_to_contents);
+
+    return s;
+}
+
+
+int main(void)
+{
+    Suite* suite = Slider_suite();
+    SRunner* sr = srunner_create(suite);
+#ifdef K_MEM_DEBUG
+    srunner_set_fork_status(sr, CK_NOFORK);
+#endif
+    srunner_run_all(sr, CK_NORMAL);
+    const int fail_count = srunner_ntests_failed(sr);
+    srunner_free(sr);
+    exit(fail_count > 0);
+}
+
+
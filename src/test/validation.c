@@ -367,6 +367,55 @@ START_TEST(Validation_rejects_shared_pattern_instances_between_songs)
 END_TEST
 
 
+START_TEST(Validation_rejects_pattern_instances_removed_from_order_list)
+{
+    set_silent_composition();
+    set_data("song_00/p_order_list.json", "[ [0, 0], [1, 0] ]");
+    set_data("pat_001/p_manifest.json", "{}");
+    set_data("pat_001/instance_000/p_manifest.json", "{}");
+    validate();
+
+    set_data("song_00/p_order_list.json", "[ [0, 0] ]");
+
+    kqt_Handle_validate(handle);
+
+    check_validation_error("instance",
+            "Handle accepts a pattern instance removed from its song");
+}
+END_TEST
+
+
+START_TEST(Validation_rejects_removed_pattern_instances_used_in_songs)
+{
+    set_silent_composition();
+    set_data("song_00/p_order_list.json", "[ [0, 0], [0, 1] ]");
+    set_data("pat_000/instance_001/p_manifest.json", "{}");
+    validate();
+
+    set_data("pat_000/instance_001/p_manifest.json", "");
+
+    kqt_Handle_validate(handle);
+
+    check_validation_error("instance",
+            "Handle accepts a song with a removed pattern instance");
+}
+END_TEST
+
+
+START_TEST(Full_validation_rejects_album_without_tracks)
+{
+    set_silent_composition();
+    validate();
+
+    set_data("album/p_tracks.json", "[]");
+
+    kqt_Handle_validate_full(handle);
+
+    check_validation_error("album", "Handle accepts an album without tracks");
+}
+END_TEST
+
+
 START_TEST(Validation_rejects_nonexistent_controls_used_in_control_map)
 {
     set_data("p_control_map.json", "[ [0, 0] ]");
@@ -415,8 +464,13 @@ Suite* Validation_suite(void)
             Validation_rejects_reused_pattern_instances_in_song);
     tcase_add_test(tc_reject,
             Validation_rejects_shared_pattern_instances_between_songs);
+    tcase_add_test(tc_reject,
+            Validation_rejects_pattern_instances_removed_from_order_list);
+    tcase_add_test(tc_reject,
+            Validation_rejects_removed_pattern_instances_used_in_songs);
     tcase_add_test(tc_reject,
             Validation_rejects_nonexistent_controls_used_in_control_map);
+    tcase_add_test(tc_reject, Full_validation_rejects_album_without_tracks);
 
     return s;
 }